@@ -0,0 +1,804 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * License); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * AS IS BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*
+ * Copyright (c) 2020, OPEN AI LAB
+ * Author: haoluo@openailab.com
+ */
+
+/*
+ * post training quantization: the fp32 graph runs over a directory of calibration images, the
+ * range of every activation is taken from its min/max or from the threshold with the least
+ * KL divergence, then the weights are quantized per output channel and the graph is saved as
+ * an int8 (symmetric) or uint8 (asymmetric) tmfile.
+ */
+
+#include <unistd.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include <float.h>
+#include <dirent.h>
+#include "tengine_c_api.h"
+#include "tengine_operations.h"
+#include "common.h"
+
+#define DEFAULT_IMG_H 224
+#define DEFAULT_IMG_W 224
+#define DEFAULT_SCALE1 0.017f
+#define DEFAULT_SCALE2 0.017f
+#define DEFAULT_SCALE3 0.017f
+#define DEFAULT_MEAN1 104.007
+#define DEFAULT_MEAN2 116.669
+#define DEFAULT_MEAN3 122.679
+#define DEFAULT_THREAD_COUNT 1
+
+#define ALGO_MINMAX 0
+#define ALGO_KL 1
+
+#define HIST_BINS 2048
+#define QUANT_LEVELS 128
+
+struct tensor_stat
+{
+    tensor_t tensor;
+    float min;
+    float max;
+    float absmax;
+    uint32_t* hist; /* |x| over [0, absmax], only for the kl algorithm */
+};
+
+struct calib_context
+{
+    struct tensor_stat* stats;
+    int stat_num;
+    int stat_max;
+    node_t* nodes; /* the conv and fc nodes in run order, their weights are quantized at the end */
+    int node_num;
+    int node_max;
+    void** buffers; /* the quantized weights and biases, the graph does not own them */
+    int buffer_num;
+    int pass; /* 0: min/max, 1: histogram */
+};
+
+static struct tensor_stat* find_stat(struct calib_context* ctx, tensor_t tensor)
+{
+    for (int i = 0; i < ctx->stat_num; i++)
+    {
+        if (ctx->stats[i].tensor == tensor)
+            return &ctx->stats[i];
+    }
+
+    return NULL;
+}
+
+static struct tensor_stat* add_stat(struct calib_context* ctx, tensor_t tensor)
+{
+    if (ctx->stat_num == ctx->stat_max)
+    {
+        int max = ctx->stat_max ? ctx->stat_max * 2 : 64;
+        struct tensor_stat* stats = ( struct tensor_stat* )realloc(ctx->stats, max * sizeof(struct tensor_stat));
+
+        if (stats == NULL)
+            return NULL;
+
+        ctx->stats = stats;
+        ctx->stat_max = max;
+    }
+
+    struct tensor_stat* stat = &ctx->stats[ctx->stat_num++];
+
+    stat->tensor = tensor;
+    stat->min = FLT_MAX;
+    stat->max = -FLT_MAX;
+    stat->absmax = 0.f;
+    stat->hist = NULL;
+
+    return stat;
+}
+
+static int add_node(struct calib_context* ctx, node_t node)
+{
+    for (int i = 0; i < ctx->node_num; i++)
+    {
+        if (ctx->nodes[i] == node)
+            return 0;
+    }
+
+    if (ctx->node_num == ctx->node_max)
+    {
+        int max = ctx->node_max ? ctx->node_max * 2 : 64;
+        node_t* nodes = ( node_t* )realloc(ctx->nodes, max * sizeof(node_t));
+
+        if (nodes == NULL)
+            return -1;
+
+        ctx->nodes = nodes;
+        ctx->node_max = max;
+    }
+
+    ctx->nodes[ctx->node_num++] = node;
+
+    return 0;
+}
+
+static int record_tensor(struct calib_context* ctx, tensor_t tensor)
+{
+    if (get_tensor_data_type(tensor) != TENGINE_DT_FP32)
+        return 0;
+
+    const float* data = ( const float* )get_tensor_buffer(tensor);
+    int size = get_tensor_buffer_size(tensor) / sizeof(float);
+
+    if (data == NULL)
+        return 0;
+
+    struct tensor_stat* stat = find_stat(ctx, tensor);
+
+    if (stat == NULL)
+    {
+        if (ctx->pass != 0 || (stat = add_stat(ctx, tensor)) == NULL)
+            return -1;
+    }
+
+    if (ctx->pass == 0)
+    {
+        float min = stat->min;
+        float max = stat->max;
+
+        for (int i = 0; i < size; i++)
+        {
+            if (data[i] < min)
+                min = data[i];
+            if (data[i] > max)
+                max = data[i];
+        }
+
+        stat->min = min;
+        stat->max = max;
+        stat->absmax = fmaxf(fabsf(min), fabsf(max));
+
+        return 0;
+    }
+
+    if (stat->absmax == 0.f)
+        return 0;
+
+    if (stat->hist == NULL)
+    {
+        stat->hist = ( uint32_t* )calloc(HIST_BINS, sizeof(uint32_t));
+
+        if (stat->hist == NULL)
+            return -1;
+    }
+
+    float bin_scale = HIST_BINS / stat->absmax;
+
+    /* the zeros, mostly from relu, would only pull the threshold down */
+    for (int i = 0; i < size; i++)
+    {
+        if (data[i] == 0.f)
+            continue;
+
+        int bin = ( int )(fabsf(data[i]) * bin_scale);
+
+        stat->hist[bin < HIST_BINS ? bin : HIST_BINS - 1]++;
+    }
+
+    return 0;
+}
+
+static int calib_observer(graph_t graph, node_t node, void* arg)
+{
+    struct calib_context* ctx = ( struct calib_context* )arg;
+    const char* op = get_node_op(node);
+
+    if (ctx->pass == 0 && (strcmp(op, "Convolution") == 0 || strcmp(op, "FullyConnected") == 0) &&
+        add_node(ctx, node) < 0)
+        return -1;
+
+    /* the anchors and the decoded boxes are kept in fp32 */
+    if (strcmp(op, "PriorBox") == 0 || strcmp(op, "DetectionOutput") == 0 ||
+        strcmp(op, "DetectionPostProcess") == 0)
+        return 0;
+
+    for (int i = 0; i < get_node_output_number(node); i++)
+    {
+        if (record_tensor(ctx, get_node_output_tensor(node, i)) < 0)
+            return -1;
+    }
+
+    return 0;
+}
+
+/*
+ * the threshold whose 128 level quantized distribution is the closest to the clipped one,
+ * in the way of tensorrt: the bins past the threshold are added to the last one, and every
+ * level spreads its count over the nonzero bins it covers.
+ */
+static float get_kl_threshold(const uint32_t* hist, float absmax)
+{
+    double p[HIST_BINS];
+    double q[HIST_BINS];
+
+    int best = HIST_BINS;
+    double best_kl = DBL_MAX;
+
+    double total = 0.;
+    for (int i = 0; i < HIST_BINS; i++)
+        total += hist[i];
+
+    if (total == 0.)
+        return absmax;
+
+    double outliers = 0.;
+    for (int i = QUANT_LEVELS; i < HIST_BINS; i++)
+        outliers += hist[i];
+
+    for (int threshold = QUANT_LEVELS; threshold <= HIST_BINS; threshold++)
+    {
+        int merged = threshold / QUANT_LEVELS;
+
+        for (int i = 0; i < threshold; i++)
+            p[i] = hist[i];
+        p[threshold - 1] += outliers;
+
+        if (threshold < HIST_BINS)
+            outliers -= hist[threshold];
+
+        for (int level = 0; level < QUANT_LEVELS; level++)
+        {
+            int start = level * merged;
+            int end = level == QUANT_LEVELS - 1 ? threshold : start + merged;
+
+            double sum = 0.;
+            int nonzero = 0;
+
+            for (int i = start; i < end; i++)
+            {
+                sum += hist[i];
+                nonzero += hist[i] != 0;
+            }
+
+            for (int i = start; i < end; i++)
+                q[i] = (hist[i] != 0 && nonzero) ? sum / nonzero : 0.;
+        }
+
+        double p_sum = 0.;
+        double q_sum = 0.;
+        for (int i = 0; i < threshold; i++)
+        {
+            p_sum += p[i];
+            q_sum += q[i];
+        }
+
+        if (q_sum == 0.)
+            continue;
+
+        /* a bin of p that q leaves empty is charged as if q held a tiny part of the mass */
+        double kl = 0.;
+        for (int i = 0; i < threshold; i++)
+        {
+            if (p[i] == 0.)
+                continue;
+
+            double pi = p[i] / p_sum;
+            double qi = q[i] != 0. ? q[i] / q_sum : 1e-4 / threshold;
+
+            kl += pi * log(pi / qi);
+        }
+
+        if (kl < best_kl)
+        {
+            best_kl = kl;
+            best = threshold;
+        }
+    }
+
+    return (best + 0.5f) * absmax / HIST_BINS;
+}
+
+static void get_act_quant_param(struct tensor_stat* stat, int algorithm, int data_type, float* scale, int* zero_point)
+{
+    float threshold = stat->absmax;
+
+    if (algorithm == ALGO_KL && stat->hist)
+        threshold = get_kl_threshold(stat->hist, stat->absmax);
+
+    *zero_point = 0;
+
+    if (data_type == TENGINE_DT_INT8)
+    {
+        *scale = threshold / 127.f;
+    }
+    else
+    {
+        float min = stat->min < 0.f ? fmaxf(stat->min, -threshold) : 0.f;
+        float max = stat->max > 0.f ? fminf(stat->max, threshold) : 0.f;
+
+        *scale = (max - min) / 255.f;
+        if (*scale > 0.f)
+        {
+            int zero = ( int )roundf(-min / *scale);
+            *zero_point = zero < 0 ? 0 : (zero > 255 ? 255 : zero);
+        }
+    }
+
+    if (*scale == 0.f)
+        *scale = 1.f;
+}
+
+/* int8 weights are symmetric per output channel, uint8 ones are asymmetric per tensor */
+static int quant_weight(tensor_t weight, int data_type, void** buffer, float** scale_out, int* scale_num)
+{
+    int dims[4];
+    int dim_num = get_tensor_shape(weight, dims, 4);
+    int size = get_tensor_buffer_size(weight) / sizeof(float);
+    const float* data = ( const float* )get_tensor_buffer(weight);
+
+    if (dim_num < 1 || data == NULL)
+        return -1;
+
+    int channel = dims[0];
+    int channel_size = size / channel;
+    int8_t* qdata = ( int8_t* )malloc(size);
+    float* scale = ( float* )malloc(channel * sizeof(float));
+    int* zero_point = ( int* )calloc(channel, sizeof(int));
+
+    if (qdata == NULL || scale == NULL || zero_point == NULL)
+        goto error;
+
+    if (data_type == TENGINE_DT_INT8)
+    {
+        for (int c = 0; c < channel; c++)
+        {
+            const float* cdata = data + c * channel_size;
+            float absmax = 0.f;
+
+            for (int i = 0; i < channel_size; i++)
+                absmax = fmaxf(absmax, fabsf(cdata[i]));
+
+            scale[c] = absmax > 0.f ? absmax / 127.f : 1.f;
+
+            for (int i = 0; i < channel_size; i++)
+            {
+                int v = ( int )roundf(cdata[i] / scale[c]);
+                qdata[c * channel_size + i] = ( int8_t )(v > 127 ? 127 : (v < -127 ? -127 : v));
+            }
+        }
+
+        if (set_tensor_quant_param(weight, scale, zero_point, channel) < 0)
+            goto error;
+    }
+    else
+    {
+        float min = 0.f;
+        float max = 0.f;
+
+        for (int i = 0; i < size; i++)
+        {
+            min = fminf(min, data[i]);
+            max = fmaxf(max, data[i]);
+        }
+
+        float w_scale = max > min ? (max - min) / 255.f : 1.f;
+        zero_point[0] = ( int )roundf(-min / w_scale);
+
+        for (int i = 0; i < size; i++)
+        {
+            int v = ( int )roundf(data[i] / w_scale) + zero_point[0];
+            (( uint8_t* )qdata)[i] = ( uint8_t )(v > 255 ? 255 : (v < 0 ? 0 : v));
+        }
+
+        scale[0] = w_scale;
+
+        if (set_tensor_quant_param(weight, &w_scale, zero_point, 1) < 0)
+            goto error;
+    }
+
+    if (set_tensor_data_type(weight, data_type) < 0 || set_tensor_buffer(weight, qdata, size) < 0)
+        goto error;
+
+    free(zero_point);
+
+    *buffer = qdata;
+    *scale_out = scale;
+    *scale_num = data_type == TENGINE_DT_INT8 ? channel : 1;
+
+    return 0;
+
+error:
+    free(qdata);
+    free(scale);
+    free(zero_point);
+    return -1;
+}
+
+/* the bias is int32 in the scale of input x weight, per output channel if the weight is */
+static int quant_bias(tensor_t bias, void** buffer, float input_scale, const float* weight_scale, int scale_num)
+{
+    int size = get_tensor_buffer_size(bias) / sizeof(float);
+    const float* data = ( const float* )get_tensor_buffer(bias);
+    int32_t* qdata = ( int32_t* )malloc(size * sizeof(int32_t));
+    float* scale = ( float* )malloc(size * sizeof(float));
+    int* zero_point = ( int* )calloc(size, sizeof(int));
+
+    if (data == NULL || qdata == NULL || scale == NULL || zero_point == NULL)
+        goto error;
+
+    for (int i = 0; i < size; i++)
+    {
+        scale[i] = input_scale * weight_scale[scale_num > 1 ? i : 0];
+        qdata[i] = ( int32_t )roundf(data[i] / scale[i]);
+    }
+
+    if (set_tensor_quant_param(bias, scale, zero_point, scale_num > 1 ? size : 1) < 0 ||
+        set_tensor_data_type(bias, TENGINE_DT_INT32) < 0 || set_tensor_buffer(bias, qdata, size * sizeof(int32_t)) < 0)
+        goto error;
+
+    free(scale);
+    free(zero_point);
+
+    *buffer = qdata;
+
+    return 0;
+
+error:
+    free(qdata);
+    free(scale);
+    free(zero_point);
+    return -1;
+}
+
+static int is_image_file(const char* name)
+{
+    const char* ext = strrchr(name, '.');
+
+    if (ext == NULL)
+        return 0;
+
+    return strcasecmp(ext, ".jpg") == 0 || strcasecmp(ext, ".jpeg") == 0 || strcasecmp(ext, ".png") == 0 ||
+           strcasecmp(ext, ".bmp") == 0;
+}
+
+static int list_images(const char* image_dir, char*** image_list, int max_num)
+{
+    DIR* dir = opendir(image_dir);
+    struct dirent* entry;
+    char** list = NULL;
+    int num = 0;
+
+    if (dir == NULL)
+    {
+        fprintf(stderr, "Open calibration image dir %s failed\n", image_dir);
+        return -1;
+    }
+
+    while ((entry = readdir(dir)) != NULL && (max_num <= 0 || num < max_num))
+    {
+        if (!is_image_file(entry->d_name))
+            continue;
+
+        char** new_list = ( char** )realloc(list, (num + 1) * sizeof(char*));
+        char* path = ( char* )malloc(strlen(image_dir) + strlen(entry->d_name) + 2);
+
+        if (new_list == NULL || path == NULL)
+        {
+            free(path);
+            list = new_list ? new_list : list;
+            break;
+        }
+
+        sprintf(path, "%s/%s", image_dir, entry->d_name);
+        list = new_list;
+        list[num++] = path;
+    }
+
+    closedir(dir);
+
+    *image_list = list;
+
+    return num;
+}
+
+static int run_calibration(graph_t graph, tensor_t input_tensor, float* input_data, char** image_list, int image_num,
+                           int img_h, int img_w, const float* mean, const float* scale, struct calib_context* ctx)
+{
+    for (int i = 0; i < image_num; i++)
+    {
+        get_input_data(image_list[i], input_data, img_h, img_w, mean, scale);
+
+        if (record_tensor(ctx, input_tensor) < 0 || run_graph(graph, 1) < 0)
+        {
+            fprintf(stderr, "Run graph failed on %s\n", image_list[i]);
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+static int quantize_graph(graph_t graph, struct calib_context* ctx, int algorithm, int data_type)
+{
+    /* activations first, the bias of a node needs the scale of its input */
+    for (int i = 0; i < ctx->stat_num; i++)
+    {
+        struct tensor_stat* stat = &ctx->stats[i];
+        float scale;
+        int zero_point;
+
+        get_act_quant_param(stat, algorithm, data_type, &scale, &zero_point);
+
+        if (set_tensor_quant_param(stat->tensor, &scale, &zero_point, 1) < 0)
+            return -1;
+    }
+
+    ctx->buffers = ( void** )calloc(ctx->node_num * 2 + 1, sizeof(void*));
+    if (ctx->buffers == NULL)
+        return -1;
+
+    for (int i = 0; i < ctx->node_num; i++)
+    {
+        node_t node = ctx->nodes[i];
+        tensor_t input = get_node_input_tensor(node, 0);
+        tensor_t weight = get_node_input_tensor(node, 1);
+        tensor_t bias = get_node_input_number(node) > 2 ? get_node_input_tensor(node, 2) : NULL;
+        float* weight_scale = NULL;
+        float input_scale;
+        int zero_point;
+        int scale_num;
+
+        if (get_tensor_data_type(weight) != TENGINE_DT_FP32)
+            continue;
+
+        if (get_tensor_quant_param(input, &input_scale, &zero_point, 1) < 0 ||
+            quant_weight(weight, data_type, &ctx->buffers[ctx->buffer_num++], &weight_scale, &scale_num) < 0 ||
+            (bias && quant_bias(bias, &ctx->buffers[ctx->buffer_num++], input_scale, weight_scale, scale_num) < 0))
+        {
+            fprintf(stderr, "Quantize node %s failed\n", get_node_name(node));
+            free(weight_scale);
+            return -1;
+        }
+
+        free(weight_scale);
+    }
+
+    for (int i = 0; i < ctx->stat_num; i++)
+    {
+        if (set_tensor_data_type(ctx->stats[i].tensor, data_type) < 0)
+            return -1;
+    }
+
+    return 0;
+}
+
+int quantize(const char* model_file, const char* image_dir, const char* output_file, int img_h, int img_w,
+             const float* mean, const float* scale, int algorithm, int data_type, int max_image, int num_thread)
+{
+    struct calib_context ctx;
+    float* input_data = NULL;
+    char** image_list = NULL;
+    int image_num = list_images(image_dir, &image_list, max_image);
+    int ret = -1;
+
+    memset(&ctx, 0, sizeof(ctx));
+
+    if (image_num <= 0)
+    {
+        fprintf(stderr, "No calibration image found in %s\n", image_dir);
+        return -1;
+    }
+
+    fprintf(stderr, "calibration images: %d\n", image_num);
+
+    graph_t graph = create_graph(NULL, "tengine", model_file);
+    if (graph == NULL)
+    {
+        fprintf(stderr, "Create graph failed.\n");
+        fprintf(stderr, "errno: %d \n", get_tengine_errno());
+        goto out;
+    }
+
+    int img_size = img_h * img_w * 3;
+    int dims[] = {1, 3, img_h, img_w};
+    tensor_t input_tensor = get_graph_input_tensor(graph, 0, 0);
+    input_data = ( float* )malloc(img_size * sizeof(float));
+    if (input_data == NULL || input_tensor == NULL || set_tensor_shape(input_tensor, dims, 4) < 0)
+    {
+        fprintf(stderr, "Set input tensor shape failed\n");
+        goto out_graph;
+    }
+
+    /* the fused graph is the one calibrated and saved */
+    if (prerun_graph_multithread(graph, TENGINE_CLUSTER_ALL, num_thread) < 0)
+    {
+        fprintf(stderr, "Prerun graph failed.\n");
+        goto out_graph;
+    }
+
+    if (set_tensor_buffer(input_tensor, input_data, img_size * sizeof(float)) < 0 ||
+        set_graph_node_observer(graph, calib_observer, &ctx) < 0)
+        goto out_postrun;
+
+    for (ctx.pass = 0; ctx.pass < (algorithm == ALGO_KL ? 2 : 1); ctx.pass++)
+    {
+        fprintf(stderr, "calibration pass %d ...\n", ctx.pass);
+
+        if (run_calibration(graph, input_tensor, input_data, image_list, image_num, img_h, img_w, mean, scale,
+                            &ctx) < 0)
+            goto out_postrun;
+    }
+
+    set_graph_node_observer(graph, NULL, NULL);
+    postrun_graph(graph);
+
+    if (quantize_graph(graph, &ctx, algorithm, data_type) < 0)
+    {
+        fprintf(stderr, "Quantize graph failed\n");
+        goto out_graph;
+    }
+
+    if (save_graph(graph, "tengine", output_file) < 0)
+    {
+        fprintf(stderr, "Save graph %s failed\n", output_file);
+        goto out_graph;
+    }
+
+    fprintf(stderr, "%d tensors and %d nodes quantized, saved to %s\n", ctx.stat_num, ctx.node_num, output_file);
+    ret = 0;
+    goto out_graph;
+
+out_postrun:
+    postrun_graph(graph);
+out_graph:
+    destroy_graph(graph);
+    free(input_data);
+out:
+    for (int i = 0; i < ctx.stat_num; i++)
+        free(ctx.stats[i].hist);
+    free(ctx.stats);
+    free(ctx.nodes);
+    for (int i = 0; i < ctx.buffer_num; i++)
+        free(ctx.buffers[i]);
+    free(ctx.buffers);
+    for (int i = 0; i < image_num; i++)
+        free(image_list[i]);
+    free(image_list);
+
+    return ret;
+}
+
+void show_usage()
+{
+    fprintf(stderr, "[Usage]:  [-h]\n    [-m model_file] [-i image_dir] [-o output_file] [-g img_h,img_w] "
+                    "[-s scale[0],scale[1],scale[2]] [-w mean[0],mean[1],mean[2]] [-a algorithm, 0:minmax, 1:kl] "
+                    "[-y type, 0:int8, 1:uint8] [-n max_image] [-t thread_count]\n");
+    fprintf(stderr, "\nmobilenet example: \n    ./tm_quantize -m mobilenet.tmfile -i /path/to/images "
+                    "-o mobilenet_int8.tmfile -g 224,224 -s 0.017,0.017,0.017 -w 104.007,116.669,122.679 -a 1\n");
+}
+
+int main(int argc, char* argv[])
+{
+    int num_thread = DEFAULT_THREAD_COUNT;
+    int algorithm = ALGO_MINMAX;
+    int data_type = TENGINE_DT_INT8;
+    int max_image = 0;
+    char* model_file = NULL;
+    char* image_dir = NULL;
+    char* output_file = NULL;
+    float img_hw[2] = {0.f};
+    int img_h = 0;
+    int img_w = 0;
+    float mean[3] = {-1.f, -1.f, -1.f};
+    float scale[3] = {0.f, 0.f, 0.f};
+
+    int res;
+    while ((res = getopt(argc, argv, "m:i:o:g:s:w:a:y:n:t:h")) != -1)
+    {
+        switch (res)
+        {
+            case 'm':
+                model_file = optarg;
+                break;
+            case 'i':
+                image_dir = optarg;
+                break;
+            case 'o':
+                output_file = optarg;
+                break;
+            case 'g':
+                split(img_hw, optarg, ",");
+                img_h = ( int )img_hw[0];
+                img_w = ( int )img_hw[1];
+                break;
+            case 's':
+                split(scale, optarg, ",");
+                break;
+            case 'w':
+                split(mean, optarg, ",");
+                break;
+            case 'a':
+                algorithm = atoi(optarg) == 1 ? ALGO_KL : ALGO_MINMAX;
+                break;
+            case 'y':
+                data_type = atoi(optarg) == 1 ? TENGINE_DT_UINT8 : TENGINE_DT_INT8;
+                break;
+            case 'n':
+                max_image = atoi(optarg);
+                break;
+            case 't':
+                num_thread = atoi(optarg);
+                break;
+            case 'h':
+                show_usage();
+                return 0;
+            default:
+                break;
+        }
+    }
+
+    if (model_file == NULL || image_dir == NULL || output_file == NULL)
+    {
+        fprintf(stderr, "Error: model file, calibration image dir and output file must be specified!\n");
+        show_usage();
+        return -1;
+    }
+
+    if (!check_file_exist(model_file))
+        return -1;
+
+    if (img_h == 0 || img_w == 0)
+    {
+        img_h = DEFAULT_IMG_H;
+        img_w = DEFAULT_IMG_W;
+        fprintf(stderr, "Image size not specified, use default %d, %d\n", img_h, img_w);
+    }
+
+    if (scale[0] == 0.f || scale[1] == 0.f || scale[2] == 0.f)
+    {
+        scale[0] = DEFAULT_SCALE1;
+        scale[1] = DEFAULT_SCALE2;
+        scale[2] = DEFAULT_SCALE3;
+        fprintf(stderr, "Scale value not specified, use default  %.3f, %.3f, %.3f\n", scale[0], scale[1], scale[2]);
+    }
+
+    if (mean[0] == -1.0 || mean[1] == -1.0 || mean[2] == -1.0)
+    {
+        mean[0] = DEFAULT_MEAN1;
+        mean[1] = DEFAULT_MEAN2;
+        mean[2] = DEFAULT_MEAN3;
+        fprintf(stderr, "Mean value not specified, use default   %.1f, %.1f, %.1f\n", mean[0], mean[1], mean[2]);
+    }
+
+    if (init_tengine() != 0)
+    {
+        fprintf(stderr, "Initial tengine failed.\n");
+        return -1;
+    }
+    fprintf(stderr, "tengine-lite library version: %s\n", get_tengine_version());
+
+    int ret = quantize(model_file, image_dir, output_file, img_h, img_w, mean, scale, algorithm, data_type, max_image,
+                       num_thread);
+
+    release_tengine();
+
+    return ret;
+}
@@ -27,6 +27,14 @@
 
 struct ir_graph;
 
+/*
+ * graph attrs which make the allocator split the graph into stages of about the same cost.
+ * PIPELINE_CPU_MASK_ATTR is a size_t[MAX_PIPELINE_STAGE], the cores of each stage
+ */
+#define PIPELINE_STAGE_NUM_ATTR "pipeline_stage_num"
+#define PIPELINE_CPU_MASK_ATTR "pipeline_cpu_mask"
+#define MAX_PIPELINE_STAGE 8
+
 struct dev_allocator
 {
     char* name;
@@ -33,8 +33,10 @@ struct exec_scheduler
 
     int (*prerun)(struct exec_scheduler*, struct ir_graph*, int num_thread, int cpu_affinity);
     int (*run)(struct exec_scheduler*, struct ir_graph*, int block);
-    int (*wait)(struct exec_scheduler*, struct ir_graph*);
+    int (*wait)(struct exec_scheduler*, struct ir_graph*, int try_wait);
+    int (*reshape)(struct exec_scheduler*, struct ir_graph*);
     int (*postrun)(struct exec_scheduler*, struct ir_graph*);
+    void (*release_graph)(struct exec_scheduler*, struct ir_graph*);
     void (*release)(struct exec_scheduler*);
 };
 
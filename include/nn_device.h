@@ -26,6 +26,7 @@
 #define __NN_DEVICE_H__
 
 struct subgraph;
+struct perf_info;
 
 struct nn_device
 {
@@ -35,10 +36,14 @@ struct nn_device
     int (*prerun)(struct nn_device* dev, struct subgraph* subgraph, int num_thread, int cpu_affinity);
     int (*run)(struct nn_device* dev, struct subgraph* subgraph);
     int (*postrun)(struct nn_device* dev, struct subgraph* subgraph);
+    /* the graph input shapes changed after prerun, the shapes are inferred again already */
+    int (*reshape)(struct nn_device* dev, struct subgraph* subgraph);
     int (*async_run)(struct nn_device* dev, struct subgraph* subgraph);
     int (*async_wait)(struct nn_device* dev, struct subgraph* subgraph, int try_wait);
     int (*release)(struct nn_device* dev);
     int (*release_exec_graph)(struct nn_device* dev, void* exec_graph);
+    int (*perf_stat)(struct nn_device* dev, struct subgraph* subgraph, int action);
+    int (*get_perf_stat)(struct nn_device* dev, struct subgraph* subgraph, struct perf_info** buf, int buf_size);
 };
 
 extern struct nn_device* get_nn_device_by_name(const char* name);
@@ -118,11 +118,18 @@ typedef void* context_t;
 typedef void* graph_t;
 typedef void* tensor_t;
 typedef void* node_t;
+typedef void* session_t;
+typedef void* batch_runner_t;
+typedef void* pipeline_t;
 
 typedef int (*event_handler_t)(graph_t, int, void* arg);
 
+typedef int (*node_observer_t)(graph_t, node_t, void* arg);
+
 typedef void (*log_print_t)(const char*);
 
+typedef void (*batch_done_t)(int status, void* arg);
+
 /* performance profiling records */
 
 struct perf_info
@@ -340,8 +347,25 @@ int request_tengine_version(const char* version);
 
 graph_t create_graph(context_t context, const char* model_format, const char* file_name, ...);
 
+/*!
+ * @brief Create another instance of a graph, to run at the same time as the graph in another thread.
+ *        The clone shares the const tensors with the graph, and on the cpu the packed kernels too,
+ *        but it has its own activation memory and execution state. It is prerun and run on its own.
+ *        Clone the graph before it is prerun, so that its packed kernels are shared as well.
+ *        Each of the graph and its clones is destroyed with destroy_graph, in any order.
+ *        It may be called from several threads, also while another thread preruns the graph.
+ *
+ * @param [in] graph: The graph handle.
+ *
+ * @return  The graph handler or NULL if failed.
+ */
+
+graph_t clone_graph(graph_t graph);
+
 /*!
  * @brief save the graph into file using the model format
+ *        only "tengine" can be saved now. A graph saved after prerun_graph is
+ *        written as it runs, with the fused nodes and the folded const data.
  *
  * @param [in] graph, the graph handle
  * @param [in] model_format, the name of the model format
@@ -797,6 +821,10 @@ int get_tensor_shape(tensor_t tensor, int dims[], int dim_number);
 /*!
  * @brief Set the shape of tensor.
  *
+ *        The input tensors of a prerun graph can be reshaped between runs, the next run_graph()
+ *        infers the shapes and plans the activation memory again, without postrun and prerun.
+ *        The input buffer has to be set again for the new size, and the output buffers moved.
+ *
  * @param [in] tensor: The tensor handle.
  * @param [in] dims: An int array to represent shape.
  * @param [in] dim_number: The array size.
@@ -960,6 +988,10 @@ int set_graph_thread_mask(graph_t graph, size_t cpu_mask);
 /*!
  * @brief The interface to set some proprietary attribute items for graph.
  *        The backend device to run the graph may use the attribute item.
+ *        The cpu device knows "cpu_pack_cache": a zero terminated file path, set before prerun,
+ *        where the packed kernels are saved and loaded from in later preruns.
+ *        And "cpu_plan_cache_size": an int, the number of input shapes whose memory plans are kept,
+ *        so that reshaping the inputs back to one of them takes no new planning, 1 by default.
  *
  * @param [in] graph: The graph handle.
  * @param [in] attr_name: The attribute name.
@@ -1024,6 +1056,7 @@ int prerun_graph(graph_t graph);
  * @param [in] block: Blocking or nonlocking.
  * @return 0: Success, -1: Fail.
  * @note  If block is 0, need to call wait_graph to get result or set GRAPH_DONE event hook.
+ *        Non block runs are executed in order by a worker thread of the graph.
  *
  */
 int run_graph(graph_t graph, int block);
@@ -1035,10 +1068,170 @@ int run_graph(graph_t graph, int block);
  * @param [in] try_wait: If set, just check status and return.
  * @return  1: Graph is done.
  *          0: Try again.
+ *         -1: The graph is not prerun yet, or a run failed.
  *
  */
 int wait_graph(graph_t graph, int try_wait);
 
+/*!
+ * @brief Create an execution session of a graph. A session has its own activation memory and
+ *        execution state, and shares the const tensors and the packed kernels with the graph and
+ *        the other sessions of it, so that several sessions of one graph run at the same time,
+ *        one call per session at a time. The session is prerun when it is created, sessions may
+ *        be created while other sessions of the graph run, but not while the graph itself runs.
+ *
+ * @param [in] graph: The graph handle, it does not need to be prerun.
+ *
+ * @return  The session handle or NULL if failed.
+ */
+session_t create_exec_session(graph_t graph);
+
+/*!
+ * @brief Run a session once, blocking.
+ *
+ * @param [in] session: The session handle.
+ * @param [in] input_data: The data of the graph input tensors, in the order of the input nodes
+ *                         and of the output tensors of each input node.
+ * @param [in] input_size: The byte size of each input, it must match the input tensor.
+ * @param [out] output_data: The buffers the graph output tensors are copied to, in the order of the
+ *                           output nodes and of their output tensors. A NULL buffer is skipped.
+ * @param [in] output_size: The byte size of each output buffer.
+ *
+ * @return 0: Success, -1: Fail.
+ * @note   To run another input shape, set it on the input tensors of get_session_graph() first.
+ */
+int run_session(session_t session, const void* input_data[], const int input_size[], void* output_data[],
+                const int output_size[]);
+
+/*!
+ * @brief Get the graph a session runs, to query or reshape its input and output tensors.
+ *        Do not postrun or destroy it.
+ *
+ * @param [in] session: The session handle.
+ *
+ * @return The graph handle.
+ */
+graph_t get_session_graph(session_t session);
+
+/*!
+ * @brief Release a session, the graph it was created from is not affected.
+ *
+ * @param [in] session: The session handle.
+ *
+ * @return 0: Success, -1: Fail.
+ */
+int release_exec_session(session_t session);
+
+/*!
+ * @brief Create a runner which batches single requests on dims[0] of the graph inputs.
+ *        The requests queued are run together once max_batch of them are queued, or once the
+ *        oldest one has waited timeout_us. The graph is prerun for one request, and is then run
+ *        only by the runner, with its memory planned again when the batch size changes. Unless set
+ *        already, the "cpu_plan_cache_size" attribute of the graph is set to 2, to keep the plans
+ *        of the full batch and of the last partial batch.
+ *
+ * @param [in] graph: The graph handle, prerun with a batch of one.
+ * @param [in] max_batch: The largest batch to run.
+ * @param [in] timeout_us: How long a request waits for the batch to fill, in microseconds.
+ *
+ * @return  The runner handle or NULL if failed.
+ */
+batch_runner_t create_batch_runner(graph_t graph, int max_batch, int timeout_us);
+
+/*!
+ * @brief Queue a request, it is done when its outputs are written and done is called.
+ *
+ * @param [in] runner: The runner handle.
+ * @param [in] input_data: The data of one request for each graph input tensor, in the order of
+ *                         the input nodes and of their output tensors. It is read when the batch runs.
+ * @param [in] input_size: The byte size of each input, one request of the input tensor.
+ * @param [out] output_data: The buffers for one request of each graph output tensor, in the order of
+ *                           the output nodes and of their output tensors. A NULL buffer is skipped.
+ * @param [in] output_size: The byte size of each output buffer.
+ * @param [in] done: Called from the worker of the runner once the request is done, with
+ *                   0 for success or -1 if the batch failed. Could be NULL.
+ * @param [in] arg: The argument of done.
+ *
+ * @return 0: Success, -1: Fail.
+ */
+int submit_batch_request(batch_runner_t runner, const void* input_data[], const int input_size[],
+                         void* output_data[], const int output_size[], batch_done_t done, void* arg);
+
+/*!
+ * @brief Get the percentiles of the queueing latency, the time from the submit of a request to
+ *        the start of its batch, over the last 1024 requests.
+ *
+ * @param [in] runner: The runner handle.
+ * @param [in] percent: The wanted percentiles, such as 50, 90, 99.
+ * @param [out] latency_us: The latency of each percentile, in microseconds.
+ * @param [in] number: The number of percentiles.
+ *
+ * @return The number of requests the percentiles are taken on, -1: Fail.
+ */
+int get_batch_runner_latency(batch_runner_t runner, const float percent[], float latency_us[], int number);
+
+/*!
+ * @brief Release a runner. The requests queued are run first.
+ *
+ * @param [in] runner: The runner handle.
+ *
+ * @return 0: Success, -1: Fail.
+ */
+int release_batch_runner(batch_runner_t runner);
+
+/*!
+ * @brief Create a pipeline which runs the graph in stages, each stage on its own cores.
+ *        The nodes are split, in order, into stages of about the same cost, so that while a frame
+ *        is in one stage the next frame can be in the stage before. The graph is cloned once for
+ *        each frame in flight, one for each stage, so the tensors between two stages are at least
+ *        double buffered. The clones share the const tensors and the packed kernels of the graph.
+ *
+ * @param [in] graph: The graph handle, its input shapes are the ones of the frames.
+ * @param [in] stage_num: The number of stages, 1 to 8. A graph with fewer nodes gets fewer stages.
+ * @param [in] cpu_mask: The cores of each stage, the stage runs one thread on each of them.
+ *                       0, or a NULL cpu_mask, runs the stage on one thread of the default cores.
+ *
+ * @return  The pipeline handle or NULL if failed.
+ */
+pipeline_t create_pipeline(graph_t graph, int stage_num, const size_t cpu_mask[]);
+
+/*!
+ * @brief Queue a frame. Frames are done in the order they are submitted.
+ *
+ * @param [in] pipeline: The pipeline handle.
+ * @param [in] input_data: The data of each graph input tensor, in the order of the input nodes
+ *                         and of their output tensors. It is read in place until the frame is done.
+ * @param [in] input_size: The byte size of each input, it must match the input tensor.
+ * @param [out] output_data: The buffers the graph output tensors are copied to, in the order of the
+ *                           output nodes and of their output tensors. A NULL buffer is skipped.
+ * @param [in] output_size: The byte size of each output buffer.
+ * @param [in] done: Called from the thread of the last stage once the frame is done, with
+ *                   0 for success or -1 if a stage failed. Could be NULL.
+ * @param [in] arg: The argument of done.
+ *
+ * @return 0: Success, -1: Fail.
+ */
+int submit_pipeline_frame(pipeline_t pipeline, const void* input_data[], const int input_size[],
+                          void* output_data[], const int output_size[], batch_done_t done, void* arg);
+
+/*!
+ * @brief Wait until the frames submitted are all done.
+ *
+ * @param [in] pipeline: The pipeline handle.
+ *
+ * @return 0: Success, -1: a frame failed since the last wait.
+ */
+int wait_pipeline(pipeline_t pipeline);
+
+/*!
+ * @brief Release a pipeline. The frames queued are run first.
+ *
+ * @param [in] pipeline: The pipeline handle.
+ *
+ * @return 0: Success, -1: Fail.
+ */
+int release_pipeline(pipeline_t pipeline);
+
 /*!
  * @brief Release the resource for graph execution.
  * @param [in] graph: graph handle.
@@ -1058,6 +1251,8 @@ int get_graph_exec_status(graph_t graph);
 
 /*!
  * @brief Set the event hook for graph execution.
+ *        START, DONE and ABORT are fired for every run, from the worker thread for
+ *        non block runs. The hook should not postrun or destroy the graph.
  *
  * @param [in] graph: The graph handle.
  * @param [in] event: The event to be hooked.
@@ -1068,6 +1263,20 @@ int get_graph_exec_status(graph_t graph);
  */
 int set_graph_event_hook(graph_t graph, int event, event_handler_t cb_func, void* cb_arg);
 
+/*!
+ * @brief Set the observer called after each node of the graph has run.
+ *        The output tensors of the node are valid only inside the callback, as their
+ *        memory may be reused by the nodes run later. A negative return aborts the run.
+ *        Input and const nodes are not reported.
+ *
+ * @param [in] graph: The graph handle.
+ * @param [in] observer: The callback function, NULL to remove it.
+ * @param [in] arg: The argument will be passed to the callback function.
+ * @return 0: Success, -1: Fail.
+ *
+ */
+int set_graph_node_observer(graph_t graph, node_observer_t observer, void* arg);
+
 /***************** Device related *****************************/
 
 /*!
@@ -1142,9 +1351,11 @@ int get_node_dump_buffer(node_t node, void** buf, int buf_size);
 
 /*!
  * @brief Start or stop the perf stats
+ *        ENABLE and START both start collecting, STOP pauses it and keeps the records,
+ *        RESET clears the counters and DISABLE drops the records
  *
  * @param [in] graph: the graph handle
- * @param [in] action: 0 stop, 1 start, 2 reset counter
+ * @param [in] action: one of GRAPH_PERF_STAT_DISABLE/ENABLE/STOP/START/RESET
  *
  * @return 0 success, -1 fail
  */
@@ -1154,7 +1365,8 @@ int do_graph_perf_stat(graph_t graph, int action);
 /*!
  * @brief get graph performance stats records
  *        If the returned number equals buf_size, there may be som records do not be
- *        retrieved yet
+ *        retrieved yet. The records are owned by the graph and valid until postrun
+ *        or perf stat is disabled
  *
  * @param [in] graph: the graph handle
  * @param [out] buf: the pointer array to struct perf_info  buffer
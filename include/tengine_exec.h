@@ -27,6 +27,7 @@
 
 #include <stdint.h>
 
+#include "tengine_c_api.h"
 #include "vector.h"
 #include "nn_device.h"
 #include "dev_allocator.h"
@@ -78,9 +79,16 @@ struct exec_attr
     uint8_t fc_mt;
     uint8_t pool_mt;
     uint8_t priv_context;
+    uint8_t perf_stat; /* GRAPH_PERF_STAT_DISABLE, _STOP or _START */
     struct exec_context* exec_context;
     void* sched_priv;
     void* allocator_priv;
+
+    event_handler_t event_hook[GRAPH_EXEC_DONE + 1];
+    void* event_arg[GRAPH_EXEC_DONE + 1];
+
+    node_observer_t node_observer;
+    void* observer_arg;
 };
 
 void init_exec_attr(struct exec_attr* attr, struct exec_context* context);
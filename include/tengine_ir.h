@@ -161,6 +161,8 @@ struct subgraph
 
     struct nn_device* nn_dev; /* the device to run the subgraph */
     void* exec_graph; /* the execution graph */
+
+    size_t cpu_mask; /* the cores to run on, one thread each. 0 follows the cluster the graph is prerun with */
 };
 
 struct ir_graph
@@ -191,12 +193,24 @@ struct ir_graph
     struct ir_attr* attr_mem;
     struct vector* subgraph_list;
     struct vector* graph_list; /* for composed graph */
+
+    struct ir_graph* origin; /* a clone uses the const tensors of its origin, NULL if not a clone */
+    int ref_count; /* the graph and the clones of it alive */
 };
 
 struct ir_graph* create_ir_graph(struct exec_context* context);
 void init_ir_graph(struct ir_graph* ir_graph, struct exec_context* context);
 void destroy_ir_graph(struct ir_graph* ir_graph);
 
+/* a new graph with the same nodes, it has its own tensors but shares the const data with the origin */
+struct ir_graph* clone_ir_graph(struct ir_graph* origin, struct exec_context* context);
+
+/* the kernels prepared from the const data can be shared with the other instances */
+static inline int is_ir_graph_shared(struct ir_graph* ir_graph)
+{
+    return ir_graph->origin != NULL || __atomic_load_n(&ir_graph->ref_count, __ATOMIC_ACQUIRE) > 1;
+}
+
 int set_ir_graph_input_node(struct ir_graph* ir_graph, int16_t input_nodes[], int input_number);
 int set_ir_graph_output_node(struct ir_graph* ir_graph, int16_t output_nodes[], int output_number);
 
@@ -226,6 +240,7 @@ static inline struct exec_attr* get_ir_graph_exec_attr(struct ir_graph* ir_graph
 }
 
 int infer_shape_graph(struct ir_graph* ir_graph);
+int fuse_ir_graph(struct ir_graph* ir_graph);
 
 void dump_ir_graph(struct ir_graph* ir_graph);
 
@@ -286,6 +301,9 @@ int set_attr_val(struct ir_attr* attr_mem, int attr_num, const char* attr_name,
 int get_attr_val(struct ir_attr* attr_mem, int attr_num, const char* attr_name, const char* type_name, void* buf,
                  int size);
 
+/* the value of the attr in place and its size, NULL if there is no such attr */
+void* get_attr_val_ptr(struct ir_attr* attr_mem, int attr_num, const char* attr_name, int* size);
+
 
 
 /* simple pack and unpack */
@@ -40,11 +40,18 @@ struct serializer
     /* unload graph, free serializer related and device releated  resource */
     int (*unload_graph)(struct serializer*, struct ir_graph*, void* s_priv, void* dev_priv);
 
+    /* save graph to file, NULL if the format cannot be written */
+    int (*save_model)(struct serializer*, struct ir_graph*, const char* fname, va_list ap);
+
     /* those interface exposed for operator extension */
     int (*register_op_loader)(struct serializer*, int op_type, int op_ver, void* op_load_func, void* op_type_map_func,
                               void* op_ver_map_func);
     int (*unregister_op_loader)(struct serializer*, int op_type, int op_ver, void* op_load_func);
 
+    /* op_type is the ir op type the save function writes */
+    int (*register_op_saver)(struct serializer*, int op_type, void* op_save_func);
+    int (*unregister_op_saver)(struct serializer*, int op_type, void* op_save_func);
+
     /* interface for regiser and unregister */
     int (*init)(struct serializer*);
     int (*release)(struct serializer*);
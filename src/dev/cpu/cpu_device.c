@@ -25,14 +25,18 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <assert.h>
+#include <limits.h>
 
 #include "sys_port.h"
 #include "tengine_errno.h"
 #include "tengine_utils.h"
+#include "tengine_c_api.h"
 #include "tengine_ir.h"
+#include "tengine_exec.h"
 #include "nn_device.h"
 #include "cpu_device.h"
 #include "cpu_node_ops.h"
+#include "cpu.h"
 #include "tengine_log.h"
 #include "tengine_op.h"
 
@@ -608,7 +612,7 @@ void extract_feature_blob_f32(const char* comment, const char* layer_name, const
 }
 #endif
 
-#define INPLACE_BLOCK_FLAG 0x40
+#define INPLACE_BLOCK_FLAG 0x4000
 static void release_mem_pool(struct mem_pool* mem_pool);
 
 struct mem_record
@@ -633,6 +637,23 @@ static int find_tensor_mem_list(struct vector* tensor_mem_list, const struct ir_
     return -1;
 }
 
+/* the graph outputs are read after the run, their memory must not be reused */
+static int is_graph_output_tensor(struct ir_graph* ir_graph, const struct ir_tensor* ir_tensor)
+{
+    for (int i = 0; i < ir_graph->output_num; i++)
+    {
+        struct ir_node* ir_node = get_ir_graph_node(ir_graph, ir_graph->output_nodes[i]);
+
+        for (int j = 0; j < ir_node->output_num; j++)
+        {
+            if (ir_node->output_tensors[j] == ir_tensor->idx)
+                return 1;
+        }
+    }
+
+    return 0;
+}
+
 static int init_exec_node(struct exec_graph* exec_graph, struct exec_node* exec_node, struct ir_node* ir_node,
                           struct node_ops* node_ops)
 {
@@ -644,11 +665,11 @@ static int init_exec_node(struct exec_graph* exec_graph, struct exec_node* exec_
     exec_node->shared_mem_size = 0;
     exec_node->output_num = ir_node->output_num;
 
-    int8_t* block_id = exec_node->block_id;
+    int16_t* block_id = exec_node->block_id;
 
     if (exec_node->output_num > 4)
     {
-        exec_node->block_id_ptr = ( int8_t* )sys_malloc(sizeof(int8_t) * exec_node->output_num);
+        exec_node->block_id_ptr = ( int16_t* )sys_malloc(sizeof(int16_t) * exec_node->output_num);
         block_id = exec_node->block_id_ptr;
     }
 
@@ -691,6 +712,15 @@ static struct exec_graph* new_exec_graph(void)
     exec_graph->shared_mem = NULL;
     exec_graph->shared_mem_size = 0;
     exec_graph->mem_pool = NULL;
+    exec_graph->perf_info = NULL;
+    exec_graph->cpu_pool = NULL;
+    exec_graph->pack_cache = NULL;
+    exec_graph->plan = NULL;
+    exec_graph->plan_num = 0;
+    exec_graph->reshape_all = 1;
+    exec_graph->input_shape = NULL;
+    exec_graph->mem_plan_list = NULL;
+    exec_graph->mem_plan_clock = 0;
 
     return exec_graph;
 }
@@ -713,6 +743,27 @@ static void free_exec_graph_mem(struct exec_graph* graph)
     }
 }
 
+static void release_mem_plan(struct mem_plan* plan)
+{
+    if (plan->mem_pool)
+        release_mem_pool(plan->mem_pool);
+
+    sys_free(plan->shared_mem);
+    sys_free(plan->block_id);
+    sys_free(plan->input_shape);
+}
+
+static void release_mem_plan_list(struct vector* mem_plan_list)
+{
+    if (mem_plan_list == NULL)
+        return;
+
+    for (int i = 0; i < get_vector_num(mem_plan_list); i++)
+        release_mem_plan(( struct mem_plan* )get_vector_data(mem_plan_list, i));
+
+    release_vector(mem_plan_list);
+}
+
 static void release_exec_graph(void* exec_graph)
 {
     struct exec_graph* graph = ( struct exec_graph* )exec_graph;
@@ -729,6 +780,19 @@ static void release_exec_graph(void* exec_graph)
 
     free_exec_graph_mem(graph);
 
+    release_mem_plan_list(graph->mem_plan_list);
+    sys_free(graph->input_shape);
+
+    if (graph->perf_info)
+        sys_free(graph->perf_info);
+
+    release_cpu_pool(graph->cpu_pool);
+
+    /* after the nodes, cached kernels may still point into the mapped file */
+    release_pack_cache(graph->pack_cache);
+
+    sys_free(graph->plan);
+
     release_vector(graph->exec_node_list);
 
     sys_free(graph);
@@ -748,10 +812,29 @@ static struct exec_graph* create_exec_graph(struct subgraph* subgraph, int num_t
         return NULL;
     }
 
+    size_t cpu_mask = get_cluster_mask(cpu_affinity);
+
+    /* a pipeline stage is bound to its own cores */
+    if (subgraph->cpu_mask)
+    {
+        cpu_mask = subgraph->cpu_mask;
+        num_thread = get_mask_count(cpu_mask);
+    }
+
     exec_graph->dev = dev;
     exec_graph->num_thread = num_thread;
     exec_graph->cpu_affinity = cpu_affinity;
 
+    /* the workers live as long as the exec graph, so layers do not pay for thread start up */
+    if (num_thread > 1)
+    {
+        exec_graph->cpu_pool = create_cpu_pool(num_thread, cpu_mask);
+        if (exec_graph->cpu_pool)
+            exec_graph->num_thread = get_cpu_pool_thread_num(exec_graph->cpu_pool);
+    }
+
+    exec_graph->pack_cache = open_pack_cache(ir_graph);
+
     for (int i = 0; i < node_num; i++)
     {
         struct ir_node* ir_node = get_ir_graph_node(ir_graph, subgraph->node_list[i]);
@@ -828,13 +911,15 @@ static void mem_pool_dump(struct mem_pool* mem_pool)
     int block_number = get_vector_num(mem_pool->block_list);
 
     TLOG_INFO("block number: %d align size: %d\n", block_number, mem_pool->align_size);
+    TLOG_INFO("arena: %p size: %d peak: %d total: %d\n", mem_pool->arena, mem_pool->arena_size, mem_pool->peak_size,
+              mem_pool->total_size);
 
     for (int i = 0; i < block_number; i++)
     {
         struct mem_block_entry* entry = ( struct mem_block_entry* )get_vector_data(mem_pool->block_list, i);
 
-        TLOG_INFO("%d: %p (%d) used: %d free: %d\n", i, entry->addr, entry->block_size, entry->alloc_count,
-                  entry->free_count);
+        TLOG_DEBUG("%d: offset %d (%d) live: [%d, %d]\n", i, entry->offset, entry->size, entry->alloc_time,
+                   entry->free_time);
     }
 }
 
@@ -842,61 +927,155 @@ static void* mem_pool_get_mem_block(struct mem_pool* mem_pool, int block_id)
 {
     struct mem_block_entry* entry = ( struct mem_block_entry* )get_vector_data(mem_pool->block_list, block_id);
 
-    unsigned long addr = ( long )(entry->addr);
-    unsigned long aligned_addr = (addr + 4 + mem_pool->align_size) & (~(mem_pool->align_size - 1));
+    unsigned long addr = ( long )(mem_pool->arena);
+    unsigned long aligned_addr = (addr + mem_pool->align_size - 1) & (~(mem_pool->align_size - 1));
 
-    return ( void* )aligned_addr;
+    return ( void* )(aligned_addr + entry->offset);
 }
 
-static int mem_pool_get_backend_mem(struct mem_pool* mem_pool)
+static inline int block_live_overlap(const struct mem_block_entry* a, const struct mem_block_entry* b)
+{
+    return a->alloc_time <= b->free_time && b->alloc_time <= a->free_time;
+}
+
+static int block_size_cmp(const void* a, const void* b)
+{
+    const struct mem_block_entry* ea = *( const struct mem_block_entry** )a;
+    const struct mem_block_entry* eb = *( const struct mem_block_entry** )b;
+
+    if (ea->size != eb->size)
+        return ea->size > eb->size ? -1 : 1;
+
+    return ea->alloc_time - eb->alloc_time;
+}
+
+static int block_offset_cmp(const void* a, const void* b)
+{
+    const struct mem_block_entry* ea = *( const struct mem_block_entry** )a;
+    const struct mem_block_entry* eb = *( const struct mem_block_entry** )b;
+
+    return ea->offset - eb->offset;
+}
+
+/*
+ * greedy by size: the blocks are placed from the biggest one, each into the smallest gap
+ * between the already placed blocks whose live range overlaps with it, or on top of them.
+ */
+static int plan_mem_pool(struct mem_pool* mem_pool)
 {
     int block_num = get_vector_num(mem_pool->block_list);
 
+    mem_pool->arena_size = 0;
+    mem_pool->peak_size = 0;
+    mem_pool->total_size = 0;
+
+    if (block_num == 0)
+        return 0;
+
+    struct mem_block_entry** order = ( struct mem_block_entry** )sys_malloc(sizeof(void*) * block_num * 2);
+
+    if (order == NULL)
+        return -1;
+
+    struct mem_block_entry** conflict = order + block_num;
+
+    for (int i = 0; i < block_num; i++)
+        order[i] = ( struct mem_block_entry* )get_vector_data(mem_pool->block_list, i);
+
+    qsort(order, block_num, sizeof(void*), block_size_cmp);
+
     for (int i = 0; i < block_num; i++)
     {
-        struct mem_block_entry* entry = ( struct mem_block_entry* )get_vector_data(mem_pool->block_list, i);
+        struct mem_block_entry* entry = order[i];
+        int conflict_num = 0;
 
-        entry->block_size = entry->max_req_size + mem_pool->align_size + 4;
+        for (int j = 0; j < i; j++)
+        {
+            if (block_live_overlap(entry, order[j]))
+                conflict[conflict_num++] = order[j];
+        }
 
-        entry->addr = sys_malloc(entry->block_size);
+        qsort(conflict, conflict_num, sizeof(void*), block_offset_cmp);
 
-        if (entry->addr == NULL)
-            return -1;
+        int best_offset = -1;
+        int best_gap = 0;
+        int prev_end = 0;
+
+        for (int j = 0; j < conflict_num; j++)
+        {
+            int gap = conflict[j]->offset - prev_end;
+
+            if (gap >= entry->size && (best_offset < 0 || gap < best_gap))
+            {
+                best_offset = prev_end;
+                best_gap = gap;
+            }
+
+            if (conflict[j]->offset + conflict[j]->size > prev_end)
+                prev_end = conflict[j]->offset + conflict[j]->size;
+        }
+
+        entry->offset = best_offset < 0 ? prev_end : best_offset;
+
+        if (entry->offset + entry->size > mem_pool->arena_size)
+            mem_pool->arena_size = entry->offset + entry->size;
+    }
+
+    /* the peak is reached when some block gets allocated */
+    for (int i = 0; i < block_num; i++)
+    {
+        int live_size = 0;
+
+        for (int j = 0; j < block_num; j++)
+        {
+            if (order[j]->alloc_time <= order[i]->alloc_time && order[i]->alloc_time <= order[j]->free_time)
+                live_size += order[j]->size;
+        }
+
+        if (live_size > mem_pool->peak_size)
+            mem_pool->peak_size = live_size;
+
+        mem_pool->total_size += order[i]->size;
     }
 
+    sys_free(order);
+
     return 0;
 }
 
-static int mem_pool_allocate(struct mem_pool* mem_pool, int size)
+static int mem_pool_get_backend_mem(struct mem_pool* mem_pool)
 {
-    int block_num = get_vector_num(mem_pool->block_list);
-    ;
+    if (plan_mem_pool(mem_pool) < 0)
+        return -1;
 
-    for (int i = 0; i < block_num; i++)
-    {
-        struct mem_block_entry* entry = ( struct mem_block_entry* )get_vector_data(mem_pool->block_list, i);
+    if (mem_pool->arena_size == 0)
+        return 0;
 
-        if (entry->free_count != entry->alloc_count)
-            continue;
+    mem_pool->arena = sys_malloc(mem_pool->arena_size + mem_pool->align_size);
 
-        /* TODO: use the best match alg */
+    if (mem_pool->arena == NULL)
+        return -1;
 
-        entry->alloc_count++;
+    return 0;
+}
 
-        if (entry->max_req_size < size)
-            entry->max_req_size = size;
+static int mem_pool_allocate(struct mem_pool* mem_pool, int size)
+{
+    int block_num = get_vector_num(mem_pool->block_list);
 
-        return i;
+    if (block_num >= INPLACE_BLOCK_FLAG)
+    {
+        TLOG_ERR("too many memory blocks: %d\n", block_num);
+        return -1;
     }
 
-    /* create new block */
-
+    /* the block lives until it is freed, graph outputs are never freed */
     struct mem_block_entry e;
 
-    e.addr = NULL;
-    e.max_req_size = size;
-    e.alloc_count = 1;
-    e.free_count = 0;
+    e.size = (size + mem_pool->align_size - 1) & (~(mem_pool->align_size - 1));
+    e.offset = 0;
+    e.alloc_time = mem_pool->clock++;
+    e.free_time = INT_MAX;
 
     push_vector_data(mem_pool->block_list, &e);
 
@@ -907,24 +1086,16 @@ static void mem_pool_free(struct mem_pool* mem_pool, int block_id)
 {
     struct mem_block_entry* block = ( struct mem_block_entry* )get_vector_data(mem_pool->block_list, block_id);
 
-    block->free_count++;
+    block->free_time = mem_pool->clock++;
 }
 
 static void release_mem_pool(struct mem_pool* mem_pool)
 {
     if (mem_pool->block_list != NULL)
-    {
-        int block_num = get_vector_num(mem_pool->block_list);
-
-        for (int i = 0; i < block_num; i++)
-        {
-            struct mem_block_entry* entry = ( struct mem_block_entry* )get_vector_data(mem_pool->block_list, i);
-
-            sys_free(entry->addr);
-        }
-
         release_vector(mem_pool->block_list);
-    }
+
+    if (mem_pool->arena != NULL)
+        sys_free(mem_pool->arena);
 
     sys_free(mem_pool);
 }
@@ -937,6 +1108,11 @@ static struct mem_pool* create_mem_pool(void)
         return NULL;
 
     mem_pool->align_size = 16;
+    mem_pool->arena = NULL;
+    mem_pool->arena_size = 0;
+    mem_pool->peak_size = 0;
+    mem_pool->total_size = 0;
+    mem_pool->clock = 0;
     mem_pool->block_list = create_vector(sizeof(struct mem_block_entry), NULL);
 
     if (mem_pool->block_list == NULL)
@@ -957,6 +1133,51 @@ error:
     return NULL;
 }
 
+/* point the output tensors to their blocks in the pool, or to the input they are inplace with */
+static void bind_exec_graph_mem(struct exec_graph* exec_graph)
+{
+    int node_num = get_vector_num(exec_graph->exec_node_list);
+    struct mem_pool* mem_pool = exec_graph->mem_pool;
+
+    for (int i = 0; i < node_num; i++)
+    {
+        struct exec_node* exec_node = ( struct exec_node* )get_vector_data(exec_graph->exec_node_list, i);
+        struct ir_node* ir_node = exec_node->ir_node;
+        struct ir_graph* ir_graph = ir_node->graph;
+
+        int16_t* block_id;
+
+        if (exec_node->output_num > 4)
+            block_id = exec_node->block_id_ptr;
+        else
+            block_id = exec_node->block_id;
+
+        for (int j = 0; j < ir_node->output_num; j++)
+        {
+            struct ir_tensor* ir_tensor = get_ir_graph_tensor(ir_graph, ir_node->output_tensors[j]);
+
+            if (block_id[j] < 0)
+                continue;
+
+            if (block_id[j] & INPLACE_BLOCK_FLAG)
+            {
+                int input_idx = block_id[j] & (INPLACE_BLOCK_FLAG - 1);
+
+                struct ir_tensor* input_tensor = get_ir_graph_tensor(ir_graph, ir_node->input_tensors[input_idx]);
+                ir_tensor->data = input_tensor->data;
+                ir_tensor->free_host_mem = 0;
+                ir_tensor->internal_allocated = MEM_POOL_ALLOCATED;
+            }
+            else
+            {
+                ir_tensor->data = mem_pool->get_mem_block(mem_pool, block_id[j]);
+                ir_tensor->free_host_mem = 0;
+                ir_tensor->internal_allocated = MEM_POOL_ALLOCATED;
+            }
+        }
+    }
+}
+
 static int alloc_exec_graph_mem(struct exec_graph* exec_graph)
 {
     struct mem_pool* mem_pool;
@@ -982,7 +1203,7 @@ static int alloc_exec_graph_mem(struct exec_graph* exec_graph)
         struct ir_node* ir_node = exec_node->ir_node;
         struct ir_graph* ir_graph = ir_node->graph;
 
-        int8_t* block_id;
+        int16_t* block_id;
 
         if (exec_node->output_num > 4)
             block_id = exec_node->block_id_ptr;
@@ -1025,6 +1246,12 @@ static int alloc_exec_graph_mem(struct exec_graph* exec_graph)
             r.block_id = mem_pool->allocate(mem_pool, mem_size);
             r.used = ir_tensor->consumer_num;
 
+            if (r.block_id < 0)
+            {
+                release_vector(tensor_mem_list);
+                return -1;
+            }
+
             block_id[j] = r.block_id;
 
             push_vector_data(tensor_mem_list, &r);
@@ -1047,7 +1274,7 @@ static int alloc_exec_graph_mem(struct exec_graph* exec_graph)
 
             input_r->used--;
 
-            if (input_r->used == 0)
+            if (input_r->used == 0 && !is_graph_output_tensor(ir_graph, input_r->ir_tensor))
             {
                 mem_pool->free(mem_pool, input_r->block_id);
                 remove_vector_by_idx(tensor_mem_list, idx);
@@ -1086,68 +1313,177 @@ static int alloc_exec_graph_mem(struct exec_graph* exec_graph)
 
     mem_pool->dump(mem_pool);
 
-    /* now, the real allocate */
+    bind_exec_graph_mem(exec_graph);
+
+    return 0;
+}
+
+static int prerun_exec_graph(struct exec_graph* exec_graph)
+{
+    int node_num = get_vector_num(exec_graph->exec_node_list);
+
+    for (int i = 0; i < node_num; i++)
+    {
+        struct exec_node* exec_node = ( struct exec_node* )get_vector_data(exec_graph->exec_node_list, i);
+        struct node_ops* node_ops = exec_node->node_ops;
+
+        if (node_ops->prerun && node_ops->prerun(node_ops, exec_node, exec_graph) < 0)
+        {
+            TLOG_ERR("%s: failed to prerun node %d\n", exec_graph->dev->base.name, exec_node->ir_node->idx);
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+static int build_exec_plan(struct exec_graph* exec_graph)
+{
+    int node_num = get_vector_num(exec_graph->exec_node_list);
+    int input_num = 0;
+
+    for (int i = 0; i < node_num; i++)
+    {
+        struct exec_node* exec_node = ( struct exec_node* )get_vector_data(exec_graph->exec_node_list, i);
+        input_num += exec_node->ir_node->input_num;
+    }
+
+    /* the entries and the input tensor pointers share one block */
+    int size = sizeof(struct exec_plan_entry) * node_num + sizeof(struct ir_tensor*) * input_num;
+    struct exec_plan_entry* plan = ( struct exec_plan_entry* )sys_malloc(size > 0 ? size : 1);
+
+    if (plan == NULL)
+    {
+        set_tengine_errno(ENOMEM);
+        return -1;
+    }
+
+    struct ir_tensor** input_tensors = ( struct ir_tensor** )(plan + node_num);
+
     for (int i = 0; i < node_num; i++)
     {
         struct exec_node* exec_node = ( struct exec_node* )get_vector_data(exec_graph->exec_node_list, i);
         struct ir_node* ir_node = exec_node->ir_node;
-        struct ir_graph* ir_graph = ir_node->graph;
-        struct mem_pool* mem_pool = exec_graph->mem_pool;
+        struct exec_plan_entry* entry = &plan[i];
 
-        int8_t* block_id;
+        entry->run = exec_node->node_ops->run;
+        entry->reshape = exec_node->node_ops->reshape;
+        entry->node_ops = exec_node->node_ops;
+        entry->exec_node = exec_node;
+        entry->input_tensors = input_tensors;
+        entry->input_num = ir_node->input_num;
 
-        if (exec_node->output_num > 4)
-            block_id = exec_node->block_id_ptr;
-        else
-            block_id = exec_node->block_id;
+        for (int j = 0; j < ir_node->input_num; j++)
+            input_tensors[j] = get_ir_graph_tensor(ir_node->graph, ir_node->input_tensors[j]);
 
-        for (int j = 0; j < ir_node->output_num; j++)
-        {
-            struct ir_tensor* ir_tensor = get_ir_graph_tensor(ir_graph, ir_node->output_tensors[j]);
+        input_tensors += ir_node->input_num;
+    }
 
-            if (block_id[j] < 0)
-                continue;
+    exec_graph->plan = plan;
+    exec_graph->plan_num = node_num;
+    exec_graph->reshape_all = 1;
 
-            if (block_id[j] & INPLACE_BLOCK_FLAG)
-            {
-                int input_idx = block_id[j] & (INPLACE_BLOCK_FLAG - 1);
+    return 0;
+}
 
-                struct ir_tensor* input_tensor = get_ir_graph_tensor(ir_graph, ir_node->input_tensors[input_idx]);
-                ir_tensor->data = input_tensor->data;
-                ir_tensor->free_host_mem = 0;
-                ir_tensor->internal_allocated = MEM_POOL_ALLOCATED;
-            }
-            else
-            {
-                ir_tensor->data = mem_pool->get_mem_block(mem_pool, block_id[j]);
-                ir_tensor->free_host_mem = 0;
-                ir_tensor->internal_allocated = MEM_POOL_ALLOCATED;
-            }
+/* the reshaped flag of a tensor counts down its consumers, each consumer takes one */
+static inline int take_input_reshaped(const struct exec_plan_entry* entry)
+{
+    int reshaped = 0;
+
+    for (int i = 0; i < entry->input_num; i++)
+    {
+        struct ir_tensor* ir_tensor = entry->input_tensors[i];
+
+        if (ir_tensor->reshaped)
+        {
+            ir_tensor->reshaped--;
+            reshaped = 1;
         }
     }
 
-    return 0;
+    return reshaped;
 }
 
-static int prerun_exec_graph(struct exec_graph* exec_graph)
+static void reset_perf_info(struct exec_graph* exec_graph)
+{
+    int node_num = get_vector_num(exec_graph->exec_node_list);
+
+    for (int i = 0; i < node_num; i++)
+    {
+        struct perf_info* perf_info = &exec_graph->perf_info[i];
+
+        perf_info->count = 0;
+        perf_info->min = 0;
+        perf_info->max = 0;
+        perf_info->total_time = 0;
+    }
+}
+
+static int alloc_perf_info(struct exec_graph* exec_graph)
 {
     int node_num = get_vector_num(exec_graph->exec_node_list);
 
+    if (exec_graph->perf_info || node_num == 0)
+        return 0;
+
+    exec_graph->perf_info = ( struct perf_info* )sys_malloc(sizeof(struct perf_info) * node_num);
+
+    if (exec_graph->perf_info == NULL)
+    {
+        set_tengine_errno(ENOMEM);
+        return -1;
+    }
+
     for (int i = 0; i < node_num; i++)
     {
         struct exec_node* exec_node = ( struct exec_node* )get_vector_data(exec_graph->exec_node_list, i);
-        struct node_ops* node_ops = exec_node->node_ops;
+        struct perf_info* perf_info = &exec_graph->perf_info[i];
 
-        if (node_ops->prerun && node_ops->prerun(node_ops, exec_node, exec_graph) < 0)
-        {
-            TLOG_ERR("%s: failed to prerun node %d\n", exec_graph->dev->base.name, exec_node->ir_node->idx);
-            return -1;
-        }
+        perf_info->name = exec_node->ir_node->name;
+        perf_info->dev_name = exec_graph->dev->base.name;
+        perf_info->base = 1000; /* time is counted in us */
     }
 
+    reset_perf_info(exec_graph);
+
     return 0;
 }
 
+/* the dim number and dims of each subgraph input, after the total length of the key */
+static int* get_input_shape(struct subgraph* subgraph)
+{
+    struct ir_graph* ir_graph = subgraph->graph;
+    int size = 1;
+
+    for (int i = 0; i < subgraph->input_num; i++)
+        size += 1 + get_ir_graph_tensor(ir_graph, subgraph->input_tensor_list[i])->dim_num;
+
+    int* input_shape = ( int* )sys_malloc(sizeof(int) * size);
+
+    if (input_shape == NULL)
+    {
+        set_tengine_errno(ENOMEM);
+        return NULL;
+    }
+
+    int* p = input_shape;
+
+    *p++ = size;
+
+    for (int i = 0; i < subgraph->input_num; i++)
+    {
+        struct ir_tensor* ir_tensor = get_ir_graph_tensor(ir_graph, subgraph->input_tensor_list[i]);
+
+        *p++ = ir_tensor->dim_num;
+
+        for (int j = 0; j < ir_tensor->dim_num; j++)
+            *p++ = ir_tensor->dims[j];
+    }
+
+    return input_shape;
+}
+
 static int prerun(struct nn_device* dev, struct subgraph* subgraph, int num_thread, int cpu_affinity)
 {
     struct exec_graph* exec_graph;
@@ -1158,7 +1494,22 @@ static int prerun(struct nn_device* dev, struct subgraph* subgraph, int num_thre
     if (exec_graph == NULL)
         return -1;
 
-    if (alloc_exec_graph_mem(exec_graph) < 0 || prerun_exec_graph(exec_graph) < 0)
+    exec_graph->input_shape = get_input_shape(subgraph);
+
+    if (exec_graph->input_shape == NULL || alloc_exec_graph_mem(exec_graph) < 0 || prerun_exec_graph(exec_graph) < 0 ||
+        build_exec_plan(exec_graph) < 0)
+    {
+        release_exec_graph(exec_graph);
+        return -1;
+    }
+
+    /* save what the nodes packed in this prerun, a failure only costs the next start */
+    if (exec_graph->pack_cache)
+        flush_pack_cache(exec_graph->pack_cache);
+
+    /* perf stat may be switched on before prerun */
+    if (get_ir_graph_exec_attr(subgraph->graph)->perf_stat != GRAPH_PERF_STAT_DISABLE &&
+        alloc_perf_info(exec_graph) < 0)
     {
         release_exec_graph(exec_graph);
         return -1;
@@ -1179,19 +1530,51 @@ static double get_cur_time(void)
 }
 #endif
 
+static inline uint64_t get_perf_time(void)
+{
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+
+    return ( uint64_t )tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
+static inline void update_perf_info(struct perf_info* perf_info, uint64_t start)
+{
+    uint32_t used = ( uint32_t )(get_perf_time() - start);
+
+    if (perf_info->count == 0 || used < perf_info->min)
+        perf_info->min = used;
+
+    if (used > perf_info->max)
+        perf_info->max = used;
+
+    perf_info->total_time += used;
+    perf_info->count++;
+}
+
 static int run(struct nn_device* dev, struct subgraph* subgraph)
 {
     struct exec_graph* exec_graph = subgraph->exec_graph;
+    struct exec_plan_entry* plan = exec_graph->plan;
+    struct exec_attr* exec_attr = get_ir_graph_exec_attr(subgraph->graph);
+    struct perf_info* perf_info = NULL;
 
-    int node_num = get_vector_num(exec_graph->exec_node_list);
+    int node_num = exec_graph->plan_num;
+    int reshape_all = exec_graph->reshape_all;
+
+    if (exec_attr->perf_stat == GRAPH_PERF_STAT_START)
+        perf_info = exec_graph->perf_info;
 
     for (int i = 0; i < node_num; i++)
     {
-        struct exec_node* node = ( struct exec_node* )get_vector_data(exec_graph->exec_node_list, i);
-        struct node_ops* node_ops = node->node_ops;
+        struct exec_plan_entry* entry = &plan[i];
+        struct exec_node* node = entry->exec_node;
+
+        int reshaped = take_input_reshaped(entry);
 
-        /* TODO: handle the shape changed  and dynamic shape case */
-        if (node_ops->reshape && node_ops->reshape(node_ops, node, exec_graph) < 0)
+        /* TODO: handle the dynamic shape case, the graph input shapes are handled by reshape() */
+        if (entry->reshape && (reshaped || reshape_all) && entry->reshape(entry->node_ops, node, exec_graph) < 0)
         {
             TLOG_ERR("%s: failed to run node %d, %s\n", dev->name, node->ir_node->idx, node->ir_node->name);
             return -1;
@@ -1201,11 +1584,25 @@ static int run(struct nn_device* dev, struct subgraph* subgraph)
 #ifdef DEBUG_TIME
         double start = get_cur_time();
 #endif
-        if (node_ops->run(node_ops, node, exec_graph) < 0)
+        uint64_t perf_start = perf_info ? get_perf_time() : 0;
+
+        if (entry->run(entry->node_ops, node, exec_graph) < 0)
         {
             TLOG_ERR("%s: failed to run node %d, %s\n", dev->name, node->ir_node->idx, node->ir_node->name);
             return -1;
         }
+
+        if (perf_info)
+            update_perf_info(&perf_info[i], perf_start);
+
+        /* the outputs are only valid here, before the memory is reused by the nodes after */
+        if (exec_attr->node_observer &&
+            exec_attr->node_observer(subgraph->graph, node->ir_node, exec_attr->observer_arg) < 0)
+        {
+            TLOG_ERR("%s: node %d, %s aborted by the observer\n", dev->name, node->ir_node->idx, node->ir_node->name);
+            return -1;
+        }
+
         char* name = node->ir_node->name;
 #ifdef DEBUG_TIME
         double end = get_cur_time();
@@ -1241,6 +1638,8 @@ static int run(struct nn_device* dev, struct subgraph* subgraph)
 #endif
     }
 
+    exec_graph->reshape_all = 0;
+
     return 0;
 }
 
@@ -1268,20 +1667,298 @@ static int postrun(struct nn_device* dev, struct subgraph* subgraph)
     return 0;
 }
 
+/* the number of memory plans kept for different input shapes, the current one included */
+static int get_mem_plan_cache_size(struct ir_graph* ir_graph)
+{
+    int cache_size;
+
+    if (get_attr_val(ir_graph->attr_mem, ir_graph->attr_num, "cpu_plan_cache_size", NULL, &cache_size, sizeof(int)) < 0)
+        return 1;
+
+    return cache_size;
+}
+
+static int16_t* get_exec_node_block_id(struct exec_node* exec_node)
+{
+    if (exec_node->output_num > 4)
+        return exec_node->block_id_ptr;
+
+    return exec_node->block_id;
+}
+
+/* drop the pointers into the activation memory, the tensors get their blocks from the next plan */
+static void unbind_exec_graph_mem(struct exec_graph* exec_graph, int16_t* saved_block_id)
+{
+    int node_num = get_vector_num(exec_graph->exec_node_list);
+
+    for (int i = 0; i < node_num; i++)
+    {
+        struct exec_node* exec_node = ( struct exec_node* )get_vector_data(exec_graph->exec_node_list, i);
+        struct ir_node* ir_node = exec_node->ir_node;
+        int16_t* block_id = get_exec_node_block_id(exec_node);
+
+        for (int j = 0; j < ir_node->output_num; j++)
+        {
+            struct ir_tensor* ir_tensor = get_ir_graph_tensor(ir_node->graph, ir_node->output_tensors[j]);
+
+            if (ir_tensor->internal_allocated == MEM_POOL_ALLOCATED)
+            {
+                ir_tensor->data = NULL;
+                ir_tensor->internal_allocated = 0;
+            }
+
+            if (saved_block_id)
+                *saved_block_id++ = block_id[j];
+
+            block_id[j] = -1;
+        }
+    }
+}
+
+/* move the current memory into a plan of the cache, keyed by the input shape it was planned for */
+static int save_mem_plan(struct exec_graph* exec_graph)
+{
+    struct mem_plan plan;
+    int output_num = 0;
+    int node_num = get_vector_num(exec_graph->exec_node_list);
+
+    for (int i = 0; i < node_num; i++)
+        output_num += (( struct exec_node* )get_vector_data(exec_graph->exec_node_list, i))->output_num;
+
+    if (exec_graph->mem_plan_list == NULL)
+        exec_graph->mem_plan_list = create_vector(sizeof(struct mem_plan), NULL);
+
+    plan.block_id = ( int16_t* )sys_malloc(sizeof(int16_t) * (output_num > 0 ? output_num : 1));
+
+    if (exec_graph->mem_plan_list == NULL || plan.block_id == NULL)
+    {
+        sys_free(plan.block_id);
+        set_tengine_errno(ENOMEM);
+        return -1;
+    }
+
+    unbind_exec_graph_mem(exec_graph, plan.block_id);
+
+    plan.input_shape = exec_graph->input_shape;
+    plan.mem_pool = exec_graph->mem_pool;
+    plan.shared_mem = exec_graph->shared_mem;
+    plan.shared_mem_size = exec_graph->shared_mem_size;
+    plan.last_used = exec_graph->mem_plan_clock++;
+
+    push_vector_data(exec_graph->mem_plan_list, &plan);
+
+    exec_graph->input_shape = NULL;
+    exec_graph->mem_pool = NULL;
+    exec_graph->shared_mem = NULL;
+    exec_graph->shared_mem_size = 0;
+
+    return 0;
+}
+
+static int find_mem_plan(struct exec_graph* exec_graph, const int* input_shape)
+{
+    if (exec_graph->mem_plan_list == NULL)
+        return -1;
+
+    for (int i = 0; i < get_vector_num(exec_graph->mem_plan_list); i++)
+    {
+        struct mem_plan* plan = ( struct mem_plan* )get_vector_data(exec_graph->mem_plan_list, i);
+
+        if (plan->input_shape[0] == input_shape[0] &&
+            !memcmp(plan->input_shape, input_shape, sizeof(int) * input_shape[0]))
+            return i;
+    }
+
+    return -1;
+}
+
+/* take a plan out of the cache as the current memory */
+static void restore_mem_plan(struct exec_graph* exec_graph, int idx)
+{
+    struct mem_plan* plan = ( struct mem_plan* )get_vector_data(exec_graph->mem_plan_list, idx);
+    int16_t* saved_block_id = plan->block_id;
+    int node_num = get_vector_num(exec_graph->exec_node_list);
+
+    for (int i = 0; i < node_num; i++)
+    {
+        struct exec_node* exec_node = ( struct exec_node* )get_vector_data(exec_graph->exec_node_list, i);
+        int16_t* block_id = get_exec_node_block_id(exec_node);
+
+        for (int j = 0; j < exec_node->output_num; j++)
+            block_id[j] = *saved_block_id++;
+    }
+
+    exec_graph->mem_pool = plan->mem_pool;
+    exec_graph->shared_mem = plan->shared_mem;
+    exec_graph->shared_mem_size = plan->shared_mem_size;
+
+    sys_free(plan->block_id);
+    sys_free(plan->input_shape);
+    remove_vector_by_idx(exec_graph->mem_plan_list, idx);
+
+    bind_exec_graph_mem(exec_graph);
+}
+
+/* drop the least recently used plans, the current memory takes one of the places */
+static void evict_mem_plan(struct exec_graph* exec_graph, int cache_size)
+{
+    if (exec_graph->mem_plan_list == NULL)
+        return;
+
+    while (get_vector_num(exec_graph->mem_plan_list) > 0 && get_vector_num(exec_graph->mem_plan_list) >= cache_size)
+    {
+        int lru = 0;
+
+        for (int i = 1; i < get_vector_num(exec_graph->mem_plan_list); i++)
+        {
+            struct mem_plan* plan = ( struct mem_plan* )get_vector_data(exec_graph->mem_plan_list, i);
+            struct mem_plan* lru_plan = ( struct mem_plan* )get_vector_data(exec_graph->mem_plan_list, lru);
+
+            if (plan->last_used < lru_plan->last_used)
+                lru = i;
+        }
+
+        release_mem_plan(( struct mem_plan* )get_vector_data(exec_graph->mem_plan_list, lru));
+        remove_vector_by_idx(exec_graph->mem_plan_list, lru);
+    }
+}
+
+/*
+ * the graph inputs were reshaped after prerun: the nodes follow the new shapes with their
+ * reshape(), or with postrun() and prerun() if they have none, and the memory is planned again.
+ * with "cpu_plan_cache_size" above 1, the memory of the shapes seen before is kept, and taken
+ * back without planning when the inputs switch to one of them again.
+ */
+static int reshape(struct nn_device* dev, struct subgraph* subgraph)
+{
+    struct exec_graph* exec_graph = subgraph->exec_graph;
+
+    int node_num = get_vector_num(exec_graph->exec_node_list);
+    int cache_size = get_mem_plan_cache_size(subgraph->graph);
+
+    for (int i = 0; i < node_num; i++)
+    {
+        struct exec_node* node = ( struct exec_node* )get_vector_data(exec_graph->exec_node_list, i);
+        struct node_ops* node_ops = node->node_ops;
+
+        if (node_ops->reshape)
+        {
+            if (node_ops->reshape(node_ops, node, exec_graph) < 0)
+            {
+                TLOG_ERR("%s: failed to reshape node %d, %s\n", dev->name, node->ir_node->idx, node->ir_node->name);
+                return -1;
+            }
+        }
+        else if (node_ops->postrun)
+        {
+            node_ops->postrun(node_ops, node, exec_graph);
+        }
+    }
+
+    int* input_shape = get_input_shape(subgraph);
+
+    if (input_shape == NULL)
+        return -1;
+
+    if (cache_size <= 1 || exec_graph->input_shape == NULL || save_mem_plan(exec_graph) < 0)
+    {
+        unbind_exec_graph_mem(exec_graph, NULL);
+        free_exec_graph_mem(exec_graph);
+        release_mem_plan_list(exec_graph->mem_plan_list);
+        exec_graph->mem_plan_list = NULL;
+    }
+
+    sys_free(exec_graph->input_shape);
+    exec_graph->input_shape = input_shape;
+
+    int idx = find_mem_plan(exec_graph, input_shape);
+
+    if (idx >= 0)
+        restore_mem_plan(exec_graph, idx);
+    else if (alloc_exec_graph_mem(exec_graph) < 0)
+        return -1;
+
+    evict_mem_plan(exec_graph, cache_size);
+
+    for (int i = 0; i < node_num; i++)
+    {
+        struct exec_node* node = ( struct exec_node* )get_vector_data(exec_graph->exec_node_list, i);
+        struct node_ops* node_ops = node->node_ops;
+
+        if (node_ops->reshape == NULL && node_ops->prerun && node_ops->prerun(node_ops, node, exec_graph) < 0)
+        {
+            TLOG_ERR("%s: failed to prerun node %d, %s\n", dev->name, node->ir_node->idx, node->ir_node->name);
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
 static int cpu_dev_release_exec_graph(struct nn_device* dev, void* exec_graph)
 {
     release_exec_graph(exec_graph);
     return 0;
 }
 
+static int perf_stat(struct nn_device* dev, struct subgraph* subgraph, int action)
+{
+    struct exec_graph* exec_graph = subgraph->exec_graph;
+
+    /* not prerun yet, the records will be created by prerun */
+    if (exec_graph == NULL)
+        return 0;
+
+    switch (action)
+    {
+        case GRAPH_PERF_STAT_ENABLE:
+        case GRAPH_PERF_STAT_START:
+            return alloc_perf_info(exec_graph);
+        case GRAPH_PERF_STAT_DISABLE:
+            if (exec_graph->perf_info)
+                sys_free(exec_graph->perf_info);
+            exec_graph->perf_info = NULL;
+            break;
+        case GRAPH_PERF_STAT_RESET:
+            if (exec_graph->perf_info)
+                reset_perf_info(exec_graph);
+            break;
+        default:
+            break;
+    }
+
+    return 0;
+}
+
+static int get_perf_stat(struct nn_device* dev, struct subgraph* subgraph, struct perf_info** buf, int buf_size)
+{
+    struct exec_graph* exec_graph = subgraph->exec_graph;
+
+    if (exec_graph == NULL || exec_graph->perf_info == NULL)
+        return 0;
+
+    int node_num = get_vector_num(exec_graph->exec_node_list);
+
+    if (node_num > buf_size)
+        node_num = buf_size;
+
+    for (int i = 0; i < node_num; i++)
+        buf[i] = &exec_graph->perf_info[i];
+
+    return node_num;
+}
+
 static struct cpu_device cpu_dev = {
     .base = {.name = "cpu_dev",
              .prerun = prerun,
              .run = run,
              .postrun = postrun,
+             .reshape = reshape,
              .async_run = NULL,
              .async_wait = NULL,
              .release_exec_graph = cpu_dev_release_exec_graph,
+             .perf_stat = perf_stat,
+             .get_perf_stat = get_perf_stat,
              .init = NULL,
              .release = NULL},
     .master_cpu = 0,
@@ -26,11 +26,15 @@
 #define __CPU_DEVICE_H__
 
 #include "nn_device.h"
+#include "cpu_pool.h"
+#include "cpu_pack_cache.h"
 
 #define MEM_POOL_ALLOCATED 8
 
 struct node_ops;
 struct ir_node;
+struct ir_tensor;
+struct exec_graph;
 
 struct cpu_device
 {
@@ -56,20 +60,20 @@ struct exec_node
 
     union
     {
-        int8_t block_id[4];
-        int8_t* block_id_ptr;
+        int16_t block_id[4];
+        int16_t* block_id_ptr;
     };
 
     int shared_mem_size;
 };
 
+/* one block per tensor, the live range is counted in allocate/free calls */
 struct mem_block_entry
 {
-    void* addr;
-    int block_size;
-    int max_req_size;
-    int alloc_count;
-    int free_count;
+    int size;
+    int offset; /* in the arena, set by get_backend_mem */
+    int alloc_time;
+    int free_time;
 };
 
 struct mem_pool
@@ -77,6 +81,12 @@ struct mem_pool
     uint8_t align_size; /* must be 2^n */
     struct vector* block_list;
 
+    void* arena; /* all the blocks are packed into it */
+    int arena_size;
+    int peak_size; /* max total size of the blocks alive at the same time */
+    int total_size; /* sum of all the block sizes */
+    int clock;
+
     int (*get_backend_mem)(struct mem_pool*);
     void* (*get_mem_block)(struct mem_pool*, int block_id);
     int (*allocate)(struct mem_pool*, int size);
@@ -84,6 +94,28 @@ struct mem_pool
     void (*dump)(struct mem_pool*);
 };
 
+/* the activation memory planned for one input shape, kept to switch back to the shape later */
+struct mem_plan
+{
+    int* input_shape; /* the key, see get_input_shape() */
+    struct mem_pool* mem_pool;
+    void* shared_mem;
+    int shared_mem_size;
+    int16_t* block_id; /* of all the exec node outputs, in node order */
+    uint32_t last_used;
+};
+
+/* launch record of an exec node, resolved at prerun so run() does not walk the lists */
+struct exec_plan_entry
+{
+    int (*run)(struct node_ops*, struct exec_node*, struct exec_graph*);
+    int (*reshape)(struct node_ops*, struct exec_node*, struct exec_graph*);
+    struct node_ops* node_ops;
+    struct exec_node* exec_node;
+    struct ir_tensor** input_tensors; /* stored right after the entries */
+    int input_num;
+};
+
 struct exec_graph
 {
     struct vector* exec_node_list;
@@ -94,6 +126,18 @@ struct exec_graph
     int shared_mem_size;
     int num_thread;
     int cpu_affinity;
+
+    struct perf_info* perf_info; /* one record per exec node, NULL if perf stat is disabled */
+    struct cpu_pool* cpu_pool; /* worker threads of the graph, NULL if running single threaded */
+    struct pack_cache* pack_cache; /* packed kernels saved by an earlier run, NULL if not enabled */
+
+    struct exec_plan_entry* plan; /* one entry per exec node, in run order */
+    int plan_num;
+    int reshape_all; /* the first run reshapes every node, later ones only those with a reshaped input */
+
+    int* input_shape; /* the input shape the memory is planned for */
+    struct vector* mem_plan_list; /* plans of other input shapes, NULL until the graph is reshaped */
+    uint32_t mem_plan_clock;
 };
 
 #define GET_MEM_PTR_HEADER(ptr) ( struct mem_ptr_header* )(( char* )ptr - 4);
@@ -40,5 +40,14 @@
 #define ARCH_ARM_V8 1
 #define ARCH_ARM_V7 2
 #define ARCH_ARM_V8_2 3
+#define ARCH_X86 4
+
+/* instruction set extensions, probed by cpuid on x86 */
+
+#define CPU_ISA_SSE41 (1 << 0)
+#define CPU_ISA_AVX2 (1 << 1)
+#define CPU_ISA_FMA (1 << 2)
+#define CPU_ISA_AVX512F (1 << 3)
+#define CPU_ISA_AVX512BW (1 << 4)
 
 #endif
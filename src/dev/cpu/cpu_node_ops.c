@@ -31,6 +31,7 @@
 #include "tengine_ir.h"
 #include "tengine_op.h"
 #include "cpu_node_ops.h"
+#include "cpu_probe.h"
 
 static struct vector** builtin_ops_registry;
 static struct vector* custom_ops_registry;
@@ -121,15 +122,19 @@ static inline struct node_ops* find_builtin_node_ops(struct exec_graph* exec_gra
     int num = get_vector_num(ops_vector);
 
     int max_score = 0;
+    int cpu_isa = get_probed_cpu_isa();
     struct node_ops* selected_ops = NULL;
 
     for (int i = 0; i < num; i++)
     {
         struct node_ops* node_ops = *( struct node_ops** )get_vector_data(ops_vector, i);
 
+        if ((node_ops->isa & cpu_isa) != node_ops->isa)
+            continue;
+
         int score = node_ops->score(node_ops, exec_graph, ir_node);
 
-        if (score > max_score)
+        if (score > max_score || (score == max_score && selected_ops && node_ops->isa > selected_ops->isa))
         {
             selected_ops = node_ops;
             max_score = score;
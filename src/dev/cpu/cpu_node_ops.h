@@ -38,6 +38,10 @@ struct node_ops
 {
     int (*prerun)(struct node_ops*, struct exec_node*, struct exec_graph*);
     int (*run)(struct node_ops*, struct exec_node*, struct exec_graph*);
+    /* reshape is called before run() when an input shape changed, and when the graph inputs are
+       reshaped after prerun: then the shapes are inferred already and the memory is not planned yet,
+       the node updates its shape dependent state and shared_mem_size, and keeps its packed weights.
+       nodes without reshape are postrun and prerun again instead. */
     int (*reshape)(struct node_ops*, struct exec_node*, struct exec_graph*);
     int (*postrun)(struct node_ops*, struct exec_node*, struct exec_graph*);
 
@@ -54,6 +58,12 @@ struct node_ops
 
     /* score */
     int (*score)(struct node_ops*, struct exec_graph*, struct ir_node*);
+
+    /* the isa flags required by the node ops, see CPU_ISA_* in cpu_model.h.
+       node ops are skipped if the cpu does not support them, and the one with
+       wider isa wins when the scores are the same.
+    */
+    int isa;
 };
 
 int init_cpu_node_ops_registry(void);
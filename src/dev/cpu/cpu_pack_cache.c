@@ -0,0 +1,581 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * License); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * AS IS BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*
+ * Copyright (c) 2020, OPEN AI LAB
+ * Author: haoluo@openailab.com
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "sys_port.h"
+#include "vector.h"
+#include "tengine_c_api.h"
+#include "tengine_errno.h"
+#include "tengine_log.h"
+#include "tengine_ir.h"
+#include "cpu_pack_cache.h"
+
+uint64_t get_pack_hash(const void* data, int size, uint64_t seed)
+{
+    const uint8_t* p = ( const uint8_t* )data;
+    const uint64_t m = 0xff51afd7ed558ccdULL;
+    uint64_t h[4];
+    int i = 0;
+
+    for (int k = 0; k < 4; k++)
+        h[k] = seed + (k + 1) * 0x9e3779b97f4a7c15ULL;
+
+    /* four independent lanes, the multiplies do not wait for each other */
+    for (; i + 32 <= size; i += 32)
+    {
+        for (int k = 0; k < 4; k++)
+        {
+            uint64_t w;
+            memcpy(&w, p + i + k * 8, 8);
+            h[k] = (h[k] ^ w) * m;
+            h[k] ^= h[k] >> 29;
+        }
+    }
+
+    uint64_t r = h[0] ^ (h[1] * 3) ^ (h[2] * 5) ^ (h[3] * 7) ^ ( uint64_t )size;
+
+    for (; i < size; i++)
+        r = (r ^ p[i]) * 0x100000001b3ULL;
+
+    r ^= r >> 33;
+    r *= 0xc4ceb9fe1a85ec53ULL;
+    r ^= r >> 33;
+
+    return r;
+}
+
+#ifndef CONFIG_BAREMETAL_BUILD
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define PACK_CACHE_MAGIC 0x4b505054 /* "TPPK" */
+#define PACK_CACHE_VERSION 1
+#define PACK_CACHE_ALIGN 64
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define PACK_CACHE_ARCH 1
+#elif defined(__aarch64__)
+#define PACK_CACHE_ARCH 2
+#elif defined(__arm__)
+#define PACK_CACHE_ARCH 3
+#else
+#define PACK_CACHE_ARCH 0
+#endif
+
+/* file layout: header, entry table, then the data of the entries, each aligned to 64 bytes */
+struct pack_cache_header
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t arch;
+    uint32_t entry_num;
+};
+
+struct pack_cache_entry
+{
+    uint64_t key;
+    uint64_t offset;
+    uint64_t size;
+};
+
+struct pack_file
+{
+    void* base;
+    size_t len;
+    const struct pack_cache_entry* entry_list;
+    int entry_num;
+};
+
+struct pending_entry
+{
+    uint64_t key;
+    const void* data;
+    int size;
+};
+
+struct pack_cache
+{
+    char* path;
+    struct pack_file file; /* the file as it was at open, the cached kernels point into it */
+    struct vector* pending_list;
+};
+
+static const char* get_pack_cache_path(struct ir_graph* graph)
+{
+    int size;
+    const char* path = get_attr_val_ptr(graph->attr_mem, graph->attr_num, PACK_CACHE_ATTR_NAME, &size);
+
+    if (path == NULL || size < 2 || path[size - 1] != '\0')
+        return NULL;
+
+    return path;
+}
+
+static void unmap_pack_file(struct pack_file* file)
+{
+    if (file->base != NULL)
+        munmap(file->base, file->len);
+
+    memset(file, 0, sizeof(struct pack_file));
+}
+
+/* a missing, foreign or broken file just maps to an empty cache */
+static int map_pack_file(const char* path, struct pack_file* file)
+{
+    struct stat stat;
+
+    memset(file, 0, sizeof(struct pack_file));
+
+    int fd = open(path, O_RDONLY);
+
+    if (fd < 0)
+        return -1;
+
+    if (fstat(fd, &stat) < 0 || stat.st_size < ( off_t )sizeof(struct pack_cache_header))
+    {
+        close(fd);
+        return -1;
+    }
+
+    void* base = mmap(NULL, stat.st_size, PROT_READ, MAP_SHARED, fd, 0);
+
+    close(fd);
+
+    if (base == MAP_FAILED)
+        return -1;
+
+    file->base = base;
+    file->len = stat.st_size;
+
+    const struct pack_cache_header* header = ( const struct pack_cache_header* )base;
+    size_t table_end = sizeof(struct pack_cache_header) + ( size_t )header->entry_num * sizeof(struct pack_cache_entry);
+
+    if (header->magic != PACK_CACHE_MAGIC || header->version != PACK_CACHE_VERSION || header->arch != PACK_CACHE_ARCH ||
+        table_end > file->len)
+    {
+        TLOG_ERR("pack cache: %s is not a cache of this build, ignored\n", path);
+        unmap_pack_file(file);
+        return -1;
+    }
+
+    file->entry_list = ( const struct pack_cache_entry* )(header + 1);
+    file->entry_num = header->entry_num;
+
+    for (int i = 0; i < file->entry_num; i++)
+    {
+        const struct pack_cache_entry* e = &file->entry_list[i];
+
+        if (e->offset < table_end || e->offset > file->len || e->size > file->len - e->offset)
+        {
+            TLOG_ERR("pack cache: %s is broken, ignored\n", path);
+            unmap_pack_file(file);
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+static const struct pack_cache_entry* find_pack_file(const struct pack_file* file, uint64_t key)
+{
+    for (int i = 0; i < file->entry_num; i++)
+    {
+        if (file->entry_list[i].key == key)
+            return &file->entry_list[i];
+    }
+
+    return NULL;
+}
+
+struct pack_cache* open_pack_cache(struct ir_graph* graph)
+{
+    const char* path = get_pack_cache_path(graph);
+
+    if (path == NULL)
+        return NULL;
+
+    struct pack_cache* cache = ( struct pack_cache* )sys_malloc(sizeof(struct pack_cache));
+
+    if (cache == NULL)
+        return NULL;
+
+    cache->path = ( char* )sys_malloc(strlen(path) + 1);
+    cache->pending_list = create_vector(sizeof(struct pending_entry), NULL);
+
+    if (cache->path == NULL || cache->pending_list == NULL)
+    {
+        if (cache->pending_list)
+            release_vector(cache->pending_list);
+        sys_free(cache->path);
+        sys_free(cache);
+        return NULL;
+    }
+
+    strcpy(cache->path, path);
+
+    map_pack_file(path, &cache->file);
+
+    return cache;
+}
+
+void release_pack_cache(struct pack_cache* cache)
+{
+    if (cache == NULL)
+        return;
+
+    unmap_pack_file(&cache->file);
+    release_vector(cache->pending_list);
+    sys_free(cache->path);
+    sys_free(cache);
+}
+
+const void* find_pack_cache(struct pack_cache* cache, uint64_t key, int* size)
+{
+    const struct pack_cache_entry* e = find_pack_file(&cache->file, key);
+
+    if (e == NULL)
+        return NULL;
+
+    *size = ( int )e->size;
+
+    return ( const char* )cache->file.base + e->offset;
+}
+
+static struct pending_entry* find_pending(struct pack_cache* cache, uint64_t key)
+{
+    int pending_num = get_vector_num(cache->pending_list);
+
+    for (int i = 0; i < pending_num; i++)
+    {
+        struct pending_entry* p = ( struct pending_entry* )get_vector_data(cache->pending_list, i);
+
+        if (p->key == key)
+            return p;
+    }
+
+    return NULL;
+}
+
+int add_pack_cache(struct pack_cache* cache, uint64_t key, const void* data, int size)
+{
+    if (find_pending(cache, key) != NULL)
+        return 0;
+
+    struct pending_entry e;
+
+    e.key = key;
+    e.data = data;
+    e.size = size;
+
+    return push_vector_data(cache->pending_list, &e);
+}
+
+static int write_pad(FILE* fp, long pos)
+{
+    static const char zero[PACK_CACHE_ALIGN] = {0};
+    long pad = (( pos + PACK_CACHE_ALIGN - 1 ) & -PACK_CACHE_ALIGN) - pos;
+
+    if (pad > 0 && fwrite(zero, 1, pad, fp) != ( size_t )pad)
+        return -1;
+
+    return 0;
+}
+
+/* the entries already in the file, maybe written by another exec graph meanwhile, plus the pending ones */
+static int write_pack_file(struct pack_cache* cache, const struct pack_file* cur, const char* tmp_path)
+{
+    int pending_num = get_vector_num(cache->pending_list);
+    int entry_num = cur->entry_num + pending_num;
+    struct pack_cache_entry* entry_list = ( struct pack_cache_entry* )sys_malloc(sizeof(struct pack_cache_entry) * entry_num);
+    const void** data_list = ( const void** )sys_malloc(sizeof(void*) * entry_num);
+
+    if (entry_list == NULL || data_list == NULL)
+    {
+        sys_free(entry_list);
+        sys_free(data_list);
+        return -1;
+    }
+
+    int n = 0;
+
+    for (int i = 0; i < cur->entry_num; i++)
+    {
+        const struct pack_cache_entry* e = &cur->entry_list[i];
+
+        if (find_pending(cache, e->key) != NULL)
+            continue;
+
+        entry_list[n] = *e;
+        data_list[n] = ( const char* )cur->base + e->offset;
+        n++;
+    }
+
+    for (int i = 0; i < pending_num; i++)
+    {
+        struct pending_entry* p = ( struct pending_entry* )get_vector_data(cache->pending_list, i);
+
+        entry_list[n].key = p->key;
+        entry_list[n].size = p->size;
+        data_list[n] = p->data;
+        n++;
+    }
+
+    entry_num = n;
+
+    /* lay the data out after the table */
+    uint64_t offset = sizeof(struct pack_cache_header) + sizeof(struct pack_cache_entry) * entry_num;
+
+    for (int i = 0; i < entry_num; i++)
+    {
+        offset = (offset + PACK_CACHE_ALIGN - 1) & -( uint64_t )PACK_CACHE_ALIGN;
+        entry_list[i].offset = offset;
+        offset += entry_list[i].size;
+    }
+
+    struct pack_cache_header header;
+
+    header.magic = PACK_CACHE_MAGIC;
+    header.version = PACK_CACHE_VERSION;
+    header.arch = PACK_CACHE_ARCH;
+    header.entry_num = entry_num;
+
+    int ret = -1;
+    FILE* fp = fopen(tmp_path, "wb");
+
+    if (fp == NULL)
+        goto out;
+
+    if (fwrite(&header, sizeof(header), 1, fp) != 1 ||
+        fwrite(entry_list, sizeof(struct pack_cache_entry), entry_num, fp) != ( size_t )entry_num)
+        goto out;
+
+    for (int i = 0; i < entry_num; i++)
+    {
+        if (write_pad(fp, ftell(fp)) < 0 || fwrite(data_list[i], 1, entry_list[i].size, fp) != entry_list[i].size)
+            goto out;
+    }
+
+    ret = 0;
+
+out:
+    if (fp != NULL && fclose(fp) != 0)
+        ret = -1;
+
+    sys_free(entry_list);
+    sys_free(data_list);
+
+    return ret;
+}
+
+int flush_pack_cache(struct pack_cache* cache)
+{
+    if (get_vector_num(cache->pending_list) == 0)
+        return 0;
+
+    struct pack_file cur;
+    char* tmp_path = ( char* )sys_malloc(strlen(cache->path) + 32);
+
+    if (tmp_path == NULL)
+        return -1;
+
+    sprintf(tmp_path, "%s.%d.tmp", cache->path, ( int )getpid());
+
+    map_pack_file(cache->path, &cur);
+
+    /* a new file is renamed over the old one, the mapping of the old one stays valid */
+    int ret = write_pack_file(cache, &cur, tmp_path);
+
+    if (ret == 0 && rename(tmp_path, cache->path) != 0)
+        ret = -1;
+
+    if (ret < 0)
+    {
+        TLOG_ERR("pack cache: cannot write %s\n", cache->path);
+        remove(tmp_path);
+    }
+
+    unmap_pack_file(&cur);
+    sys_free(tmp_path);
+
+    /* the pending data belongs to the kernels, do not keep it around */
+    while (get_vector_num(cache->pending_list) > 0)
+        remove_vector_by_idx(cache->pending_list, 0);
+
+    return ret;
+}
+
+struct shared_pack
+{
+    uint64_t key;
+    void* data;
+    int size;
+    int ref;
+};
+
+static struct vector* shared_pack_list;
+static pthread_mutex_t shared_pack_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static struct shared_pack* find_shared_pack(uint64_t key, const void* data)
+{
+    if (shared_pack_list == NULL)
+        return NULL;
+
+    for (int i = 0; i < get_vector_num(shared_pack_list); i++)
+    {
+        struct shared_pack* p = ( struct shared_pack* )get_vector_data(shared_pack_list, i);
+
+        if (data ? p->data == data : p->key == key)
+            return p;
+    }
+
+    return NULL;
+}
+
+const void* get_shared_pack(uint64_t key, int* size)
+{
+    pthread_mutex_lock(&shared_pack_lock);
+
+    struct shared_pack* p = find_shared_pack(key, NULL);
+
+    if (p != NULL)
+    {
+        p->ref++;
+        *size = p->size;
+    }
+
+    pthread_mutex_unlock(&shared_pack_lock);
+
+    return p ? p->data : NULL;
+}
+
+const void* add_shared_pack(uint64_t key, void* data, int size)
+{
+    const void* shared = NULL;
+
+    pthread_mutex_lock(&shared_pack_lock);
+
+    struct shared_pack* p = find_shared_pack(key, NULL);
+
+    if (p != NULL)
+    {
+        /* packed by another instance at the same time */
+        p->ref++;
+        shared = p->data;
+        sys_free(data);
+    }
+    else
+    {
+        if (shared_pack_list == NULL)
+            shared_pack_list = create_vector(sizeof(struct shared_pack), NULL);
+
+        struct shared_pack e = {key, data, size, 1};
+
+        if (shared_pack_list != NULL && push_vector_data(shared_pack_list, &e) == 0)
+            shared = data;
+    }
+
+    pthread_mutex_unlock(&shared_pack_lock);
+
+    return shared;
+}
+
+int put_shared_pack(const void* data)
+{
+    int ret = -1;
+
+    if (data == NULL)
+        return -1;
+
+    pthread_mutex_lock(&shared_pack_lock);
+
+    struct shared_pack* p = find_shared_pack(0, data);
+
+    if (p != NULL && --p->ref == 0)
+    {
+        sys_free(p->data);
+        remove_vector_data(shared_pack_list, p);
+    }
+
+    if (p != NULL)
+        ret = 0;
+
+    if (shared_pack_list != NULL && get_vector_num(shared_pack_list) == 0)
+    {
+        release_vector(shared_pack_list);
+        shared_pack_list = NULL;
+    }
+
+    pthread_mutex_unlock(&shared_pack_lock);
+
+    return ret;
+}
+
+#else
+
+struct pack_cache* open_pack_cache(struct ir_graph* graph)
+{
+    return NULL;
+}
+
+void release_pack_cache(struct pack_cache* cache)
+{
+}
+
+const void* find_pack_cache(struct pack_cache* cache, uint64_t key, int* size)
+{
+    return NULL;
+}
+
+int add_pack_cache(struct pack_cache* cache, uint64_t key, const void* data, int size)
+{
+    return 0;
+}
+
+int flush_pack_cache(struct pack_cache* cache)
+{
+    return 0;
+}
+
+const void* get_shared_pack(uint64_t key, int* size)
+{
+    return NULL;
+}
+
+const void* add_shared_pack(uint64_t key, void* data, int size)
+{
+    return NULL;
+}
+
+int put_shared_pack(const void* data)
+{
+    return -1;
+}
+
+#endif
@@ -0,0 +1,73 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * License); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * AS IS BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*
+ * Copyright (c) 2020, OPEN AI LAB
+ * Author: haoluo@openailab.com
+ */
+
+#ifndef __CPU_PACK_CACHE_H__
+#define __CPU_PACK_CACHE_H__
+
+#include <stdint.h>
+
+/*
+ * the graph attribute naming the cache file, a zero terminated path:
+ *     set_graph_attr(graph, "cpu_pack_cache", path, strlen(path) + 1);
+ */
+#define PACK_CACHE_ATTR_NAME "cpu_pack_cache"
+
+struct ir_graph;
+struct pack_cache;
+
+/*
+ * the cache keeps the packed kernels of a graph in a file, so prerun maps them instead of
+ * packing the weights again. the entries are keyed by a hash of the weight data and of the
+ * kernel variant, see get_pack_hash(); the file is bound to the cpu arch it was made on.
+ */
+struct pack_cache* open_pack_cache(struct ir_graph* graph);
+
+void release_pack_cache(struct pack_cache* cache);
+
+/* returns the packed data of the key and its size, NULL if it is not cached */
+const void* find_pack_cache(struct pack_cache* cache, uint64_t key, int* size);
+
+/* record freshly packed data, it must stay valid until flush_pack_cache() */
+int add_pack_cache(struct pack_cache* cache, uint64_t key, const void* data, int size);
+
+/* write the recorded entries to the file, together with the ones already in it */
+int flush_pack_cache(struct pack_cache* cache);
+
+uint64_t get_pack_hash(const void* data, int size, uint64_t seed);
+
+/*
+ * the packed kernels of a graph and its clones are kept once in the process, counted by reference.
+ * get_shared_pack() takes a reference of the data of the key, NULL if it is not shared yet.
+ * add_shared_pack() hands the sys_malloc()ed data over and takes a reference of it; if the key was
+ * added meanwhile, the data is freed and the one added before is returned. NULL if it can not be
+ * shared, the data stays with the caller then.
+ * put_shared_pack() drops a reference, the last one frees the data. -1 if the data is not shared.
+ */
+const void* get_shared_pack(uint64_t key, int* size);
+
+const void* add_shared_pack(uint64_t key, void* data, int size);
+
+int put_shared_pack(const void* data);
+
+#endif
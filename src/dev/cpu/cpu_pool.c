@@ -0,0 +1,362 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * License); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * AS IS BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*
+ * Copyright (c) 2020, OPEN AI LAB
+ * Author: haoluo@openailab.com
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "sys_port.h"
+#include "tengine_c_api.h"
+#include "tengine_errno.h"
+#include "tengine_log.h"
+#include "cpu_pool.h"
+
+#ifndef CONFIG_BAREMETAL_BUILD
+
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+#if defined(__linux__) || defined(__ANDROID__)
+#include <sys/syscall.h>
+#endif
+
+/* rounds a worker polls for the next task set before it sleeps, keeps the gap between layers cheap */
+#define CPU_POOL_SPIN_COUNT (1 << 14)
+
+struct cpu_worker
+{
+    struct cpu_pool* pool;
+    pthread_t thread;
+    int cpu_id; /* -1: not pinned */
+};
+
+struct cpu_pool
+{
+    int thread_num;
+    struct cpu_worker* worker_list; /* thread_num - 1 workers */
+
+    int master_cpu; /* the core of the calling thread, -1: not pinned */
+    int master_bound; /* master is pinned to master_cpu */
+    pthread_t master;
+
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    int generation; /* bumped for each parallel_for */
+    int quit;
+
+    /* the current task set */
+    cpu_task_t task;
+    void* arg;
+    int task_num;
+    int next_task;
+    int pending; /* workers not yet done with the current generation */
+};
+
+static inline void cpu_relax(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __asm__ __volatile__("pause" ::: "memory");
+#elif defined(__aarch64__) || defined(__arm__)
+    __asm__ __volatile__("yield" ::: "memory");
+#else
+    __asm__ __volatile__("" ::: "memory");
+#endif
+}
+
+static void bind_cpu(int cpu_id)
+{
+#if defined(__linux__) || defined(__ANDROID__)
+    /* raw syscall, cpu_set_t is not available everywhere. pid 0 is the calling thread */
+    unsigned long mask[1024 / (8 * sizeof(unsigned long))];
+
+    if (cpu_id < 0 || cpu_id >= ( int )(sizeof(mask) * 8))
+        return;
+
+    memset(mask, 0, sizeof(mask));
+    mask[cpu_id / (8 * sizeof(unsigned long))] |= 1UL << (cpu_id % (8 * sizeof(unsigned long)));
+
+    if (syscall(__NR_sched_setaffinity, 0, sizeof(mask), mask) != 0)
+        TLOG_ERR("cpu pool: bind thread to cpu %d failed\n", cpu_id);
+#else
+    /* thread affinity is not supported, leave it to the os */
+    (void)cpu_id;
+#endif
+}
+
+static void run_tasks(struct cpu_pool* pool)
+{
+    cpu_task_t task = pool->task;
+    void* arg = pool->arg;
+    int task_num = pool->task_num;
+
+    while (1)
+    {
+        int task_id = __atomic_fetch_add(&pool->next_task, 1, __ATOMIC_RELAXED);
+
+        if (task_id >= task_num)
+            break;
+
+        task(arg, task_id);
+    }
+}
+
+/* returns the new generation, or -1 if the pool is quitting */
+static int wait_generation(struct cpu_pool* pool, int seen)
+{
+    int generation;
+
+    for (int i = 0; i < CPU_POOL_SPIN_COUNT; i++)
+    {
+        if (__atomic_load_n(&pool->quit, __ATOMIC_ACQUIRE))
+            return -1;
+
+        generation = __atomic_load_n(&pool->generation, __ATOMIC_ACQUIRE);
+        if (generation != seen)
+            return generation;
+
+        cpu_relax();
+    }
+
+    pthread_mutex_lock(&pool->mutex);
+
+    while (!pool->quit && pool->generation == seen)
+        pthread_cond_wait(&pool->cond, &pool->mutex);
+
+    generation = pool->quit ? -1 : pool->generation;
+
+    pthread_mutex_unlock(&pool->mutex);
+
+    return generation;
+}
+
+static void* cpu_worker_main(void* arg)
+{
+    struct cpu_worker* worker = ( struct cpu_worker* )arg;
+    struct cpu_pool* pool = worker->pool;
+    int seen = 0;
+
+    if (worker->cpu_id >= 0)
+        bind_cpu(worker->cpu_id);
+
+    while (1)
+    {
+        int generation = wait_generation(pool, seen);
+
+        if (generation < 0)
+            break;
+
+        seen = generation;
+
+        run_tasks(pool);
+
+        __atomic_sub_fetch(&pool->pending, 1, __ATOMIC_ACQ_REL);
+    }
+
+    return NULL;
+}
+
+/* the i-th set bit of mask, wrapping around */
+static int get_mask_cpu(size_t cpu_mask, int i)
+{
+    int count = 0;
+
+    for (int bit = 0; bit < ( int )sizeof(size_t) * 8; bit++)
+    {
+        if (cpu_mask & (( size_t )1 << bit))
+            count++;
+    }
+
+    if (count == 0)
+        return -1;
+
+    i = i % count;
+
+    for (int bit = 0; bit < ( int )sizeof(size_t) * 8; bit++)
+    {
+        if ((cpu_mask & (( size_t )1 << bit)) && i-- == 0)
+            return bit;
+    }
+
+    return -1;
+}
+
+static void stop_workers(struct cpu_pool* pool, int started)
+{
+    pthread_mutex_lock(&pool->mutex);
+    __atomic_store_n(&pool->quit, 1, __ATOMIC_RELEASE);
+    pthread_cond_broadcast(&pool->cond);
+    pthread_mutex_unlock(&pool->mutex);
+
+    for (int i = 0; i < started; i++)
+        pthread_join(pool->worker_list[i].thread, NULL);
+}
+
+struct cpu_pool* create_cpu_pool(int thread_num, size_t cpu_mask)
+{
+    if (thread_num <= 1)
+        return NULL;
+
+    struct cpu_pool* pool = ( struct cpu_pool* )sys_malloc(sizeof(struct cpu_pool));
+
+    if (pool == NULL)
+    {
+        set_tengine_errno(ENOMEM);
+        return NULL;
+    }
+
+    memset(pool, 0, sizeof(struct cpu_pool));
+
+    pool->worker_list = ( struct cpu_worker* )sys_malloc(sizeof(struct cpu_worker) * (thread_num - 1));
+
+    if (pool->worker_list == NULL)
+    {
+        sys_free(pool);
+        set_tengine_errno(ENOMEM);
+        return NULL;
+    }
+
+    pthread_mutex_init(&pool->mutex, NULL);
+    pthread_cond_init(&pool->cond, NULL);
+
+    /* the calling thread takes the first core of the mask, the workers the following ones */
+    pool->master_cpu = get_mask_cpu(cpu_mask, 0);
+
+    int started = 0;
+
+    for (int i = 0; i < thread_num - 1; i++)
+    {
+        struct cpu_worker* worker = &pool->worker_list[i];
+
+        worker->pool = pool;
+        worker->cpu_id = get_mask_cpu(cpu_mask, i + 1);
+
+        if (pthread_create(&worker->thread, NULL, cpu_worker_main, worker) != 0)
+            break;
+
+        started++;
+    }
+
+    if (started == 0)
+    {
+        TLOG_ERR("cpu pool: create worker thread failed\n");
+        stop_workers(pool, 0);
+        pthread_mutex_destroy(&pool->mutex);
+        pthread_cond_destroy(&pool->cond);
+        sys_free(pool->worker_list);
+        sys_free(pool);
+        return NULL;
+    }
+
+    pool->thread_num = started + 1;
+
+    return pool;
+}
+
+void release_cpu_pool(struct cpu_pool* pool)
+{
+    if (pool == NULL)
+        return;
+
+    stop_workers(pool, pool->thread_num - 1);
+
+    pthread_mutex_destroy(&pool->mutex);
+    pthread_cond_destroy(&pool->cond);
+
+    sys_free(pool->worker_list);
+    sys_free(pool);
+}
+
+int get_cpu_pool_thread_num(struct cpu_pool* pool)
+{
+    if (pool == NULL)
+        return 1;
+
+    return pool->thread_num;
+}
+
+void cpu_pool_parallel_for(struct cpu_pool* pool, cpu_task_t task, void* arg, int task_num)
+{
+    if (pool == NULL || task_num <= 1)
+    {
+        for (int i = 0; i < task_num; i++)
+            task(arg, i);
+
+        return;
+    }
+
+    /* the graph may be run from another thread than the last time */
+    if (pool->master_cpu >= 0 && (!pool->master_bound || !pthread_equal(pool->master, pthread_self())))
+    {
+        bind_cpu(pool->master_cpu);
+        pool->master = pthread_self();
+        pool->master_bound = 1;
+    }
+
+    pool->task = task;
+    pool->arg = arg;
+    pool->task_num = task_num;
+    pool->next_task = 0;
+    pool->pending = pool->thread_num - 1;
+
+    /* spinning workers pick the new generation up at once, the sleeping ones need the signal */
+    pthread_mutex_lock(&pool->mutex);
+    __atomic_add_fetch(&pool->generation, 1, __ATOMIC_RELEASE);
+    pthread_cond_broadcast(&pool->cond);
+    pthread_mutex_unlock(&pool->mutex);
+
+    run_tasks(pool);
+
+    /* every worker has to leave the task set before it can be reused */
+    for (int i = 0; __atomic_load_n(&pool->pending, __ATOMIC_ACQUIRE) != 0; i++)
+    {
+        if (i < CPU_POOL_SPIN_COUNT)
+            cpu_relax();
+        else
+            sched_yield();
+    }
+}
+
+#else
+
+struct cpu_pool* create_cpu_pool(int thread_num, size_t cpu_mask)
+{
+    return NULL;
+}
+
+void release_cpu_pool(struct cpu_pool* pool)
+{
+}
+
+int get_cpu_pool_thread_num(struct cpu_pool* pool)
+{
+    return 1;
+}
+
+void cpu_pool_parallel_for(struct cpu_pool* pool, cpu_task_t task, void* arg, int task_num)
+{
+    for (int i = 0; i < task_num; i++)
+        task(arg, i);
+}
+
+#endif
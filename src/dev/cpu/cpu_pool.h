@@ -0,0 +1,54 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * License); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * AS IS BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*
+ * Copyright (c) 2020, OPEN AI LAB
+ * Author: haoluo@openailab.com
+ */
+
+#ifndef __CPU_POOL_H__
+#define __CPU_POOL_H__
+
+#include <stddef.h>
+
+struct cpu_pool;
+
+/* task body, called once for each task_id in [0, task_num) */
+typedef void (*cpu_task_t)(void* arg, int task_id);
+
+/*
+ * create a pool running thread_num threads in total: the calling thread plus thread_num - 1
+ * workers, each pinned to one core of cpu_mask. the thread calling parallel_for is pinned to
+ * the first core of the mask when it first runs on the pool, the workers take the following ones.
+ * returns NULL when no worker is needed (thread_num <= 1) or threads are not available,
+ * parallel_for then runs serially.
+ *
+ * the x86 and the reference kernels run on the pool. the arm kernels still use OpenMP, on arm
+ * a graph running both creates a second thread team on the same cores.
+ */
+struct cpu_pool* create_cpu_pool(int thread_num, size_t cpu_mask);
+
+void release_cpu_pool(struct cpu_pool* pool);
+
+int get_cpu_pool_thread_num(struct cpu_pool* pool);
+
+/* run task(arg, 0 .. task_num - 1) on the pool and the calling thread, returns when all are done */
+void cpu_pool_parallel_for(struct cpu_pool* pool, cpu_task_t task, void* arg, int task_num);
+
+#endif
@@ -36,6 +36,7 @@ static struct cluster_entry cluster0 = {
     .leader_cpu = 0,
     .cpu_model = ARCH_GENERIC,
     .cpu_arch = ARCH_GENERIC,
+    .cpu_isa = 0,
     .cpu_num = 1,
     .l1_size = 1024,
     .l2_size = 16 * 1024,
@@ -54,6 +55,11 @@ struct probed_cpu_info* get_probed_cpu_info(void)
     return &probed_cpu_info;
 }
 
+int get_probed_cpu_isa(void)
+{
+    return cluster0.cpu_isa;
+}
+
 #else
 #include <sys/types.h>
 #include <sys/stat.h>
@@ -76,6 +82,19 @@ struct probed_cpu_info* get_probed_cpu_info(void)
     return probed_cpu_info;
 }
 
+int get_probed_cpu_isa(void)
+{
+    if (probed_cpu_info == NULL)
+        return 0;
+
+    int isa = probed_cpu_info->cluster_list[0].cpu_isa;
+
+    for (int i = 1; i < probed_cpu_info->cluster_num; i++)
+        isa &= probed_cpu_info->cluster_list[i].cpu_isa;
+
+    return isa;
+}
+
 struct cpu_item
 {
     int cpu_id;
@@ -287,6 +306,69 @@ static int get_cpu_model_arch(int id, struct cluster_entry* cluster)
     return 0;
 }
 
+#elif defined(__x86_64__) || defined(__i386__)
+
+#include <cpuid.h>
+
+static unsigned int get_xcr0(void)
+{
+    unsigned int eax, edx;
+
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+
+    return eax;
+}
+
+/*
+    the isa is probed by cpuid on the calling core, the cores of one x86 package
+    report the same extensions. the avx and avx-512 states must also be enabled
+    by the os, which is checked in xcr0.
+*/
+static int get_cpu_isa(void)
+{
+    unsigned int eax, ebx, ecx, edx;
+    int isa = 0;
+
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+        return 0;
+
+    if (ecx & bit_SSE4_1)
+        isa |= CPU_ISA_SSE41;
+
+    if (!(ecx & bit_OSXSAVE) || !(ecx & bit_AVX))
+        return isa;
+
+    unsigned int xcr0 = get_xcr0();
+    int os_avx = (xcr0 & 0x6) == 0x6;
+    int os_avx512 = (xcr0 & 0xe6) == 0xe6;
+    int has_fma = (ecx & bit_FMA) != 0;
+
+    if (!os_avx || !__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx))
+        return isa;
+
+    if (ebx & bit_AVX2)
+        isa |= CPU_ISA_AVX2;
+    if (has_fma)
+        isa |= CPU_ISA_FMA;
+    if (os_avx512 && (ebx & bit_AVX512F))
+        isa |= CPU_ISA_AVX512F;
+    if (os_avx512 && (ebx & bit_AVX512F) && (ebx & bit_AVX512BW))
+        isa |= CPU_ISA_AVX512BW;
+
+    return isa;
+}
+
+static int get_cpu_model_arch(int id, struct cluster_entry* cluster)
+{
+    cluster->cpu_model = CPU_GENERIC;
+    cluster->cpu_arch = ARCH_X86;
+    cluster->cpu_isa = get_cpu_isa();
+    cluster->l1_size = 32 << 10;
+    cluster->l2_size = 512 << 10;
+
+    return 0;
+}
+
 #else
 
 static int get_cpu_model_arch(int id, struct cluster_entry* cluster)
@@ -350,6 +432,7 @@ static int probe_system_cpu(void* arg)
         cluster->cpu_num = 0;
         cluster->cpu_model = -1;
         cluster->cpu_arch = -1;
+        cluster->cpu_isa = 0;
         cluster->l1_size = -1;
         cluster->l2_size = -1;
         cluster->max_freq = -1;
@@ -39,6 +39,7 @@ struct cluster_entry
     int leader_cpu;
     int cpu_model;
     int cpu_arch;
+    int cpu_isa;
     int cpu_num;
     int l1_size;
     int l2_size;
@@ -56,4 +57,7 @@ struct probed_cpu_info
 
 struct probed_cpu_info* get_probed_cpu_info(void);
 
+/* the isa flags supported by all the clusters, see CPU_ISA_* */
+int get_probed_cpu_isa(void);
+
 #endif
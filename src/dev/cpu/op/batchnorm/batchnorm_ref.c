@@ -51,49 +51,65 @@ struct ref_batchnorm_param
     int out_zero;
 };
 
-static int ref_batchnorm_fp32(float* input, float* output, const struct ref_batchnorm_param* param, int num_thread)
+struct batchnorm_task_param
 {
+    float* input;
+    float* output;
+    const struct ref_batchnorm_param* param;
+};
+
+/* one row of one image */
+static void batchnorm_task(void* arg, int task_id)
+{
+    struct batchnorm_task_param* p = ( struct batchnorm_task_param* )arg;
+    const struct ref_batchnorm_param* param = p->param;
+    float* input = p->input;
+    float* output = p->output;
     float* scale_mean = param->scale_mean;
     float* scale_var_inv = param->scale_var_inv;
     float* gamma = param->gamma;
     float* beta = param->beta;
 
     int img_size = param->input_c * param->input_h * param->input_w;
+    int n = task_id / param->input_h;
+    int h = task_id % param->input_h;
 
-    for (int n = 0; n < param->input_n; ++n)
+    for (int w = 0; w < param->input_w; ++w)
     {
-#pragma omp parallel for num_threads(num_thread)
-        for (int h = 0; h < param->input_h; ++h)
+        for (int c = 0; c < param->input_c; ++c)
         {
-            for (int w = 0; w < param->input_w; ++w)
+            float s_mean = scale_mean[c];
+            float s_var = scale_var_inv[c];
+            float s_val1 = s_mean;
+            float s_val2 = s_var;
+            if (!param->iscaffe)
+            {
+                float s_gamma = gamma[c];
+                float s_beta = beta[c];
+                s_val1 = s_beta + s_gamma * s_mean;
+                s_val2 = s_gamma * s_var;
+            }
+            int offset = 0;
+            if (TENGINE_LAYOUT_NCHW == param->layout)
+            {
+                offset = n * img_size + c * param->input_h * param->input_w + h * param->input_w + w;
+            }
+            else
             {
-                for (int c = 0; c < param->input_c; ++c)
-                {
-                    float s_mean = scale_mean[c];
-                    float s_var = scale_var_inv[c];
-                    float s_val1 = s_mean;
-                    float s_val2 = s_var;
-                    if (!param->iscaffe)
-                    {
-                        float s_gamma = gamma[c];
-                        float s_beta = beta[c];
-                        s_val1 = s_beta + s_gamma * s_mean;
-                        s_val2 = s_gamma * s_var;
-                    }
-                    int offset = 0;
-                    if (TENGINE_LAYOUT_NCHW == param->layout)
-                    {
-                        offset = n * img_size + c * param->input_h * param->input_w + h * param->input_w + w;
-                    }
-                    else
-                    {
-                        offset = n * img_size + h * param->input_w * param->input_c + w * param->input_c + c;
-                    }
-                    output[offset] = input[offset] * s_val2 + s_val1;
-                }
+                offset = n * img_size + h * param->input_w * param->input_c + w * param->input_c + c;
             }
+            output[offset] = input[offset] * s_val2 + s_val1;
         }
     }
+}
+
+static int ref_batchnorm_fp32(float* input, float* output, const struct ref_batchnorm_param* param,
+                              struct cpu_pool* pool)
+{
+    struct batchnorm_task_param task_param = {input, output, param};
+
+    cpu_pool_parallel_for(pool, batchnorm_task, &task_param, param->input_n * param->input_h);
+
     return 0;
 }
 
@@ -231,7 +247,7 @@ static int run(struct node_ops* node_ops, struct exec_node* exec_node, struct ex
         }
     }
 
-    int ret = ref_batchnorm_fp32(input, out_data, batchnorm_op_param, exec_graph->num_thread);
+    int ret = ref_batchnorm_fp32(input, out_data, batchnorm_op_param, exec_graph->cpu_pool);
 
     return ret;
 }
@@ -31,28 +31,36 @@
 #include "tengine_op.h"
 #include <math.h>
 
+struct bias_task_param
+{
+    float* input;
+    float* bias;
+    float* output;
+    int size;
+};
+
+static void bias_task(void* arg, int c)
+{
+    struct bias_task_param* p = ( struct bias_task_param* )arg;
+    float* out_ptr = p->output + c * p->size;
+    float* in_ptr = p->input + c * p->size;
+
+    for (int i = 0; i < p->size; i++)
+    {
+        out_ptr[i] = in_ptr[i] + p->bias[c];
+    }
+}
+
 int ref_bias_fp32(struct ir_tensor* input_tensor, struct ir_tensor* output_tensor, struct ir_tensor* bias_tensor,
-                  int num_thread)
+                  struct cpu_pool* pool)
 {
     int channels = input_tensor->dims[1];
     int h = input_tensor->dims[2];
     int w = input_tensor->dims[3];
-    int size = h * w;
 
-    float* in_data = input_tensor->data;
-    float* bias = bias_tensor->data;
-    float* out_data = output_tensor->data;
+    struct bias_task_param param = {input_tensor->data, bias_tensor->data, output_tensor->data, h * w};
 
-#pragma omp parallel for num_threads(num_thread)
-    for (int c = 0; c < channels; c++)
-    {
-        float* out_ptr = out_data + c * size;
-        float* in_ptr = in_data + c * size;
-        for (int i = 0; i < size; i++)
-        {
-            out_ptr[i] = in_ptr[i] + bias[c];
-        }
-    }
+    cpu_pool_parallel_for(pool, bias_task, &param, channels);
 
     return 0;
 }
@@ -93,7 +101,7 @@ static int run(struct node_ops* node_ops, struct exec_node* exec_node, struct ex
     //     return -1;
     // }
 
-    int ret = ref_bias_fp32(input_tensor, output_tensor, bias_tensor, exec_graph->num_thread);
+    int ret = ref_bias_fp32(input_tensor, output_tensor, bias_tensor, exec_graph->cpu_pool);
     if (ret != 0)
         return -1;
 
@@ -33,6 +33,39 @@
 #include "compiler_fp16.h"
 #include "cast_param.h"
 
+struct cast_task_param
+{
+    void* input;
+    void* output;
+    int channel_size;
+};
+
+static void cast_fp32_to_fp16_task(void* arg, int i)
+{
+    struct cast_task_param* p = ( struct cast_task_param* )arg;
+    float* idata = ( float* )p->input;
+    __fp16* odata = ( __fp16* )p->output;
+    int offset = i * p->channel_size;
+
+    for (int j = 0; j < p->channel_size; j++)
+    {
+        odata[j + offset] = fp32_to_fp16(idata[j + offset]);
+    }
+}
+
+static void cast_fp16_to_fp32_task(void* arg, int i)
+{
+    struct cast_task_param* p = ( struct cast_task_param* )arg;
+    __fp16* idata = ( __fp16* )p->input;
+    float* odata = ( float* )p->output;
+    int offset = i * p->channel_size;
+
+    for (int j = 0; j < p->channel_size; j++)
+    {
+        odata[j + offset] = fp16_to_fp32(idata[j + offset]);
+    }
+}
+
 static int init_node(struct node_ops* node_ops, struct exec_node* exec_node, struct exec_graph* exec_graph)
 {
     return 0;
@@ -66,39 +99,13 @@ static int run(struct node_ops* node_ops, struct exec_node* exec_node, struct ex
     int batch_number = input_tensor->dims[0];
     int channel_size = (input_tensor->dims[2]) * (input_tensor->dims[3]);
 
-    int num_thread = exec_graph->num_thread;
+    struct cast_task_param param = {input_tensor->data, output_tensor->data, channel_size};
 
     if (type_from == 1 && type_to == 2)
-    {
-        float* idata = ( float* )input_tensor->data;
-        __fp16* odata = ( __fp16* )output_tensor->data;
-
-#pragma omp parallel for num_threads(num_thread)
-        for (int i = 0; i < (channel_num * batch_number); i++)
-        {
-            int offset = i * channel_size;
-            for (int j = 0; j < channel_size; j++)
-            {
-                odata[j + offset] = fp32_to_fp16(idata[j + offset]);
-            }
-        }
-    }
+        cpu_pool_parallel_for(exec_graph->cpu_pool, cast_fp32_to_fp16_task, &param, channel_num * batch_number);
 
     if (type_from == 2 && type_to == 1)
-    {
-        __fp16* idata = ( __fp16* )input_tensor->data;
-        float* odata = ( float* )output_tensor->data;
-
-#pragma omp parallel for num_threads(num_thread)
-        for (int i = 0; i < (channel_num * batch_number); i++)
-        {
-            int offset = i * channel_size;
-            for (int j = 0; j < channel_size; j++)
-            {
-                odata[j + offset] = fp16_to_fp32(idata[j + offset]);
-            }
-        }
-    }
+        cpu_pool_parallel_for(exec_graph->cpu_pool, cast_fp16_to_fp32_task, &param, channel_num * batch_number);
 
     return 0;
 }
@@ -31,7 +31,26 @@
 #include "tengine_op.h"
 #include <math.h>
 
-int ref_ceil_fp32(struct ir_tensor* input_tensor, struct ir_tensor* output_tensor, int num_thread)
+struct ceil_task_param
+{
+    float* input;
+    float* output;
+    int size;
+};
+
+static void ceil_task(void* arg, int task_id)
+{
+    struct ceil_task_param* p = ( struct ceil_task_param* )arg;
+    float* src = p->input + p->size * task_id;
+    float* dst = p->output + p->size * task_id;
+
+    for (int i = 0; i < p->size; i++)
+    {
+        dst[i] = ceil(src[i]);
+    }
+}
+
+int ref_ceil_fp32(struct ir_tensor* input_tensor, struct ir_tensor* output_tensor, struct cpu_pool* pool)
 {
     // dims size = 2 or 3
     if (input_tensor->dim_num < 4)
@@ -53,23 +72,9 @@ int ref_ceil_fp32(struct ir_tensor* input_tensor, struct ir_tensor* output_tenso
         int w = input_tensor->dims[3];
         int h = output_tensor->dims[2];
         int channels = input_tensor->dims[1];
-        int size = h * w;
-        int c_step = h * w;
-
-        float* input_data = input_tensor->data;
-        float* out_data = output_tensor->data;
+        struct ceil_task_param param = {input_tensor->data, output_tensor->data, h * w};
 
-#pragma omp parallel for num_threads(num_thread)
-        for (int q = 0; q < channels; q++)
-        {
-            float* src = input_data + c_step * q;
-            float* dst = out_data + c_step * q;
-
-            for (int i = 0; i < size; i++)
-            {
-                dst[i] = ceil(src[i]);
-            }
-        }
+        cpu_pool_parallel_for(pool, ceil_task, &param, channels);
 
         return 0;
     }
@@ -115,7 +120,7 @@ static int run(struct node_ops* node_ops, struct exec_node* exec_node, struct ex
     //     return -1;
     // }
 
-    int ret = ref_ceil_fp32(input_tensor, output_tensor, exec_graph->num_thread);
+    int ret = ref_ceil_fp32(input_tensor, output_tensor, exec_graph->cpu_pool);
     if (ret != 0)
         return -1;
 
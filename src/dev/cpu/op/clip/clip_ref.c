@@ -32,34 +32,70 @@
 #include "clip_param.h"
 #include <math.h>
 
-int ref_clip_fp32(struct ir_tensor* input_tensor, struct ir_tensor* output_tensor, float max, float min, int num_thread)
+struct clip_task_param
+{
+    float* input;
+    float* output;
+    int size;
+    float max;
+    float min;
+};
+
+static void clip_task(void* arg, int task_id)
+{
+    struct clip_task_param* p = ( struct clip_task_param* )arg;
+    float* src = p->input + p->size * task_id;
+    float* dst = p->output + p->size * task_id;
+
+    for (int i = 0; i < p->size; i++)
+    {
+        dst[i] = src[i];
+
+        if (dst[i] > p->max)
+            dst[i] = p->max;
+        if (dst[i] < p->min)
+            dst[i] = p->min;
+    }
+}
+
+int ref_clip_fp32(struct ir_tensor* input_tensor, struct ir_tensor* output_tensor, float max, float min,
+                  struct cpu_pool* pool)
 {
     int w = input_tensor->dims[3];
     int h = output_tensor->dims[2];
     int channels = input_tensor->dims[1];
-    int size = h * w;
-    int c_step = h * w;
 
-    float* input_data = input_tensor->data;
-    float* out_data = output_tensor->data;
+    struct clip_task_param param = {input_tensor->data, output_tensor->data, h * w, max, min};
+
+    cpu_pool_parallel_for(pool, clip_task, &param, channels);
 
-#pragma omp parallel for num_threads(num_thread)
-    for (int q = 0; q < channels; q++)
+    return 0;
+}
+
+static int ref_clip_uint8(struct ir_tensor* input_tensor, struct ir_tensor* output_tensor, float max, float min)
+{
+    uint8_t* input_data = input_tensor->data;
+    uint8_t* out_data = output_tensor->data;
+    float input_scale = input_tensor->scale;
+    float output_scale = output_tensor->scale;
+    int input_zero = input_tensor->zero_point;
+    int output_zero = output_tensor->zero_point;
+    uint8_t table[256];
+
+    for (int i = 0; i < 256; i++)
     {
-        float* src = input_data + c_step * q;
-        float* dst = out_data + c_step * q;
-
-        for (int i = 0; i < size; i++)
-        {
-            dst[i] = src[i];
-
-            if (dst[i] > max)
-                dst[i] = max;
-            if (dst[i] < min)
-                dst[i] = min;
-        }
+        float x = (i - input_zero) * input_scale;
+        if (x > max)
+            x = max;
+        if (x < min)
+            x = min;
+        int v = ( int )roundf(x / output_scale) + output_zero;
+        table[i] = v > 255 ? 255 : (v < 0 ? 0 : v);
     }
 
+    for (int i = 0; i < input_tensor->elem_num; i++)
+        out_data[i] = table[input_data[i]];
+
     return 0;
 }
 
@@ -94,7 +130,11 @@ static int run(struct node_ops* node_ops, struct exec_node* exec_node, struct ex
     float max = clip_param->max;
     float min = clip_param->min;
 
-    int ret = ref_clip_fp32(input_tensor, output_tensor, max, min, exec_graph->num_thread);
+    int ret;
+    if (input_tensor->data_type == TENGINE_DT_UINT8)
+        ret = ref_clip_uint8(input_tensor, output_tensor, max, min);
+    else
+        ret = ref_clip_fp32(input_tensor, output_tensor, max, min, exec_graph->cpu_pool);
     if (ret != 0)
         return -1;
 
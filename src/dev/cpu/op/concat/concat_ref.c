@@ -152,7 +152,8 @@ static int ref_concat_uint8(const uint8_t** in_data, uint8_t* out_data, const st
                 float t_scale = scale / out_scale;
                 for (int ii = 0; ii < cp_size; ++ii)
                 {
-                    output_ptr[ii] = round((input_ptr[ii] - input_zero) * t_scale) + out_zero;
+                    int data = round((input_ptr[ii] - input_zero) * t_scale) + out_zero;
+                    output_ptr[ii] = data > 255 ? 255 : (data < 0 ? 0 : data);
                 }
             }
             output_ptr += cp_size;
@@ -94,6 +94,9 @@ static int score(struct node_ops* node_ops, struct exec_graph* exec_graph, struc
     input_tensor = get_ir_graph_tensor(ir_graph, ir_node->input_tensors[0]);
     output_tensor = get_ir_graph_tensor(ir_graph, ir_node->output_tensors[0]);
 
+    if (input_tensor->data_type != TENGINE_DT_FP32)
+        return 0;
+
     int in_c = input_tensor->dims[1] / group;
     int out_c = output_tensor->dims[1] / group;
 
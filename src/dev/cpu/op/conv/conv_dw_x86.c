@@ -0,0 +1,170 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * License); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * AS IS BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*
+ * Copyright (c) 2020, OPEN AI LAB
+ * Author: haoluo@openailab.com
+ */
+#include "sys_port.h"
+#include "module.h"
+#include "tengine_errno.h"
+#include "tengine_log.h"
+#include "tengine_ir.h"
+#include "../../cpu_node_ops.h"
+#include "../../cpu_model.h"
+#include "tengine_op.h"
+#include "convolution_param.h"
+#include "x86/conv_dw_kernel_x86.h"
+
+static int prerun(struct node_ops* node_ops, struct exec_node* exec_node, struct exec_graph* exec_graph)
+{
+    struct ir_node* ir_node = exec_node->ir_node;
+    struct ir_graph* ir_graph = ir_node->graph;
+    struct ir_tensor* input_tensor = get_ir_graph_tensor(ir_graph, ir_node->input_tensors[0]);
+    struct ir_tensor* output_tensor = get_ir_graph_tensor(ir_graph, ir_node->output_tensors[0]);
+    struct conv_param* conv_param = ( struct conv_param* )ir_node->op.param_mem;
+    struct conv_dw_priv_info* conv_dw_priv_info = ( struct conv_dw_priv_info* )exec_node->ops_priv;
+
+    if (conv_dw_x86_prerun(input_tensor, output_tensor, conv_dw_priv_info, conv_param, exec_graph->num_thread) < 0)
+    {
+        TLOG_ERR("x86 conv dw prerun failed\n");
+        set_tengine_errno(ENOMEM);
+        return -1;
+    }
+
+    return 0;
+}
+
+static int run(struct node_ops* node_ops, struct exec_node* exec_node, struct exec_graph* exec_graph)
+{
+    struct ir_node* ir_node = exec_node->ir_node;
+    struct ir_graph* ir_graph = ir_node->graph;
+    struct ir_tensor* input_tensor;
+    struct ir_tensor* weight_tensor;
+    struct ir_tensor* bias_tensor = NULL;
+    struct ir_tensor* output_tensor = NULL;
+
+    /* set the input data and shape again, in case of reshape or dynamic shape */
+    input_tensor = get_ir_graph_tensor(ir_graph, ir_node->input_tensors[0]);
+    weight_tensor = get_ir_graph_tensor(ir_graph, ir_node->input_tensors[1]);
+    if (ir_node->input_num > 2)
+        bias_tensor = get_ir_graph_tensor(ir_graph, ir_node->input_tensors[2]);
+    output_tensor = get_ir_graph_tensor(ir_graph, ir_node->output_tensors[0]);
+
+    struct conv_param* conv_param = ( struct conv_param* )ir_node->op.param_mem;
+    struct conv_dw_priv_info* conv_dw_priv_info = ( struct conv_dw_priv_info* )exec_node->ops_priv;
+
+    if (conv_dw_x86_run(input_tensor, weight_tensor, bias_tensor, output_tensor, conv_dw_priv_info, conv_param,
+                        exec_graph->cpu_pool) < 0)
+    {
+        TLOG_ERR("x86 conv dw run failed\n");
+        set_tengine_errno(EFAULT);
+        return -1;
+    }
+
+    return 0;
+}
+
+static int postrun(struct node_ops* node_ops, struct exec_node* exec_node, struct exec_graph* exec_graph)
+{
+    struct conv_dw_priv_info* conv_dw_priv_info = ( struct conv_dw_priv_info* )exec_node->ops_priv;
+
+    return conv_dw_x86_postrun(conv_dw_priv_info);
+}
+
+/* the size of the pad buffer follows the input shape */
+static int reshape(struct node_ops* node_ops, struct exec_node* exec_node, struct exec_graph* exec_graph)
+{
+    postrun(node_ops, exec_node, exec_graph);
+
+    return prerun(node_ops, exec_node, exec_graph);
+}
+
+static int init_node(struct node_ops* node_ops, struct exec_node* exec_node, struct exec_graph* exec_graph)
+{
+    struct conv_dw_priv_info* conv_dw_priv_info =
+        ( struct conv_dw_priv_info* )sys_malloc(sizeof(struct conv_dw_priv_info));
+    if (conv_dw_priv_info == NULL)
+    {
+        set_tengine_errno(ENOMEM);
+        return -1;
+    }
+
+    memset(conv_dw_priv_info, 0, sizeof(struct conv_dw_priv_info));
+    exec_node->ops_priv = conv_dw_priv_info;
+
+    return 0;
+}
+
+static int release_node(struct node_ops* node_ops, struct exec_node* exec_node, struct exec_graph* exec_graph)
+{
+    sys_free(exec_node->ops_priv);
+    exec_node->ops_priv = NULL;
+
+    return 0;
+}
+
+static int score(struct node_ops* node_ops, struct exec_graph* exec_graph, struct ir_node* exec_node)
+{
+    struct conv_param* param = ( struct conv_param* )exec_node->op.param_mem;
+    struct ir_node* ir_node = exec_node;
+    struct ir_graph* ir_graph = ir_node->graph;
+
+    struct ir_tensor* input_tensor;
+    struct ir_tensor* output_tensor;
+
+    int group = param->group;
+
+    input_tensor = get_ir_graph_tensor(ir_graph, ir_node->input_tensors[0]);
+    output_tensor = get_ir_graph_tensor(ir_graph, ir_node->output_tensors[0]);
+
+    if (input_tensor->data_type != TENGINE_DT_FP32 || ir_graph->graph_layout != TENGINE_LAYOUT_NCHW)
+        return 0;
+
+    int in_c = input_tensor->dims[1] / group;
+    int out_c = output_tensor->dims[1] / group;
+
+    if (group > 1 && in_c == 1 && out_c == 1)
+        return OPS_SCORE_BEST * 2;
+    else
+        return 0;
+}
+
+static struct node_ops x86_node_ops = {.prerun = prerun,
+                                       .run = run,
+                                       .reshape = reshape,
+                                       .postrun = postrun,
+                                       .init_node = init_node,
+                                       .release_node = release_node,
+                                       .score = score,
+                                       .isa = CPU_ISA_AVX2 | CPU_ISA_FMA};
+
+static int reg_conv_dw_x86_ops(void* arg)
+{
+    return register_builtin_node_ops(OP_CONV, &x86_node_ops);
+}
+
+static int unreg_conv_dw_x86_ops(void* arg)
+{
+    unregister_builtin_node_ops(OP_CONV, &x86_node_ops);
+    return 0;
+}
+
+AUTO_REGISTER_OPS(reg_conv_dw_x86_ops);
+AUTO_UNREGISTER_OPS(unreg_conv_dw_x86_ops);
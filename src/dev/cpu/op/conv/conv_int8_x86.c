@@ -0,0 +1,206 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * License); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * AS IS BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*
+ * Copyright (c) 2020, OPEN AI LAB
+ * Author: haoluo@openailab.com
+ */
+#include "sys_port.h"
+#include "module.h"
+#include "tengine_errno.h"
+#include "tengine_log.h"
+#include "tengine_ir.h"
+#include "../../cpu_node_ops.h"
+#include "../../cpu_model.h"
+#include "tengine_op.h"
+#include "convolution_param.h"
+#include "x86/conv_int8_kernel_x86.h"
+
+static int prerun(struct node_ops* node_ops, struct exec_node* exec_node, struct exec_graph* exec_graph)
+{
+    struct ir_node* ir_node = exec_node->ir_node;
+    struct ir_graph* ir_graph = ir_node->graph;
+    struct ir_tensor* input_tensor;
+    struct ir_tensor* filter_tensor;
+    struct ir_tensor* bias_tensor = NULL;
+    struct ir_tensor* output_tensor;
+
+    struct conv_int8_priv_info* priv_info = ( struct conv_int8_priv_info* )exec_node->ops_priv;
+
+    if (exec_node->shared_mem_size <= exec_graph->shared_mem_size)
+    {
+        if (conv_int8_x86_set_shared_mem(priv_info, exec_graph->shared_mem, exec_node->shared_mem_size) < 0)
+        {
+            TLOG_ERR("x86 int8 conv: set shared memory failed\n");
+            set_tengine_errno(EFAULT);
+            return -1;
+        }
+    }
+
+    input_tensor = get_ir_graph_tensor(ir_graph, ir_node->input_tensors[0]);
+    filter_tensor = get_ir_graph_tensor(ir_graph, ir_node->input_tensors[1]);
+    if (ir_node->input_num > 2)
+        bias_tensor = get_ir_graph_tensor(ir_graph, ir_node->input_tensors[2]);
+    output_tensor = get_ir_graph_tensor(ir_graph, ir_node->output_tensors[0]);
+
+    struct conv_param* conv_param = ( struct conv_param* )ir_node->op.param_mem;
+
+    priv_info->cpu_pool = exec_graph->cpu_pool;
+
+    if (conv_int8_x86_prerun(input_tensor, filter_tensor, bias_tensor, output_tensor, priv_info, conv_param) < 0)
+    {
+        TLOG_ERR("x86 int8 conv prerun failed, the weight needs one scale or one per output channel\n");
+        set_tengine_errno(EFAULT);
+        return -1;
+    }
+
+    return 0;
+}
+
+static int run(struct node_ops* node_ops, struct exec_node* exec_node, struct exec_graph* exec_graph)
+{
+    struct ir_node* ir_node = exec_node->ir_node;
+    struct ir_graph* ir_graph = ir_node->graph;
+    struct ir_tensor* input_tensor = get_ir_graph_tensor(ir_graph, ir_node->input_tensors[0]);
+    struct ir_tensor* output_tensor = get_ir_graph_tensor(ir_graph, ir_node->output_tensors[0]);
+
+    struct conv_param* conv_param = ( struct conv_param* )ir_node->op.param_mem;
+    struct conv_int8_priv_info* priv_info = ( struct conv_int8_priv_info* )exec_node->ops_priv;
+
+    /* the shared memory is planned again on reshape */
+    if (priv_info->external_im2col_mem)
+        priv_info->im2col_buffer = exec_graph->shared_mem;
+
+    if (conv_int8_x86_run(input_tensor, output_tensor, priv_info, conv_param) < 0)
+    {
+        TLOG_ERR("x86 int8 conv run failed\n");
+        set_tengine_errno(EFAULT);
+        return -1;
+    }
+
+    return 0;
+}
+
+static int reshape(struct node_ops* node_ops, struct exec_node* exec_node, struct exec_graph* exec_graph)
+{
+    struct ir_node* ir_node = exec_node->ir_node;
+    struct ir_graph* ir_graph = ir_node->graph;
+    struct ir_tensor* input_tensor = get_ir_graph_tensor(ir_graph, ir_node->input_tensors[0]);
+    struct ir_tensor* output_tensor = get_ir_graph_tensor(ir_graph, ir_node->output_tensors[0]);
+
+    struct conv_param* conv_param = ( struct conv_param* )ir_node->op.param_mem;
+    struct conv_int8_priv_info* priv_info = ( struct conv_int8_priv_info* )exec_node->ops_priv;
+
+    exec_node->shared_mem_size = conv_int8_x86_get_shared_mem_size(input_tensor, output_tensor, conv_param);
+
+    if (conv_int8_x86_reshape(input_tensor, output_tensor, priv_info, conv_param) < 0)
+    {
+        TLOG_ERR("x86 int8 conv reshape failed\n");
+        set_tengine_errno(ENOMEM);
+        return -1;
+    }
+
+    return 0;
+}
+
+static int postrun(struct node_ops* node_ops, struct exec_node* exec_node, struct exec_graph* exec_graph)
+{
+    struct conv_int8_priv_info* priv_info = ( struct conv_int8_priv_info* )exec_node->ops_priv;
+
+    if (conv_int8_x86_postrun(priv_info) < 0)
+    {
+        TLOG_ERR("x86 int8 conv postrun failed\n");
+        set_tengine_errno(EFAULT);
+        return -1;
+    }
+
+    return 0;
+}
+
+static int init_node(struct node_ops* node_ops, struct exec_node* exec_node, struct exec_graph* exec_graph)
+{
+    struct ir_node* ir_node = exec_node->ir_node;
+    struct ir_graph* ir_graph = ir_node->graph;
+    struct ir_tensor* input_tensor = get_ir_graph_tensor(ir_graph, ir_node->input_tensors[0]);
+    struct ir_tensor* output_tensor = get_ir_graph_tensor(ir_graph, ir_node->output_tensors[0]);
+
+    struct conv_param* conv_param = ( struct conv_param* )ir_node->op.param_mem;
+    struct conv_int8_priv_info* priv_info =
+        ( struct conv_int8_priv_info* )sys_malloc(sizeof(struct conv_int8_priv_info));
+
+    if (priv_info == NULL)
+    {
+        set_tengine_errno(ENOMEM);
+        return -1;
+    }
+
+    memset(priv_info, 0, sizeof(struct conv_int8_priv_info));
+
+    exec_node->ops_priv = priv_info;
+    exec_node->shared_mem_size = conv_int8_x86_get_shared_mem_size(input_tensor, output_tensor, conv_param);
+
+    return 0;
+}
+
+static int release_node(struct node_ops* node_ops, struct exec_node* exec_node, struct exec_graph* exec_graph)
+{
+    struct conv_int8_priv_info* priv_info = ( struct conv_int8_priv_info* )exec_node->ops_priv;
+    sys_free(priv_info);
+    exec_node->ops_priv = NULL;
+
+    return 0;
+}
+
+static int score(struct node_ops* node_ops, struct exec_graph* exec_graph, struct ir_node* exec_node)
+{
+    struct ir_node* ir_node = exec_node;
+    struct ir_graph* ir_graph = ir_node->graph;
+    struct ir_tensor* input_tensor = get_ir_graph_tensor(ir_graph, ir_node->input_tensors[0]);
+    struct ir_tensor* filter_tensor = get_ir_graph_tensor(ir_graph, ir_node->input_tensors[1]);
+    struct ir_tensor* output_tensor = get_ir_graph_tensor(ir_graph, ir_node->output_tensors[0]);
+
+    if (input_tensor->data_type != TENGINE_DT_INT8 || filter_tensor->data_type != TENGINE_DT_INT8 ||
+        output_tensor->data_type != TENGINE_DT_INT8 || ir_graph->graph_layout != TENGINE_LAYOUT_NCHW)
+        return 0;
+
+    return OPS_SCORE_PREFER;
+}
+
+static struct node_ops x86_node_ops = {.prerun = prerun,
+                                       .run = run,
+                                       .reshape = reshape,
+                                       .postrun = postrun,
+                                       .init_node = init_node,
+                                       .release_node = release_node,
+                                       .score = score,
+                                       .isa = CPU_ISA_AVX2};
+
+static int reg_conv_int8_x86_ops(void* arg)
+{
+    return register_builtin_node_ops(OP_CONV, &x86_node_ops);
+}
+
+static int unreg_conv_int8_x86_ops(void* arg)
+{
+    unregister_builtin_node_ops(OP_CONV, &x86_node_ops);
+    return 0;
+}
+
+AUTO_REGISTER_OPS(reg_conv_int8_x86_ops);
+AUTO_UNREGISTER_OPS(unreg_conv_int8_x86_ops);
@@ -76,7 +76,6 @@ static int run(struct node_ops* node_ops, struct exec_node* exec_node, struct ex
     struct ir_tensor* weight_tensor;
     struct ir_tensor* bias_tensor = NULL;
     struct ir_tensor* output_tensor = NULL;
-    int num_thread = exec_graph->num_thread;
 
     input_tensor = get_ir_graph_tensor(ir_graph, ir_node->input_tensors[0]);
     weight_tensor = get_ir_graph_tensor(ir_graph, ir_node->input_tensors[1]);
@@ -89,8 +88,11 @@ static int run(struct node_ops* node_ops, struct exec_node* exec_node, struct ex
     struct conv_param* conv_param = ( struct conv_param* )ir_node->op.param_mem;
     struct conv_priv_info* conv_priv_info = ( struct conv_priv_info* )exec_node->ops_priv;
 
+    if (conv_priv_info->external_im2col_mem)
+        conv_priv_info->im2col_buffer = exec_graph->shared_mem;
+
     if (conv_kernel_run(input_tensor, weight_tensor, bias_tensor, output_tensor, conv_priv_info, conv_param,
-                        num_thread) < 0)
+                        exec_graph->cpu_pool) < 0)
     {
         TLOG_ERR("hcl conv run failed\n");
         set_tengine_errno(EFAULT);
@@ -214,6 +216,9 @@ static int reshape(struct node_ops* node_ops, struct exec_node* exec_node, struc
         }
     }
 
+    /* the im2col buffer is the shared memory, it is bound again at run */
+    exec_node->shared_mem_size = conv_kernel_get_shared_mem_size(input_tensor, output_tensor, conv_param);
+
     return ret;
 }
 
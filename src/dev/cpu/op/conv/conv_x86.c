@@ -0,0 +1,303 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * License); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * AS IS BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*
+ * Copyright (c) 2020, OPEN AI LAB
+ * Author: haoluo@openailab.com
+ */
+#include "sys_port.h"
+#include "module.h"
+#include "tengine_errno.h"
+#include "tengine_log.h"
+#include "tengine_ir.h"
+#include "../../cpu_node_ops.h"
+#include "../../cpu_model.h"
+#include "tengine_op.h"
+#include "convolution_param.h"
+#include "x86/conv_kernel_x86.h"
+
+/* the packed kernel depends on the weights, the isa and everything that selects the conv algorithm */
+static uint64_t get_pack_key(struct ir_tensor* input_tensor, struct ir_tensor* filter_tensor,
+                             struct conv_priv_info* priv_info, struct conv_param* param)
+{
+    int variant[16] = {priv_info->isa,         param->group,           param->kernel_h,        param->kernel_w,
+                       param->stride_h,        param->stride_w,        param->dilation_h,      param->dilation_w,
+                       param->pad_h0,          param->pad_w0,          input_tensor->dims[1],  input_tensor->dims[2],
+                       input_tensor->dims[3],  filter_tensor->dims[0], filter_tensor->dims[1], filter_tensor->elem_size};
+
+    uint64_t seed = get_pack_hash(variant, sizeof(variant), 0);
+
+    return get_pack_hash(filter_tensor->data, filter_tensor->elem_num * filter_tensor->elem_size, seed);
+}
+
+static int prerun(struct node_ops* node_ops, struct exec_node* exec_node, struct exec_graph* exec_graph)
+{
+    struct ir_node* ir_node = exec_node->ir_node;
+    struct ir_graph* ir_graph = ir_node->graph;
+    struct ir_tensor* input_tensor;
+    struct ir_tensor* filter_tensor;
+    struct ir_tensor* output_tensor;
+
+    struct conv_priv_info* conv_priv_info = ( struct conv_priv_info* )exec_node->ops_priv;
+
+    if (conv_x86_set_shared_mem && exec_node->shared_mem_size <= exec_graph->shared_mem_size)
+    {
+        if (conv_x86_set_shared_mem(conv_priv_info, exec_graph->shared_mem, exec_node->shared_mem_size) < 0)
+        {
+            TLOG_ERR("x86 conv: set shared memory failed\n");
+            set_tengine_errno(EFAULT);
+            return -1;
+        }
+    }
+
+    input_tensor = get_ir_graph_tensor(ir_graph, ir_node->input_tensors[0]);
+    filter_tensor = get_ir_graph_tensor(ir_graph, ir_node->input_tensors[1]);
+    output_tensor = get_ir_graph_tensor(ir_graph, ir_node->output_tensors[0]);
+
+    struct conv_param* conv_param = ( struct conv_param* )ir_node->op.param_mem;
+
+    // get cpu affinity
+    conv_priv_info->cpu_type = exec_graph->cpu_affinity;
+    conv_priv_info->num_thread = exec_graph->num_thread;
+    conv_priv_info->cpu_pool = exec_graph->cpu_pool;
+
+    /* take the packed kernel from another instance of the graph, or from the cache if an earlier run saved it */
+    uint64_t pack_key = 0;
+    int shared = is_ir_graph_shared(ir_graph);
+
+    if ((exec_graph->pack_cache || shared) && !conv_priv_info->external_interleave_mem)
+    {
+        int size = 0;
+        const void* packed = NULL;
+
+        pack_key = get_pack_key(input_tensor, filter_tensor, conv_priv_info, conv_param);
+
+        if (shared)
+            packed = get_shared_pack(pack_key, &size);
+
+        if (packed == NULL && exec_graph->pack_cache)
+            packed = find_pack_cache(exec_graph->pack_cache, pack_key, &size);
+
+        if (packed != NULL)
+        {
+            conv_priv_info->interleave_buffer = ( void* )packed;
+            conv_priv_info->interleave_buffer_size = size;
+            conv_priv_info->external_interleave_mem = 1;
+            conv_priv_info->interleave_packed = 1;
+        }
+    }
+
+    /* prerun now */
+    if (conv_x86_prerun(input_tensor, filter_tensor, output_tensor, conv_priv_info, conv_param) < 0)
+    {
+        TLOG_ERR("x86 conv prerun failed\n");
+        set_tengine_errno(EFAULT);
+        return -1;
+    }
+
+    int packed_now = !conv_priv_info->interleave_packed && !conv_priv_info->external_interleave_mem;
+
+    if (packed_now && shared)
+    {
+        const void* packed = add_shared_pack(pack_key, conv_priv_info->interleave_buffer,
+                                             conv_priv_info->interleave_buffer_size);
+
+        if (packed != NULL)
+        {
+            conv_priv_info->interleave_buffer = ( void* )packed;
+            conv_priv_info->external_interleave_mem = 1;
+        }
+    }
+
+    if (packed_now && exec_graph->pack_cache)
+        add_pack_cache(exec_graph->pack_cache, pack_key, conv_priv_info->interleave_buffer,
+                       conv_priv_info->interleave_buffer_size);
+
+    return 0;
+}
+
+static int run(struct node_ops* node_ops, struct exec_node* exec_node, struct exec_graph* exec_graph)
+{
+    struct ir_node* ir_node = exec_node->ir_node;
+    struct ir_graph* ir_graph = ir_node->graph;
+    struct ir_tensor* input_tensor;
+    struct ir_tensor* weight_tensor;
+    struct ir_tensor* bias_tensor = NULL;
+    struct ir_tensor* output_tensor = NULL;
+    int num_thread = exec_graph->num_thread;
+    int cpu_affinity = exec_graph->cpu_affinity;
+
+    /* set the input data and shape again, in case of reshape or dynamic shape */
+    input_tensor = get_ir_graph_tensor(ir_graph, ir_node->input_tensors[0]);
+    weight_tensor = get_ir_graph_tensor(ir_graph, ir_node->input_tensors[1]);
+    if (ir_node->input_num > 2)
+        bias_tensor = get_ir_graph_tensor(ir_graph, ir_node->input_tensors[2]);
+    output_tensor = get_ir_graph_tensor(ir_graph, ir_node->output_tensors[0]);
+
+    struct conv_param* conv_param = ( struct conv_param* )ir_node->op.param_mem;
+    struct conv_priv_info* conv_priv_info = ( struct conv_priv_info* )exec_node->ops_priv;
+
+    /* the shared memory moves when the graph is reshaped */
+    if (conv_priv_info->external_im2col_mem)
+        conv_priv_info->im2col_buffer = exec_graph->shared_mem;
+
+    if (conv_x86_run(input_tensor, weight_tensor, bias_tensor, output_tensor, conv_priv_info, conv_param, num_thread,
+                     cpu_affinity) < 0)
+    {
+        TLOG_ERR("x86 conv run failed\n");
+        set_tengine_errno(EFAULT);
+        return -1;
+    }
+
+    return 0;
+}
+
+static int reshape(struct node_ops* node_ops, struct exec_node* exec_node, struct exec_graph* exec_graph)
+{
+    struct ir_node* ir_node = exec_node->ir_node;
+    struct ir_graph* ir_graph = ir_node->graph;
+    struct ir_tensor* input_tensor;
+    struct ir_tensor* filter_tensor;
+    struct ir_tensor* output_tensor;
+
+    input_tensor = get_ir_graph_tensor(ir_graph, ir_node->input_tensors[0]);
+    filter_tensor = get_ir_graph_tensor(ir_graph, ir_node->input_tensors[1]);
+    output_tensor = get_ir_graph_tensor(ir_graph, ir_node->output_tensors[0]);
+
+    struct conv_param* conv_param = ( struct conv_param* )ir_node->op.param_mem;
+    struct conv_priv_info* conv_priv_info = ( struct conv_priv_info* )exec_node->ops_priv;
+
+    exec_node->shared_mem_size = conv_x86_get_shared_mem_size(input_tensor, output_tensor, conv_param);
+
+    if (conv_x86_reshape(input_tensor, filter_tensor, output_tensor, conv_priv_info, conv_param) < 0)
+    {
+        TLOG_ERR("x86 conv reshape failed\n");
+        set_tengine_errno(EFAULT);
+        return -1;
+    }
+
+    return 0;
+}
+
+static int postrun(struct node_ops* node_ops, struct exec_node* exec_node, struct exec_graph* exec_graph)
+{
+    struct conv_priv_info* conv_priv_info = ( struct conv_priv_info* )exec_node->ops_priv;
+
+    /* the kernels shared with the other instances are not freed by the kernel postrun */
+    if (conv_priv_info->external_interleave_mem && put_shared_pack(conv_priv_info->interleave_buffer) == 0)
+        conv_priv_info->interleave_buffer = NULL;
+
+    if (conv_priv_info->standby_external && put_shared_pack(conv_priv_info->standby_buffer) == 0)
+        conv_priv_info->standby_buffer = NULL;
+
+    if (conv_x86_postrun(conv_priv_info) < 0)
+    {
+        TLOG_ERR("x86 conv postrun failed\n");
+        set_tengine_errno(EFAULT);
+        return -1;
+    }
+    return 0;
+}
+
+static int init_node(struct node_ops* node_ops, struct exec_node* exec_node, struct exec_graph* exec_graph)
+{
+    struct ir_node* ir_node = exec_node->ir_node;
+    struct ir_graph* ir_graph = ir_node->graph;
+    struct ir_tensor* input_tensor;
+    struct ir_tensor* output_tensor;
+
+    input_tensor = get_ir_graph_tensor(ir_graph, ir_node->input_tensors[0]);
+    output_tensor = get_ir_graph_tensor(ir_graph, ir_node->output_tensors[0]);
+
+    struct conv_param* conv_param = ( struct conv_param* )ir_node->op.param_mem;
+    struct conv_priv_info* conv_priv_info = ( struct conv_priv_info* )sys_malloc(sizeof(struct conv_priv_info));
+    if (conv_priv_info == NULL)
+    {
+        set_tengine_errno(ENOMEM);
+        return -1;
+    }
+
+    memset(conv_priv_info, 0, sizeof(struct conv_priv_info));
+
+    /* the kernel variant follows the isa of the selected node ops */
+    conv_priv_info->isa = node_ops->isa;
+
+    /* get shared memory size */
+    exec_node->ops_priv = conv_priv_info;
+    exec_node->shared_mem_size = conv_x86_get_shared_mem_size(input_tensor, output_tensor, conv_param);
+
+    return 0;
+}
+
+static int release_node(struct node_ops* node_ops, struct exec_node* exec_node, struct exec_graph* exec_graph)
+{
+    struct conv_priv_info* conv_priv_info = ( struct conv_priv_info* )exec_node->ops_priv;
+    sys_free(conv_priv_info);
+    exec_node->ops_priv = NULL;
+
+    return 0;
+}
+
+static int score(struct node_ops* node_ops, struct exec_graph* exec_graph, struct ir_node* exec_node)
+{
+    struct ir_node* ir_node = exec_node;
+    struct ir_graph* ir_graph = ir_node->graph;
+    struct ir_tensor* input_tensor = get_ir_graph_tensor(ir_graph, ir_node->input_tensors[0]);
+
+    if (input_tensor->data_type != TENGINE_DT_FP32 || ir_graph->graph_layout != TENGINE_LAYOUT_NCHW)
+        return 0;
+
+    return OPS_SCORE_PREFER;
+}
+
+static struct node_ops x86_node_ops = {.prerun = prerun,
+                                       .run = run,
+                                       .reshape = reshape,
+                                       .postrun = postrun,
+                                       .init_node = init_node,
+                                       .release_node = release_node,
+                                       .score = score,
+                                       .isa = CPU_ISA_AVX2 | CPU_ISA_FMA};
+
+static struct node_ops x86_avx512_node_ops = {.prerun = prerun,
+                                              .run = run,
+                                              .reshape = reshape,
+                                              .postrun = postrun,
+                                              .init_node = init_node,
+                                              .release_node = release_node,
+                                              .score = score,
+                                              .isa = CPU_ISA_AVX512F | CPU_ISA_AVX2 | CPU_ISA_FMA};
+
+static int reg_conv_x86_ops(void* arg)
+{
+    if (register_builtin_node_ops(OP_CONV, &x86_node_ops) < 0)
+        return -1;
+
+    return register_builtin_node_ops(OP_CONV, &x86_avx512_node_ops);
+}
+
+static int unreg_conv_x86_ops(void* arg)
+{
+    unregister_builtin_node_ops(OP_CONV, &x86_node_ops);
+    unregister_builtin_node_ops(OP_CONV, &x86_avx512_node_ops);
+    return 0;
+}
+
+AUTO_REGISTER_OPS(reg_conv_x86_ops);
+AUTO_UNREGISTER_OPS(unreg_conv_x86_ops);
@@ -1,6 +1,7 @@
 #include <stdint.h>
 #include <stdlib.h>
 #include <math.h>
+#include "../../../cpu_pool.h"
 #include "conv_kernel_ref.h"
 
 #include <sys/time.h>
@@ -40,10 +41,11 @@ static inline void copy_one_element(void* src, void* dst, int src_off, int dst_o
             int_dst[dst_off] = int_src[src_off];
         }
         break;
+        /* uint8 is widened to int16 with the zero point taken off */
         case 1: {
-            int8_t* int_dst = dst;
+            int16_t* int_dst = dst;
             uint8_t* int_src = src;
-            int_dst[dst_off] = (int8_t)(( int )int_src[src_off] - ( int )input_zero);
+            int_dst[dst_off] = ( int16_t )(( int )int_src[src_off] - input_zero);
         }
         break;
     }
@@ -64,7 +66,7 @@ static inline void zero_one_element(void* dst, int dst_off, int elem_size)
         }
         break;
         case 1: {
-            int8_t* int_dst = dst;
+            int16_t* int_dst = dst;
             int_dst[dst_off] = 0x0;
         }
         break;
@@ -126,9 +128,41 @@ static void im2col(struct ir_tensor* input, struct ir_tensor* output, struct con
               input->elem_size, input_zero);
 }
 
+struct sgemm_fp32_param
+{
+    float* interleave;
+    float* im2col;
+    float* output;
+    int kernel_size;
+    int out_hw;
+};
+
+/* one output channel of the group */
+static void sgemm_fp32_task(void* arg, int i)
+{
+    struct sgemm_fp32_param* p = ( struct sgemm_fp32_param* )arg;
+    int kernel_size = p->kernel_size;
+    float* kernel = p->interleave + i * kernel_size;
+    float* input = p->im2col;
+    float* output = p->output + i * p->out_hw;
+
+    for (int j = 0; j < p->out_hw; j++)
+    {
+        int im2col_off = j * kernel_size;
+
+        float sum = 0.f;
+        for (int k = 0; k < kernel_size; k++)
+        {
+            sum += kernel[k] * input[im2col_off + k];
+        }
+        output[0] = sum;
+        output++;
+    }
+}
+
 static void sgemm_fp32(struct ir_tensor* input, struct ir_tensor* filter, struct ir_tensor* bias,
                        struct ir_tensor* output, struct conv_priv_info* priv_info, struct conv_param* param, int n,
-                       int group, int num_thread)
+                       int group, struct cpu_pool* pool)
 {
     int kernel_size = param->kernel_h * param->kernel_w * param->input_channel / param->group;
     int outchan_g = param->output_channel / param->group;
@@ -145,26 +179,9 @@ static void sgemm_fp32(struct ir_tensor* input, struct ir_tensor* filter, struct
     if (bias)
         bias_fp32 = ( float* )bias->data + outchan_g * group;
 
-    #pragma omp parallel for num_threads(num_thread)
-    for(int i = 0; i < outchan_g; i++)
-    {
-        float* kernel = interleave_fp32 + i * kernel_size;
-        float* input = im2col_fp32;
-        float* output = output_fp32 + i * (out_h * out_w);
+    struct sgemm_fp32_param sgemm_param = {interleave_fp32, im2col_fp32, output_fp32, kernel_size, out_h * out_w};
 
-        for (int j = 0; j < out_h * out_w; j++)
-        {
-            int im2col_off = j * kernel_size;
-
-            float sum = 0.f;
-            for (int k = 0; k < kernel_size; k++)
-            {
-                sum += kernel[k] * input[im2col_off + k];
-            }
-            output[0] = sum;
-            output++;
-        }
-    }
+    cpu_pool_parallel_for(pool, sgemm_fp32_task, &sgemm_param, outchan_g);
 
     // process bias
     if (bias)
@@ -214,7 +231,7 @@ static void sgemm_fp32(struct ir_tensor* input, struct ir_tensor* filter, struct
 
 static void sgemm_uint8(struct ir_tensor* input_tensor, struct ir_tensor* filter_tensor, struct ir_tensor* bias_tensor,
                         struct ir_tensor* output_tensor, struct conv_priv_info* priv_info, struct conv_param* param,
-                        int n, int group, int num_thread)
+                        int n, int group, struct cpu_pool* pool)
 {
     int kernel_size = param->kernel_h * param->kernel_w * param->input_channel / param->group;
     int outchan_g = param->output_channel / param->group;
@@ -225,55 +242,48 @@ static void sgemm_uint8(struct ir_tensor* input_tensor, struct ir_tensor* filter
 
     /* data point */
     unsigned char* interleave_uint8 = ( unsigned char* )priv_info->interleave_buffer + outchan_g * group * kernel_size;
-    signed char* im2col_int8 = priv_info->im2col_buffer;
+    int16_t* im2col_int16 = priv_info->im2col_buffer;
     unsigned char* output_uint8 =
         ( unsigned char* )output_tensor->data + n * out_image_size + outchan_g * group * out_h * out_w;
     int* bias_int32 = NULL;
     if (bias_tensor)
         bias_int32 = ( int* )bias_tensor->data + outchan_g * group;
 
-    /* quantizaion scale and zero-point */
+    /* quantizaion scale and zero-point, the weight scale may be per output channel */
     float input_scale = input_tensor->scale;
-    float weight_scale = filter_tensor->scale;
     float output_scale = output_tensor->scale;
-    float bias_scale = 0.f;
-    if (bias_tensor)
-        bias_scale = bias_tensor->scale;
 
-    unsigned char input_zero = input_tensor->zero_point;
-    unsigned char weight_zero = filter_tensor->zero_point;
-    unsigned char output_zero = output_tensor->zero_point;
+    int weight_zero = filter_tensor->zero_point;
+    int output_zero = output_tensor->zero_point;
+
+    if (filter_tensor->quant_param_num > 1)
+        weight_zero = filter_tensor->zp_list[0];
 
     /* int8 sgemm */
     //    #pragma omp parallel for num_threads(num_thread)
     for (int i = 0; i < outchan_g; i++)
     {
         unsigned char* kernel = interleave_uint8 + i * kernel_size;
-        signed char* input = im2col_int8;
+        int16_t* input = im2col_int16;
         unsigned char* output = output_uint8 + i * (out_h * out_w);
 
+        float weight_scale = filter_tensor->scale;
+        if (filter_tensor->quant_param_num > 1)
+            weight_scale = filter_tensor->scale_list[outchan_g * group + i];
+
         for (int j = 0; j < out_h * out_w; j++)
         {
             int im2col_off = j * kernel_size;
             int sum_int32 = bias_tensor ? bias_int32[i] : 0;
 
             for (int k = 0; k < kernel_size; k++)
-            {
-                int input_data = input[im2col_off + k];
-                int input_data_u32 = ( unsigned char )input[im2col_off + k];
-                int kernel_data = kernel[k] - weight_zero;
-
-                if (input_zero == 0)
-                    sum_int32 += input_data_u32 * kernel_data;
-                else
-                    sum_int32 += input_data * kernel_data;
-            }
+                sum_int32 += input[im2col_off + k] * (kernel[k] - weight_zero);
 
             // dequant sum from int32 to fp32
             float sum_fp32 = sum_int32 * input_scale * weight_scale;
 
             // relu
-            if (param->activation > 0)
+            if (param->activation == 0)
             {
                 if (sum_fp32 < 0)
                     sum_fp32 = 0;
@@ -299,7 +309,6 @@ static void sgemm_uint8(struct ir_tensor* input_tensor, struct ir_tensor* filter
         }
     }
 }
-#if 0
 int conv_kernel_get_shared_mem_size(struct ir_tensor* input, struct ir_tensor* output, struct conv_param* param)
 {
     int group = param->group;
@@ -308,6 +317,10 @@ int conv_kernel_get_shared_mem_size(struct ir_tensor* input, struct ir_tensor* o
     int output_xy = output->dims[2] * output->dims[3];
     int elem_size = input->elem_size;
 
+    /* uint8 is unpacked to int16 */
+    if (input->data_type == TENGINE_DT_UINT8)
+        elem_size = 2;
+
     return elem_size * output_xy * kernel_size;
 }
 
@@ -354,7 +367,7 @@ int conv_kernel_postrun(struct conv_priv_info* priv_info)
 
 int conv_kernel_run(struct ir_tensor* input_tensor, struct ir_tensor* filter_tensor, struct ir_tensor* bias_tensor,
                     struct ir_tensor* output_tensor, struct conv_priv_info* priv_info, struct conv_param* param,
-                    int num_thread)
+                    struct cpu_pool* pool)
 {
     int group = param->group;
     int type = input_tensor->data_type;
@@ -365,10 +378,9 @@ int conv_kernel_run(struct ir_tensor* input_tensor, struct ir_tensor* filter_ten
         {
             im2col(input_tensor, output_tensor, priv_info, param, i, j);
             if (type == TENGINE_DT_FP32)
-                sgemm_fp32(input_tensor, filter_tensor, bias_tensor, output_tensor, priv_info, param, i, j, num_thread);
+                sgemm_fp32(input_tensor, filter_tensor, bias_tensor, output_tensor, priv_info, param, i, j, pool);
             else
-                sgemm_uint8(input_tensor, filter_tensor, bias_tensor, output_tensor, priv_info, param, i, j,
-                            num_thread);
+                sgemm_uint8(input_tensor, filter_tensor, bias_tensor, output_tensor, priv_info, param, i, j, pool);
         }
     }
 
@@ -382,4 +394,3 @@ int conv_kernel_set_shared_mem(struct conv_priv_info* priv_info, void* mem, int
     priv_info->im2col_buffer_size = mem_size;
     return 0;
 }
-#endif
\ No newline at end of file
@@ -4,6 +4,8 @@
 #include "tengine_ir.h"
 #include "convolution_param.h"
 
+struct cpu_pool;
+
 struct conv_priv_info
 {
     void* interleave_buffer;
@@ -23,7 +25,7 @@ int conv_kernel_postrun(struct conv_priv_info* info) __attribute__((weak));
 
 int conv_kernel_run(struct ir_tensor* input_tensor, struct ir_tensor* filter_tensor, struct ir_tensor* bias_tensor,
                     struct ir_tensor* output_tensor, struct conv_priv_info* conv_info, struct conv_param* param,
-                    int num_thread) __attribute__((weak));
+                    struct cpu_pool* pool) __attribute__((weak));
 
 int conv_kernel_get_shared_mem_size(struct ir_tensor* input_tensor, struct ir_tensor* output_tensor,
                                     struct conv_param* param) __attribute__((weak));
@@ -0,0 +1,456 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * License); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * AS IS BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*
+ * Copyright (c) 2020, OPEN AI LAB
+ * Author: haoluo@openailab.com
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <immintrin.h>
+
+#include "sys_port.h"
+#include "../../../cpu_pool.h"
+#include "conv_dw_kernel_x86.h"
+
+typedef void (*dw_channel_t)(const float* input, int in_w, const float* kernel, float* output, int out_h, int out_w,
+                             float bias, int activation, int dilation_h, int dilation_w);
+
+static inline float elem_activation(float data, int activation)
+{
+    if (activation >= 0)
+    {
+        if (data < 0.f)
+            data = 0.f;
+        if (activation > 0 && data > 6.f)
+            data = 6.f;
+    }
+
+    return data;
+}
+
+static inline __m256 vector_activation(__m256 data, int activation)
+{
+    if (activation >= 0)
+    {
+        data = _mm256_max_ps(data, _mm256_setzero_ps());
+        if (activation > 0)
+            data = _mm256_min_ps(data, _mm256_set1_ps(6.f));
+    }
+
+    return data;
+}
+
+/* load 8 floats from p[0], p[2], ..., p[14], without touching p[15] */
+static inline __m256 load_stride2(const float* p)
+{
+    __m256 lo = _mm256_loadu_ps(p);
+    __m256 hi = _mm256_loadu_ps(p + 7);
+    __m256 even = _mm256_shuffle_ps(lo, hi, 0xd8);
+
+    return _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(even), 0xd8));
+}
+
+static inline __m256 load_strided(const float* p, const int stride)
+{
+    if (stride == 1)
+        return _mm256_loadu_ps(p);
+    else
+        return load_stride2(p);
+}
+
+static inline __m256i lane_mask(int n)
+{
+    return _mm256_cmpgt_epi32(_mm256_set1_epi32(n), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+}
+
+/* same as load_strided, only the first n results are valid and nothing beyond them is read */
+static inline __m256 load_strided_mask(const float* p, const int stride, __m256i mask_lo, __m256i mask_hi)
+{
+    if (stride == 1)
+        return _mm256_maskload_ps(p, mask_lo);
+
+    __m256 lo = _mm256_maskload_ps(p, mask_lo);
+    __m256 hi = _mm256_maskload_ps(p + 7, mask_hi);
+    __m256 even = _mm256_shuffle_ps(lo, hi, 0xd8);
+
+    return _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(even), 0xd8));
+}
+
+/*
+ * one channel of depthwise convolution on an already padded input. kernel and stride are
+ * compile-time constants in the wrappers below, so the tap loops are fully unrolled; four
+ * accumulators of 8 outputs are kept in flight to hide the fma latency.
+ */
+static inline __attribute__((always_inline)) void dw_channel(const float* input, int in_w, const float* kernel,
+                                                             float* output, int out_h, int out_w, float bias,
+                                                             int activation, const int kernel_h, const int kernel_w,
+                                                             const int stride_h, const int stride_w, int dilation_h,
+                                                             int dilation_w)
+{
+    /* input columns read by a block of 8 outputs */
+    int vec_extent = (stride_w == 1 ? 8 : 15) + (kernel_w - 1) * dilation_w;
+    int vec_end = 0;
+    int vec_tail = -1;
+    if (stride_w <= 2)
+    {
+        while (vec_end + 8 <= out_w && vec_end * stride_w + vec_extent <= in_w)
+            vec_end += 8;
+
+        /* the remaining outputs are covered by one more block overlapping the previous one */
+        if (vec_end < out_w && out_w >= 8 && (out_w - 8) * stride_w + vec_extent <= in_w)
+            vec_tail = out_w - 8;
+    }
+
+    __m256 _bias = _mm256_set1_ps(bias);
+
+    for (int y = 0; y < out_h; y++)
+    {
+        const float* in_row = input + y * stride_h * in_w;
+        float* out_row = output + y * out_w;
+        int x = 0;
+
+        for (; x + 32 <= vec_end; x += 32)
+        {
+            __m256 acc0 = _bias;
+            __m256 acc1 = _bias;
+            __m256 acc2 = _bias;
+            __m256 acc3 = _bias;
+            for (int i = 0; i < kernel_h; i++)
+            {
+                const float* row = in_row + i * dilation_h * in_w + x * stride_w;
+                for (int j = 0; j < kernel_w; j++)
+                {
+                    const float* p = row + j * dilation_w;
+                    __m256 k = _mm256_set1_ps(kernel[i * kernel_w + j]);
+                    acc0 = _mm256_fmadd_ps(k, load_strided(p, stride_w), acc0);
+                    acc1 = _mm256_fmadd_ps(k, load_strided(p + 8 * stride_w, stride_w), acc1);
+                    acc2 = _mm256_fmadd_ps(k, load_strided(p + 16 * stride_w, stride_w), acc2);
+                    acc3 = _mm256_fmadd_ps(k, load_strided(p + 24 * stride_w, stride_w), acc3);
+                }
+            }
+            _mm256_storeu_ps(out_row + x, vector_activation(acc0, activation));
+            _mm256_storeu_ps(out_row + x + 8, vector_activation(acc1, activation));
+            _mm256_storeu_ps(out_row + x + 16, vector_activation(acc2, activation));
+            _mm256_storeu_ps(out_row + x + 24, vector_activation(acc3, activation));
+        }
+
+        for (; x + 8 <= vec_end; x += 8)
+        {
+            __m256 acc = _bias;
+            for (int i = 0; i < kernel_h; i++)
+            {
+                const float* row = in_row + i * dilation_h * in_w + x * stride_w;
+                for (int j = 0; j < kernel_w; j++)
+                    acc = _mm256_fmadd_ps(_mm256_set1_ps(kernel[i * kernel_w + j]),
+                                          load_strided(row + j * dilation_w, stride_w), acc);
+            }
+            _mm256_storeu_ps(out_row + x, vector_activation(acc, activation));
+        }
+
+        if (vec_tail >= 0)
+        {
+            __m256 acc = _bias;
+            for (int i = 0; i < kernel_h; i++)
+            {
+                const float* row = in_row + i * dilation_h * in_w + vec_tail * stride_w;
+                for (int j = 0; j < kernel_w; j++)
+                    acc = _mm256_fmadd_ps(_mm256_set1_ps(kernel[i * kernel_w + j]),
+                                          load_strided(row + j * dilation_w, stride_w), acc);
+            }
+            _mm256_storeu_ps(out_row + vec_tail, vector_activation(acc, activation));
+            x = out_w;
+        }
+
+        /* narrow rows, the leftover outputs are done with masked loads and stores */
+        for (; stride_w <= 2 && x < out_w; x += 8)
+        {
+            int n = out_w - x < 8 ? out_w - x : 8;
+            __m256i mask_out = lane_mask(n);
+            __m256i mask_lo = stride_w == 1 ? mask_out : lane_mask(2 * n - 1);
+            __m256i mask_hi = lane_mask(2 * n - 8);
+            __m256 acc = _bias;
+            for (int i = 0; i < kernel_h; i++)
+            {
+                const float* row = in_row + i * dilation_h * in_w + x * stride_w;
+                for (int j = 0; j < kernel_w; j++)
+                    acc = _mm256_fmadd_ps(_mm256_set1_ps(kernel[i * kernel_w + j]),
+                                          load_strided_mask(row + j * dilation_w, stride_w, mask_lo, mask_hi), acc);
+            }
+            _mm256_maskstore_ps(out_row + x, mask_out, vector_activation(acc, activation));
+        }
+
+        for (; x < out_w; x++)
+        {
+            float acc = bias;
+            for (int i = 0; i < kernel_h; i++)
+            {
+                const float* row = in_row + i * dilation_h * in_w + x * stride_w;
+                for (int j = 0; j < kernel_w; j++)
+                    acc += kernel[i * kernel_w + j] * row[j * dilation_w];
+            }
+            out_row[x] = elem_activation(acc, activation);
+        }
+    }
+}
+
+#define DW_CHANNEL_KERNEL(K, S)                                                                                   \
+    static void dw_k##K##s##S(const float* input, int in_w, const float* kernel, float* output, int out_h,         \
+                              int out_w, float bias, int activation, int dilation_h, int dilation_w)              \
+    {                                                                                                             \
+        dw_channel(input, in_w, kernel, output, out_h, out_w, bias, activation, K, K, S, S, dilation_h,           \
+                   dilation_w);                                                                                   \
+    }
+
+DW_CHANNEL_KERNEL(3, 1)
+DW_CHANNEL_KERNEL(3, 2)
+DW_CHANNEL_KERNEL(5, 1)
+DW_CHANNEL_KERNEL(5, 2)
+DW_CHANNEL_KERNEL(7, 1)
+DW_CHANNEL_KERNEL(7, 2)
+
+static void dw_generic(const float* input, int in_w, const float* kernel, float* output, int out_h, int out_w,
+                       float bias, int activation, int kernel_h, int kernel_w, int stride_h, int stride_w,
+                       int dilation_h, int dilation_w)
+{
+    if (stride_w == 1)
+        dw_channel(input, in_w, kernel, output, out_h, out_w, bias, activation, kernel_h, kernel_w, stride_h, 1,
+                   dilation_h, dilation_w);
+    else if (stride_w == 2)
+        dw_channel(input, in_w, kernel, output, out_h, out_w, bias, activation, kernel_h, kernel_w, stride_h, 2,
+                   dilation_h, dilation_w);
+    else
+        dw_channel(input, in_w, kernel, output, out_h, out_w, bias, activation, kernel_h, kernel_w, stride_h,
+                   stride_w, dilation_h, dilation_w);
+}
+
+static dw_channel_t get_dw_kernel(int kernel_h, int kernel_w, int stride_h, int stride_w)
+{
+    if (kernel_h != kernel_w || stride_h != stride_w)
+        return NULL;
+
+    if (kernel_h == 3 && stride_h == 1)
+        return dw_k3s1;
+    if (kernel_h == 3 && stride_h == 2)
+        return dw_k3s2;
+    if (kernel_h == 5 && stride_h == 1)
+        return dw_k5s1;
+    if (kernel_h == 5 && stride_h == 2)
+        return dw_k5s2;
+    if (kernel_h == 7 && stride_h == 1)
+        return dw_k7s1;
+    if (kernel_h == 7 && stride_h == 2)
+        return dw_k7s2;
+
+    return NULL;
+}
+
+/* copy one channel into the interior of a zero bordered buffer */
+static void pad_channel(const float* input, int in_h, int in_w, float* output, int out_h, int out_w, int pad_h,
+                        int pad_w)
+{
+    int copy_h = in_h < out_h - pad_h ? in_h : out_h - pad_h;
+    int copy_w = in_w < out_w - pad_w ? in_w : out_w - pad_w;
+
+    if (copy_w <= 0)
+        return;
+
+    for (int h = 0; h < copy_h; h++)
+        memcpy(output + (h + pad_h) * out_w + pad_w, input + h * in_w, copy_w * sizeof(float));
+}
+
+/* the floats of the zero bordered copy of one channel, 0 if the outputs read the input in place */
+static int get_pad_size(struct ir_tensor* input_tensor, struct ir_tensor* output_tensor, struct conv_param* param)
+{
+    int in_h = input_tensor->dims[2];
+    int in_w = input_tensor->dims[3];
+    int out_h = output_tensor->dims[2];
+    int out_w = output_tensor->dims[3];
+
+    /* the extent of the input actually read by the outputs, padding included */
+    int pad_in_h = (out_h - 1) * param->stride_h + (param->kernel_h - 1) * param->dilation_h + 1;
+    int pad_in_w = (out_w - 1) * param->stride_w + (param->kernel_w - 1) * param->dilation_w + 1;
+
+    if (param->pad_h0 > 0 || param->pad_w0 > 0 || pad_in_h > in_h || pad_in_w > in_w)
+        return pad_in_h * pad_in_w;
+
+    return 0;
+}
+
+static int get_dw_thread_num(int num_thread, int group)
+{
+    if (num_thread > group)
+        num_thread = group;
+    if (num_thread < 1)
+        num_thread = 1;
+
+    return num_thread;
+}
+
+int conv_dw_x86_prerun(struct ir_tensor* input_tensor, struct ir_tensor* output_tensor, struct conv_dw_priv_info* info,
+                       struct conv_param* param, int num_thread)
+{
+    int pad_size = get_pad_size(input_tensor, output_tensor, param);
+    int buf_size = sizeof(float) * pad_size * get_dw_thread_num(num_thread, param->group);
+
+    info->pad_buf = NULL;
+    info->pad_buf_size = 0;
+
+    if (buf_size == 0)
+        return 0;
+
+    info->pad_buf = ( float* )sys_malloc(buf_size);
+
+    if (info->pad_buf == NULL)
+        return -1;
+
+    /* only the interior is written by the runs, the border stays zero */
+    memset(info->pad_buf, 0, buf_size);
+    info->pad_buf_size = buf_size;
+
+    return 0;
+}
+
+int conv_dw_x86_postrun(struct conv_dw_priv_info* info)
+{
+    sys_free(info->pad_buf);
+
+    info->pad_buf = NULL;
+    info->pad_buf_size = 0;
+
+    return 0;
+}
+
+struct dw_param
+{
+    const float* input;
+    const float* kernel;
+    const float* biases;
+    float* output;
+    float* pad_buf;
+    dw_channel_t dw_kernel;
+    int channel;
+    int chan_per_thread;
+    int in_h;
+    int in_w;
+    int out_h;
+    int out_w;
+    int pad_in_h;
+    int pad_in_w;
+    int need_pad;
+    struct conv_param* conv_param;
+};
+
+/* every thread owns a pad buffer, so the channels are handed out in per thread chunks */
+static void dw_task(void* arg, int t)
+{
+    struct dw_param* p = ( struct dw_param* )arg;
+    struct conv_param* param = p->conv_param;
+    int kernel_h = param->kernel_h;
+    int kernel_w = param->kernel_w;
+    int in_hw = p->in_h * p->in_w;
+    int out_hw = p->out_h * p->out_w;
+
+    int chan_start = t * p->chan_per_thread;
+    int chan_end = chan_start + p->chan_per_thread < p->channel ? chan_start + p->chan_per_thread : p->channel;
+    float* thread_pad_buf = p->need_pad ? p->pad_buf + t * p->pad_in_h * p->pad_in_w : NULL;
+
+    for (int c = chan_start; c < chan_end; c++)
+    {
+        const float* chan_input = p->input + c * in_hw;
+        const float* chan_kernel = p->kernel + c * kernel_h * kernel_w;
+        float* chan_output = p->output + c * out_hw;
+        float bias = p->biases ? p->biases[c] : 0.f;
+        int chan_in_w = p->in_w;
+
+        if (p->need_pad)
+        {
+            pad_channel(chan_input, p->in_h, p->in_w, thread_pad_buf, p->pad_in_h, p->pad_in_w, param->pad_h0,
+                        param->pad_w0);
+            chan_input = thread_pad_buf;
+            chan_in_w = p->pad_in_w;
+        }
+
+        if (p->dw_kernel)
+            p->dw_kernel(chan_input, chan_in_w, chan_kernel, chan_output, p->out_h, p->out_w, bias, param->activation,
+                         param->dilation_h, param->dilation_w);
+        else
+            dw_generic(chan_input, chan_in_w, chan_kernel, chan_output, p->out_h, p->out_w, bias, param->activation,
+                       kernel_h, kernel_w, param->stride_h, param->stride_w, param->dilation_h, param->dilation_w);
+    }
+}
+
+int conv_dw_x86_run(struct ir_tensor* input_tensor, struct ir_tensor* filter_tensor, struct ir_tensor* bias_tensor,
+                    struct ir_tensor* output_tensor, struct conv_dw_priv_info* info, struct conv_param* param,
+                    struct cpu_pool* pool)
+{
+    int group = param->group;
+    int kernel_h = param->kernel_h;
+    int kernel_w = param->kernel_w;
+    int stride_h = param->stride_h;
+    int stride_w = param->stride_w;
+    int dilation_h = param->dilation_h;
+    int dilation_w = param->dilation_w;
+
+    int batch = input_tensor->dims[0];
+    int in_h = input_tensor->dims[2];
+    int in_w = input_tensor->dims[3];
+    int out_h = output_tensor->dims[2];
+    int out_w = output_tensor->dims[3];
+
+    float* input_buf = ( float* )input_tensor->data;
+    float* output_buf = ( float* )output_tensor->data;
+
+    struct dw_param dw_param;
+
+    dw_param.pad_in_h = (out_h - 1) * stride_h + (kernel_h - 1) * dilation_h + 1;
+    dw_param.pad_in_w = (out_w - 1) * stride_w + (kernel_w - 1) * dilation_w + 1;
+    int pad_size = get_pad_size(input_tensor, output_tensor, param);
+    dw_param.need_pad = pad_size > 0;
+    dw_param.pad_buf = info->pad_buf;
+
+    dw_param.dw_kernel = get_dw_kernel(kernel_h, kernel_w, stride_h, stride_w);
+    dw_param.kernel = ( float* )filter_tensor->data;
+    dw_param.biases = bias_tensor ? ( float* )bias_tensor->data : NULL;
+    dw_param.channel = group;
+    dw_param.in_h = in_h;
+    dw_param.in_w = in_w;
+    dw_param.out_h = out_h;
+    dw_param.out_w = out_w;
+    dw_param.conv_param = param;
+
+    int num_thread = get_dw_thread_num(get_cpu_pool_thread_num(pool), group);
+
+    /* the buffer is sized by prerun for the current shape */
+    if (( int )sizeof(float) * pad_size * num_thread > info->pad_buf_size)
+        return -1;
+
+    dw_param.chan_per_thread = (group + num_thread - 1) / num_thread;
+
+    for (int n = 0; n < batch; n++)
+    {
+        dw_param.input = input_buf + n * group * in_h * in_w;
+        dw_param.output = output_buf + n * group * out_h * out_w;
+
+        cpu_pool_parallel_for(pool, dw_task, &dw_param, num_thread);
+    }
+
+    return 0;
+}
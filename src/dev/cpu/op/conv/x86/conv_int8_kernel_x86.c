@@ -0,0 +1,824 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * License); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * AS IS BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*
+ * Copyright (c) 2020, OPEN AI LAB
+ * Author: haoluo@openailab.com
+ */
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <immintrin.h>
+
+#include "sys_port.h"
+#include "tengine_errno.h"
+#include "../../../cpu_pool.h"
+#include "conv_int8_kernel_x86.h"
+
+/*
+ * int8 data is widened to int16 and vpmaddwd multiplies and adds pairs of k into int32.
+ * unlike vpmaddubsw, whose int16 sums saturate for full range int8 weights, this is exact.
+ *
+ * kernels are interleaved by 4 output channels and pairs of k: [k / 2][4][2], the col buffer
+ * is packed by lines of 8 output pixels: [k / 2][8][2]. an odd k is padded with zero.
+ */
+#define PER_OUT_CHAN 4
+#define PER_COL_LINE 8
+
+static inline float get_weight_scale(struct ir_tensor* filter, int ch)
+{
+    return filter->quant_param_num > 1 ? filter->scale_list[ch] : filter->scale;
+}
+
+/* the int32 accumulators of a channel are scaled to the output by input scale x weight scale / output scale */
+static int init_requant(struct ir_tensor* input, struct ir_tensor* filter, struct ir_tensor* bias,
+                        struct ir_tensor* output, struct conv_int8_priv_info* info, int out_chan, int activation)
+{
+    if (input->quant_param_num < 1 || output->quant_param_num < 1 ||
+        (filter->quant_param_num != 1 && filter->quant_param_num != out_chan))
+    {
+        set_tengine_errno(EINVAL);
+        return -1;
+    }
+
+    info->bias = ( int32_t* )sys_malloc(sizeof(int32_t) * out_chan);
+    info->requant_scale = ( float* )sys_malloc(sizeof(float) * out_chan);
+
+    if (info->bias == NULL || info->requant_scale == NULL)
+    {
+        set_tengine_errno(ENOMEM);
+        return -1;
+    }
+
+    for (int i = 0; i < out_chan; i++)
+    {
+        float acc_scale = input->scale * get_weight_scale(filter, i);
+
+        info->requant_scale[i] = acc_scale / output->scale;
+
+        if (bias == NULL)
+            info->bias[i] = 0;
+        else if (bias->data_type == TENGINE_DT_INT32)
+            info->bias[i] = (( int32_t* )bias->data)[i];
+        else
+            info->bias[i] = acc_scale != 0.f ? ( int32_t )roundf((( float* )bias->data)[i] / acc_scale) : 0;
+    }
+
+    info->act_min = -127;
+    info->act_max = 127;
+
+    if (activation >= 0)
+    {
+        info->act_min = 0;
+
+        if (activation > 0)
+        {
+            int act_max = ( int )roundf(6.f / output->scale);
+            if (act_max < info->act_max)
+                info->act_max = act_max;
+        }
+    }
+
+    return 0;
+}
+
+/* v is clamped already */
+static inline void store_int8x8(int8_t* output, __m256i v)
+{
+    __m128i v16 = _mm_packs_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    _mm_storel_epi64(( __m128i* )output, _mm_packs_epi16(v16, v16));
+}
+
+/* (acc + bias) x scale, rounded to nearest even and clamped to the activation range */
+static inline __m256i requant_int8x8(__m256i acc, __m256i bias, __m256 scale, __m256i act_min, __m256i act_max)
+{
+    __m256 v = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_add_epi32(acc, bias)), scale);
+    __m256i r = _mm256_cvtps_epi32(v);
+
+    return _mm256_min_epi32(_mm256_max_epi32(r, act_min), act_max);
+}
+
+static void requant_store(const int32_t* result, int col_cnt, const int32_t* bias, const float* scale, int8_t* output,
+                          int output_xy, int ch_cnt, int pix_cnt, int act_min, int act_max)
+{
+    __m256i v_min = _mm256_set1_epi32(act_min);
+    __m256i v_max = _mm256_set1_epi32(act_max);
+
+    for (int i = 0; i < ch_cnt; i++)
+    {
+        __m256i v_bias = _mm256_set1_epi32(bias[i]);
+        __m256 v_scale = _mm256_set1_ps(scale[i]);
+        int8_t* cur_output = output + i * output_xy;
+
+        for (int j = 0; j < pix_cnt; j += PER_COL_LINE)
+        {
+            __m256i acc = _mm256_loadu_si256(( __m256i* )(result + i * col_cnt + j));
+            __m256i r = requant_int8x8(acc, v_bias, v_scale, v_min, v_max);
+
+            if (j + PER_COL_LINE <= pix_cnt)
+            {
+                store_int8x8(cur_output + j, r);
+            }
+            else
+            {
+                int8_t tmp[PER_COL_LINE * 2];
+                store_int8x8(tmp, r);
+                memcpy(cur_output + j, tmp, pix_cnt - j);
+            }
+        }
+    }
+}
+
+static void interleave_kernel(const int8_t* kernel, int16_t* kernel_interleaved, int kernel_chan, int kernel_size)
+{
+    int k2 = (kernel_size + 1) / 2;
+
+    for (int p = 0; p < kernel_chan; p += PER_OUT_CHAN)
+    {
+        for (int k = 0; k < k2; k++)
+        {
+            for (int i = 0; i < PER_OUT_CHAN; i++)
+            {
+                int ch = p + i;
+
+                for (int j = 0; j < 2; j++)
+                {
+                    int kk = 2 * k + j;
+                    *kernel_interleaved++ = (ch < kernel_chan && kk < kernel_size) ? kernel[ch * kernel_size + kk] : 0;
+                }
+            }
+        }
+    }
+}
+
+struct im2col_int8_param
+{
+    const int8_t* input;
+    int16_t* col;
+    int in_c;
+    int in_w;
+    int in_h;
+    int k_w;
+    int k_h;
+    int s_w;
+    int s_h;
+    int d_w;
+    int d_h;
+    int pad_w0;
+    int pad_h0;
+    int out_w;
+    int out_h;
+};
+
+/* the 8 pixels of one tap, zero outside of the image */
+static inline __m128i im2col_int8_row(const int8_t* input, int in_w, int in_h, const int* imx_start,
+                                      const int* imy_start, int kx, int ky, int col_end, int same_row, int s_w)
+{
+    int imy = imy_start[0] + ky;
+    int imx0 = imx_start[0] + kx;
+    int imx1 = imx_start[PER_COL_LINE - 1] + kx;
+
+    if (same_row && (imy < 0 || imy >= in_h))
+        return _mm_setzero_si128();
+
+    if (same_row && s_w == 1)
+    {
+        if (imx0 >= 0 && imx1 < in_w)
+            return _mm_cvtepi8_epi16(_mm_loadl_epi64(( __m128i* )(input + imy * in_w + imx0)));
+
+        /* the line crosses the left or right padding, shift the 8 bytes next to the border in */
+        const int8_t* row = input + imy * in_w;
+
+        if (in_w >= PER_COL_LINE && imx0 < 0 && imx1 < in_w)
+            return _mm_cvtepi8_epi16(_mm_sll_epi64(_mm_loadl_epi64(( __m128i* )row), _mm_cvtsi32_si128(-imx0 * 8)));
+
+        if (in_w >= PER_COL_LINE && imx0 >= 0 && imx1 >= in_w)
+        {
+            __m128i v = _mm_loadl_epi64(( __m128i* )(row + in_w - PER_COL_LINE));
+            return _mm_cvtepi8_epi16(_mm_srl_epi64(v, _mm_cvtsi32_si128((imx0 - in_w + PER_COL_LINE) * 8)));
+        }
+
+        int8_t tmp[PER_COL_LINE] = {0};
+        int start = imx0 < 0 ? -imx0 : 0;
+        int end = imx1 < in_w ? PER_COL_LINE : in_w - imx0;
+
+        if (start < end)
+            memcpy(tmp + start, input + imy * in_w + imx0 + start, end - start);
+
+        return _mm_cvtepi8_epi16(_mm_loadl_epi64(( __m128i* )tmp));
+    }
+
+    if (same_row && s_w == 2 && imx0 >= 0 && imx0 + 2 * PER_COL_LINE <= in_w)
+    {
+        const __m128i even = _mm_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14, -1, -1, -1, -1, -1, -1, -1, -1);
+        return _mm_cvtepi8_epi16(_mm_shuffle_epi8(_mm_loadu_si128(( __m128i* )(input + imy * in_w + imx0)), even));
+    }
+
+    int16_t tmp[PER_COL_LINE];
+
+    for (int i = 0; i < PER_COL_LINE; i++)
+    {
+        int x = imx_start[i] + kx;
+        int y = imy_start[i] + ky;
+
+        if (i < col_end && x >= 0 && x < in_w && y >= 0 && y < in_h)
+            tmp[i] = input[y * in_w + x];
+        else
+            tmp[i] = 0;
+    }
+
+    return _mm_loadu_si128(( __m128i* )tmp);
+}
+
+/*
+ * one task fills one col line. the rows of k are stored one after another first, then every two
+ * rows are interleaved into pairs in place, they take the same 32 bytes.
+ */
+static void im2col_int8_task(void* arg, int col_i)
+{
+    struct im2col_int8_param* p = ( struct im2col_int8_param* )arg;
+    const int8_t* input = p->input;
+    int in_c = p->in_c;
+    int in_w = p->in_w;
+    int in_h = p->in_h;
+    int k_w = p->k_w;
+    int k_h = p->k_h;
+    int s_w = p->s_w;
+    int d_w = p->d_w;
+    int d_h = p->d_h;
+    int out_w = p->out_w;
+    int in_xy = in_w * in_h;
+    int out_xy = out_w * p->out_h;
+    int kernel_size = k_w * k_h * in_c;
+    int k2 = (kernel_size + 1) / 2;
+
+    int16_t* cur_col = p->col + col_i * PER_COL_LINE * 2 * k2;
+    int col_start = col_i * PER_COL_LINE;
+    int col_end = out_xy - col_start;
+    if (col_end > PER_COL_LINE)
+        col_end = PER_COL_LINE;
+
+    int imy_start[PER_COL_LINE];
+    int imx_start[PER_COL_LINE];
+    for (int i = 0; i < PER_COL_LINE; i++)
+    {
+        int cnt = col_start + (i < col_end ? i : 0);
+        imy_start[i] = (cnt / out_w) * p->s_h - p->pad_h0;
+        imx_start[i] = (cnt % out_w) * s_w - p->pad_w0;
+    }
+
+    int same_row = col_end == PER_COL_LINE && imy_start[0] == imy_start[PER_COL_LINE - 1];
+    int16_t* row = cur_col;
+
+    if (col_end == PER_COL_LINE && k_w == 1 && k_h == 1 && s_w == 1 && p->s_h == 1 && p->pad_w0 == 0 &&
+        p->pad_h0 == 0)
+    {
+        /* 1x1 without stride and padding, the line is in place in every input channel */
+        for (int kch = 0; kch < in_c; kch++)
+        {
+            __m128i v = _mm_cvtepi8_epi16(_mm_loadl_epi64(( __m128i* )(input + kch * in_xy + col_start)));
+            _mm_storeu_si128(( __m128i* )row, v);
+            row += PER_COL_LINE;
+        }
+    }
+    else
+    {
+        for (int kch = 0; kch < in_c; kch++)
+        {
+            const int8_t* cur_input = input + kch * in_xy;
+
+            for (int ky = 0; ky < k_h * d_h; ky += d_h)
+            {
+                int imy = imy_start[0] + ky;
+
+                if (same_row && s_w == 1 && imy >= 0 && imy < in_h && imx_start[0] >= 0 &&
+                    imx_start[PER_COL_LINE - 1] + (k_w - 1) * d_w < in_w)
+                {
+                    /* all the taps of the kernel row are inside the image */
+                    const int8_t* ptr = cur_input + imy * in_w + imx_start[0];
+
+                    for (int kx = 0; kx < k_w * d_w; kx += d_w)
+                    {
+                        _mm_storeu_si128(( __m128i* )row, _mm_cvtepi8_epi16(_mm_loadl_epi64(( __m128i* )(ptr + kx))));
+                        row += PER_COL_LINE;
+                    }
+                }
+                else
+                {
+                    for (int kx = 0; kx < k_w * d_w; kx += d_w)
+                    {
+                        __m128i v = im2col_int8_row(cur_input, in_w, in_h, imx_start, imy_start, kx, ky, col_end,
+                                                    same_row, s_w);
+                        _mm_storeu_si128(( __m128i* )row, v);
+                        row += PER_COL_LINE;
+                    }
+                }
+            }
+        }
+    }
+
+    if (kernel_size & 1)
+        _mm_storeu_si128(( __m128i* )row, _mm_setzero_si128());
+
+    for (int k = 0; k < k2; k++)
+    {
+        __m128i row0 = _mm_loadu_si128(( __m128i* )cur_col);
+        __m128i row1 = _mm_loadu_si128(( __m128i* )(cur_col + PER_COL_LINE));
+
+        _mm_storeu_si128(( __m128i* )cur_col, _mm_unpacklo_epi16(row0, row1));
+        _mm_storeu_si128(( __m128i* )(cur_col + PER_COL_LINE), _mm_unpackhi_epi16(row0, row1));
+        cur_col += 2 * PER_COL_LINE;
+    }
+}
+
+static inline __m256i broadcast_pair(const int16_t* kernel)
+{
+    int32_t pair;
+    memcpy(&pair, kernel, sizeof(pair));
+
+    return _mm256_set1_epi32(pair);
+}
+
+/* gemm kernel of 24 output pixels (three col lines) x 4 output channels, 12 ymm accumulators */
+static void gemm_int8_24x4(const int16_t* col, const int16_t* kernel, int k2, int32_t* result)
+{
+    const int16_t* col0 = col;
+    const int16_t* col1 = col + 2 * PER_COL_LINE * k2;
+    const int16_t* col2 = col + 4 * PER_COL_LINE * k2;
+
+    __m256i acc00, acc01, acc02, acc10, acc11, acc12, acc20, acc21, acc22, acc30, acc31, acc32;
+    acc00 = acc01 = acc02 = acc10 = acc11 = acc12 = _mm256_setzero_si256();
+    acc20 = acc21 = acc22 = acc30 = acc31 = acc32 = _mm256_setzero_si256();
+
+    for (int k = 0; k < k2; k++)
+    {
+        __m256i c0 = _mm256_loadu_si256(( __m256i* )col0);
+        __m256i c1 = _mm256_loadu_si256(( __m256i* )col1);
+        __m256i c2 = _mm256_loadu_si256(( __m256i* )col2);
+
+        __m256i k0 = broadcast_pair(kernel);
+        acc00 = _mm256_add_epi32(acc00, _mm256_madd_epi16(c0, k0));
+        acc01 = _mm256_add_epi32(acc01, _mm256_madd_epi16(c1, k0));
+        acc02 = _mm256_add_epi32(acc02, _mm256_madd_epi16(c2, k0));
+        __m256i k1 = broadcast_pair(kernel + 2);
+        acc10 = _mm256_add_epi32(acc10, _mm256_madd_epi16(c0, k1));
+        acc11 = _mm256_add_epi32(acc11, _mm256_madd_epi16(c1, k1));
+        acc12 = _mm256_add_epi32(acc12, _mm256_madd_epi16(c2, k1));
+        __m256i k2_ = broadcast_pair(kernel + 4);
+        acc20 = _mm256_add_epi32(acc20, _mm256_madd_epi16(c0, k2_));
+        acc21 = _mm256_add_epi32(acc21, _mm256_madd_epi16(c1, k2_));
+        acc22 = _mm256_add_epi32(acc22, _mm256_madd_epi16(c2, k2_));
+        __m256i k3 = broadcast_pair(kernel + 6);
+        acc30 = _mm256_add_epi32(acc30, _mm256_madd_epi16(c0, k3));
+        acc31 = _mm256_add_epi32(acc31, _mm256_madd_epi16(c1, k3));
+        acc32 = _mm256_add_epi32(acc32, _mm256_madd_epi16(c2, k3));
+
+        col0 += 2 * PER_COL_LINE;
+        col1 += 2 * PER_COL_LINE;
+        col2 += 2 * PER_COL_LINE;
+        kernel += 2 * PER_OUT_CHAN;
+    }
+
+    _mm256_storeu_si256(( __m256i* )result, acc00);
+    _mm256_storeu_si256(( __m256i* )(result + 8), acc01);
+    _mm256_storeu_si256(( __m256i* )(result + 16), acc02);
+    _mm256_storeu_si256(( __m256i* )(result + 24), acc10);
+    _mm256_storeu_si256(( __m256i* )(result + 32), acc11);
+    _mm256_storeu_si256(( __m256i* )(result + 40), acc12);
+    _mm256_storeu_si256(( __m256i* )(result + 48), acc20);
+    _mm256_storeu_si256(( __m256i* )(result + 56), acc21);
+    _mm256_storeu_si256(( __m256i* )(result + 64), acc22);
+    _mm256_storeu_si256(( __m256i* )(result + 72), acc30);
+    _mm256_storeu_si256(( __m256i* )(result + 80), acc31);
+    _mm256_storeu_si256(( __m256i* )(result + 88), acc32);
+}
+
+/* gemm kernel of 8 output pixels x 4 output channels, for the remained col lines */
+static void gemm_int8_8x4(const int16_t* col, const int16_t* kernel, int k2, int32_t* result)
+{
+    __m256i acc0, acc1, acc2, acc3;
+    acc0 = acc1 = acc2 = acc3 = _mm256_setzero_si256();
+
+    for (int k = 0; k < k2; k++)
+    {
+        __m256i c0 = _mm256_loadu_si256(( __m256i* )col);
+        acc0 = _mm256_add_epi32(acc0, _mm256_madd_epi16(c0, broadcast_pair(kernel)));
+        acc1 = _mm256_add_epi32(acc1, _mm256_madd_epi16(c0, broadcast_pair(kernel + 2)));
+        acc2 = _mm256_add_epi32(acc2, _mm256_madd_epi16(c0, broadcast_pair(kernel + 4)));
+        acc3 = _mm256_add_epi32(acc3, _mm256_madd_epi16(c0, broadcast_pair(kernel + 6)));
+
+        col += 2 * PER_COL_LINE;
+        kernel += 2 * PER_OUT_CHAN;
+    }
+
+    _mm256_storeu_si256(( __m256i* )result, acc0);
+    _mm256_storeu_si256(( __m256i* )(result + 8), acc1);
+    _mm256_storeu_si256(( __m256i* )(result + 16), acc2);
+    _mm256_storeu_si256(( __m256i* )(result + 24), acc3);
+}
+
+struct gemm_int8_param
+{
+    const int16_t* col;
+    const int16_t* kernel;
+    const int32_t* bias;
+    const float* scale;
+    int8_t* output;
+    int k2;
+    int out_chan;
+    int output_xy;
+    int col_set_num;
+    int act_min;
+    int act_max;
+};
+
+/* every task works on one col set (3 col lines) or one remained col line, for all the output channels */
+static void gemm_int8_task(void* arg, int t)
+{
+    struct gemm_int8_param* p = ( struct gemm_int8_param* )arg;
+    int k2 = p->k2;
+    int col_line_idx = t < p->col_set_num ? t * 3 : p->col_set_num * 3 + (t - p->col_set_num);
+    int col_cnt = t < p->col_set_num ? 3 * PER_COL_LINE : PER_COL_LINE;
+    int col_start = col_line_idx * PER_COL_LINE;
+    int pix_cnt = p->output_xy - col_start;
+    const int16_t* cur_col = p->col + col_line_idx * PER_COL_LINE * 2 * k2;
+
+    if (pix_cnt > col_cnt)
+        pix_cnt = col_cnt;
+
+    int32_t result[PER_OUT_CHAN * 3 * PER_COL_LINE];
+
+    for (int ch = 0; ch < p->out_chan; ch += PER_OUT_CHAN)
+    {
+        const int16_t* cur_kernel = p->kernel + ch * 2 * k2;
+        int ch_cnt = p->out_chan - ch < PER_OUT_CHAN ? p->out_chan - ch : PER_OUT_CHAN;
+
+        if (col_cnt == 3 * PER_COL_LINE)
+            gemm_int8_24x4(cur_col, cur_kernel, k2, result);
+        else
+            gemm_int8_8x4(cur_col, cur_kernel, k2, result);
+
+        requant_store(result, col_cnt, p->bias + ch, p->scale + ch, p->output + ch * p->output_xy + col_start,
+                      p->output_xy, ch_cnt, pix_cnt, p->act_min, p->act_max);
+    }
+}
+
+int conv_int8_x86_get_shared_mem_size(struct ir_tensor* input, struct ir_tensor* output, struct conv_param* param)
+{
+    int input_chan = param->input_channel / param->group;
+    int kernel_size = input_chan * param->kernel_h * param->kernel_w;
+    int k2 = (kernel_size + 1) / 2;
+    int output_xy = output->dims[2] * output->dims[3];
+
+    return sizeof(int16_t) * 2 * k2 * ((output_xy + PER_COL_LINE - 1) & -PER_COL_LINE) + 128;
+}
+
+int conv_int8_x86_set_shared_mem(struct conv_int8_priv_info* info, void* mem, int mem_size)
+{
+    info->external_im2col_mem = 1;
+    info->im2col_buffer = mem;
+    info->im2col_buffer_size = mem_size;
+
+    return 0;
+}
+
+int conv_int8_x86_prerun(struct ir_tensor* input_tensor, struct ir_tensor* filter_tensor,
+                         struct ir_tensor* bias_tensor, struct ir_tensor* output_tensor,
+                         struct conv_int8_priv_info* info, struct conv_param* param)
+{
+    int group = param->group;
+    int out_chan = filter_tensor->dims[0] / group;
+    int kernel_size = filter_tensor->dims[1] * filter_tensor->dims[2] * filter_tensor->dims[3];
+    int k2 = (kernel_size + 1) / 2;
+    int out_chan_align = (out_chan + PER_OUT_CHAN - 1) & -PER_OUT_CHAN;
+
+    if (!info->external_im2col_mem)
+    {
+        int mem_size = conv_int8_x86_get_shared_mem_size(input_tensor, output_tensor, param);
+        info->im2col_buffer = ( int16_t* )sys_malloc(mem_size);
+        info->im2col_buffer_size = mem_size;
+    }
+
+    info->interleave_buffer = ( int16_t* )sys_malloc(sizeof(int16_t) * 2 * k2 * out_chan_align * group);
+
+    if (info->im2col_buffer == NULL || info->interleave_buffer == NULL)
+    {
+        set_tengine_errno(ENOMEM);
+        return -1;
+    }
+
+    for (int g = 0; g < group; g++)
+    {
+        const int8_t* kernel = ( const int8_t* )filter_tensor->data + g * out_chan * kernel_size;
+        interleave_kernel(kernel, info->interleave_buffer + g * 2 * k2 * out_chan_align, out_chan, kernel_size);
+    }
+
+    return init_requant(input_tensor, filter_tensor, bias_tensor, output_tensor, info, filter_tensor->dims[0],
+                        param->activation);
+}
+
+int conv_int8_x86_postrun(struct conv_int8_priv_info* info)
+{
+    if (!info->external_im2col_mem && info->im2col_buffer != NULL)
+        sys_free(info->im2col_buffer);
+
+    sys_free(info->interleave_buffer);
+    sys_free(info->bias);
+    sys_free(info->requant_scale);
+
+    info->im2col_buffer = NULL;
+    info->interleave_buffer = NULL;
+    info->bias = NULL;
+    info->requant_scale = NULL;
+
+    return 0;
+}
+
+int conv_int8_x86_reshape(struct ir_tensor* input_tensor, struct ir_tensor* output_tensor,
+                          struct conv_int8_priv_info* info, struct conv_param* param)
+{
+    int mem_size = conv_int8_x86_get_shared_mem_size(input_tensor, output_tensor, param);
+
+    if (info->external_im2col_mem || mem_size <= info->im2col_buffer_size)
+        return 0;
+
+    sys_free(info->im2col_buffer);
+
+    info->im2col_buffer = ( int16_t* )sys_malloc(mem_size);
+    info->im2col_buffer_size = mem_size;
+
+    return info->im2col_buffer ? 0 : -1;
+}
+
+int conv_int8_x86_run(struct ir_tensor* input_tensor, struct ir_tensor* output_tensor,
+                      struct conv_int8_priv_info* info, struct conv_param* param)
+{
+    int group = param->group;
+    int batch = input_tensor->dims[0];
+    int in_c = input_tensor->dims[1] / group;
+    int in_h = input_tensor->dims[2];
+    int in_w = input_tensor->dims[3];
+    int kernel_size = in_c * param->kernel_h * param->kernel_w;
+    int k2 = (kernel_size + 1) / 2;
+    int input_image_size = input_tensor->dims[1] * in_h * in_w;
+
+    int out_c = output_tensor->dims[1] / group;
+    int out_h = output_tensor->dims[2];
+    int out_w = output_tensor->dims[3];
+    int out_hw = out_h * out_w;
+    int out_c_align = (out_c + PER_OUT_CHAN - 1) & -PER_OUT_CHAN;
+    int output_image_size = output_tensor->dims[1] * out_hw;
+
+    int col_line_num = (out_hw + PER_COL_LINE - 1) / PER_COL_LINE;
+
+    struct im2col_int8_param im2col_param = {NULL,          info->im2col_buffer, in_c,          in_w, in_h,
+                                             param->kernel_w, param->kernel_h,    param->stride_w, param->stride_h,
+                                             param->dilation_w, param->dilation_h, param->pad_w0, param->pad_h0,
+                                             out_w,         out_h};
+    struct gemm_int8_param gemm_param;
+
+    gemm_param.col = info->im2col_buffer;
+    gemm_param.k2 = k2;
+    gemm_param.out_chan = out_c;
+    gemm_param.output_xy = out_hw;
+    gemm_param.col_set_num = col_line_num / 3;
+    gemm_param.act_min = info->act_min;
+    gemm_param.act_max = info->act_max;
+
+    for (int n = 0; n < batch; n++)
+    {
+        for (int g = 0; g < group; g++)
+        {
+            im2col_param.input = ( const int8_t* )input_tensor->data + n * input_image_size + g * in_c * in_h * in_w;
+            cpu_pool_parallel_for(info->cpu_pool, im2col_int8_task, &im2col_param, col_line_num);
+
+            gemm_param.kernel = info->interleave_buffer + g * 2 * k2 * out_c_align;
+            gemm_param.bias = info->bias + g * out_c;
+            gemm_param.scale = info->requant_scale + g * out_c;
+            gemm_param.output = ( int8_t* )output_tensor->data + n * output_image_size + g * out_c * out_hw;
+            cpu_pool_parallel_for(info->cpu_pool, gemm_int8_task, &gemm_param,
+                                  gemm_param.col_set_num + col_line_num % 3);
+        }
+    }
+
+    return 0;
+}
+
+/*
+ * depthwise: every channel is copied into a zero padded plane first, so the taps load 8 output
+ * pixels without bound checks. the plane is wide enough for the over-read of the last pixels.
+ */
+struct dw_int8_param
+{
+    const int8_t* input;
+    const int8_t* kernel;
+    int8_t* output;
+    struct conv_int8_priv_info* info;
+    struct conv_param* param;
+    int channel;
+    int in_h;
+    int in_w;
+    int out_h;
+    int out_w;
+    int plane_h;
+    int plane_w;
+    int task_num;
+    int task_per_thread;
+};
+
+/* 8 pixels of a tap in the low half */
+static inline __m128i load_int8x8(const int8_t* ptr, int stride)
+{
+    if (stride == 1)
+        return _mm_loadl_epi64(( __m128i* )ptr);
+
+    if (stride == 2)
+    {
+        const __m128i even = _mm_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14, -1, -1, -1, -1, -1, -1, -1, -1);
+        return _mm_shuffle_epi8(_mm_loadu_si128(( __m128i* )ptr), even);
+    }
+
+    int8_t tmp[PER_COL_LINE];
+    for (int i = 0; i < PER_COL_LINE; i++)
+        tmp[i] = ptr[i * stride];
+
+    return _mm_loadl_epi64(( __m128i* )tmp);
+}
+
+/*
+ * the taps are taken in pairs: the pixels of two taps are interleaved and widened to int16, so
+ * vpmaddwd multiplies them by the two weights and adds them in one go. an odd tap count is
+ * padded with a zero weight on the first tap.
+ */
+static void dw_int8_channel(const int8_t* plane, const int32_t* pair_weight, const int* tap_offset, int pair_num,
+                            int8_t* output, struct dw_int8_param* p, int32_t bias, float scale)
+{
+    struct conv_param* param = p->param;
+    int s_h = param->stride_h;
+    int s_w = param->stride_w;
+    int out_w = p->out_w;
+
+    __m256i v_bias = _mm256_set1_epi32(bias);
+    __m256 v_scale = _mm256_set1_ps(scale);
+    __m256i v_min = _mm256_set1_epi32(p->info->act_min);
+    __m256i v_max = _mm256_set1_epi32(p->info->act_max);
+
+    for (int oy = 0; oy < p->out_h; oy++)
+    {
+        int8_t* cur_output = output + oy * out_w;
+
+        for (int ox = 0; ox < out_w; ox += PER_COL_LINE)
+        {
+            const int8_t* base = plane + oy * s_h * p->plane_w + ox * s_w;
+            __m256i acc = _mm256_setzero_si256();
+
+            for (int i = 0; i < pair_num; i++)
+            {
+                __m128i a = load_int8x8(base + tap_offset[2 * i], s_w);
+                __m128i b = load_int8x8(base + tap_offset[2 * i + 1], s_w);
+                __m256i v = _mm256_cvtepi8_epi16(_mm_unpacklo_epi8(a, b));
+
+                acc = _mm256_add_epi32(acc, _mm256_madd_epi16(v, _mm256_set1_epi32(pair_weight[i])));
+            }
+
+            __m256i r = requant_int8x8(acc, v_bias, v_scale, v_min, v_max);
+
+            if (ox + PER_COL_LINE <= out_w)
+            {
+                store_int8x8(cur_output + ox, r);
+            }
+            else
+            {
+                int8_t tmp[PER_COL_LINE * 2];
+                store_int8x8(tmp, r);
+                memcpy(cur_output + ox, tmp, out_w - ox);
+            }
+        }
+    }
+}
+
+/* every thread owns a plane buffer, so the channels are handed out in per thread chunks */
+static void dw_int8_task(void* arg, int t)
+{
+    struct dw_int8_param* p = ( struct dw_int8_param* )arg;
+    struct conv_param* param = p->param;
+    int task_end = (t + 1) * p->task_per_thread < p->task_num ? (t + 1) * p->task_per_thread : p->task_num;
+    int in_xy = p->in_h * p->in_w;
+    int out_xy = p->out_h * p->out_w;
+    int k_xy = param->kernel_h * param->kernel_w;
+    int pair_num = (k_xy + 1) / 2;
+
+    int8_t* plane = ( int8_t* )sys_malloc(p->plane_h * p->plane_w);
+    int* tap_offset = ( int* )sys_malloc(sizeof(int) * pair_num * 2);
+    int32_t* pair_weight = ( int32_t* )sys_malloc(sizeof(int32_t) * pair_num);
+
+    if (plane == NULL || tap_offset == NULL || pair_weight == NULL)
+    {
+        sys_free(plane);
+        sys_free(tap_offset);
+        sys_free(pair_weight);
+        return;
+    }
+
+    memset(plane, 0, p->plane_h * p->plane_w);
+
+    for (int i = 0; i < pair_num * 2; i++)
+    {
+        int tap = i < k_xy ? i : 0;
+        int ky = tap / param->kernel_w;
+        int kx = tap % param->kernel_w;
+        tap_offset[i] = ky * param->dilation_h * p->plane_w + kx * param->dilation_w;
+    }
+
+    for (int task = t * p->task_per_thread; task < task_end; task++)
+    {
+        int ch = task % p->channel;
+        const int8_t* cur_input = p->input + task * in_xy;
+        const int8_t* kernel = p->kernel + ch * k_xy;
+
+        /* the padding stays zero, only the image part is copied */
+        for (int y = 0; y < p->in_h; y++)
+            memcpy(plane + (y + param->pad_h0) * p->plane_w + param->pad_w0, cur_input + y * p->in_w, p->in_w);
+
+        for (int i = 0; i < pair_num; i++)
+        {
+            int16_t w0 = kernel[2 * i];
+            int16_t w1 = 2 * i + 1 < k_xy ? kernel[2 * i + 1] : 0;
+            pair_weight[i] = ( int32_t )(( uint32_t )( uint16_t )w0 | (( uint32_t )( uint16_t )w1 << 16));
+        }
+
+        dw_int8_channel(plane, pair_weight, tap_offset, pair_num, p->output + task * out_xy, p, p->info->bias[ch],
+                        p->info->requant_scale[ch]);
+    }
+
+    sys_free(plane);
+    sys_free(tap_offset);
+    sys_free(pair_weight);
+}
+
+int conv_dw_int8_x86_prerun(struct ir_tensor* input_tensor, struct ir_tensor* filter_tensor,
+                            struct ir_tensor* bias_tensor, struct ir_tensor* output_tensor,
+                            struct conv_int8_priv_info* info, struct conv_param* param)
+{
+    return init_requant(input_tensor, filter_tensor, bias_tensor, output_tensor, info, filter_tensor->dims[0],
+                        param->activation);
+}
+
+int conv_dw_int8_x86_run(struct ir_tensor* input_tensor, struct ir_tensor* filter_tensor,
+                         struct ir_tensor* output_tensor, struct conv_int8_priv_info* info, struct conv_param* param)
+{
+    struct dw_int8_param p;
+
+    p.input = ( const int8_t* )input_tensor->data;
+    p.kernel = ( const int8_t* )filter_tensor->data;
+    p.output = ( int8_t* )output_tensor->data;
+    p.info = info;
+    p.param = param;
+    p.channel = input_tensor->dims[1];
+    p.in_h = input_tensor->dims[2];
+    p.in_w = input_tensor->dims[3];
+    p.out_h = output_tensor->dims[2];
+    p.out_w = output_tensor->dims[3];
+
+    int out_w_align = (p.out_w + PER_COL_LINE - 1) & -PER_COL_LINE;
+    int span_h = (p.out_h - 1) * param->stride_h + (param->kernel_h - 1) * param->dilation_h + 1;
+
+    /* 16 more bytes for the stride 2 loads */
+    p.plane_w = out_w_align * param->stride_w + (param->kernel_w - 1) * param->dilation_w + 16;
+    p.plane_h = span_h > p.in_h + param->pad_h0 ? span_h : p.in_h + param->pad_h0;
+
+    if (p.plane_w < p.in_w + param->pad_w0)
+        p.plane_w = p.in_w + param->pad_w0;
+
+    int num_thread = get_cpu_pool_thread_num(info->cpu_pool);
+
+    p.task_num = input_tensor->dims[0] * p.channel;
+
+    if (num_thread > p.task_num)
+        num_thread = p.task_num;
+    if (num_thread < 1)
+        num_thread = 1;
+
+    p.task_per_thread = (p.task_num + num_thread - 1) / num_thread;
+
+    cpu_pool_parallel_for(info->cpu_pool, dw_int8_task, &p, num_thread);
+
+    return 0;
+}
@@ -0,0 +1,80 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * License); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * AS IS BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*
+ * Copyright (c) 2020, OPEN AI LAB
+ * Author: haoluo@openailab.com
+ */
+
+#ifndef _CONV_INT8_KERNEL_X86_H_
+#define _CONV_INT8_KERNEL_X86_H_
+
+#include <stdint.h>
+
+#include "tengine_ir.h"
+#include "convolution_param.h"
+
+struct cpu_pool;
+
+/*
+ * symmetric int8: input and output have one scale each, the weight has one scale per output
+ * channel in scale_list (or a single one), the bias is int32 in the scale of input x weight,
+ * or fp32 which is quantized at prerun. zero points are taken as 0.
+ */
+struct conv_int8_priv_info
+{
+    int16_t* interleave_buffer; /* weights widened to int16, interleaved by 4 output channels and by pairs of k */
+    int16_t* im2col_buffer;
+    int32_t* bias; /* per output channel, 0 if there is no bias */
+    float* requant_scale; /* per output channel, input scale x weight scale / output scale */
+    int im2col_buffer_size;
+    int external_im2col_mem;
+    int act_min; /* the output clamp, activation included */
+    int act_max;
+    struct cpu_pool* cpu_pool; /* the worker threads of the exec graph */
+};
+
+int conv_int8_x86_prerun(struct ir_tensor* input_tensor, struct ir_tensor* filter_tensor,
+                         struct ir_tensor* bias_tensor, struct ir_tensor* output_tensor,
+                         struct conv_int8_priv_info* info, struct conv_param* param) __attribute__((weak));
+
+int conv_int8_x86_postrun(struct conv_int8_priv_info* info) __attribute__((weak));
+
+/* only the im2col buffer depends on the input size, the prepared weights are kept */
+int conv_int8_x86_reshape(struct ir_tensor* input_tensor, struct ir_tensor* output_tensor,
+                          struct conv_int8_priv_info* info, struct conv_param* param) __attribute__((weak));
+
+int conv_int8_x86_run(struct ir_tensor* input_tensor, struct ir_tensor* output_tensor,
+                      struct conv_int8_priv_info* info, struct conv_param* param) __attribute__((weak));
+
+int conv_int8_x86_get_shared_mem_size(struct ir_tensor* input_tensor, struct ir_tensor* output_tensor,
+                                      struct conv_param* param) __attribute__((weak));
+
+int conv_int8_x86_set_shared_mem(struct conv_int8_priv_info* info, void* mem, int mem_size) __attribute__((weak));
+
+/* depthwise, the weights are used as they are, only the bias and scales are prepared */
+int conv_dw_int8_x86_prerun(struct ir_tensor* input_tensor, struct ir_tensor* filter_tensor,
+                            struct ir_tensor* bias_tensor, struct ir_tensor* output_tensor,
+                            struct conv_int8_priv_info* info, struct conv_param* param) __attribute__((weak));
+
+int conv_dw_int8_x86_run(struct ir_tensor* input_tensor, struct ir_tensor* filter_tensor,
+                         struct ir_tensor* output_tensor, struct conv_int8_priv_info* info,
+                         struct conv_param* param) __attribute__((weak));
+
+#endif
@@ -0,0 +1,1049 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * License); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * AS IS BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*
+ * Copyright (c) 2020, OPEN AI LAB
+ * Author: haoluo@openailab.com
+ */
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <immintrin.h>
+
+#include "sys_port.h"
+#include "../../../cpu_model.h"
+#include "../../../cpu_pool.h"
+#include "conv_kernel_x86.h"
+#include "wino_conv_kernel_x86.h"
+
+/*
+ * kernels are interleaved by 4 output channels, the col buffer is packed by lines
+ * of 8 output pixels, or 16 output pixels for the avx-512 kernels.
+ */
+#define PER_OUT_CHAN 4
+#define PER_COL_LINE 8
+#define PER_COL_LINE_AVX512 16
+#define MAX_COL_LINE 16
+
+/*
+ * the images of a batch are run as one gemm on their pixels put end to end, until there are
+ * this many pixels: small outputs then fill whole col sets, and the kernel is streamed once
+ * per col set of the batch instead of once per col set of every image
+ */
+#define BATCH_GEMM_PIX 256
+
+typedef void (*sgemm_kernel_t)(float* biases, float* col, float* kernel, int kernel_size, float* output,
+                               int output_xy, int activation);
+
+void sgemm_48x4_avx512(float* biases, float* col, float* kernel, int kernel_size, float* output, int output_xy,
+                       int activation);
+void sgemm_16x4_avx512(float* biases, float* col, float* kernel, int kernel_size, float* output, int output_xy,
+                       int activation);
+
+static void interleave_kernel(float* kernel, float* kernel_interleaved, int kernel_chan, int kernel_size)
+{
+    int i, j, k;
+    float* cur_kernel[PER_OUT_CHAN];
+    float* cur_kernel_interleaved = kernel_interleaved;
+
+    // interleave PER_OUT_CHAN kernels
+    for (i = 0; i + PER_OUT_CHAN - 1 < kernel_chan; i += PER_OUT_CHAN)
+    {
+        for (k = 0; k < PER_OUT_CHAN; k++)
+            cur_kernel[k] = kernel + kernel_size * (i + k);
+        for (j = 0; j < kernel_size; j++)
+        {
+            for (k = 0; k < PER_OUT_CHAN; k++)
+                *(cur_kernel_interleaved++) = cur_kernel[k][j];
+        }
+    }
+    // last kernels, padded with zero
+    int kernel_end = kernel_chan - i;
+    if (kernel_end)
+    {
+        for (k = 0; k < kernel_end; k++)
+            cur_kernel[k] = kernel + kernel_size * (i + k);
+        for (j = 0; j < kernel_size; j++)
+        {
+            for (k = 0; k < PER_OUT_CHAN; k++)
+                *(cur_kernel_interleaved++) = k < kernel_end ? cur_kernel[k][j] : 0.f;
+        }
+    }
+}
+
+static void interleave(struct ir_tensor* filter, struct conv_priv_info* priv_info, struct conv_param* param)
+{
+    int group = param->group;
+    int kernel_size = filter->dims[1] * filter->dims[2] * filter->dims[3];
+    int out_chan = filter->dims[0] / group;
+
+    int kernel_size_algin = kernel_size * ((out_chan + PER_OUT_CHAN - 1) & -PER_OUT_CHAN);
+    int kernel_size_g = kernel_size * out_chan;
+
+    float* kernel = filter->data;
+    float* interleave_buf = priv_info->interleave_buffer;
+    for (int g = 0; g < group; g++)
+    {
+        float* cur_kernel = kernel + g * kernel_size_g;
+        float* cur_interleave = interleave_buf + g * kernel_size_algin;
+        interleave_kernel(cur_kernel, cur_interleave, out_chan, kernel_size);
+    }
+}
+
+/*
+ * im2col, packed as [out_xy / col_line][kernel_size][col_line], the last line is padded
+ * with zero. the pixels of a line are loaded as a whole when they sit in one output row
+ * and the stride is 1, otherwise they are gathered one by one. 1x1 convolution without
+ * padding does not come here, see conv_pointwise_x86().
+ * for a batch, the pixels of the images follow each other, a line may start in one image
+ * and end in the next one.
+ */
+struct im2col_param
+{
+    float* input;
+    float* col;
+    int batch;
+    int in_image_size;
+    int in_c;
+    int in_w;
+    int in_h;
+    int k_w;
+    int k_h;
+    int s_w;
+    int s_h;
+    int d_w;
+    int d_h;
+    int pad_w0;
+    int pad_h0;
+    int out_w;
+    int out_h;
+    int col_line;
+};
+
+/* one task fills one col line */
+static void im2col_task(void* arg, int col_i)
+{
+    struct im2col_param* p = ( struct im2col_param* )arg;
+    float* input = p->input;
+    float* col = p->col;
+    int in_c = p->in_c;
+    int in_w = p->in_w;
+    int in_h = p->in_h;
+    int k_w = p->k_w;
+    int k_h = p->k_h;
+    int s_w = p->s_w;
+    int s_h = p->s_h;
+    int d_w = p->d_w;
+    int d_h = p->d_h;
+    int pad_w0 = p->pad_w0;
+    int pad_h0 = p->pad_h0;
+    int out_w = p->out_w;
+    int col_line = p->col_line;
+    int kernel_size = k_w * k_h * in_c;
+    int in_xy = in_w * in_h;
+    int out_xy = out_w * p->out_h;
+
+    float* cur_col = col + col_i * col_line * kernel_size;
+    int col_start = col_i * col_line;
+    int col_end = out_xy * p->batch - col_start;
+    if (col_end > col_line)
+        col_end = col_line;
+
+    int imy_start[MAX_COL_LINE];
+    int imx_start[MAX_COL_LINE];
+    int image[MAX_COL_LINE];
+    for (int i = 0; i < col_line; i++)
+    {
+        int pix = col_start + (i < col_end ? i : 0);
+        int cnt = pix % out_xy;
+        image[i] = pix / out_xy;
+        imy_start[i] = (cnt / out_w) * s_h - pad_h0;
+        imx_start[i] = (cnt % out_w) * s_w - pad_w0;
+    }
+
+    /* all pixels of the line are in the same output row */
+    int same_row = col_end == col_line && image[0] == image[col_line - 1] && imy_start[0] == imy_start[col_line - 1];
+
+    for (int kch = 0; kch < in_c; kch++)
+    {
+        float* cur_input = input + image[0] * p->in_image_size + kch * in_xy;
+        for (int ky = 0; ky < k_h * d_h; ky += d_h)
+        {
+            for (int kx = 0; kx < k_w * d_w; kx += d_w)
+            {
+                if (same_row)
+                {
+                    int imy = imy_start[0] + ky;
+                    int imx0 = imx_start[0] + kx;
+                    int imx1 = imx_start[col_line - 1] + kx;
+
+                    if (imy < 0 || imy >= in_h)
+                    {
+                        for (int i = 0; i < col_line; i += 8)
+                            _mm256_storeu_ps(cur_col + i, _mm256_setzero_ps());
+                        cur_col += col_line;
+                        continue;
+                    }
+                    if (s_w == 1 && imx0 >= 0 && imx1 < in_w)
+                    {
+                        float* l0 = cur_input + imy * in_w + imx0;
+                        for (int i = 0; i < col_line; i += 8)
+                            _mm256_storeu_ps(cur_col + i, _mm256_loadu_ps(l0 + i));
+                        cur_col += col_line;
+                        continue;
+                    }
+                    for (int i = 0; i < col_line; i++)
+                    {
+                        int imx = imx_start[i] + kx;
+                        *cur_col++ = (imx >= 0 && imx < in_w) ? cur_input[imy * in_w + imx] : 0.f;
+                    }
+                }
+                else
+                {
+                    for (int i = 0; i < col_line; i++)
+                    {
+                        int imx = imx_start[i] + kx;
+                        int imy = imy_start[i] + ky;
+                        float* image_input = input + image[i] * p->in_image_size + kch * in_xy;
+                        if (i < col_end && imx >= 0 && imx < in_w && imy >= 0 && imy < in_h)
+                            *cur_col++ = image_input[imy * in_w + imx];
+                        else
+                            *cur_col++ = 0.f;
+                    }
+                }
+            }
+        }
+    }
+}
+
+static void im2col(float* input, float* col, int batch, int in_image_size, int in_c, int in_w, int in_h, int k_w,
+                   int k_h, int s_w, int s_h, int d_w, int d_h, int pad_w0, int pad_h0, int out_w, int out_h,
+                   int col_line, struct cpu_pool* pool)
+{
+    struct im2col_param param = {input, col, batch, in_image_size, in_c, in_w, in_h, k_w, k_h, s_w, s_h, d_w,
+                                 d_h, pad_w0, pad_h0, out_w, out_h, col_line};
+    int col_line_num = (out_w * out_h * batch + col_line - 1) / col_line;
+
+    cpu_pool_parallel_for(pool, im2col_task, &param, col_line_num);
+}
+
+static inline __m256 activation_avx(__m256 v, int activation)
+{
+    if (activation >= 0)
+    {
+        v = _mm256_max_ps(v, _mm256_setzero_ps());
+        if (activation > 0)
+            v = _mm256_min_ps(v, _mm256_set1_ps(6.f));
+    }
+
+    return v;
+}
+
+/*
+ * sgemm kernel of 24 output pixels x 4 output channels, the 24 pixels come from three
+ * continuous col lines. 12 ymm registers hold the accumulators.
+ */
+static void sgemm_24x4_avx2(float* biases, float* col, float* kernel, int kernel_size, float* output, int output_xy,
+                            int activation)
+{
+    float* col0 = col;
+    float* col1 = col + PER_COL_LINE * kernel_size;
+    float* col2 = col + 2 * PER_COL_LINE * kernel_size;
+
+    __m256 acc00, acc01, acc02, acc10, acc11, acc12, acc20, acc21, acc22, acc30, acc31, acc32;
+    if (biases)
+    {
+        acc00 = acc01 = acc02 = _mm256_broadcast_ss(biases);
+        acc10 = acc11 = acc12 = _mm256_broadcast_ss(biases + 1);
+        acc20 = acc21 = acc22 = _mm256_broadcast_ss(biases + 2);
+        acc30 = acc31 = acc32 = _mm256_broadcast_ss(biases + 3);
+    }
+    else
+    {
+        acc00 = acc01 = acc02 = acc10 = acc11 = acc12 = _mm256_setzero_ps();
+        acc20 = acc21 = acc22 = acc30 = acc31 = acc32 = _mm256_setzero_ps();
+    }
+
+    for (int k = 0; k < kernel_size; k++)
+    {
+        __m256 c0 = _mm256_loadu_ps(col0);
+        __m256 c1 = _mm256_loadu_ps(col1);
+        __m256 c2 = _mm256_loadu_ps(col2);
+
+        __m256 k0 = _mm256_broadcast_ss(kernel);
+        acc00 = _mm256_fmadd_ps(c0, k0, acc00);
+        acc01 = _mm256_fmadd_ps(c1, k0, acc01);
+        acc02 = _mm256_fmadd_ps(c2, k0, acc02);
+        __m256 k1 = _mm256_broadcast_ss(kernel + 1);
+        acc10 = _mm256_fmadd_ps(c0, k1, acc10);
+        acc11 = _mm256_fmadd_ps(c1, k1, acc11);
+        acc12 = _mm256_fmadd_ps(c2, k1, acc12);
+        __m256 k2 = _mm256_broadcast_ss(kernel + 2);
+        acc20 = _mm256_fmadd_ps(c0, k2, acc20);
+        acc21 = _mm256_fmadd_ps(c1, k2, acc21);
+        acc22 = _mm256_fmadd_ps(c2, k2, acc22);
+        __m256 k3 = _mm256_broadcast_ss(kernel + 3);
+        acc30 = _mm256_fmadd_ps(c0, k3, acc30);
+        acc31 = _mm256_fmadd_ps(c1, k3, acc31);
+        acc32 = _mm256_fmadd_ps(c2, k3, acc32);
+
+        col0 += PER_COL_LINE;
+        col1 += PER_COL_LINE;
+        col2 += PER_COL_LINE;
+        kernel += PER_OUT_CHAN;
+    }
+
+    _mm256_storeu_ps(output, activation_avx(acc00, activation));
+    _mm256_storeu_ps(output + 8, activation_avx(acc01, activation));
+    _mm256_storeu_ps(output + 16, activation_avx(acc02, activation));
+    output += output_xy;
+    _mm256_storeu_ps(output, activation_avx(acc10, activation));
+    _mm256_storeu_ps(output + 8, activation_avx(acc11, activation));
+    _mm256_storeu_ps(output + 16, activation_avx(acc12, activation));
+    output += output_xy;
+    _mm256_storeu_ps(output, activation_avx(acc20, activation));
+    _mm256_storeu_ps(output + 8, activation_avx(acc21, activation));
+    _mm256_storeu_ps(output + 16, activation_avx(acc22, activation));
+    output += output_xy;
+    _mm256_storeu_ps(output, activation_avx(acc30, activation));
+    _mm256_storeu_ps(output + 8, activation_avx(acc31, activation));
+    _mm256_storeu_ps(output + 16, activation_avx(acc32, activation));
+}
+
+/* sgemm kernel of 8 output pixels x 4 output channels, for the remained col lines */
+static void sgemm_8x4_avx2(float* biases, float* col, float* kernel, int kernel_size, float* output, int output_xy,
+                           int activation)
+{
+    __m256 acc0, acc1, acc2, acc3;
+    if (biases)
+    {
+        acc0 = _mm256_broadcast_ss(biases);
+        acc1 = _mm256_broadcast_ss(biases + 1);
+        acc2 = _mm256_broadcast_ss(biases + 2);
+        acc3 = _mm256_broadcast_ss(biases + 3);
+    }
+    else
+    {
+        acc0 = acc1 = acc2 = acc3 = _mm256_setzero_ps();
+    }
+
+    for (int k = 0; k < kernel_size; k++)
+    {
+        __m256 c0 = _mm256_loadu_ps(col);
+        acc0 = _mm256_fmadd_ps(c0, _mm256_broadcast_ss(kernel), acc0);
+        acc1 = _mm256_fmadd_ps(c0, _mm256_broadcast_ss(kernel + 1), acc1);
+        acc2 = _mm256_fmadd_ps(c0, _mm256_broadcast_ss(kernel + 2), acc2);
+        acc3 = _mm256_fmadd_ps(c0, _mm256_broadcast_ss(kernel + 3), acc3);
+
+        col += PER_COL_LINE;
+        kernel += PER_OUT_CHAN;
+    }
+
+    _mm256_storeu_ps(output, activation_avx(acc0, activation));
+    _mm256_storeu_ps(output + output_xy, activation_avx(acc1, activation));
+    _mm256_storeu_ps(output + 2 * output_xy, activation_avx(acc2, activation));
+    _mm256_storeu_ps(output + 3 * output_xy, activation_avx(acc3, activation));
+}
+
+/*
+ * run the sgemm kernel on one col set (3 col lines) or one col line for all the output
+ * channels. col_cnt is the pixel count of the block, col_end the valid pixels left in
+ * the output starting from it.
+ */
+static void sgemm_block(sgemm_kernel_t sgemm_kernel, float* col, int col_cnt, int col_end, float* kernel,
+                        float* biases, float* output, int kernel_size, int out_chan, int output_xy, int activation)
+{
+    int kernel_num = (out_chan + PER_OUT_CHAN - 1) / PER_OUT_CHAN;
+
+    for (int p = 0; p < kernel_num; p++)
+    {
+        int ch = p * PER_OUT_CHAN;
+        int ch_end = out_chan - ch;
+        float* cur_kernel = kernel + ch * kernel_size;
+        float* cur_output = output + ch * output_xy;
+        float bias_tmp[PER_OUT_CHAN];
+        float* cur_bias = NULL;
+
+        if (biases)
+        {
+            if (ch_end >= PER_OUT_CHAN)
+            {
+                cur_bias = biases + ch;
+            }
+            else
+            {
+                for (int i = 0; i < PER_OUT_CHAN; i++)
+                    bias_tmp[i] = i < ch_end ? biases[ch + i] : 0.f;
+                cur_bias = bias_tmp;
+            }
+        }
+
+        if (ch_end >= PER_OUT_CHAN && col_end >= col_cnt)
+        {
+            sgemm_kernel(cur_bias, col, cur_kernel, kernel_size, cur_output, output_xy, activation);
+        }
+        else
+        {
+            /* the edge of the output, compute into a temp buffer and copy the valid part */
+            float result[PER_OUT_CHAN * 3 * MAX_COL_LINE];
+            sgemm_kernel(cur_bias, col, cur_kernel, kernel_size, result, col_cnt, activation);
+
+            int i_end = ch_end < PER_OUT_CHAN ? ch_end : PER_OUT_CHAN;
+            int j_end = col_end < col_cnt ? col_end : col_cnt;
+            for (int i = 0; i < i_end; i++)
+                memcpy(cur_output + i * output_xy, result + i * col_cnt, j_end * sizeof(float));
+        }
+    }
+}
+
+/*
+ * a block of the col matrix of a batch, pix_start is its first pixel in the batch and pix_num the
+ * pixels of the batch. a block which runs into the next image is computed into a temp buffer and
+ * every part of it is copied to the output of its image.
+ */
+static void sgemm_block_batch(sgemm_kernel_t sgemm_kernel, float* col, int col_cnt, int pix_start, int pix_num,
+                              float* kernel, float* biases, float* output, int kernel_size, int out_chan,
+                              int output_xy, int output_image_size, int activation)
+{
+    int image = pix_start / output_xy;
+    int pix = pix_start % output_xy;
+    int pix_end = pix_num - pix_start < col_cnt ? pix_num - pix_start : col_cnt;
+
+    if (pix + pix_end <= output_xy)
+    {
+        sgemm_block(sgemm_kernel, col, col_cnt, output_xy - pix, kernel, biases,
+                    output + image * output_image_size + pix, kernel_size, out_chan, output_xy, activation);
+        return;
+    }
+
+    for (int ch = 0; ch < out_chan; ch += PER_OUT_CHAN)
+    {
+        float result[PER_OUT_CHAN * 3 * MAX_COL_LINE];
+        int ch_num = out_chan - ch < PER_OUT_CHAN ? out_chan - ch : PER_OUT_CHAN;
+
+        sgemm_block(sgemm_kernel, col, col_cnt, col_cnt, kernel + ch * kernel_size, biases ? biases + ch : NULL, result,
+                    kernel_size, ch_num, col_cnt, activation);
+
+        for (int j = 0; j < pix_end;)
+        {
+            int cur_image = (pix_start + j) / output_xy;
+            int cur_pix = (pix_start + j) % output_xy;
+            int cnt = output_xy - cur_pix < pix_end - j ? output_xy - cur_pix : pix_end - j;
+            float* cur_output = output + cur_image * output_image_size + ch * output_xy + cur_pix;
+
+            for (int i = 0; i < ch_num; i++)
+                memcpy(cur_output + i * output_xy, result + i * col_cnt + j, cnt * sizeof(float));
+
+            j += cnt;
+        }
+    }
+}
+
+static void get_sgemm_kernels(int isa, sgemm_kernel_t* set_kernel, sgemm_kernel_t* line_kernel, int* col_line)
+{
+    if (isa & CPU_ISA_AVX512F)
+    {
+        *set_kernel = sgemm_48x4_avx512;
+        *line_kernel = sgemm_16x4_avx512;
+        *col_line = PER_COL_LINE_AVX512;
+    }
+    else
+    {
+        *set_kernel = sgemm_24x4_avx2;
+        *line_kernel = sgemm_8x4_avx2;
+        *col_line = PER_COL_LINE;
+    }
+}
+
+struct sgemm_param
+{
+    float* col;
+    float* kernel;
+    float* biases;
+    float* output;
+    int kernel_size;
+    int out_chan;
+    int output_xy;
+    int output_image_size;
+    int batch;
+    int activation;
+    int col_line;
+    int col_set_num;
+    sgemm_kernel_t set_kernel;
+    sgemm_kernel_t line_kernel;
+};
+
+/* every task works on one col set (3 col lines) or one remained col line */
+static void sgemm_set_task(void* arg, int t)
+{
+    struct sgemm_param* p = ( struct sgemm_param* )arg;
+    int col_set_num = p->col_set_num;
+    int col_line = p->col_line;
+
+    int col_line_idx = t < col_set_num ? t * 3 : col_set_num * 3 + (t - col_set_num);
+    int col_cnt = t < col_set_num ? 3 * col_line : col_line;
+    int col_start = col_line_idx * col_line;
+    float* cur_col = p->col + col_start * p->kernel_size;
+    sgemm_kernel_t sgemm_kernel = t < col_set_num ? p->set_kernel : p->line_kernel;
+
+    sgemm_block_batch(sgemm_kernel, cur_col, col_cnt, col_start, p->output_xy * p->batch, p->kernel, p->biases,
+                      p->output, p->kernel_size, p->out_chan, p->output_xy, p->output_image_size, p->activation);
+}
+
+static void sgemm_batch_x86(float* col, float* kernel, float* biases, float* output, int kernel_size, int out_chan,
+                            int output_xy, int batch, int output_image_size, int activation, int isa,
+                            struct cpu_pool* pool)
+{
+    struct sgemm_param param;
+
+    get_sgemm_kernels(isa, &param.set_kernel, &param.line_kernel, &param.col_line);
+
+    int col_line_num = (output_xy * batch + param.col_line - 1) / param.col_line;
+
+    param.col = col;
+    param.kernel = kernel;
+    param.biases = biases;
+    param.output = output;
+    param.kernel_size = kernel_size;
+    param.out_chan = out_chan;
+    param.output_xy = output_xy;
+    param.output_image_size = output_image_size;
+    param.batch = batch;
+    param.activation = activation;
+    param.col_set_num = col_line_num / 3;
+
+    cpu_pool_parallel_for(pool, sgemm_set_task, &param, param.col_set_num + col_line_num % 3);
+}
+
+void sgemm_set_x86(float* col, float* kernel, float* biases, float* output, int kernel_size, int out_chan,
+                   int output_xy, int activation, int isa, struct cpu_pool* pool)
+{
+    sgemm_batch_x86(col, kernel, biases, output, kernel_size, out_chan, output_xy, 1, 0, activation, isa, pool);
+}
+
+/*
+ * 1x1 convolution without padding skips im2col: the input of a stride 1 conv already is the
+ * col matrix. every thread copies (stride 1) or gathers (stride 2) only the col set it works
+ * on, in the im2col line layout, into a small buffer which stays in cache for all the output
+ * channels. so no col buffer of the whole image is needed. the pixels of a batch follow each
+ * other like in im2col(), a line across two images is gathered.
+ */
+static void pack_pw_block(float* input, float* col, int in_c, int in_w, int in_xy, int in_image_size, int out_w,
+                          int out_xy, int stride, int col_line, int pix_start, int pix_cnt, int line_num)
+{
+    for (int l = 0; l < line_num; l++)
+    {
+        int line_start = pix_start + l * col_line;
+        int line_cnt = pix_cnt - l * col_line;
+        float* cur_col = col + l * col_line * in_c;
+
+        if (line_cnt > col_line)
+            line_cnt = col_line;
+
+        int image = line_start / out_xy;
+        int image_end = (line_start + line_cnt - 1) / out_xy;
+        float* image_input = input + image * in_image_size;
+
+        line_start -= image * out_xy;
+
+        if (image != image_end)
+        {
+            int offset[MAX_COL_LINE];
+            for (int i = 0; i < col_line; i++)
+            {
+                int pix = line_start + (i < line_cnt ? i : 0);
+                int pix_image = pix / out_xy;
+
+                pix -= pix_image * out_xy;
+                offset[i] = pix_image * in_image_size + (pix / out_w) * stride * in_w + (pix % out_w) * stride;
+            }
+
+            for (int k = 0; k < in_c; k++)
+            {
+                for (int i = 0; i < col_line; i++)
+                    cur_col[i] = image_input[k * in_xy + offset[i]];
+                cur_col += col_line;
+            }
+        }
+        else if (stride == 1 && line_cnt == col_line)
+        {
+            float* cur_input = image_input + line_start;
+            for (int k = 0; k < in_c; k++)
+            {
+                for (int i = 0; i < col_line; i += 8)
+                    _mm256_storeu_ps(cur_col + i, _mm256_loadu_ps(cur_input + i));
+                cur_input += in_xy;
+                cur_col += col_line;
+            }
+        }
+        else if (stride == 1)
+        {
+            float* cur_input = image_input + line_start;
+            for (int k = 0; k < in_c; k++)
+            {
+                for (int i = 0; i < col_line; i++)
+                    cur_col[i] = i < line_cnt ? cur_input[i] : 0.f;
+                cur_input += in_xy;
+                cur_col += col_line;
+            }
+        }
+        else
+        {
+            /* the pixels beyond line_cnt repeat the first one, their results are dropped */
+            int offset[MAX_COL_LINE];
+            for (int i = 0; i < col_line; i++)
+            {
+                int pix = line_start + (i < line_cnt ? i : 0);
+                offset[i] = (pix / out_w) * stride * in_w + (pix % out_w) * stride;
+            }
+
+            for (int k = 0; k < in_c; k++)
+            {
+                float* cur_input = image_input + k * in_xy;
+                for (int i = 0; i < col_line; i += 8)
+                {
+                    __m256i idx = _mm256_loadu_si256(( __m256i* )(offset + i));
+                    _mm256_storeu_ps(cur_col + i, _mm256_i32gather_ps(cur_input, idx, 4));
+                }
+                cur_col += col_line;
+            }
+        }
+    }
+}
+
+static int pointwise_support(struct conv_param* param)
+{
+    if (param->kernel_h != 1 || param->kernel_w != 1)
+        return 0;
+    if (param->pad_h0 != 0 || param->pad_w0 != 0 || param->pad_h1 != 0 || param->pad_w1 != 0)
+        return 0;
+    if (param->stride_h != param->stride_w || (param->stride_h != 1 && param->stride_h != 2))
+        return 0;
+
+    return 1;
+}
+
+static int get_pointwise_pack_size(int in_c, int isa)
+{
+    sgemm_kernel_t sgemm_set_kernel;
+    sgemm_kernel_t sgemm_line_kernel;
+    int col_line;
+
+    get_sgemm_kernels(isa, &sgemm_set_kernel, &sgemm_line_kernel, &col_line);
+
+    return in_c * 3 * col_line;
+}
+
+struct pointwise_param
+{
+    float* input;
+    float* kernel;
+    float* biases;
+    float* output;
+    float* pack_buf;
+    int pack_size;
+    int in_c;
+    int in_w;
+    int in_xy;
+    int in_image_size;
+    int out_c;
+    int out_w;
+    int out_xy;
+    int out_image_size;
+    int batch;
+    int stride;
+    int activation;
+    int col_line;
+    int col_set_num;
+    int task_num;
+    int task_per_thread;
+    sgemm_kernel_t set_kernel;
+    sgemm_kernel_t line_kernel;
+};
+
+/* every thread owns a pack buffer, so the tasks are handed out in per thread chunks */
+static void pointwise_task(void* arg, int t)
+{
+    struct pointwise_param* p = ( struct pointwise_param* )arg;
+    float* col = p->pack_buf + t * p->pack_size;
+    int col_set_num = p->col_set_num;
+    int col_line = p->col_line;
+    int task_end = (t + 1) * p->task_per_thread < p->task_num ? (t + 1) * p->task_per_thread : p->task_num;
+
+    for (int task = t * p->task_per_thread; task < task_end; task++)
+    {
+        int col_line_idx = task < col_set_num ? task * 3 : col_set_num * 3 + (task - col_set_num);
+        int line_num = task < col_set_num ? 3 : 1;
+        int col_start = col_line_idx * col_line;
+        int pix_num = p->out_xy * p->batch;
+        sgemm_kernel_t sgemm_kernel = task < col_set_num ? p->set_kernel : p->line_kernel;
+
+        pack_pw_block(p->input, col, p->in_c, p->in_w, p->in_xy, p->in_image_size, p->out_w, p->out_xy, p->stride,
+                      col_line, col_start, pix_num - col_start, line_num);
+        sgemm_block_batch(sgemm_kernel, col, line_num * col_line, col_start, pix_num, p->kernel, p->biases, p->output,
+                          p->in_c, p->out_c, p->out_xy, p->out_image_size, p->activation);
+    }
+}
+
+static int conv_pointwise_x86(float* input, float* kernel, float* biases, float* output, int batch, int in_image_size,
+                              int out_image_size, int in_c, int in_h, int in_w, int out_c, int out_h, int out_w,
+                              int stride, int activation, int isa, float* pack_buf, int pack_buf_size,
+                              struct cpu_pool* pool)
+{
+    struct pointwise_param param;
+
+    get_sgemm_kernels(isa, &param.set_kernel, &param.line_kernel, &param.col_line);
+
+    int col_line = param.col_line;
+    int out_xy = out_h * out_w;
+    int col_line_num = (out_xy * batch + col_line - 1) / col_line;
+    int col_set_num = col_line_num / 3;
+    int task_num = col_set_num + col_line_num % 3;
+    int num_thread = get_cpu_pool_thread_num(pool);
+
+    int pack_size = in_c * 3 * col_line;
+    int pack_num = pack_buf_size / (( int )sizeof(float) * pack_size);
+
+    if (num_thread > task_num)
+        num_thread = task_num;
+    if (num_thread > pack_num)
+        num_thread = pack_num;
+    if (num_thread < 1)
+        return -1;
+
+    param.pack_size = pack_size;
+    param.pack_buf = pack_buf;
+    param.input = input;
+    param.kernel = kernel;
+    param.biases = biases;
+    param.output = output;
+    param.in_c = in_c;
+    param.in_w = in_w;
+    param.in_xy = in_h * in_w;
+    param.in_image_size = in_image_size;
+    param.out_c = out_c;
+    param.out_w = out_w;
+    param.out_xy = out_xy;
+    param.out_image_size = out_image_size;
+    param.batch = batch;
+    param.stride = stride;
+    param.activation = activation;
+    param.col_set_num = col_set_num;
+    param.task_num = task_num;
+    param.task_per_thread = (task_num + num_thread - 1) / num_thread;
+
+    cpu_pool_parallel_for(pool, pointwise_task, &param, num_thread);
+
+    return 0;
+}
+
+static int winograd_support(struct conv_param* param, int in_h, int in_w)
+{
+    int kernel_h = param->kernel_h;
+    int kernel_w = param->kernel_w;
+    int stride_h = param->stride_h;
+    int stride_w = param->stride_w;
+    int dilation_h = param->dilation_h;
+    int dilation_w = param->dilation_w;
+    int output_chan = param->output_channel;
+    int group = param->group;
+
+    if (in_h < 7 && in_w < 7)
+        return 0;
+    if (in_h < 10 && in_w < 10 && output_chan < 16)
+        return 0;
+    if (group != 1 || kernel_h != 3 || kernel_w != 3)
+        return 0;
+    if (dilation_h != 1 || dilation_w != 1 || stride_h != 1 || stride_w != 1)
+        return 0;
+
+    return 1;
+}
+
+/* the images which run in one gemm, the col buffer is sized for them */
+static int get_batch_chunk(int batch, int output_xy)
+{
+    int chunk = (BATCH_GEMM_PIX + output_xy - 1) / output_xy;
+
+    return chunk < batch ? chunk : batch;
+}
+
+int conv_x86_get_shared_mem_size(struct ir_tensor* input, struct ir_tensor* output, struct conv_param* param)
+{
+    if (winograd_support(param, input->dims[2], input->dims[3]))
+        return wino_conv_x86_get_shared_mem_size(input, output, param);
+
+    /* no col buffer for 1x1 */
+    if (pointwise_support(param))
+        return 0;
+
+    int group = param->group;
+    int input_chan = param->input_channel / group;
+    int kernel_size = input_chan * param->kernel_h * param->kernel_w;
+
+    int output_xy = output->dims[2] * output->dims[3];
+    int col_pix = output_xy * get_batch_chunk(output->dims[0], output_xy);
+    int elem_size = input->elem_size;
+    int mem_size = elem_size * kernel_size * ((col_pix + MAX_COL_LINE - 1) & -MAX_COL_LINE) + 128;
+
+    return mem_size;
+}
+
+int conv_x86_set_shared_mem(struct conv_priv_info* priv_info, void* mem, int mem_size)
+{
+    priv_info->external_im2col_mem = 1;
+    priv_info->im2col_buffer = mem;
+    priv_info->im2col_buffer_size = mem_size;
+
+    return 0;
+}
+
+static int get_private_mem_size(struct ir_tensor* filter, struct conv_param* param)
+{
+    int group = param->group;
+    int out_chan = filter->dims[0] / group;
+    int kernel_size = filter->dims[1] * filter->dims[2] * filter->dims[3];
+
+    return kernel_size * filter->elem_size * ((out_chan + PER_OUT_CHAN - 1) & -PER_OUT_CHAN) * group + 128;
+}
+
+int conv_x86_prerun(struct ir_tensor* input_tensor, struct ir_tensor* filter_tensor, struct ir_tensor* output_tensor,
+                    struct conv_priv_info* priv_info, struct conv_param* param)
+{
+    int in_h = input_tensor->dims[2];
+    int in_w = input_tensor->dims[3];
+
+    priv_info->winograd = winograd_support(param, in_h, in_w);
+
+    if (priv_info->winograd)
+    {
+        return wino_conv_x86_prerun(input_tensor, filter_tensor, output_tensor, priv_info, param);
+    }
+
+    int pointwise = pointwise_support(param);
+
+    if (!pointwise && !priv_info->external_im2col_mem)
+    {
+        int mem_size = conv_x86_get_shared_mem_size(input_tensor, output_tensor, param);
+        void* mem = sys_malloc(mem_size);
+        priv_info->im2col_buffer = mem;
+        priv_info->im2col_buffer_size = mem_size;
+    }
+
+    /* a packed kernel of another layout can not be used, pack it again */
+    if (priv_info->interleave_packed && priv_info->interleave_buffer_size != get_private_mem_size(filter_tensor, param))
+    {
+        priv_info->interleave_packed = 0;
+        priv_info->external_interleave_mem = 0;
+        priv_info->interleave_buffer = NULL;
+    }
+
+    if (!priv_info->external_interleave_mem && priv_info->interleave_buffer == NULL)
+    {
+        int mem_size = get_private_mem_size(filter_tensor, param);
+        void* mem = sys_malloc(mem_size);
+        priv_info->interleave_buffer = mem;
+        priv_info->interleave_buffer_size = mem_size;
+    }
+
+    if (pointwise && priv_info->pack_buffer == NULL)
+    {
+        int num_thread = priv_info->num_thread > 0 ? priv_info->num_thread : 1;
+        int mem_size = sizeof(float) * get_pointwise_pack_size(param->input_channel / param->group, priv_info->isa);
+
+        priv_info->pack_buffer = sys_malloc(mem_size * num_thread);
+        priv_info->pack_buffer_size = mem_size * num_thread;
+    }
+
+    if ((!pointwise && priv_info->im2col_buffer == NULL) || (pointwise && priv_info->pack_buffer == NULL) ||
+        priv_info->interleave_buffer == NULL)
+        return -1;
+
+    if (!priv_info->interleave_packed)
+        interleave(filter_tensor, priv_info, param);
+
+    return 0;
+}
+
+int conv_x86_postrun(struct conv_priv_info* priv_info)
+{
+    if (!priv_info->external_interleave_mem && priv_info->interleave_buffer != NULL)
+    {
+        sys_free(priv_info->interleave_buffer);
+        priv_info->interleave_buffer = NULL;
+    }
+
+    if (!priv_info->external_im2col_mem && priv_info->im2col_buffer != NULL)
+    {
+        sys_free(priv_info->im2col_buffer);
+        priv_info->im2col_buffer = NULL;
+    }
+
+    if (!priv_info->standby_external && priv_info->standby_buffer != NULL)
+    {
+        sys_free(priv_info->standby_buffer);
+        priv_info->standby_buffer = NULL;
+    }
+
+    if (priv_info->pack_buffer != NULL)
+    {
+        sys_free(priv_info->pack_buffer);
+        priv_info->pack_buffer = NULL;
+        priv_info->pack_buffer_size = 0;
+    }
+
+    return 0;
+}
+
+int conv_x86_reshape(struct ir_tensor* input_tensor, struct ir_tensor* filter_tensor, struct ir_tensor* output_tensor,
+                     struct conv_priv_info* priv_info, struct conv_param* param)
+{
+    /* winograd is picked by the input size, its kernel layout differs from the gemm one */
+    if (winograd_support(param, input_tensor->dims[2], input_tensor->dims[3]) != priv_info->winograd)
+    {
+        /* swap with the standby kernel, it is only packed the first time the layout is needed */
+        void* buffer = priv_info->interleave_buffer;
+        int buffer_size = priv_info->interleave_buffer_size;
+        int external = priv_info->external_interleave_mem;
+
+        priv_info->interleave_buffer = priv_info->standby_buffer;
+        priv_info->interleave_buffer_size = priv_info->standby_buffer_size;
+        priv_info->external_interleave_mem = priv_info->standby_external;
+        priv_info->interleave_packed = priv_info->standby_buffer != NULL;
+
+        priv_info->standby_buffer = buffer;
+        priv_info->standby_buffer_size = buffer_size;
+        priv_info->standby_external = external;
+
+        if (!priv_info->external_im2col_mem && priv_info->im2col_buffer != NULL)
+        {
+            sys_free(priv_info->im2col_buffer);
+            priv_info->im2col_buffer = NULL;
+        }
+
+        return conv_x86_prerun(input_tensor, filter_tensor, output_tensor, priv_info, param);
+    }
+
+    int mem_size = conv_x86_get_shared_mem_size(input_tensor, output_tensor, param);
+
+    if (priv_info->external_im2col_mem || priv_info->im2col_buffer == NULL || mem_size <= priv_info->im2col_buffer_size)
+        return 0;
+
+    sys_free(priv_info->im2col_buffer);
+
+    priv_info->im2col_buffer = sys_malloc(mem_size);
+    priv_info->im2col_buffer_size = mem_size;
+
+    return priv_info->im2col_buffer ? 0 : -1;
+}
+
+int conv_x86_run(struct ir_tensor* input_tensor, struct ir_tensor* filter_tensor, struct ir_tensor* bias_tensor,
+                 struct ir_tensor* output_tensor, struct conv_priv_info* priv_info, struct conv_param* param,
+                 int num_thread, int cpu_affinity)
+{
+    /* param */
+    int group = param->group;
+    int kernel_h = param->kernel_h;
+    int kernel_w = param->kernel_w;
+    int stride_h = param->stride_h;
+    int stride_w = param->stride_w;
+    int dilation_h = param->dilation_h;
+    int dilation_w = param->dilation_w;
+    int pad_h0 = param->pad_h0;
+    int pad_w0 = param->pad_w0;
+    int act_type = param->activation;
+
+    int batch = input_tensor->dims[0];
+    int in_c = input_tensor->dims[1] / group;
+    int in_h = input_tensor->dims[2];
+    int in_w = input_tensor->dims[3];
+    int input_size = in_c * in_h * in_w;
+    int kernel_size = in_c * kernel_h * kernel_w;
+    int input_image_size = input_tensor->dims[1] * input_tensor->dims[2] * input_tensor->dims[3];
+
+    if (winograd_support(param, in_h, in_w))
+    {
+        return wino_conv_x86_run(input_tensor, filter_tensor, bias_tensor, output_tensor, priv_info, param, num_thread,
+                                 cpu_affinity);
+    }
+
+    int out_c = output_tensor->dims[1] / group;
+    int out_h = output_tensor->dims[2];
+    int out_w = output_tensor->dims[3];
+    int out_hw = out_h * out_w;
+    int output_size = out_c * out_h * out_w;
+    int out_c_align = ((out_c + PER_OUT_CHAN - 1) & -PER_OUT_CHAN);
+    int output_image_size = output_tensor->dims[1] * output_tensor->dims[2] * output_tensor->dims[3];
+
+    /* buffer addr */
+    float* input_buf = ( float* )input_tensor->data;
+    float* output_buf = ( float* )output_tensor->data;
+    float* biases_buf = NULL;
+    if (bias_tensor != NULL)
+        biases_buf = ( float* )bias_tensor->data;
+    float* col_buf = ( float* )priv_info->im2col_buffer;
+    float* interleave_buf = ( float* )priv_info->interleave_buffer;
+    int col_line = (priv_info->isa & CPU_ISA_AVX512F) ? PER_COL_LINE_AVX512 : PER_COL_LINE;
+
+    /* the whole batch is one gemm for 1x1, it needs no col buffer */
+    if (pointwise_support(param))
+    {
+        for (int g = 0; g < group; g++)
+        {
+            float* cur_input = input_buf + g * input_size;
+            float* cur_kernel = interleave_buf + g * kernel_size * out_c_align;
+            float* cur_output = output_buf + g * output_size;
+            float* cur_bias = biases_buf ? (biases_buf + g * out_c) : NULL;
+
+            if (conv_pointwise_x86(cur_input, cur_kernel, cur_bias, cur_output, batch, input_image_size,
+                                   output_image_size, in_c, in_h, in_w, out_c, out_h, out_w, stride_h, act_type,
+                                   priv_info->isa, priv_info->pack_buffer, priv_info->pack_buffer_size,
+                                   priv_info->cpu_pool) < 0)
+                return -1;
+        }
+
+        return 0;
+    }
+
+    int chunk = get_batch_chunk(batch, out_hw);
+
+    for (int n = 0; n < batch; n += chunk)
+    {
+        int image_num = batch - n < chunk ? batch - n : chunk;
+
+        for (int g = 0; g < group; g++)
+        {
+            /* im2col */
+            float* cur_input = input_buf + n * input_image_size + g * input_size;
+            im2col(cur_input, col_buf, image_num, input_image_size, in_c, in_w, in_h, kernel_w, kernel_h, stride_w,
+                   stride_h, dilation_w, dilation_h, pad_w0, pad_h0, out_w, out_h, col_line, priv_info->cpu_pool);
+
+            /* gemm */
+            float* cur_kernel = interleave_buf + g * kernel_size * out_c_align;
+            float* cur_output = output_buf + n * output_image_size + g * output_size;
+            float* cur_bias = biases_buf ? (biases_buf + g * out_c) : NULL;
+
+            sgemm_batch_x86(col_buf, cur_kernel, cur_bias, cur_output, kernel_size, out_c, out_hw, image_num,
+                            output_image_size, act_type, priv_info->isa, priv_info->cpu_pool);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,73 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * License); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * AS IS BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*
+ * Copyright (c) 2020, OPEN AI LAB
+ * Author: haoluo@openailab.com
+ */
+
+#ifndef _CONV_KERNEL_X86_H_
+#define _CONV_KERNEL_X86_H_
+
+#include "tengine_ir.h"
+#include "convolution_param.h"
+
+struct cpu_pool;
+
+struct conv_priv_info
+{
+    void* interleave_buffer;
+    void* im2col_buffer;
+    void* p_input_max;
+    void* p_kernel_max;
+    int im2col_buffer_size;
+    int interleave_buffer_size;
+    int external_im2col_mem;
+    int external_interleave_mem;
+    int interleave_packed; /* interleave_buffer already holds the packed kernel, taken from the pack cache */
+    int winograd; /* the kernel is transformed for winograd, not interleaved for gemm */
+    void* standby_buffer; /* the kernel in the other layout, kept in case the input size switches back */
+    int standby_buffer_size;
+    int standby_external;
+    void* pack_buffer; /* the per-thread column blocks of the 1x1 path */
+    int pack_buffer_size;
+    int num_thread;
+    int cpu_type;
+    int isa;
+    struct cpu_pool* cpu_pool; /* the worker threads of the exec graph */
+};
+
+int conv_x86_prerun(struct ir_tensor* input_tensor, struct ir_tensor* filter_tensor, struct ir_tensor* output_tensor,
+                    struct conv_priv_info* info, struct conv_param* param) __attribute__((weak));
+
+int conv_x86_postrun(struct conv_priv_info* info) __attribute__((weak));
+
+int conv_x86_reshape(struct ir_tensor* input_tensor, struct ir_tensor* filter_tensor, struct ir_tensor* output_tensor,
+                     struct conv_priv_info* info, struct conv_param* param) __attribute__((weak));
+
+int conv_x86_run(struct ir_tensor* input_tensor, struct ir_tensor* filter_tensor, struct ir_tensor* bias_tensor,
+                 struct ir_tensor* output_tensor, struct conv_priv_info* conv_info, struct conv_param* param,
+                 int num_thread, int cpu_affinity) __attribute__((weak));
+
+int conv_x86_get_shared_mem_size(struct ir_tensor* input_tensor, struct ir_tensor* output_tensor,
+                                 struct conv_param* param) __attribute__((weak));
+
+int conv_x86_set_shared_mem(struct conv_priv_info* priv_info, void* mem, int mem_size) __attribute__((weak));
+
+#endif
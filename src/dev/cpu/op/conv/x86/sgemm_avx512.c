@@ -0,0 +1,146 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * License); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * AS IS BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*
+ * Copyright (c) 2020, OPEN AI LAB
+ * Author: haoluo@openailab.com
+ */
+#include <immintrin.h>
+
+/* the col lines of the avx-512 kernels hold 16 output pixels */
+#define PER_OUT_CHAN 4
+#define PER_COL_LINE 16
+
+static inline __m512 activation_avx512(__m512 v, int activation)
+{
+    if (activation >= 0)
+    {
+        v = _mm512_max_ps(v, _mm512_setzero_ps());
+        if (activation > 0)
+            v = _mm512_min_ps(v, _mm512_set1_ps(6.f));
+    }
+
+    return v;
+}
+
+/*
+ * sgemm kernel of 48 output pixels x 4 output channels, the 48 pixels come from three
+ * continuous col lines. 12 zmm registers hold the accumulators.
+ */
+void sgemm_48x4_avx512(float* biases, float* col, float* kernel, int kernel_size, float* output, int output_xy,
+                       int activation)
+{
+    float* col0 = col;
+    float* col1 = col + PER_COL_LINE * kernel_size;
+    float* col2 = col + 2 * PER_COL_LINE * kernel_size;
+
+    __m512 acc00, acc01, acc02, acc10, acc11, acc12, acc20, acc21, acc22, acc30, acc31, acc32;
+    if (biases)
+    {
+        acc00 = acc01 = acc02 = _mm512_set1_ps(biases[0]);
+        acc10 = acc11 = acc12 = _mm512_set1_ps(biases[1]);
+        acc20 = acc21 = acc22 = _mm512_set1_ps(biases[2]);
+        acc30 = acc31 = acc32 = _mm512_set1_ps(biases[3]);
+    }
+    else
+    {
+        acc00 = acc01 = acc02 = acc10 = acc11 = acc12 = _mm512_setzero_ps();
+        acc20 = acc21 = acc22 = acc30 = acc31 = acc32 = _mm512_setzero_ps();
+    }
+
+    for (int k = 0; k < kernel_size; k++)
+    {
+        __m512 c0 = _mm512_loadu_ps(col0);
+        __m512 c1 = _mm512_loadu_ps(col1);
+        __m512 c2 = _mm512_loadu_ps(col2);
+
+        __m512 k0 = _mm512_set1_ps(kernel[0]);
+        acc00 = _mm512_fmadd_ps(c0, k0, acc00);
+        acc01 = _mm512_fmadd_ps(c1, k0, acc01);
+        acc02 = _mm512_fmadd_ps(c2, k0, acc02);
+        __m512 k1 = _mm512_set1_ps(kernel[1]);
+        acc10 = _mm512_fmadd_ps(c0, k1, acc10);
+        acc11 = _mm512_fmadd_ps(c1, k1, acc11);
+        acc12 = _mm512_fmadd_ps(c2, k1, acc12);
+        __m512 k2 = _mm512_set1_ps(kernel[2]);
+        acc20 = _mm512_fmadd_ps(c0, k2, acc20);
+        acc21 = _mm512_fmadd_ps(c1, k2, acc21);
+        acc22 = _mm512_fmadd_ps(c2, k2, acc22);
+        __m512 k3 = _mm512_set1_ps(kernel[3]);
+        acc30 = _mm512_fmadd_ps(c0, k3, acc30);
+        acc31 = _mm512_fmadd_ps(c1, k3, acc31);
+        acc32 = _mm512_fmadd_ps(c2, k3, acc32);
+
+        col0 += PER_COL_LINE;
+        col1 += PER_COL_LINE;
+        col2 += PER_COL_LINE;
+        kernel += PER_OUT_CHAN;
+    }
+
+    _mm512_storeu_ps(output, activation_avx512(acc00, activation));
+    _mm512_storeu_ps(output + 16, activation_avx512(acc01, activation));
+    _mm512_storeu_ps(output + 32, activation_avx512(acc02, activation));
+    output += output_xy;
+    _mm512_storeu_ps(output, activation_avx512(acc10, activation));
+    _mm512_storeu_ps(output + 16, activation_avx512(acc11, activation));
+    _mm512_storeu_ps(output + 32, activation_avx512(acc12, activation));
+    output += output_xy;
+    _mm512_storeu_ps(output, activation_avx512(acc20, activation));
+    _mm512_storeu_ps(output + 16, activation_avx512(acc21, activation));
+    _mm512_storeu_ps(output + 32, activation_avx512(acc22, activation));
+    output += output_xy;
+    _mm512_storeu_ps(output, activation_avx512(acc30, activation));
+    _mm512_storeu_ps(output + 16, activation_avx512(acc31, activation));
+    _mm512_storeu_ps(output + 32, activation_avx512(acc32, activation));
+}
+
+/* sgemm kernel of 16 output pixels x 4 output channels, for the remained col lines */
+void sgemm_16x4_avx512(float* biases, float* col, float* kernel, int kernel_size, float* output, int output_xy,
+                       int activation)
+{
+    __m512 acc0, acc1, acc2, acc3;
+    if (biases)
+    {
+        acc0 = _mm512_set1_ps(biases[0]);
+        acc1 = _mm512_set1_ps(biases[1]);
+        acc2 = _mm512_set1_ps(biases[2]);
+        acc3 = _mm512_set1_ps(biases[3]);
+    }
+    else
+    {
+        acc0 = acc1 = acc2 = acc3 = _mm512_setzero_ps();
+    }
+
+    for (int k = 0; k < kernel_size; k++)
+    {
+        __m512 c0 = _mm512_loadu_ps(col);
+        acc0 = _mm512_fmadd_ps(c0, _mm512_set1_ps(kernel[0]), acc0);
+        acc1 = _mm512_fmadd_ps(c0, _mm512_set1_ps(kernel[1]), acc1);
+        acc2 = _mm512_fmadd_ps(c0, _mm512_set1_ps(kernel[2]), acc2);
+        acc3 = _mm512_fmadd_ps(c0, _mm512_set1_ps(kernel[3]), acc3);
+
+        col += PER_COL_LINE;
+        kernel += PER_OUT_CHAN;
+    }
+
+    _mm512_storeu_ps(output, activation_avx512(acc0, activation));
+    _mm512_storeu_ps(output + output_xy, activation_avx512(acc1, activation));
+    _mm512_storeu_ps(output + 2 * output_xy, activation_avx512(acc2, activation));
+    _mm512_storeu_ps(output + 3 * output_xy, activation_avx512(acc3, activation));
+}
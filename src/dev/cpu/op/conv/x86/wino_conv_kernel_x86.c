@@ -0,0 +1,556 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * License); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * AS IS BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*
+ * Copyright (c) 2020, OPEN AI LAB
+ * Author: haoluo@openailab.com
+ */
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <immintrin.h>
+
+#include "sys_port.h"
+#include "../../../cpu_model.h"
+#include "../../../cpu_pool.h"
+#include "wino_conv_kernel_x86.h"
+
+#define TILE 4
+#define ELEM_SIZE ((TILE + 2) * (TILE + 2))
+#define PER_OUT_CHAN 4
+
+/*
+ * the transformed tiles are laid out as the col buffer of conv_kernel_x86.c, so that the
+ * 36 tile gemms run on the same packed sgemm kernels:
+ *   kernel        [ELEM_SIZE][out_c / 4][in_c][4]
+ *   trans input   [ELEM_SIZE][block_hw / col_line][in_c][col_line]
+ *   trans output  [ELEM_SIZE][out_c][block_hw]
+ */
+void sgemm_set_x86(float* col, float* kernel, float* biases, float* output, int kernel_size, int out_chan,
+                   int output_xy, int activation, int isa, struct cpu_pool* pool);
+
+static inline int get_col_line(int isa)
+{
+    return (isa & CPU_ISA_AVX512F) ? 16 : 8;
+}
+
+static inline void trans_kernel_f43(float* ker, float* trans_ker)
+{
+    /*
+    float G[18]={
+      1./4   ,     0.   ,     0.     ,
+      -1./6  ,   -1./6  ,    -1./6   ,
+      -1./6  ,    1./6  ,    -1./6   ,
+      1./24  ,   1./12  ,    1./6    ,
+      1./24  ,   -1./12 ,    1./6    ,
+      0.     ,    0.    ,     1.
+    };
+    */
+    float tmp[18] = {0};
+
+    float neg_r0_add_r2_x_1_6[6];    // (r0+r2)*1./6
+    float r0_1_4_add_r2_x_1_6[6];    // (r0*1/4 + r2)*1./6
+    float r1_1_6[6];    // r1*1/6
+    float r1_1_12[6];    // r1*1/12
+    float s_1_6 = 1. / 6.f;
+    for (int j = 0; j < 3; j++)
+    {
+        neg_r0_add_r2_x_1_6[j] = -(ker[j] + ker[6 + j]) * s_1_6;
+        r0_1_4_add_r2_x_1_6[j] = (ker[j] * 0.25 + ker[6 + j]) * s_1_6;
+        r1_1_6[j] = ker[3 + j] * s_1_6;
+        r1_1_12[j] = r1_1_6[j] * 0.5;
+    }
+    for (int j = 0; j < 3; j++)
+    {
+        tmp[j] = ker[j] * 0.25;
+        tmp[3 + j] = -r1_1_6[j] + neg_r0_add_r2_x_1_6[j];
+        tmp[6 + j] = r1_1_6[j] + neg_r0_add_r2_x_1_6[j];
+        tmp[9 + j] = r1_1_12[j] + r0_1_4_add_r2_x_1_6[j];
+        tmp[12 + j] = -r1_1_12[j] + r0_1_4_add_r2_x_1_6[j];
+        tmp[15 + j] = ker[6 + j];
+    }
+    // gemm(6,3,3,G,ker,tmp); done
+    int idx;
+    for (int j = 0; j < 6; j++)
+    {
+        idx = j * 3;
+        neg_r0_add_r2_x_1_6[j] = -(tmp[idx] + tmp[idx + 2]) * s_1_6;
+        r0_1_4_add_r2_x_1_6[j] = (tmp[idx] * 0.25 + tmp[idx + 2]) * s_1_6;
+        r1_1_6[j] = tmp[idx + 1] * s_1_6;
+        r1_1_12[j] = r1_1_6[j] * 0.5;
+    }
+
+    for (int j = 0; j < 6; j++)
+    {
+        idx = j * 6;
+        trans_ker[idx] = tmp[j * 3] * 0.25;
+        trans_ker[idx + 1] = -r1_1_6[j] + neg_r0_add_r2_x_1_6[j];
+        trans_ker[idx + 2] = r1_1_6[j] + neg_r0_add_r2_x_1_6[j];
+        trans_ker[idx + 3] = r1_1_12[j] + r0_1_4_add_r2_x_1_6[j];
+        trans_ker[idx + 4] = -r1_1_12[j] + r0_1_4_add_r2_x_1_6[j];
+        trans_ker[idx + 5] = tmp[j * 3 + 2];
+    }
+    // gemm(6,6,3,tmp,GT,trans_ker); done
+}
+
+//      src   [out_c][in_c][3][3]
+//  --> dst   [ELEM_SIZE][out_c/4][in_c][4]
+static void transform_kernel_f43(struct ir_tensor* filter, float* trans_ker)
+{
+    int out_c = filter->dims[0];
+    int in_c = filter->dims[1];
+    int out_c_align = (out_c + PER_OUT_CHAN - 1) & -PER_OUT_CHAN;
+    float* kernel = ( float* )filter->data;
+    float ker_tile[ELEM_SIZE];
+
+    memset(trans_ker, 0, sizeof(float) * ELEM_SIZE * out_c_align * in_c);
+
+    for (int p = 0; p < out_c; p++)
+    {
+        for (int c = 0; c < in_c; c++)
+        {
+            trans_kernel_f43(kernel + 9 * (p * in_c + c), ker_tile);
+
+            float* ker_ptr = trans_ker + (p / PER_OUT_CHAN) * in_c * PER_OUT_CHAN + c * PER_OUT_CHAN + p % PER_OUT_CHAN;
+            for (int s = 0; s < ELEM_SIZE; s++)
+                ker_ptr[s * out_c_align * in_c] = ker_tile[s];
+        }
+    }
+}
+
+static void pad_input(const float* input, float* inp_padded, int inc, int inh, int inw, int padded_h, int padded_w,
+                      int pad_h, int pad_w)
+{
+    int padded_hw = padded_h * padded_w;
+    int resi_h = padded_h - pad_h - inh;
+    int resi_w = padded_w - pad_w - inw;
+
+    for (int c = 0; c < inc; c++)
+    {
+        const float* inp_ptr = input + c * inh * inw;
+        float* pad_ptr = inp_padded + c * padded_hw;
+
+        // pad h_top
+        memset(pad_ptr, 0, padded_w * pad_h * sizeof(float));
+        pad_ptr += pad_h * padded_w;
+        // pad h_mid
+        for (int h = 0; h < inh; h++)
+        {
+            memset(pad_ptr, 0, pad_w * sizeof(float));
+            memcpy(pad_ptr + pad_w, inp_ptr, inw * sizeof(float));
+            memset(pad_ptr + pad_w + inw, 0, resi_w * sizeof(float));
+
+            inp_ptr += inw;
+            pad_ptr += padded_w;
+        }
+        // pad h_bottom
+        memset(pad_ptr, 0, padded_w * resi_h * sizeof(float));
+    }
+}
+
+static inline void transpose8_ps(__m256* r)
+{
+    __m256 t0 = _mm256_unpacklo_ps(r[0], r[1]);
+    __m256 t1 = _mm256_unpackhi_ps(r[0], r[1]);
+    __m256 t2 = _mm256_unpacklo_ps(r[2], r[3]);
+    __m256 t3 = _mm256_unpackhi_ps(r[2], r[3]);
+    __m256 t4 = _mm256_unpacklo_ps(r[4], r[5]);
+    __m256 t5 = _mm256_unpackhi_ps(r[4], r[5]);
+    __m256 t6 = _mm256_unpacklo_ps(r[6], r[7]);
+    __m256 t7 = _mm256_unpackhi_ps(r[6], r[7]);
+
+    __m256 s0 = _mm256_shuffle_ps(t0, t2, 0x44);
+    __m256 s1 = _mm256_shuffle_ps(t0, t2, 0xee);
+    __m256 s2 = _mm256_shuffle_ps(t1, t3, 0x44);
+    __m256 s3 = _mm256_shuffle_ps(t1, t3, 0xee);
+    __m256 s4 = _mm256_shuffle_ps(t4, t6, 0x44);
+    __m256 s5 = _mm256_shuffle_ps(t4, t6, 0xee);
+    __m256 s6 = _mm256_shuffle_ps(t5, t7, 0x44);
+    __m256 s7 = _mm256_shuffle_ps(t5, t7, 0xee);
+
+    r[0] = _mm256_permute2f128_ps(s0, s4, 0x20);
+    r[1] = _mm256_permute2f128_ps(s1, s5, 0x20);
+    r[2] = _mm256_permute2f128_ps(s2, s6, 0x20);
+    r[3] = _mm256_permute2f128_ps(s3, s7, 0x20);
+    r[4] = _mm256_permute2f128_ps(s0, s4, 0x31);
+    r[5] = _mm256_permute2f128_ps(s1, s5, 0x31);
+    r[6] = _mm256_permute2f128_ps(s2, s6, 0x31);
+    r[7] = _mm256_permute2f128_ps(s3, s7, 0x31);
+}
+
+/*
+    BT = {
+      4,  0, -5,  0, 1, 0,
+      0, -4, -4,  1, 1, 0,
+      0,  4, -4, -1, 1, 0,
+      0, -2, -1,  2, 1, 0,
+      0,  2, -1, -2, 1, 0,
+      0,  4,  0, -5, 0, 1
+    };
+*/
+static inline void trans_bt(__m256 d0, __m256 d1, __m256 d2, __m256 d3, __m256 d4, __m256 d5, __m256* r)
+{
+    __m256 _4 = _mm256_set1_ps(4.f);
+    __m256 _5 = _mm256_set1_ps(5.f);
+    __m256 _2 = _mm256_set1_ps(2.f);
+
+    __m256 d4_sub_4d2 = _mm256_fnmadd_ps(_4, d2, d4);
+    __m256 d3_sub_4d1 = _mm256_fnmadd_ps(_4, d1, d3);
+    __m256 d4_sub_d2 = _mm256_sub_ps(d4, d2);
+    __m256 d1_sub_d3_x2 = _mm256_mul_ps(_mm256_sub_ps(d1, d3), _2);
+
+    r[0] = _mm256_fnmadd_ps(_5, d2, _mm256_fmadd_ps(_4, d0, d4));
+    r[1] = _mm256_add_ps(d4_sub_4d2, d3_sub_4d1);
+    r[2] = _mm256_sub_ps(d4_sub_4d2, d3_sub_4d1);
+    r[3] = _mm256_sub_ps(d4_sub_d2, d1_sub_d3_x2);
+    r[4] = _mm256_add_ps(d4_sub_d2, d1_sub_d3_x2);
+    r[5] = _mm256_fnmadd_ps(_5, d3, _mm256_fmadd_ps(_4, d1, d5));
+}
+
+/*
+    AT = {
+      1,  1,  1,  1,  1,  0,
+      0,  1, -1,  2, -2,  0,
+      0,  1,  1,  4,  4,  0,
+      0,  1, -1,  8, -8,  1
+    };
+*/
+static inline void trans_at(__m256 m0, __m256 m1, __m256 m2, __m256 m3, __m256 m4, __m256 m5, __m256* r)
+{
+    __m256 m1_add_m2 = _mm256_add_ps(m1, m2);
+    __m256 m1_sub_m2 = _mm256_sub_ps(m1, m2);
+    __m256 m3_add_m4 = _mm256_add_ps(m3, m4);
+    __m256 m3_sub_m4 = _mm256_sub_ps(m3, m4);
+
+    r[0] = _mm256_add_ps(_mm256_add_ps(m0, m1_add_m2), m3_add_m4);
+    r[1] = _mm256_fmadd_ps(_mm256_set1_ps(2.f), m3_sub_m4, m1_sub_m2);
+    r[2] = _mm256_fmadd_ps(_mm256_set1_ps(4.f), m3_add_m4, m1_add_m2);
+    r[3] = _mm256_add_ps(_mm256_fmadd_ps(_mm256_set1_ps(8.f), m3_sub_m4, m1_sub_m2), m5);
+}
+
+/* the transforms run one task per 8 tiles (input) or per output channel (output) */
+struct trans_param
+{
+    const float* input;
+    float* output;
+    const float* bias;
+    int chan;
+    int block_h;
+    int block_w;
+    int h;
+    int w;
+    int block_hw_align;
+    int col_line;
+    int activation;
+};
+
+/*
+ * transform the input, 8 tiles a time: each row of the 8 tiles is loaded and transposed,
+ * so that every lane of the vectors works on one tile.
+ */
+
+static void trans_input_task(void* arg, int g)
+{
+    struct trans_param* p = ( struct trans_param* )arg;
+    const float* input = p->input;
+    float* trans_inp = p->output;
+    int inc = p->chan;
+    int block_w = p->block_w;
+    int inw = p->w;
+    int block_hw_align = p->block_hw_align;
+    int col_line = p->col_line;
+    int in_hw = p->h * inw;
+    int block_hw = p->block_h * block_w;
+
+    int tile_start = g * 8;
+    int offset[8];
+
+    for (int t = 0; t < 8; t++)
+    {
+        int tile = tile_start + t;
+        if (tile >= block_hw)
+            tile = block_hw - 1;
+        offset[t] = (tile / block_w) * TILE * inw + (tile % block_w) * TILE;
+    }
+
+    float* out_ptr = trans_inp + (tile_start / col_line) * col_line * inc + tile_start % col_line;
+
+    for (int c = 0; c < inc; c++)
+    {
+        const float* inp_ptr = input + c * in_hw;
+        __m256 d[6][8];
+        __m256 tmp[6][6];
+        __m256 r[6];
+
+        for (int i = 0; i < 6; i++)
+        {
+            for (int t = 0; t < 8; t++)
+                d[i][t] = _mm256_loadu_ps(inp_ptr + offset[t] + i * inw);
+            transpose8_ps(d[i]);
+        }
+
+        /* d[i][j] holds the element (i, j) of the 8 tiles */
+        for (int j = 0; j < 6; j++)
+            trans_bt(d[0][j], d[1][j], d[2][j], d[3][j], d[4][j], d[5][j], tmp[j]);
+
+        for (int i = 0; i < 6; i++)
+        {
+            trans_bt(tmp[0][i], tmp[1][i], tmp[2][i], tmp[3][i], tmp[4][i], tmp[5][i], r);
+            for (int j = 0; j < 6; j++)
+                _mm256_storeu_ps(out_ptr + (i * 6 + j) * inc * block_hw_align + c * col_line, r[j]);
+        }
+    }
+}
+
+static void trans_input_f43(const float* input, float* trans_inp, int inc, int block_h, int block_w, int inh, int inw,
+                            int block_hw_align, int col_line, struct cpu_pool* pool)
+{
+    struct trans_param param = {input, trans_inp, NULL, inc, block_h, block_w, inh, inw, block_hw_align, col_line, -1};
+
+    cpu_pool_parallel_for(pool, trans_input_task, &param, block_hw_align / 8);
+}
+
+static inline __m256 do_activation(__m256 v, int activation)
+{
+    if (activation >= 0)
+    {
+        v = _mm256_max_ps(v, _mm256_setzero_ps());
+        if (activation > 0)
+            v = _mm256_min_ps(v, _mm256_set1_ps(6.f));
+    }
+
+    return v;
+}
+
+/*
+ * transform the output, 8 tiles a time, with bias and activation. the 4x4 result of the
+ * tiles is transposed back so that every tile row is stored as 4 continuous floats.
+ */
+static void trans_output_task(void* arg, int p)
+{
+    struct trans_param* param = ( struct trans_param* )arg;
+    const float* trans_out = param->input;
+    const float* bias = param->bias;
+    int outc = param->chan;
+    int block_w = param->block_w;
+    int outh = param->h;
+    int outw = param->w;
+    int block_hw_align = param->block_hw_align;
+    int activation = param->activation;
+    int out_hw = outh * outw;
+    int block_hw = param->block_h * block_w;
+    int group_num = (block_hw + 7) / 8;
+
+    __m256 bias_v = bias ? _mm256_set1_ps(bias[p]) : _mm256_setzero_ps();
+    float* out_ptr = param->output + p * out_hw;
+
+    for (int g = 0; g < group_num; g++)
+    {
+        int tile_start = g * 8;
+        const float* mid_ptr = trans_out + p * block_hw_align + tile_start;
+        __m256 m[ELEM_SIZE];
+        __m256 tmp[6][4];
+        __m256 o[4][4];
+
+        for (int s = 0; s < ELEM_SIZE; s++)
+            m[s] = _mm256_loadu_ps(mid_ptr + s * outc * block_hw_align);
+
+        for (int j = 0; j < 6; j++)
+            trans_at(m[j], m[6 + j], m[12 + j], m[18 + j], m[24 + j], m[30 + j], tmp[j]);
+
+        for (int i = 0; i < 4; i++)
+        {
+            trans_at(tmp[0][i], tmp[1][i], tmp[2][i], tmp[3][i], tmp[4][i], tmp[5][i], o[i]);
+            for (int j = 0; j < 4; j++)
+                o[i][j] = do_activation(_mm256_add_ps(o[i][j], bias_v), activation);
+        }
+
+        for (int i = 0; i < 4; i++)
+        {
+            /* 4 x 8 transpose, lane t of o[i][j] goes to tile t */
+            __m256 t0 = _mm256_unpacklo_ps(o[i][0], o[i][1]);
+            __m256 t1 = _mm256_unpackhi_ps(o[i][0], o[i][1]);
+            __m256 t2 = _mm256_unpacklo_ps(o[i][2], o[i][3]);
+            __m256 t3 = _mm256_unpackhi_ps(o[i][2], o[i][3]);
+            __m256 u[4];
+            u[0] = _mm256_shuffle_ps(t0, t2, 0x44);
+            u[1] = _mm256_shuffle_ps(t0, t2, 0xee);
+            u[2] = _mm256_shuffle_ps(t1, t3, 0x44);
+            u[3] = _mm256_shuffle_ps(t1, t3, 0xee);
+
+            for (int t = 0; t < 8; t++)
+            {
+                int tile = tile_start + t;
+                if (tile >= block_hw)
+                    break;
+
+                int oh = (tile / block_w) * TILE + i;
+                int ow = (tile % block_w) * TILE;
+                if (oh >= outh)
+                    continue;
+
+                __m128 v = t < 4 ? _mm256_castps256_ps128(u[t]) : _mm256_extractf128_ps(u[t - 4], 1);
+                float* dst = out_ptr + oh * outw + ow;
+
+                if (ow + TILE <= outw)
+                {
+                    _mm_storeu_ps(dst, v);
+                }
+                else
+                {
+                    float buf[TILE];
+                    _mm_storeu_ps(buf, v);
+                    for (int k = 0; k < outw - ow; k++)
+                        dst[k] = buf[k];
+                }
+            }
+        }
+    }
+}
+
+static void trans_output_f43(const float* trans_out, float* output, const float* bias, int outc, int block_h,
+                             int block_w, int outh, int outw, int block_hw_align, int activation, struct cpu_pool* pool)
+{
+    struct trans_param param = {trans_out, output, bias, outc, block_h, block_w, outh, outw, block_hw_align, 0,
+                                activation};
+
+    cpu_pool_parallel_for(pool, trans_output_task, &param, outc);
+}
+
+int wino_conv_x86_get_shared_mem_size(struct ir_tensor* input, struct ir_tensor* output, struct conv_param* param)
+{
+    int in_c = input->dims[1];
+    int out_c = output->dims[1];
+    int block_h = (output->dims[2] + TILE - 1) / TILE;
+    int block_w = (output->dims[3] + TILE - 1) / TILE;
+    int block_hw_align = (block_h * block_w + 15) & -16;
+    int padded_size = in_c * (block_h * TILE + 2) * (block_w * TILE + 2) + 16;
+
+    return sizeof(float) * (padded_size + ELEM_SIZE * block_hw_align * (in_c + out_c)) + 128;
+}
+
+int wino_conv_x86_prerun(struct ir_tensor* input_tensor, struct ir_tensor* filter_tensor,
+                         struct ir_tensor* output_tensor, struct conv_priv_info* priv_info, struct conv_param* param)
+{
+    int out_c = filter_tensor->dims[0];
+    int in_c = filter_tensor->dims[1];
+    int out_c_align = (out_c + PER_OUT_CHAN - 1) & -PER_OUT_CHAN;
+
+    if (!priv_info->external_im2col_mem)
+    {
+        int mem_size = wino_conv_x86_get_shared_mem_size(input_tensor, output_tensor, param);
+        void* mem = sys_malloc(mem_size);
+        priv_info->im2col_buffer = mem;
+        priv_info->im2col_buffer_size = mem_size;
+    }
+
+    int kernel_mem_size = sizeof(float) * ELEM_SIZE * out_c_align * in_c + 128;
+
+    /* a packed kernel of another layout can not be used, transform it again */
+    if (priv_info->interleave_packed && priv_info->interleave_buffer_size != kernel_mem_size)
+    {
+        priv_info->interleave_packed = 0;
+        priv_info->external_interleave_mem = 0;
+        priv_info->interleave_buffer = NULL;
+    }
+
+    if (!priv_info->external_interleave_mem && priv_info->interleave_buffer == NULL)
+    {
+        void* mem = sys_malloc(kernel_mem_size);
+        priv_info->interleave_buffer = mem;
+        priv_info->interleave_buffer_size = kernel_mem_size;
+    }
+
+    if (priv_info->im2col_buffer == NULL || priv_info->interleave_buffer == NULL)
+        return -1;
+
+    if (!priv_info->interleave_packed)
+        transform_kernel_f43(filter_tensor, ( float* )priv_info->interleave_buffer);
+
+    return 0;
+}
+
+int wino_conv_x86_run(struct ir_tensor* input_tensor, struct ir_tensor* filter_tensor, struct ir_tensor* bias_tensor,
+                      struct ir_tensor* output_tensor, struct conv_priv_info* priv_info, struct conv_param* param,
+                      int num_thread, int cpu_affinity)
+{
+    int pad_h0 = param->pad_h0;
+    int pad_w0 = param->pad_w0;
+    int act_type = param->activation;
+
+    int batch = input_tensor->dims[0];
+    int in_c = input_tensor->dims[1];
+    int in_h = input_tensor->dims[2];
+    int in_w = input_tensor->dims[3];
+    int input_size = in_c * in_h * in_w;
+
+    int out_c = output_tensor->dims[1];
+    int out_h = output_tensor->dims[2];
+    int out_w = output_tensor->dims[3];
+    int output_size = out_c * out_h * out_w;
+    int out_c_align = (out_c + PER_OUT_CHAN - 1) & -PER_OUT_CHAN;
+
+    /* wino param */
+    int col_line = get_col_line(priv_info->isa);
+    int block_h = (out_h + TILE - 1) / TILE;
+    int block_w = (out_w + TILE - 1) / TILE;
+    int block_hw_align = (block_h * block_w + col_line - 1) & -col_line;
+    int padded_in_h = block_h * TILE + 2;
+    int padded_in_w = block_w * TILE + 2;
+
+    /* buffer addr */
+    float* input_buf = ( float* )input_tensor->data;
+    float* output_buf = ( float* )output_tensor->data;
+    float* biases_buf = NULL;
+    if (bias_tensor != NULL)
+        biases_buf = ( float* )bias_tensor->data;
+    float* kernel_buf = ( float* )priv_info->interleave_buffer;
+
+    /* the padded input keeps 16 floats more, as the rows of the tiles are loaded by 8 */
+    float* input_padd_buf = ( float* )priv_info->im2col_buffer;
+    float* trans_input_buf = input_padd_buf + ((in_c * padded_in_h * padded_in_w + 16 + 15) & -16);
+    float* trans_output_buf = trans_input_buf + ELEM_SIZE * in_c * block_hw_align;
+
+    for (int n = 0; n < batch; n++)
+    {
+        float* input = input_buf + n * input_size;
+        float* output = output_buf + n * output_size;
+
+        /* pad input */
+        pad_input(input, input_padd_buf, in_c, in_h, in_w, padded_in_h, padded_in_w, pad_h0, pad_w0);
+
+        /* trans input */
+        trans_input_f43(input_padd_buf, trans_input_buf, in_c, block_h, block_w, padded_in_h, padded_in_w,
+                        block_hw_align, col_line, priv_info->cpu_pool);
+
+        /* gemm of every element of the tiles */
+        for (int s = 0; s < ELEM_SIZE; s++)
+        {
+            sgemm_set_x86(trans_input_buf + s * in_c * block_hw_align, kernel_buf + s * out_c_align * in_c, NULL,
+                          trans_output_buf + s * out_c * block_hw_align, in_c, out_c, block_hw_align, -1,
+                          priv_info->isa, priv_info->cpu_pool);
+        }
+
+        /* trans output */
+        trans_output_f43(trans_output_buf, output, biases_buf, out_c, block_h, block_w, out_h, out_w, block_hw_align,
+                         act_type, priv_info->cpu_pool);
+    }
+
+    return 0;
+}
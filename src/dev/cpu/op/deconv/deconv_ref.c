@@ -22,6 +22,7 @@
  * Author: bhu@openailab.com
  */
 
+#include <math.h>
 #include "sys_port.h"
 #include "module.h"
 #include "tengine_errno.h"
@@ -202,6 +203,60 @@ static int ref_deconv_fp32(const float* input, float* output, const float* kerne
     return 0;
 }
 
+/* fp32 copy of a uint8 or int32 tensor, a per-tensor scale and zero point are assumed */
+static float* dequant_tensor(const struct ir_tensor* tensor)
+{
+    float* data = ( float* )sys_malloc(tensor->elem_num * sizeof(float));
+
+    if (tensor->data_type == TENGINE_DT_UINT8)
+    {
+        const uint8_t* org = tensor->data;
+        for (int i = 0; i < tensor->elem_num; i++)
+            data[i] = (org[i] - tensor->zero_point) * tensor->scale;
+    }
+    else if (tensor->data_type == TENGINE_DT_INT32)
+    {
+        const int32_t* org = tensor->data;
+        for (int i = 0; i < tensor->elem_num; i++)
+            data[i] = org[i] * tensor->scale;
+    }
+    else
+    {
+        memcpy(data, tensor->data, tensor->elem_num * sizeof(float));
+    }
+
+    return data;
+}
+
+static int ref_deconv_uint8(const struct ir_tensor* input_tensor, struct ir_tensor* output_tensor,
+                            const struct ir_tensor* weight_tensor, const struct ir_tensor* bias_tensor,
+                            const struct deconv_ref_param* param)
+{
+    float* input = dequant_tensor(input_tensor);
+    float* kernel = dequant_tensor(weight_tensor);
+    float* bias = NULL;
+    if (bias_tensor != NULL)
+        bias = dequant_tensor(bias_tensor);
+
+    float* output = ( float* )sys_malloc(output_tensor->elem_num * sizeof(float));
+
+    ref_deconv_fp32(input, output, kernel, bias, param);
+
+    uint8_t* output_uint8 = output_tensor->data;
+    for (int i = 0; i < output_tensor->elem_num; i++)
+    {
+        int data = round(output[i] / output_tensor->scale) + output_tensor->zero_point;
+        output_uint8[i] = data > 255 ? 255 : (data < 0 ? 0 : data);
+    }
+
+    sys_free(input);
+    sys_free(kernel);
+    sys_free(bias);
+    sys_free(output);
+
+    return 0;
+}
+
 static int prerun(struct node_ops* node_ops, struct exec_node* exec_node, struct exec_graph* exec_graph)
 {
     struct ir_node* ir_node = exec_node->ir_node;
@@ -295,8 +350,11 @@ static int run(struct node_ops* node_ops, struct exec_node* exec_node, struct ex
 
     struct deconv_ref_param* op_param = ( struct deconv_ref_param* )exec_node->ops_priv;
 
-    /* input quant param */
-    int ret = ref_deconv_fp32(input_data, output_data, kernel, bias, op_param);
+    int ret;
+    if (i_tensor->data_type == TENGINE_DT_UINT8)
+        ret = ref_deconv_uint8(i_tensor, output_tensor, weight_tensor, bias_tensor, op_param);
+    else
+        ret = ref_deconv_fp32(input_data, output_data, kernel, bias, op_param);
 
     if (ret < 0)
         return -1;
@@ -306,7 +364,8 @@ static int run(struct node_ops* node_ops, struct exec_node* exec_node, struct ex
 
 static int reshape(struct node_ops* node_ops, struct exec_node* exec_node, struct exec_graph* exec_graph)
 {
-    return 0;
+    /* prerun only takes the shapes */
+    return prerun(node_ops, exec_node, exec_graph);
 }
 
 static int postrun(struct node_ops* node_ops, struct exec_node* exec_node, struct exec_graph* exec_graph)
@@ -157,6 +157,21 @@ static int release_node(struct node_ops* node_ops, struct exec_node* exec_node,
     return 0;
 }
 
+/* the heads may be left quantized, the boxes and scores are decoded in fp32 */
+static float* get_fp32_data(struct ir_tensor* tensor)
+{
+    if (tensor->data_type != TENGINE_DT_UINT8)
+        return ( float* )tensor->data;
+
+    uint8_t* data = tensor->data;
+    float* fp32_data = ( float* )sys_malloc(tensor->elem_num * sizeof(float));
+
+    for (int i = 0; i < tensor->elem_num; i++)
+        fp32_data[i] = (data[i] - tensor->zero_point) * tensor->scale;
+
+    return fp32_data;
+}
+
 static int run(struct node_ops* node_ops, struct exec_node* exec_node, struct exec_graph* exec_graph)
 {
     struct ir_node* ir_node = exec_node->ir_node;
@@ -167,9 +182,9 @@ static int run(struct node_ops* node_ops, struct exec_node* exec_node, struct ex
     struct ir_tensor* output_tensor = get_ir_graph_tensor(ir_graph, ir_node->output_tensors[0]);
     detection_output_param_t* param = ( detection_output_param_t* )(ir_node->op.param_mem);
 
-    float* location = ( float* )loc_tensor->data;
-    float* confidence = ( float* )conf_tensor->data;
-    float* priorbox = ( float* )priorbox_tensor->data;
+    float* location = get_fp32_data(loc_tensor);
+    float* confidence = get_fp32_data(conf_tensor);
+    float* priorbox = get_fp32_data(priorbox_tensor);
 
     const int num_priorx4 = priorbox_tensor->dims[2];
     const int num_prior = num_priorx4 / 4;
@@ -247,6 +262,13 @@ static int run(struct node_ops* node_ops, struct exec_node* exec_node, struct ex
     sys_free(bbox_rects);
     release_vector(output_bbox_v);
 
+    if (location != loc_tensor->data)
+        sys_free(location);
+    if (confidence != conf_tensor->data)
+        sys_free(confidence);
+    if (priorbox != priorbox_tensor->data)
+        sys_free(priorbox);
+
     return 0;
 }
 
@@ -346,7 +346,7 @@ static int ref_eltwise_uint8(struct ir_tensor* output_tensor, struct ir_tensor*
     for (int i = 0; i < output_tensor->elem_num; i++)
     {
         int output_data = round(out_ptr[i] / out_scale) + out_zero;
-        output_uint8[i] = output_data > 255 ? 255 : output_data;
+        output_uint8[i] = output_data > 255 ? 255 : (output_data < 0 ? 0 : output_data);
     }
 
     sys_free(in0);
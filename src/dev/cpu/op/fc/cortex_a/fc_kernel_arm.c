@@ -186,6 +186,17 @@ int fc_kernel_run(struct ir_tensor* input_tensor, struct ir_tensor* filter_tenso
         sgemv1x8(cur_input, cur_output, weight, biases, kernel_size, 0, out_num_8, num_thread, cpu_affinity);
         if (out_num & 0x7)
             sgemv1x2(cur_input, cur_output, weight, biases, kernel_size, out_num_8, out_num, num_thread, cpu_affinity);
+
+        if (param->activation >= 0)
+        {
+            for (int j = 0; j < out_num; j++)
+            {
+                if (cur_output[j] < 0)
+                    cur_output[j] = 0;
+                if (param->activation > 0 && cur_output[j] > 6)
+                    cur_output[j] = 6;
+            }
+        }
     }
 
     return 0;
@@ -38,6 +38,7 @@ struct fc_data
     int batch;    // N
     int out_number;    // OUT
     int hidden;    // hidden
+    int activation;
     int zero[3];    // input, kernel, output
     float scale[3];    // input, kernel, output
 };
@@ -61,12 +62,58 @@ static int ref_fc_fp32(const float* input, float* output, const float* weight, c
                 else
                     tmp += input[n * hidden + j] * weight[i + j * out_number];
             }
+            if (param->activation >= 0)
+            {
+                if (tmp < 0)
+                    tmp = 0;
+                if (param->activation > 0 && tmp > 6)
+                    tmp = 6;
+            }
             output[n * out_number + i] = tmp;
         }
     }
     return 0;
 }
 
+/* asymmetric uint8, the int32 bias is in the scale of input x weight, the weight scale may be per output */
+static int ref_fc_uint8(const uint8_t* input, uint8_t* output, const uint8_t* weight, const int32_t* bias,
+                        const float* weight_scale, struct fc_data* param)
+{
+    int batch = param->batch;
+    int hidden = param->hidden;
+    int out_number = param->out_number;
+
+    int input_zero = param->zero[0];
+    int weight_zero = param->zero[1];
+    int output_zero = param->zero[2];
+
+    for (int n = 0; n < batch; n++)
+    {
+        for (int i = 0; i < out_number; i++)
+        {
+            int32_t sum = bias ? bias[i] : 0;
+            for (int j = 0; j < hidden; j++)
+            {
+                int w = param->need_trans == 0 ? weight[i * hidden + j] : weight[i + j * out_number];
+                sum += (input[n * hidden + j] - input_zero) * (w - weight_zero);
+            }
+
+            float tmp = sum * param->scale[0] * (weight_scale ? weight_scale[i] : param->scale[1]);
+            if (param->activation >= 0)
+            {
+                if (tmp < 0)
+                    tmp = 0;
+                if (param->activation > 0 && tmp > 6)
+                    tmp = 6;
+            }
+
+            int out = round(tmp / param->scale[2]) + output_zero;
+            output[n * out_number + i] = out > 255 ? 255 : (out < 0 ? 0 : out);
+        }
+    }
+    return 0;
+}
+
 static int init_node(struct node_ops* node_ops, struct exec_node* exec_node, struct exec_graph* exec_graph)
 {
     struct fc_data* op_param = ( struct fc_data* )sys_malloc(sizeof(struct fc_data));
@@ -118,6 +165,7 @@ static int prerun(struct node_ops* node_ops, struct exec_node* exec_node, struct
     }
     op_param->batch = input_tensor->dims[0];
     op_param->out_number = param->num_output;
+    op_param->activation = param->activation;
 
     int weight_out = weight_tensor->dims[0];
 
@@ -126,6 +174,16 @@ static int prerun(struct node_ops* node_ops, struct exec_node* exec_node, struct
     else
         op_param->need_trans = 1;
 
+    if (input_tensor->data_type == TENGINE_DT_UINT8)
+    {
+        op_param->scale[0] = input_tensor->scale;
+        op_param->scale[1] = weight_tensor->scale;
+        op_param->scale[2] = output_tensor->scale;
+        op_param->zero[0] = input_tensor->zero_point;
+        op_param->zero[1] = weight_tensor->quant_param_num > 1 ? weight_tensor->zp_list[0] : weight_tensor->zero_point;
+        op_param->zero[2] = output_tensor->zero_point;
+    }
+
     return 0;
 }
 
@@ -155,7 +213,14 @@ static int run(struct node_ops* node_ops, struct exec_node* exec_node, struct ex
         bias_tensor = get_ir_graph_tensor(ir_graph, ir_node->input_tensors[2]);
         bias_data = bias_tensor->data;
     }
-    if (ref_fc_fp32(input_data, output_data, weight_data, bias_data, op_param) < 0)
+    if (input_tensor->data_type == TENGINE_DT_UINT8)
+    {
+        const float* weight_scale = weight_tensor->quant_param_num > 1 ? weight_tensor->scale_list : NULL;
+
+        if (ref_fc_uint8(input_data, output_data, weight_data, bias_data, weight_scale, op_param) < 0)
+            return -1;
+    }
+    else if (ref_fc_fp32(input_data, output_data, weight_data, bias_data, op_param) < 0)
         return -1;
 
     return 0;
@@ -226,6 +291,9 @@ static int reshape(struct node_ops* node_ops, struct exec_node* exec_node, struc
         return -1;
     }
 
+    struct fc_data* op_param = ( struct fc_data* )exec_node->ops_priv;
+    op_param->batch = m;
+
     int ret = set_ir_tensor_shape(output, dim, input->dim_num);
 
     return ret;
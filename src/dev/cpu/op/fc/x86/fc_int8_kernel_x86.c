@@ -0,0 +1,219 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * License); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * AS IS BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+
+/*
+ * Copyright (c) 2020, OPEN AI LAB
+ * Author: haoluo@openailab.com
+ */
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <immintrin.h>
+
+#include "sys_port.h"
+#include "tengine_errno.h"
+#include "../../../cpu_pool.h"
+#include "fc_int8_kernel_x86.h"
+
+/* 4 outputs share every load of the input, 16 outputs make one task */
+#define PER_OUT_BLOCK 4
+#define PER_OUT_TASK 16
+
+struct fc_int8_param
+{
+    const int8_t* input;
+    const int8_t* weight;
+    int8_t* output;
+    struct fc_int8_priv_info* info;
+    int batch;
+    int hidden;
+    int out_number;
+};
+
+static inline __m128i sum_int32x8(__m256i v)
+{
+    return _mm_add_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+}
+
+static inline __m256i load_int8x16(const int8_t* ptr)
+{
+    return _mm256_cvtepi8_epi16(_mm_loadu_si128(( __m128i* )ptr));
+}
+
+/* int8 is widened to int16, vpmaddwd adds the products of every pair of k into int32 */
+static void fc_int8_block(const int8_t* input, const int8_t* weight, int8_t* output, struct fc_int8_priv_info* info,
+                          int hidden, int out_start, int out_cnt)
+{
+    const int8_t* w[PER_OUT_BLOCK];
+    int32_t tail[PER_OUT_BLOCK] = {0};
+
+    /* the rows beyond the last output repeat it, and are not stored */
+    for (int i = 0; i < PER_OUT_BLOCK; i++)
+        w[i] = weight + (out_start + (i < out_cnt ? i : out_cnt - 1)) * hidden;
+
+    __m256i acc0 = _mm256_setzero_si256();
+    __m256i acc1 = _mm256_setzero_si256();
+    __m256i acc2 = _mm256_setzero_si256();
+    __m256i acc3 = _mm256_setzero_si256();
+
+    int k = 0;
+    for (; k + 16 <= hidden; k += 16)
+    {
+        __m256i x = load_int8x16(input + k);
+
+        acc0 = _mm256_add_epi32(acc0, _mm256_madd_epi16(x, load_int8x16(w[0] + k)));
+        acc1 = _mm256_add_epi32(acc1, _mm256_madd_epi16(x, load_int8x16(w[1] + k)));
+        acc2 = _mm256_add_epi32(acc2, _mm256_madd_epi16(x, load_int8x16(w[2] + k)));
+        acc3 = _mm256_add_epi32(acc3, _mm256_madd_epi16(x, load_int8x16(w[3] + k)));
+    }
+
+    for (; k < hidden; k++)
+    {
+        for (int i = 0; i < PER_OUT_BLOCK; i++)
+            tail[i] += input[k] * w[i][k];
+    }
+
+    __m128i sum01 = _mm_hadd_epi32(sum_int32x8(acc0), sum_int32x8(acc1));
+    __m128i sum23 = _mm_hadd_epi32(sum_int32x8(acc2), sum_int32x8(acc3));
+    __m128i sum = _mm_add_epi32(_mm_hadd_epi32(sum01, sum23), _mm_loadu_si128(( __m128i* )tail));
+
+    int32_t bias[PER_OUT_BLOCK];
+    float scale[PER_OUT_BLOCK];
+    for (int i = 0; i < PER_OUT_BLOCK; i++)
+    {
+        int o = out_start + (i < out_cnt ? i : out_cnt - 1);
+        bias[i] = info->bias[o];
+        scale[i] = info->requant_scale[o];
+    }
+
+    /* rounded to nearest even and clamped to the activation range, as the conv does */
+    __m128 v = _mm_cvtepi32_ps(_mm_add_epi32(sum, _mm_loadu_si128(( __m128i* )bias)));
+    __m128i r = _mm_cvtps_epi32(_mm_mul_ps(v, _mm_loadu_ps(scale)));
+    r = _mm_min_epi32(_mm_max_epi32(r, _mm_set1_epi32(info->act_min)), _mm_set1_epi32(info->act_max));
+    r = _mm_packs_epi32(r, r);
+    r = _mm_packs_epi16(r, r);
+
+    int32_t packed = _mm_cvtsi128_si32(r);
+    memcpy(output + out_start, &packed, out_cnt);
+}
+
+static void fc_int8_task(void* arg, int t)
+{
+    struct fc_int8_param* p = ( struct fc_int8_param* )arg;
+    int out_end = (t + 1) * PER_OUT_TASK < p->out_number ? (t + 1) * PER_OUT_TASK : p->out_number;
+
+    for (int n = 0; n < p->batch; n++)
+    {
+        const int8_t* input = p->input + n * p->hidden;
+        int8_t* output = p->output + n * p->out_number;
+
+        for (int o = t * PER_OUT_TASK; o < out_end; o += PER_OUT_BLOCK)
+        {
+            int out_cnt = out_end - o < PER_OUT_BLOCK ? out_end - o : PER_OUT_BLOCK;
+            fc_int8_block(input, p->weight, output, p->info, p->hidden, o, out_cnt);
+        }
+    }
+}
+
+int fc_int8_x86_prerun(struct ir_tensor* input_tensor, struct ir_tensor* filter_tensor, struct ir_tensor* bias_tensor,
+                       struct ir_tensor* output_tensor, struct fc_int8_priv_info* priv_info, struct fc_param* param)
+{
+    int out_number = param->num_output;
+
+    /* only the [output][hidden] weight layout */
+    if (filter_tensor->dims[0] != out_number || input_tensor->quant_param_num < 1 ||
+        output_tensor->quant_param_num < 1 ||
+        (filter_tensor->quant_param_num != 1 && filter_tensor->quant_param_num != out_number))
+    {
+        set_tengine_errno(EINVAL);
+        return -1;
+    }
+
+    priv_info->bias = ( int32_t* )sys_malloc(sizeof(int32_t) * out_number);
+    priv_info->requant_scale = ( float* )sys_malloc(sizeof(float) * out_number);
+
+    if (priv_info->bias == NULL || priv_info->requant_scale == NULL)
+    {
+        set_tengine_errno(ENOMEM);
+        return -1;
+    }
+
+    for (int i = 0; i < out_number; i++)
+    {
+        float weight_scale = filter_tensor->quant_param_num > 1 ? filter_tensor->scale_list[i] : filter_tensor->scale;
+        float acc_scale = input_tensor->scale * weight_scale;
+
+        priv_info->requant_scale[i] = acc_scale / output_tensor->scale;
+
+        if (bias_tensor == NULL)
+            priv_info->bias[i] = 0;
+        else if (bias_tensor->data_type == TENGINE_DT_INT32)
+            priv_info->bias[i] = (( int32_t* )bias_tensor->data)[i];
+        else
+            priv_info->bias[i] = acc_scale != 0.f ? ( int32_t )roundf((( float* )bias_tensor->data)[i] / acc_scale) : 0;
+    }
+
+    priv_info->act_min = -127;
+    priv_info->act_max = 127;
+
+    if (param->activation >= 0)
+    {
+        priv_info->act_min = 0;
+
+        if (param->activation > 0)
+        {
+            int act_max = ( int )roundf(6.f / output_tensor->scale);
+            if (act_max < priv_info->act_max)
+                priv_info->act_max = act_max;
+        }
+    }
+
+    return 0;
+}
+
+int fc_int8_x86_postrun(struct fc_int8_priv_info* priv_info)
+{
+    sys_free(priv_info->bias);
+    sys_free(priv_info->requant_scale);
+
+    priv_info->bias = NULL;
+    priv_info->requant_scale = NULL;
+
+    return 0;
+}
+
+int fc_int8_x86_run(struct ir_tensor* input_tensor, struct ir_tensor* filter_tensor, struct ir_tensor* output_tensor,
+                    struct fc_int8_priv_info* priv_info, struct fc_param* param)
+{
+    struct fc_int8_param p;
+
+    p.input = ( const int8_t* )input_tensor->data;
+    p.weight = ( const int8_t* )filter_tensor->data;
+    p.output = ( int8_t* )output_tensor->data;
+    p.info = priv_info;
+    p.batch = input_tensor->dims[0];
+    p.hidden = filter_tensor->elem_num / filter_tensor->dims[0];
+    p.out_number = param->num_output;
+
+    cpu_pool_parallel_for(priv_info->cpu_pool, fc_int8_task, &p, (p.out_number + PER_OUT_TASK - 1) / PER_OUT_TASK);
+
+    return 0;
+}
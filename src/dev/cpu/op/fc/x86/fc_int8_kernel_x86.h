@@ -0,0 +1,55 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * License); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * AS IS BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+
+/*
+ * Copyright (c) 2020, OPEN AI LAB
+ * Author: haoluo@openailab.com
+ */
+
+#ifndef _FC_INT8_KERNEL_X86_H_
+#define _FC_INT8_KERNEL_X86_H_
+
+#include <stdint.h>
+
+#include "tengine_ir.h"
+#include "fc_param.h"
+
+struct cpu_pool;
+
+/* same quantization as the int8 conv: per output scale of the weight, int32 or fp32 bias */
+struct fc_int8_priv_info
+{
+    int32_t* bias; /* per output, 0 if there is no bias */
+    float* requant_scale; /* per output, input scale x weight scale / output scale */
+    int act_min; /* the output clamp, activation included */
+    int act_max;
+    struct cpu_pool* cpu_pool;
+};
+
+int fc_int8_x86_prerun(struct ir_tensor* input_tensor, struct ir_tensor* filter_tensor, struct ir_tensor* bias_tensor,
+                       struct ir_tensor* output_tensor, struct fc_int8_priv_info* priv_info,
+                       struct fc_param* param) __attribute__((weak));
+
+int fc_int8_x86_postrun(struct fc_int8_priv_info* priv_info) __attribute__((weak));
+
+int fc_int8_x86_run(struct ir_tensor* input_tensor, struct ir_tensor* filter_tensor, struct ir_tensor* output_tensor,
+                    struct fc_int8_priv_info* priv_info, struct fc_param* param) __attribute__((weak));
+
+#endif
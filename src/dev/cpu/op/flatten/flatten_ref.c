@@ -49,17 +49,9 @@ static int run(struct node_ops* node_ops, struct exec_node* exec_node, struct ex
     struct ir_tensor* input_tensor = get_ir_graph_tensor(ir_graph, ir_node->input_tensors[0]);
     struct ir_tensor* output_tensor = get_ir_graph_tensor(ir_graph, ir_node->output_tensors[0]);
 
-    int out_size = input_tensor->elem_num;
-    float* input_org = ( float* )input_tensor->data;
-    float* output_org = ( float* )output_tensor->data;
-
-    int num_thread = exec_graph->num_thread;
-
-    // #pragma omp parallel for num_threads(num_thread)
-    for (int i = 0; i < out_size; i++)
-    {
-        output_org[i] = input_org[i];
-    }
+    /* a plain copy of any data type, the quantization goes with it */
+    if (output_tensor->data != input_tensor->data)
+        memcpy(output_tensor->data, input_tensor->data, input_tensor->elem_num * input_tensor->elem_size);
 
     return 0;
 }
@@ -32,6 +32,34 @@
 #include <math.h>
 #include "hardswish_param.h"
 
+struct hardswish_task_param
+{
+    float* input;
+    float* output;
+    int chan_size;
+    float alpha;
+    float beta;
+    float lower;
+    float upper;
+};
+
+static void hardswish_task(void* arg, int j)
+{
+    struct hardswish_task_param* p = ( struct hardswish_task_param* )arg;
+    float* data = p->input + j * p->chan_size;
+    float* out_data = p->output + j * p->chan_size;
+
+    for (int i = 0; i < p->chan_size; i++)
+    {
+        if (data[i] < p->lower)
+            out_data[i] = 0.f;
+        else if (data[i] > p->upper)
+            out_data[i] = data[i];
+        else
+            out_data[i] = data[i] * (data[i] * p->alpha + p->beta);
+    }
+}
+
 static int init_node(struct node_ops* node_ops, struct exec_node* exec_node, struct exec_graph* exec_graph)
 {
     return 0;
@@ -66,26 +94,10 @@ static int run(struct node_ops* node_ops, struct exec_node* exec_node, struct ex
     int chan_num = (input_tensor->dims[0]) * (input_tensor->dims[1]);
     int chan_size = (input_tensor->dims[2]) * (input_tensor->dims[3]);
 
-    float* pdata = ( float* )input_tensor->data;
-    float* pout_data = ( float* )output_tensor->data;
-    int num_thread = exec_graph->num_thread;
+    struct hardswish_task_param param = {input_tensor->data, output_tensor->data, chan_size, alpha, beta, lower,
+                                         upper};
 
-#pragma omp parallel for num_threads(num_thread)
-    for (int j = 0; j < chan_num; j++)
-    {
-        float* data = pdata + j * chan_size;
-        float* out_data = pout_data + j * chan_size;
-
-        for (int i = 0; i < chan_size; i++)
-        {
-            if (data[i] < lower)
-                out_data[i] = 0.f;
-            else if (data[i] > upper)
-                out_data[i] = data[i];
-            else
-                out_data[i] = data[i] * (data[i] * alpha + beta);
-        }
-    }
+    cpu_pool_parallel_for(exec_graph->cpu_pool, hardswish_task, &param, chan_num);
 
     return 0;
 }
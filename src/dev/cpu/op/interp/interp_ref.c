@@ -206,6 +206,42 @@ int ref_interp_fp32(float* input, float* output, p_interp_param param)
     return 0;
 }
 
+/* bilinear weights are fractions, so uint8 goes through fp32 */
+static int ref_interp_uint8(struct ir_tensor* input_tensor, struct ir_tensor* output_tensor, p_interp_param param)
+{
+    uint8_t* input_uint8 = input_tensor->data;
+    uint8_t* output_uint8 = output_tensor->data;
+
+    int in_size = param->inc * param->in_channel_size;
+    int out_size = param->inc * param->out_channel_size;
+
+    float* input = ( float* )sys_malloc(in_size * sizeof(float));
+    float* output = ( float* )sys_malloc(out_size * sizeof(float));
+
+    if (input == NULL || output == NULL)
+    {
+        sys_free(input);
+        sys_free(output);
+        return -1;
+    }
+
+    for (int i = 0; i < in_size; i++)
+        input[i] = (input_uint8[i] - input_tensor->zero_point) * input_tensor->scale;
+
+    ref_interp_fp32(input, output, param);
+
+    for (int i = 0; i < out_size; i++)
+    {
+        int data = round(output[i] / output_tensor->scale) + output_tensor->zero_point;
+        output_uint8[i] = data > 255 ? 255 : (data < 0 ? 0 : data);
+    }
+
+    sys_free(input);
+    sys_free(output);
+
+    return 0;
+}
+
 static int run(struct node_ops* node_ops, struct exec_node* exec_node, struct exec_graph* exec_graph)
 {
     struct ir_node* node = exec_node->ir_node;
@@ -245,7 +281,11 @@ static int run(struct node_ops* node_ops, struct exec_node* exec_node, struct ex
 
     op_param.buf = ( int* )malloc(sizeof(int) * (param->output_width + param->output_height + param->output_width * 2 +
                                                  param->output_height * 2));
-    int ret = ref_interp_fp32(input, output, &op_param);
+    int ret;
+    if (input_tensor->data_type == TENGINE_DT_UINT8)
+        ret = ref_interp_uint8(input_tensor, output_tensor, &op_param);
+    else
+        ret = ref_interp_fp32(input, output, &op_param);
     free(op_param.buf);
 
     return ret;
@@ -101,6 +101,10 @@ static int score(struct node_ops* node_ops, struct exec_graph* exec_graph, struc
 
     int pool_size = 0;
 
+    struct ir_tensor* input_tensor = get_ir_graph_tensor(exec_node->graph, exec_node->input_tensors[0]);
+    if (input_tensor->data_type != TENGINE_DT_FP32)
+        return 0;
+
     /* filter perf global pooling case */
     if (global)
         return OPS_SCORE_BEST;
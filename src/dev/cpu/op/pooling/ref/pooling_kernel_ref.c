@@ -91,7 +91,6 @@ static inline uint8_t calc_max_uint8(const uint8_t* input, int layout, int c, in
 
     return max;
 }
-#if 0
 int pooling_kernel_ref_run(struct ir_tensor* input_tensor, struct ir_tensor* output_tensor,
                            struct pool_param* pool_param, int num_thread)
 {
@@ -205,6 +204,11 @@ int pooling_kernel_ref_run(struct ir_tensor* input_tensor, struct ir_tensor* out
         uint8_t* input = input_tensor->data;
         uint8_t* output = output_tensor->data;
 
+        /* the output may not share the quantization of the input, the padding counts as a real zero */
+        float requant = input_tensor->scale / output_tensor->scale;
+        int input_zero = input_tensor->zero_point;
+        int output_zero = output_tensor->zero_point;
+
         for (int n = 0; n < batch; n++)
         {
             const uint8_t* input_cur = input + n * input_chw;
@@ -246,13 +250,16 @@ int pooling_kernel_ref_run(struct ir_tensor* input_tensor, struct ir_tensor* out
                         {
                             uint8_t max = calc_max_uint8(input_cur, layout, channel, in_h, in_w, c, h_start, w_start,
                                                          h_end, w_end);
-                            output[offset] = max;
+                            int out = ( int )round((max - input_zero) * requant) + output_zero;
+                            output[offset] = out > 255 ? 255 : (out < 0 ? 0 : out);
                         }
                         else if (method == HCL_POOL_AVG)
                         {
                             int sum = calc_sum_uint8(input_cur, layout, channel, in_h, in_w, c, h_start, w_start, h_end,
                                                      w_end);
-                            output[offset] = ( uint8_t )round((sum + pool_size / 2) / pool_size);
+                            sum -= (h_end - h_start) * (w_end - w_start) * input_zero;
+                            int out = ( int )round(( float )sum / pool_size * requant) + output_zero;
+                            output[offset] = out > 255 ? 255 : (out < 0 ? 0 : out);
                         }
                         else
                             return -1;
@@ -264,4 +271,3 @@ int pooling_kernel_ref_run(struct ir_tensor* input_tensor, struct ir_tensor* out
 
     return 0;
 }
-#endif
\ No newline at end of file
@@ -28,62 +28,82 @@
 #include "../../cpu_node_ops.h"
 #include "tengine_op.h"
 #include "relu_param.h"
+#include <math.h>
 
-static int ref_relu_fp32(struct ir_tensor* input_tensor, struct ir_tensor* output_tensor, float negative_slope,
-                         int num_thread)
+struct relu_task_param
 {
-    int batch = input_tensor->dims[0];
-    int channels = input_tensor->dims[1];
-    int h = input_tensor->dims[2];
-    int w = input_tensor->dims[3];
-
-    int size = h * w;
-    int c_step = h * w;
-    int batch_step = channels * c_step;
-
-    float* input_data = input_tensor->data;
-    float* out_data = output_tensor->data;
+    float* input;
+    float* output;
+    int size;
+    float negative_slope;
+};
+
+/* one channel of one image, the channels of a batch are contiguous */
+static void relu_task(void* arg, int task_id)
+{
+    struct relu_task_param* p = ( struct relu_task_param* )arg;
+    float* src = p->input + p->size * task_id;
+    float* dst = p->output + p->size * task_id;
 
-    if (negative_slope == 0)
+    if (p->negative_slope == 0)
     {
-        for (int n = 0; n < batch; n++)
+        for (int i = 0; i < p->size; i++)
         {
-#pragma omp parallel for num_threads(num_thread)
-            for (int q = 0; q < channels; q++)
-            {
-                float* src = input_data + batch_step * n + c_step * q;
-                float* dst = out_data + batch_step * n + c_step * q;
-
-                for (int i = 0; i < size; i++)
-                {
-                    if (src[i] < 0)
-                        dst[i] = 0;
-                    else
-                        dst[i] = src[i];
-                }
-            }
+            if (src[i] < 0)
+                dst[i] = 0;
+            else
+                dst[i] = src[i];
         }
     }
     else
     {
-        for (int n = 0; n < batch; n++)
+        for (int i = 0; i < p->size; i++)
         {
-#pragma omp parallel for num_threads(num_thread)
-            for (int q = 0; q < channels; q++)
-            {
-                float* src = input_data + batch_step * n + c_step * q;
-                float* dst = out_data + batch_step * n + c_step * q;
-
-                for (int i = 0; i < size; i++)
-                {
-                    if (src[i] < 0)
-                        dst[i] = src[i] * negative_slope;
-                    else
-                        dst[i] = src[i];
-                }
-            }
+            if (src[i] < 0)
+                dst[i] = src[i] * p->negative_slope;
+            else
+                dst[i] = src[i];
         }
     }
+}
+
+static int ref_relu_fp32(struct ir_tensor* input_tensor, struct ir_tensor* output_tensor, float negative_slope,
+                         struct cpu_pool* pool)
+{
+    int batch = input_tensor->dims[0];
+    int channels = input_tensor->dims[1];
+    int h = input_tensor->dims[2];
+    int w = input_tensor->dims[3];
+
+    struct relu_task_param param = {input_tensor->data, output_tensor->data, h * w, negative_slope};
+
+    cpu_pool_parallel_for(pool, relu_task, &param, batch * channels);
+
+    return 0;
+}
+
+/* every uint8 value maps to a single output value, so a table of 256 entries covers the tensor */
+static int ref_relu_uint8(struct ir_tensor* input_tensor, struct ir_tensor* output_tensor, float negative_slope)
+{
+    uint8_t* input_data = input_tensor->data;
+    uint8_t* out_data = output_tensor->data;
+    float input_scale = input_tensor->scale;
+    float output_scale = output_tensor->scale;
+    int input_zero = input_tensor->zero_point;
+    int output_zero = output_tensor->zero_point;
+    uint8_t table[256];
+
+    for (int i = 0; i < 256; i++)
+    {
+        float x = (i - input_zero) * input_scale;
+        if (x < 0)
+            x *= negative_slope;
+        int v = ( int )roundf(x / output_scale) + output_zero;
+        table[i] = v > 255 ? 255 : (v < 0 ? 0 : v);
+    }
+
+    for (int i = 0; i < input_tensor->elem_num; i++)
+        out_data[i] = table[input_data[i]];
 
     return 0;
 }
@@ -110,7 +130,10 @@ static int run(struct node_ops* node_ops, struct exec_node* exec_node, struct ex
 
     struct relu_param* relu_param = ( struct relu_param* )ir_node->op.param_mem;
 
-    ref_relu_fp32(input_tensor, output_tensor, relu_param->negative_slope, exec_graph->num_thread);
+    if (input_tensor->data_type == TENGINE_DT_UINT8)
+        ref_relu_uint8(input_tensor, output_tensor, relu_param->negative_slope);
+    else
+        ref_relu_fp32(input_tensor, output_tensor, relu_param->negative_slope, exec_graph->cpu_pool);
 
     return 0;
 }
@@ -29,34 +29,68 @@
 #include "tengine_ir.h"
 #include "../../cpu_node_ops.h"
 #include "tengine_op.h"
+#include <math.h>
 
-int ref_relu6_fp32(struct ir_tensor* input_tensor, struct ir_tensor* output_tensor, int num_thread)
+struct relu6_task_param
+{
+    float* input;
+    float* output;
+    int size;
+};
+
+static void relu6_task(void* arg, int task_id)
+{
+    struct relu6_task_param* p = ( struct relu6_task_param* )arg;
+    float* src = p->input + p->size * task_id;
+    float* dst = p->output + p->size * task_id;
+
+    for (int i = 0; i < p->size; i++)
+    {
+        dst[i] = src[i];
+        if (dst[i] > 6)
+            dst[i] = 6;
+        if (dst[i] < 0)
+            dst[i] = 0;
+    }
+}
+
+int ref_relu6_fp32(struct ir_tensor* input_tensor, struct ir_tensor* output_tensor, struct cpu_pool* pool)
 {
     int w = input_tensor->dims[3];
     int h = output_tensor->dims[2];
     int channels = input_tensor->dims[1];
-    int size = h * w;
-    int c_step = h * w;
 
-    float* input_data = input_tensor->data;
-    float* out_data = output_tensor->data;
+    struct relu6_task_param param = {input_tensor->data, output_tensor->data, h * w};
+
+    cpu_pool_parallel_for(pool, relu6_task, &param, channels);
 
-#pragma omp parallel for num_threads(num_thread)
-    for (int q = 0; q < channels; q++)
+    return 0;
+}
+
+static int ref_relu6_uint8(struct ir_tensor* input_tensor, struct ir_tensor* output_tensor)
+{
+    uint8_t* input_data = input_tensor->data;
+    uint8_t* out_data = output_tensor->data;
+    float input_scale = input_tensor->scale;
+    float output_scale = output_tensor->scale;
+    int input_zero = input_tensor->zero_point;
+    int output_zero = output_tensor->zero_point;
+    uint8_t table[256];
+
+    for (int i = 0; i < 256; i++)
     {
-        float* src = input_data + c_step * q;
-        float* dst = out_data + c_step * q;
-
-        for (int i = 0; i < size; i++)
-        {
-            dst[i] = src[i];
-            if (dst[i] > 6)
-                dst[i] = 6;
-            if (dst[i] < 0)
-                dst[i] = 0;
-        }
+        float x = (i - input_zero) * input_scale;
+        if (x > 6)
+            x = 6;
+        if (x < 0)
+            x = 0;
+        int v = ( int )roundf(x / output_scale) + output_zero;
+        table[i] = v > 255 ? 255 : (v < 0 ? 0 : v);
     }
 
+    for (int i = 0; i < input_tensor->elem_num; i++)
+        out_data[i] = table[input_data[i]];
+
     return 0;
 }
 
@@ -80,7 +114,10 @@ static int run(struct node_ops* node_ops, struct exec_node* exec_node, struct ex
     input_tensor = get_ir_graph_tensor(ir_graph, ir_node->input_tensors[0]);
     output_tensor = get_ir_graph_tensor(ir_graph, ir_node->output_tensors[0]);
 
-    ref_relu6_fp32(input_tensor, output_tensor, exec_graph->num_thread);
+    if (input_tensor->data_type == TENGINE_DT_UINT8)
+        ref_relu6_uint8(input_tensor, output_tensor);
+    else
+        ref_relu6_fp32(input_tensor, output_tensor, exec_graph->cpu_pool);
 
     return 0;
 }
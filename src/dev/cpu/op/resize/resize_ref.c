@@ -132,6 +132,21 @@ static int run(struct node_ops* node_ops, struct exec_node* exec_node, struct ex
     float* input = ( float* )input_tensor->data;
     float* output = ( float* )output_tensor->data;
 
+    /* uint8 is resized in fp32, between a dequantized input and a requantized output */
+    if (input_tensor->data_type == TENGINE_DT_UINT8)
+    {
+        uint8_t* input_uint8 = input_tensor->data;
+
+        input = ( float* )sys_malloc(input_tensor->elem_num * sizeof(float));
+        output = ( float* )sys_malloc(output_tensor->elem_num * sizeof(float));
+
+        for (int i = 0; i < input_tensor->elem_num; i++)
+            input[i] = (input_uint8[i] - input_tensor->zero_point) * input_tensor->scale;
+    }
+
+    float* input_org = input;
+    float* output_org = output;
+
     if (resize_param->type == 0)
     {
         for (int i = 0; i < input_tensor->dims[0]; i++)
@@ -149,11 +164,25 @@ static int run(struct node_ops* node_ops, struct exec_node* exec_node, struct ex
         {
             bilinear_resize(input, output, input_tensor->dims[2], input_tensor->dims[3], input_tensor->dims[1], scale_x,
                             scale_y, output_tensor->dims[2], output_tensor->dims[3]);
-            input_tensor += in_chw;
-            output_tensor += out_chw;
+            input += in_chw;
+            output += out_chw;
         }
     }
 
+    if (input_tensor->data_type == TENGINE_DT_UINT8)
+    {
+        uint8_t* output_uint8 = output_tensor->data;
+
+        for (int i = 0; i < output_tensor->elem_num; i++)
+        {
+            int data = round(output_org[i] / output_tensor->scale) + output_tensor->zero_point;
+            output_uint8[i] = data > 255 ? 255 : (data < 0 ? 0 : data);
+        }
+
+        sys_free(input_org);
+        sys_free(output_org);
+    }
+
     return 0;
 }
 
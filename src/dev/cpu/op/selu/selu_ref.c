@@ -32,33 +32,42 @@
 #include "selu_param.h"
 #include <math.h>
 
+struct selu_task_param
+{
+    float* input;
+    float* output;
+    int chan_size;
+    float lambda;
+    float alpha_lambda;
+};
+
+static void selu_task(void* arg, int task_id)
+{
+    struct selu_task_param* p = ( struct selu_task_param* )arg;
+    float* input_data = p->input + task_id * p->chan_size;
+    float* output_data = p->output + task_id * p->chan_size;
+
+    for (int i = 0; i < p->chan_size; i++)
+    {
+        if (input_data[i] < 0.f)
+            output_data[i] = (exp(input_data[i]) - 1.f) * p->alpha_lambda;
+        else
+            output_data[i] = input_data[i] * p->lambda;
+    }
+}
+
 int ref_selu_fp32(struct ir_tensor* output_tensor, struct ir_tensor* input_tensor, struct selu_param* selu_param,
-                  int num_thread)
+                  struct cpu_pool* pool)
 {
-    float* data = ( float* )input_tensor->data;
-    float* out_data = ( float* )output_tensor->data;
     float alpha = selu_param->alpha;
     float lambda = selu_param->lambda;
-    float alpha_lambda = alpha * lambda;
 
     int chan_num = input_tensor->dims[0] * input_tensor->dims[1];
     int chan_size = input_tensor->dims[2] * input_tensor->dims[3];
 
-#pragma omp parallel for num_threads(num_thread)
-    for (int i = 0; i < chan_num; i++)
-    {
-        int offset = i * chan_size;
-        float* input_data = ( float* )input_tensor->data + i * chan_size;
-        float* output_data = ( float* )output_tensor->data + i * chan_size;
-
-        for (int i = 0; i < chan_size; i++)
-        {
-            if (input_data[i] < 0.f)
-                output_data[i] = (exp(input_data[i]) - 1.f) * alpha_lambda;
-            else
-                output_data[i] = input_data[i] * lambda;
-        }
-    }
+    struct selu_task_param param = {input_tensor->data, output_tensor->data, chan_size, lambda, alpha * lambda};
+
+    cpu_pool_parallel_for(pool, selu_task, &param, chan_num);
 
     return 0;
 }
@@ -89,9 +98,8 @@ static int run(struct node_ops* node_ops, struct exec_node* exec_node, struct ex
     output_tensor = get_ir_graph_tensor(ir_graph, ir_node->output_tensors[0]);
     struct selu_param* selu_param = ( struct selu_param* )ir_node->op.param_mem;
 
-    int num_thread = exec_graph->num_thread;
 
-    ref_selu_fp32(output_tensor, input_tensor, selu_param, num_thread);
+    ref_selu_fp32(output_tensor, input_tensor, selu_param, exec_graph->cpu_pool);
 
     return 0;
 }
@@ -34,6 +34,32 @@
 #define SIGMOID_MAX(a, b) ((a) > (b) ? (a) : (b))
 #define SIGMOID_MIN(a, b) ((a) < (b) ? (a) : (b))
 
+static int ref_sigmoid_uint8(struct ir_tensor* input_tensor, struct ir_tensor* output_tensor)
+{
+    uint8_t* input_data = input_tensor->data;
+    uint8_t* out_data = output_tensor->data;
+    float input_scale = input_tensor->scale;
+    float output_scale = output_tensor->scale;
+    int input_zero = input_tensor->zero_point;
+    int output_zero = output_tensor->zero_point;
+    uint8_t table[256];
+
+    for (int i = 0; i < 256; i++)
+    {
+        float x = (i - input_zero) * input_scale;
+        x = SIGMOID_MIN(x, 30.0f);
+        x = SIGMOID_MAX(x, -30.0f);
+        x = 1.f / (1.f + expf(-x));
+        int v = ( int )roundf(x / output_scale) + output_zero;
+        table[i] = v > 255 ? 255 : (v < 0 ? 0 : v);
+    }
+
+    for (int i = 0; i < input_tensor->elem_num; i++)
+        out_data[i] = table[input_data[i]];
+
+    return 0;
+}
+
 static int init_node(struct node_ops* node_ops, struct exec_node* exec_node, struct exec_graph* exec_graph)
 {
     exec_node->inplace_map[0] = 0;
@@ -72,6 +98,9 @@ static int run(struct node_ops* node_ops, struct exec_node* exec_node, struct ex
         return -1;
     }
 
+    if (input_tensor->data_type == TENGINE_DT_UINT8)
+        return ref_sigmoid_uint8(input_tensor, output_tensor);
+
     uint32_t elem_num = input_tensor->elem_num;
     float* data = ( float* )input_tensor->data;
     for (int i = 0; i < elem_num; i++)
@@ -156,8 +156,8 @@ static int run(struct node_ops* node_ops, struct exec_node* exec_node, struct ex
 
     if (type == TENGINE_DT_UINT8)
     {
-        input_f = ( float* )malloc(on_in_size * 4);
-        output_f = ( float* )malloc(on_in_size * 4);
+        input_f = ( float* )malloc(out_size * on_in_size * 4);
+        output_f = ( float* )malloc(out_size * on_in_size * 4);
 
         float input_scale = input_tensor->scale;
         float output_scale = output_tensor->scale;
@@ -179,7 +179,10 @@ static int run(struct node_ops* node_ops, struct exec_node* exec_node, struct ex
 
         for (int i = 0; i < out_size; i++)
             for (int j = 0; j < on_in_size; j++)
-                output[i * on_in_size + j] = round((output_f[i * on_in_size + j] / output_scale) + output_zero);
+            {
+                int data = round((output_f[i * on_in_size + j] / output_scale) + output_zero);
+                output[i * on_in_size + j] = data > 255 ? 255 : (data < 0 ? 0 : data);
+            }
 
         free(input_f);
         free(output_f);
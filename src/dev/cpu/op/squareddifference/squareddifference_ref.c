@@ -31,8 +31,29 @@
 #include "tengine_op.h"
 #include <math.h>
 
+struct squareddifference_task_param
+{
+    float* input0;
+    float* input1;
+    float* output;
+    int size;
+};
+
+static void squareddifference_task(void* arg, int task_id)
+{
+    struct squareddifference_task_param* p = ( struct squareddifference_task_param* )arg;
+    float* src0 = p->input0 + p->size * task_id;
+    float* src1 = p->input1 + p->size * task_id;
+    float* dst = p->output + p->size * task_id;
+
+    for (int i = 0; i < p->size; i++)
+    {
+        dst[i] = powf((src0[i] - src1[i]), 2);
+    }
+}
+
 int ref_squareddifference_fp32(struct ir_tensor* input_tensor_0, struct ir_tensor* input_tensor_1,
-                               struct ir_tensor* output_tensor, int num_thread)
+                               struct ir_tensor* output_tensor, struct cpu_pool* pool)
 {
     // dims size = 2 or 3
     if (input_tensor_0->dim_num < 4)
@@ -55,25 +76,10 @@ int ref_squareddifference_fp32(struct ir_tensor* input_tensor_0, struct ir_tenso
         int w = output_tensor->dims[3];
         int h = output_tensor->dims[2];
         int channels = output_tensor->dims[1];
-        int size = h * w;
-        int c_step = h * w;
+        struct squareddifference_task_param param = {input_tensor_0->data, input_tensor_1->data,
+                                                     output_tensor->data, h * w};
 
-        float* input0 = input_tensor_0->data;
-        float* input1 = input_tensor_1->data;
-        float* output = output_tensor->data;
-
-#pragma omp parallel for num_threads(num_thread)
-        for (int q = 0; q < channels; q++)
-        {
-            float* src0 = input0 + c_step * q;
-            float* src1 = input1 + c_step * q;
-            float* dst = output + c_step * q;
-
-            for (int i = 0; i < size; i++)
-            {
-                dst[i] = powf((src0[i] - src1[i]), 2);
-            }
-        }
+        cpu_pool_parallel_for(pool, squareddifference_task, &param, channels);
 
         return 0;
     }
@@ -109,7 +115,7 @@ static int run(struct node_ops* node_ops, struct exec_node* exec_node, struct ex
     input_tensor_1 = get_ir_graph_tensor(ir_graph, ir_node->input_tensors[1]);
     output_tensor = get_ir_graph_tensor(ir_graph, ir_node->output_tensors[0]);
 
-    int ret = ref_squareddifference_fp32(input_tensor_0, input_tensor_1, output_tensor, exec_graph->num_thread);
+    int ret = ref_squareddifference_fp32(input_tensor_0, input_tensor_1, output_tensor, exec_graph->cpu_pool);
     if (ret != 0)
         return -1;
 
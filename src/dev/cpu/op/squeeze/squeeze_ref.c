@@ -32,6 +32,29 @@
 #include "tengine_op.h"
 #include "squeeze_param.h"
 
+struct squeeze_task_param
+{
+    float* input;
+    float* output;
+    int size;
+    int block_size;
+};
+
+static void squeeze_task(void* arg, int task_id)
+{
+    struct squeeze_task_param* p = ( struct squeeze_task_param* )arg;
+    int start = task_id * p->block_size;
+    int end = start + p->block_size;
+
+    if (end > p->size)
+        end = p->size;
+
+    for (int i = start; i < end; i++)
+    {
+        p->output[i] = p->input[i];
+    }
+}
+
 static int init_node(struct node_ops* node_ops, struct exec_node* exec_node, struct exec_graph* exec_graph)
 {
     return 0;
@@ -53,13 +76,15 @@ static int run(struct node_ops* node_ops, struct exec_node* exec_node, struct ex
     float* input_org = ( float* )input_tensor->data;
     //	float *output = (float *)sys_malloc(out_size * sizeof(float));
     float* output_org = ( float* )output_tensor->data;
-    int num_thread = exec_graph->num_thread;
-    //
-#pragma omp parallel for num_threads(num_thread)
-    for (int i = 0; i < out_size; i++)
-    {
-        output_org[i] = input_org[i];
-    }
+    int num_thread = get_cpu_pool_thread_num(exec_graph->cpu_pool);
+    int block_size = (out_size + num_thread - 1) / num_thread;
+
+    if (block_size == 0)
+        return 0;
+
+    struct squeeze_task_param param = {input_org, output_org, out_size, block_size};
+
+    cpu_pool_parallel_for(exec_graph->cpu_pool, squeeze_task, &param, (out_size + block_size - 1) / block_size);
     //	memcpy(output_org, output, out_size * sizeof(float));
     //	sys_free(output);
     return 0;
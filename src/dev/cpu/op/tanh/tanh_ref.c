@@ -31,29 +31,59 @@
 #include "tengine_op.h"
 #include <math.h>
 
-int ref_tanh_fp32(struct ir_tensor* input_tensor, struct ir_tensor* output_tensor, int num_thread)
+struct tanh_task_param
+{
+    float* input;
+    float* output;
+    int size;
+};
+
+static void tanh_task(void* arg, int task_id)
+{
+    struct tanh_task_param* p = ( struct tanh_task_param* )arg;
+    float* src = p->input + p->size * task_id;
+    float* dst = p->output + p->size * task_id;
+
+    for (int i = 0; i < p->size; i++)
+    {
+        dst[i] = tanhf(src[i]);
+    }
+}
+
+int ref_tanh_fp32(struct ir_tensor* input_tensor, struct ir_tensor* output_tensor, struct cpu_pool* pool)
 {
     int w = input_tensor->dims[3];
     int h = output_tensor->dims[2];
     int channels = input_tensor->dims[1];
-    int size = h * w;
-    int c_step = h * w;
 
-    float* input_data = input_tensor->data;
-    float* out_data = output_tensor->data;
+    struct tanh_task_param param = {input_tensor->data, output_tensor->data, h * w};
 
-#pragma omp parallel for num_threads(num_thread)
-    for (int q = 0; q < channels; q++)
-    {
-        float* src = input_data + c_step * q;
-        float* dst = out_data + c_step * q;
+    cpu_pool_parallel_for(pool, tanh_task, &param, channels);
+
+    return 0;
+}
 
-        for (int i = 0; i < size; i++)
-        {
-            dst[i] = tanhf(src[i]);
-        }
+static int ref_tanh_uint8(struct ir_tensor* input_tensor, struct ir_tensor* output_tensor)
+{
+    uint8_t* input_data = input_tensor->data;
+    uint8_t* out_data = output_tensor->data;
+    float input_scale = input_tensor->scale;
+    float output_scale = output_tensor->scale;
+    int input_zero = input_tensor->zero_point;
+    int output_zero = output_tensor->zero_point;
+    uint8_t table[256];
+
+    for (int i = 0; i < 256; i++)
+    {
+        float x = (i - input_zero) * input_scale;
+        x = tanhf(x);
+        int v = ( int )roundf(x / output_scale) + output_zero;
+        table[i] = v > 255 ? 255 : (v < 0 ? 0 : v);
     }
 
+    for (int i = 0; i < input_tensor->elem_num; i++)
+        out_data[i] = table[input_data[i]];
+
     return 0;
 }
 
@@ -88,7 +118,10 @@ static int run(struct node_ops* node_ops, struct exec_node* exec_node, struct ex
         return -1;
     }
 
-    ref_tanh_fp32(input_tensor, output_tensor, exec_graph->num_thread);
+    if (input_tensor->data_type == TENGINE_DT_UINT8)
+        ref_tanh_uint8(input_tensor, output_tensor);
+    else
+        ref_tanh_fp32(input_tensor, output_tensor, exec_graph->cpu_pool);
 
     return 0;
 }
@@ -68,6 +68,43 @@ static int ref_upsample_fp32(struct ir_tensor* input_tensor, struct ir_tensor* o
     return 0;
 }
 
+/* nearest neighbour only picks input elements, the output keeps the input quantization */
+static int ref_upsample_uint8(struct ir_tensor* input_tensor, struct ir_tensor* output_tensor,
+                             struct upsample_param* param, int num_thread)
+// static int ref_upsample_uint8(uint8_t* input, uint8_t* output, upsample_param* param)
+{
+    uint8_t* input = input_tensor->data;
+    uint8_t* output = output_tensor->data;
+
+    float scale = param->scale;
+    int batch = output_tensor->dims[0];
+    int channel = output_tensor->dims[1];
+    int out_h = output_tensor->dims[2];
+    int out_w = output_tensor->dims[3];
+    int input_h = input_tensor->dims[2];
+    int input_w = input_tensor->dims[3];
+
+    for (int n = 0; n < batch; ++n)
+    {
+        for (int c = 0; c < channel; c++)
+        {
+            for (int h = 0; h < out_h; h++)
+            {
+                for (int w = 0; w < out_w; w++)
+                {
+                    int in_w = w / scale;
+                    int in_h = h / scale;
+                    int out_idx = n * channel * out_h * out_w + c * out_h * out_w + h * out_w + w;
+                    int in_idx = n * channel * input_h * input_w + c * input_w * input_h + in_h * input_w + in_w;
+                    output[out_idx] = input[in_idx];
+                }
+            }
+        }
+    }
+
+    return 0;
+}
+
 static int init_node(struct node_ops* node_ops, struct exec_node* exec_node, struct exec_graph* exec_graph)
 {
     return 0;
@@ -90,7 +127,10 @@ static int run(struct node_ops* node_ops, struct exec_node* exec_node, struct ex
     output_tensor = get_ir_graph_tensor(ir_graph, ir_node->output_tensors[0]);
     struct upsample_param* upsample_param = ( struct upsample_param* )ir_node->op.param_mem;
 
-    ref_upsample_fp32(input_tensor, output_tensor, upsample_param, exec_graph->num_thread);
+    if (input_tensor->data_type == TENGINE_DT_UINT8)
+        ref_upsample_uint8(input_tensor, output_tensor, upsample_param, exec_graph->num_thread);
+    else
+        ref_upsample_fp32(input_tensor, output_tensor, upsample_param, exec_graph->num_thread);
 
     return 0;
 }
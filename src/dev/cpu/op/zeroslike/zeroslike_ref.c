@@ -31,7 +31,24 @@
 #include "tengine_op.h"
 #include <math.h>
 
-int ref_zeroslike_fp32(struct ir_tensor* input_tensor, struct ir_tensor* output_tensor, int num_thread)
+struct zeroslike_task_param
+{
+    float* output;
+    int size;
+};
+
+static void zeroslike_task(void* arg, int task_id)
+{
+    struct zeroslike_task_param* p = ( struct zeroslike_task_param* )arg;
+    float* dst = p->output + p->size * task_id;
+
+    for (int i = 0; i < p->size; i++)
+    {
+        dst[i] = 0.f;
+    }
+}
+
+int ref_zeroslike_fp32(struct ir_tensor* input_tensor, struct ir_tensor* output_tensor, struct cpu_pool* pool)
 {
     // dims size = 2 or 3
     if (input_tensor->dim_num < 4)
@@ -53,23 +70,9 @@ int ref_zeroslike_fp32(struct ir_tensor* input_tensor, struct ir_tensor* output_
         int w = input_tensor->dims[3];
         int h = output_tensor->dims[2];
         int channels = input_tensor->dims[1];
-        int size = h * w;
-        int c_step = h * w;
-
-        float* input_data = input_tensor->data;
-        float* out_data = output_tensor->data;
+        struct zeroslike_task_param param = {output_tensor->data, h * w};
 
-#pragma omp parallel for num_threads(num_thread)
-        for (int q = 0; q < channels; q++)
-        {
-            float* src = input_data + c_step * q;
-            float* dst = out_data + c_step * q;
-
-            for (int i = 0; i < size; i++)
-            {
-                dst[i] = 0.f;
-            }
-        }
+        cpu_pool_parallel_for(pool, zeroslike_task, &param, channels);
 
         return 0;
     }
@@ -115,7 +118,7 @@ static int run(struct node_ops* node_ops, struct exec_node* exec_node, struct ex
     //     return -1;
     // }
 
-    int ret = ref_zeroslike_fp32(input_tensor, output_tensor, exec_graph->num_thread);
+    int ret = ref_zeroslike_fp32(input_tensor, output_tensor, exec_graph->cpu_pool);
     if (ret != 0)
         return -1;
 
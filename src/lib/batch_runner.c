@@ -0,0 +1,541 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * License); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * AS IS BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+
+/*
+ * Copyright (c) 2020, OPEN AI LAB
+ * Author: haitao@openailab.com
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef CONFIG_BAREMETAL_BUILD
+#include <pthread.h>
+#include <time.h>
+#endif
+
+#include "compiler.h"
+#include "sys_port.h"
+#include "tengine_c_api.h"
+#include "tengine_ir.h"
+#include "tengine_errno.h"
+#include "tengine_log.h"
+#include "vector.h"
+
+#ifndef CONFIG_BAREMETAL_BUILD
+
+/* the queueing latency of the last requests is kept for the percentiles */
+#define LATENCY_WINDOW 1024
+
+/*
+ * single image requests are queued, and the worker runs them together as one batch on dims[0]
+ * of the graph inputs, once max_batch requests are queued or the oldest one has waited timeout_us
+ */
+struct batch_request
+{
+    const void** input_data;
+    void** output_data;
+    int* output_size;
+    batch_done_t done;
+    void* arg;
+    double submit_time;
+};
+
+struct batch_runner
+{
+    struct ir_graph* graph;
+    int max_batch;
+    int timeout_us;
+
+    int input_num;
+    int output_num;
+    struct ir_tensor** input_tensors;
+    struct ir_tensor** output_tensors;
+    int* input_item_size; /* the bytes of one request */
+    void** input_buffer; /* max_batch requests of each input */
+
+    struct batch_request* batch; /* the requests of the running batch */
+
+    pthread_t thread;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    struct vector* queue;
+    int quit;
+
+    float latency[LATENCY_WINDOW]; /* us */
+    int latency_num;
+    int latency_pos;
+};
+
+static double get_cur_time(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec * 1000000.0 + ts.tv_nsec / 1000.0;
+}
+
+static void get_abs_time(double time_us, struct timespec* ts)
+{
+    ts->tv_sec = ( time_t )(time_us / 1000000.0);
+    ts->tv_nsec = ( long )((time_us - ts->tv_sec * 1000000.0) * 1000.0);
+
+    if (ts->tv_nsec >= 1000000000L)
+    {
+        ts->tv_sec++;
+        ts->tv_nsec -= 1000000000L;
+    }
+}
+
+static void release_batch_request(struct batch_request* request)
+{
+    sys_free(request->input_data);
+}
+
+static int collect_graph_tensors(struct ir_graph* ir_graph, int16_t* nodes, int node_num, struct ir_tensor** tensors)
+{
+    int n = 0;
+
+    for (int i = 0; i < node_num; i++)
+    {
+        struct ir_node* ir_node = get_ir_graph_node(ir_graph, nodes[i]);
+
+        for (int j = 0; j < ir_node->output_num; j++)
+        {
+            if (tensors)
+                tensors[n] = get_ir_graph_tensor(ir_graph, ir_node->output_tensors[j]);
+
+            n++;
+        }
+    }
+
+    return n;
+}
+
+/* switch dims[0] of the inputs to the batch size, the graph plans the memory again on the next run */
+static int set_batch_size(struct batch_runner* runner, int batch)
+{
+    for (int i = 0; i < runner->input_num; i++)
+    {
+        struct ir_tensor* ir_tensor = runner->input_tensors[i];
+
+        if (ir_tensor->dims[0] == batch)
+            continue;
+
+        int dims[MAX_SHAPE_DIM_NUM];
+
+        memcpy(dims, ir_tensor->dims, sizeof(int) * ir_tensor->dim_num);
+        dims[0] = batch;
+
+        if (set_ir_tensor_shape(ir_tensor, dims, ir_tensor->dim_num) < 0)
+            return -1;
+    }
+
+    return 0;
+}
+
+static int run_batch(struct batch_runner* runner, int batch)
+{
+    for (int i = 0; i < runner->input_num; i++)
+    {
+        int item_size = runner->input_item_size[i];
+        char* buffer = ( char* )runner->input_buffer[i];
+
+        for (int k = 0; k < batch; k++)
+            memcpy(buffer + k * item_size, runner->batch[k].input_data[i], item_size);
+
+        runner->input_tensors[i]->data = buffer;
+    }
+
+    if (set_batch_size(runner, batch) < 0 || run_graph(runner->graph, 1) < 0)
+        return -1;
+
+    for (int i = 0; i < runner->output_num; i++)
+    {
+        struct ir_tensor* ir_tensor = runner->output_tensors[i];
+        int item_size = ir_tensor->elem_num * ir_tensor->elem_size / batch;
+
+        for (int k = 0; k < batch; k++)
+        {
+            struct batch_request* request = &runner->batch[k];
+
+            if (request->output_data[i] == NULL)
+                continue;
+
+            if (request->output_size[i] < item_size)
+            {
+                TLOG_ERR("batch runner: output %d has %d bytes, tensor %s needs %d\n", i, request->output_size[i],
+                         ir_tensor->name, item_size);
+                return -1;
+            }
+
+            memcpy(request->output_data[i], ( char* )ir_tensor->data + k * item_size, item_size);
+        }
+    }
+
+    return 0;
+}
+
+static void* batch_runner_main(void* arg)
+{
+    struct batch_runner* runner = ( struct batch_runner* )arg;
+
+    pthread_mutex_lock(&runner->mutex);
+
+    while (1)
+    {
+        while (get_vector_num(runner->queue) == 0 && !runner->quit)
+            pthread_cond_wait(&runner->cond, &runner->mutex);
+
+        /* the queued requests are run before quit */
+        if (get_vector_num(runner->queue) == 0)
+            break;
+
+        while (get_vector_num(runner->queue) < runner->max_batch && !runner->quit)
+        {
+            struct batch_request* oldest = ( struct batch_request* )get_vector_data(runner->queue, 0);
+            double deadline = oldest->submit_time + runner->timeout_us;
+            struct timespec ts;
+
+            if (get_cur_time() >= deadline)
+                break;
+
+            get_abs_time(deadline, &ts);
+            pthread_cond_timedwait(&runner->cond, &runner->mutex, &ts);
+        }
+
+        int batch = get_vector_num(runner->queue);
+        double start = get_cur_time();
+
+        if (batch > runner->max_batch)
+            batch = runner->max_batch;
+
+        for (int k = 0; k < batch; k++)
+        {
+            struct batch_request* request = ( struct batch_request* )get_vector_data(runner->queue, 0);
+
+            runner->batch[k] = *request;
+            runner->latency[runner->latency_pos] = ( float )(start - request->submit_time);
+            runner->latency_pos = (runner->latency_pos + 1) % LATENCY_WINDOW;
+
+            if (runner->latency_num < LATENCY_WINDOW)
+                runner->latency_num++;
+
+            remove_vector_by_idx(runner->queue, 0);
+        }
+
+        /* requests keep coming while the batch runs */
+        pthread_mutex_unlock(&runner->mutex);
+
+        int ret = run_batch(runner, batch);
+
+        if (ret < 0)
+            TLOG_ERR("batch runner: run a batch of %d failed\n", batch);
+
+        for (int k = 0; k < batch; k++)
+        {
+            struct batch_request* request = &runner->batch[k];
+
+            if (request->done)
+                request->done(ret, request->arg);
+
+            release_batch_request(request);
+        }
+
+        pthread_mutex_lock(&runner->mutex);
+    }
+
+    pthread_mutex_unlock(&runner->mutex);
+
+    return NULL;
+}
+
+static void free_batch_runner(struct batch_runner* runner)
+{
+    if (runner->input_buffer)
+    {
+        for (int i = 0; i < runner->input_num; i++)
+            sys_free(runner->input_buffer[i]);
+    }
+
+    if (runner->queue)
+        release_vector(runner->queue);
+
+    sys_free(runner->input_buffer);
+    sys_free(runner->input_item_size);
+    sys_free(runner->input_tensors);
+    sys_free(runner->output_tensors);
+    sys_free(runner->batch);
+    sys_free(runner);
+}
+
+batch_runner_t DLLEXPORT create_batch_runner(graph_t graph, int max_batch, int timeout_us)
+{
+    struct ir_graph* ir_graph = ( struct ir_graph* )graph;
+
+    if (max_batch < 1 || timeout_us < 0)
+    {
+        set_tengine_errno(EINVAL);
+        return NULL;
+    }
+
+    if (ir_graph->status != GRAPH_STAT_READY)
+    {
+        TLOG_ERR("create batch runner: graph is not prerun yet\n");
+        set_tengine_errno(EINVAL);
+        return NULL;
+    }
+
+    struct batch_runner* runner = ( struct batch_runner* )sys_malloc(sizeof(struct batch_runner));
+
+    if (runner == NULL)
+    {
+        set_tengine_errno(ENOMEM);
+        return NULL;
+    }
+
+    memset(runner, 0, sizeof(struct batch_runner));
+
+    runner->graph = ir_graph;
+    runner->max_batch = max_batch;
+    runner->timeout_us = timeout_us;
+    runner->input_num = collect_graph_tensors(ir_graph, ir_graph->input_nodes, ir_graph->input_num, NULL);
+    runner->output_num = collect_graph_tensors(ir_graph, ir_graph->output_nodes, ir_graph->output_num, NULL);
+
+    runner->input_tensors = ( struct ir_tensor** )sys_malloc(sizeof(struct ir_tensor*) * runner->input_num);
+    runner->output_tensors = ( struct ir_tensor** )sys_malloc(sizeof(struct ir_tensor*) * runner->output_num);
+    runner->input_item_size = ( int* )sys_malloc(sizeof(int) * runner->input_num);
+    runner->input_buffer = ( void** )sys_malloc(sizeof(void*) * runner->input_num);
+    runner->batch = ( struct batch_request* )sys_malloc(sizeof(struct batch_request) * max_batch);
+    runner->queue = create_vector(sizeof(struct batch_request), NULL);
+
+    if (runner->input_tensors == NULL || runner->output_tensors == NULL || runner->input_item_size == NULL ||
+        runner->input_buffer == NULL || runner->batch == NULL || runner->queue == NULL)
+    {
+        sys_free(runner->input_buffer);
+        runner->input_buffer = NULL;
+        free_batch_runner(runner);
+        set_tengine_errno(ENOMEM);
+        return NULL;
+    }
+
+    memset(runner->input_buffer, 0, sizeof(void*) * runner->input_num);
+
+    collect_graph_tensors(ir_graph, ir_graph->input_nodes, ir_graph->input_num, runner->input_tensors);
+    collect_graph_tensors(ir_graph, ir_graph->output_nodes, ir_graph->output_num, runner->output_tensors);
+
+    for (int i = 0; i < runner->input_num; i++)
+    {
+        struct ir_tensor* ir_tensor = runner->input_tensors[i];
+
+        /* the graph is prerun for one request */
+        runner->input_item_size[i] = ir_tensor->elem_num * ir_tensor->elem_size / ir_tensor->dims[0];
+        runner->input_buffer[i] = sys_malloc(runner->input_item_size[i] * max_batch);
+
+        if (runner->input_buffer[i] == NULL)
+        {
+            free_batch_runner(runner);
+            set_tengine_errno(ENOMEM);
+            return NULL;
+        }
+    }
+
+    /* keep the plans of the full batch and of the last partial one */
+    int plan_cache_size;
+
+    if (get_graph_attr(graph, "cpu_plan_cache_size", &plan_cache_size, sizeof(int)) < 0)
+    {
+        plan_cache_size = max_batch > 1 ? 2 : 1;
+        set_graph_attr(graph, "cpu_plan_cache_size", &plan_cache_size, sizeof(int));
+    }
+
+    pthread_mutex_init(&runner->mutex, NULL);
+
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&runner->cond, &attr);
+    pthread_condattr_destroy(&attr);
+
+    if (pthread_create(&runner->thread, NULL, batch_runner_main, runner) != 0)
+    {
+        pthread_cond_destroy(&runner->cond);
+        pthread_mutex_destroy(&runner->mutex);
+        free_batch_runner(runner);
+
+        TLOG_ERR("create batch runner: create the worker failed\n");
+        set_tengine_errno(EAGAIN);
+        return NULL;
+    }
+
+    return runner;
+}
+
+int DLLEXPORT submit_batch_request(batch_runner_t batch_runner, const void* input_data[], const int input_size[],
+                                   void* output_data[], const int output_size[], batch_done_t done, void* arg)
+{
+    struct batch_runner* runner = ( struct batch_runner* )batch_runner;
+    struct batch_request request;
+
+    for (int i = 0; i < runner->input_num; i++)
+    {
+        if (input_size[i] != runner->input_item_size[i])
+        {
+            TLOG_ERR("batch runner: input %d has %d bytes, tensor %s needs %d\n", i, input_size[i],
+                     runner->input_tensors[i]->name, runner->input_item_size[i]);
+            set_tengine_errno(EINVAL);
+            return -1;
+        }
+    }
+
+    /* the pointers are kept until the request is done, the buffers are the caller's */
+    int ptr_num = runner->input_num + runner->output_num;
+    void** ptrs = ( void** )sys_malloc(sizeof(void*) * ptr_num + sizeof(int) * runner->output_num);
+
+    if (ptrs == NULL)
+    {
+        set_tengine_errno(ENOMEM);
+        return -1;
+    }
+
+    request.input_data = ( const void** )ptrs;
+    request.output_data = ptrs + runner->input_num;
+    request.output_size = ( int* )(ptrs + ptr_num);
+    request.done = done;
+    request.arg = arg;
+
+    memcpy(request.input_data, input_data, sizeof(void*) * runner->input_num);
+    memcpy(request.output_data, output_data, sizeof(void*) * runner->output_num);
+    memcpy(request.output_size, output_size, sizeof(int) * runner->output_num);
+
+    pthread_mutex_lock(&runner->mutex);
+
+    request.submit_time = get_cur_time();
+
+    int ret = push_vector_data(runner->queue, &request);
+
+    if (ret == 0)
+        pthread_cond_signal(&runner->cond);
+
+    pthread_mutex_unlock(&runner->mutex);
+
+    if (ret < 0)
+    {
+        release_batch_request(&request);
+        set_tengine_errno(ENOMEM);
+        return -1;
+    }
+
+    return 0;
+}
+
+static int compare_float(const void* a, const void* b)
+{
+    float x = *( const float* )a;
+    float y = *( const float* )b;
+
+    return (x > y) - (x < y);
+}
+
+int DLLEXPORT get_batch_runner_latency(batch_runner_t batch_runner, const float percent[], float latency_us[],
+                                       int number)
+{
+    struct batch_runner* runner = ( struct batch_runner* )batch_runner;
+    float sorted[LATENCY_WINDOW];
+
+    pthread_mutex_lock(&runner->mutex);
+
+    int n = runner->latency_num;
+
+    memcpy(sorted, runner->latency, sizeof(float) * n);
+
+    pthread_mutex_unlock(&runner->mutex);
+
+    qsort(sorted, n, sizeof(float), compare_float);
+
+    for (int i = 0; i < number; i++)
+    {
+        int idx = ( int )(percent[i] / 100.f * (n - 1) + 0.5f);
+
+        if (idx < 0)
+            idx = 0;
+        if (idx > n - 1)
+            idx = n - 1;
+
+        latency_us[i] = n > 0 ? sorted[idx] : 0.f;
+    }
+
+    return n;
+}
+
+int DLLEXPORT release_batch_runner(batch_runner_t batch_runner)
+{
+    struct batch_runner* runner = ( struct batch_runner* )batch_runner;
+
+    pthread_mutex_lock(&runner->mutex);
+    runner->quit = 1;
+    pthread_cond_signal(&runner->cond);
+    pthread_mutex_unlock(&runner->mutex);
+
+    pthread_join(runner->thread, NULL);
+    pthread_cond_destroy(&runner->cond);
+    pthread_mutex_destroy(&runner->mutex);
+
+    /* the graph is left for one request, with no pointer into the buffers of the runner */
+    set_batch_size(runner, 1);
+
+    for (int i = 0; i < runner->input_num; i++)
+        runner->input_tensors[i]->data = NULL;
+
+    free_batch_runner(runner);
+
+    return 0;
+}
+
+#else
+
+batch_runner_t DLLEXPORT create_batch_runner(graph_t graph, int max_batch, int timeout_us)
+{
+    set_tengine_errno(ENOTSUP);
+    return NULL;
+}
+
+int DLLEXPORT submit_batch_request(batch_runner_t batch_runner, const void* input_data[], const int input_size[],
+                                   void* output_data[], const int output_size[], batch_done_t done, void* arg)
+{
+    set_tengine_errno(ENOTSUP);
+    return -1;
+}
+
+int DLLEXPORT get_batch_runner_latency(batch_runner_t batch_runner, const float percent[], float latency_us[],
+                                       int number)
+{
+    set_tengine_errno(ENOTSUP);
+    return -1;
+}
+
+int DLLEXPORT release_batch_runner(batch_runner_t batch_runner)
+{
+    set_tengine_errno(ENOTSUP);
+    return -1;
+}
+
+#endif
@@ -231,7 +231,7 @@ static int set_sched_affinity(size_t thread_affinity_mask)
     CPU_ZERO(&mask);
     for (int i = 0; i < ( int )sizeof(size_t) * 8; i++)
     {
-        if (thread_affinity_mask & (1 << i))
+        if (thread_affinity_mask & (( size_t )1 << i))
             CPU_SET(i, &mask);
     }
 
@@ -309,7 +309,7 @@ int get_mask_count(size_t mask)
     int count = 0;
 
     for (int i = 0; i < sizeof(size_t) * 8; i++)
-        if (mask & (1 << i))
+        if (mask & (( size_t )1 << i))
             count++;
 
     return count;
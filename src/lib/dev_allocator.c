@@ -29,10 +29,302 @@
 #include "vector.h"
 #include "tengine_ir.h"
 #include "tengine_exec.h"
+#include "tengine_errno.h"
+#include "tengine_log.h"
+#include "tengine_op.h"
 #include "dev_allocator.h"
 
+/* the macs of a node with weights, or the elements it writes for the others */
+static double get_node_cost(struct ir_graph* ir_graph, struct ir_node* ir_node)
+{
+    double out_elem = 0;
+
+    for (int i = 0; i < ir_node->output_num; i++)
+        out_elem += get_ir_graph_tensor(ir_graph, ir_node->output_tensors[i])->elem_num;
+
+    if (ir_node->input_num > 1)
+    {
+        struct ir_tensor* weight = get_ir_graph_tensor(ir_graph, ir_node->input_tensors[1]);
+
+        /* conv, deconv and fc weights all keep one output channel per dims[0] entry */
+        if (weight->tensor_type == TENSOR_TYPE_CONST && weight->dim_num > 1 && weight->dims[0] > 0)
+            return out_elem * (weight->elem_num / weight->dims[0]);
+    }
+
+    return out_elem;
+}
+
+/*
+ * split the nodes, in order, into stage_num runs with the smallest cost of the most costly one.
+ * cost_sum[i] is the cost of the first i nodes, start[k] is set to the first node of stage k
+ */
+static int balance_stages(const double* cost_sum, int node_num, int stage_num, int* start)
+{
+    int n = node_num + 1;
+    double* best = ( double* )sys_malloc(sizeof(double) * n * stage_num);
+    int* cut = ( int* )sys_malloc(sizeof(int) * n * stage_num);
+
+    if (best == NULL || cut == NULL)
+    {
+        sys_free(best);
+        sys_free(cut);
+        set_tengine_errno(ENOMEM);
+        return -1;
+    }
+
+    /* best[k * n + i]: the first i nodes in k + 1 stages, cut[k * n + i]: where the last one starts */
+    for (int i = 0; i < n; i++)
+    {
+        best[i] = cost_sum[i];
+        cut[i] = 0;
+    }
+
+    for (int k = 1; k < stage_num; k++)
+    {
+        for (int i = k + 1; i < n; i++)
+        {
+            best[k * n + i] = -1;
+
+            for (int j = k; j < i; j++)
+            {
+                double stage_cost = cost_sum[i] - cost_sum[j];
+                double max_cost = best[(k - 1) * n + j] > stage_cost ? best[(k - 1) * n + j] : stage_cost;
+
+                if (best[k * n + i] < 0 || max_cost < best[k * n + i])
+                {
+                    best[k * n + i] = max_cost;
+                    cut[k * n + i] = j;
+                }
+            }
+        }
+    }
+
+    int end = node_num;
+
+    for (int k = stage_num - 1; k >= 0; k--)
+    {
+        start[k] = cut[k * n + end];
+        end = start[k];
+    }
+
+    sys_free(best);
+    sys_free(cut);
+
+    return 0;
+}
+
+static int add_stage_tensor(uint16_t** tensor_list, uint8_t* tensor_num, uint16_t idx)
+{
+    for (int i = 0; i < *tensor_num; i++)
+    {
+        if ((*tensor_list)[i] == idx)
+            return 0;
+    }
+
+    if (*tensor_num == UINT8_MAX)
+    {
+        TLOG_ERR("pipeline stage: too many tensors cross the stage\n");
+        set_tengine_errno(E2BIG);
+        return -1;
+    }
+
+    uint16_t* new_list = ( uint16_t* )sys_realloc(*tensor_list, sizeof(uint16_t) * (*tensor_num + 1));
+
+    if (new_list == NULL)
+    {
+        set_tengine_errno(ENOMEM);
+        return -1;
+    }
+
+    new_list[*tensor_num] = idx;
+    *tensor_list = new_list;
+    (*tensor_num)++;
+
+    return 0;
+}
+
+/*
+ * the inputs of a stage are the graph inputs its nodes read and the var tensors written by the
+ * stages before, it waits for the latter. the outputs are the ones read by the stages after
+ */
+static int set_stage_tensors(struct ir_graph* ir_graph, struct subgraph* subgraph)
+{
+    for (int i = 0; i < subgraph->node_num; i++)
+    {
+        struct ir_node* ir_node = get_ir_graph_node(ir_graph, subgraph->node_list[i]);
+
+        for (int j = 0; j < ir_node->input_num; j++)
+        {
+            struct ir_tensor* tensor = get_ir_graph_tensor(ir_graph, ir_node->input_tensors[j]);
+
+            if (tensor->tensor_type == TENSOR_TYPE_VAR &&
+                get_ir_graph_node(ir_graph, tensor->producer)->subgraph_idx == subgraph->idx)
+                continue;
+
+            if (tensor->tensor_type != TENSOR_TYPE_VAR && tensor->tensor_type != TENSOR_TYPE_INPUT)
+                continue;
+
+            if (add_stage_tensor(&subgraph->input_tensor_list, &subgraph->input_num, tensor->idx) < 0)
+                return -1;
+        }
+
+        for (int j = 0; j < ir_node->output_num; j++)
+        {
+            struct ir_tensor* tensor = get_ir_graph_tensor(ir_graph, ir_node->output_tensors[j]);
+            int cross = tensor->consumer_num == 0;
+
+            if (tensor->tensor_type != TENSOR_TYPE_VAR)
+                continue;
+
+            for (int k = 0; k < tensor->consumer_num; k++)
+            {
+                if (get_ir_graph_node(ir_graph, tensor->consumer[k])->subgraph_idx != subgraph->idx)
+                    cross = 1;
+            }
+
+            if (cross && add_stage_tensor(&subgraph->output_tensor_list, &subgraph->output_num, tensor->idx) < 0)
+                return -1;
+        }
+    }
+
+    subgraph->input_wait_count = 0;
+
+    for (int i = 0; i < subgraph->input_num; i++)
+    {
+        struct ir_tensor* tensor = get_ir_graph_tensor(ir_graph, subgraph->input_tensor_list[i]);
+
+        if (tensor->tensor_type == TENSOR_TYPE_VAR)
+            subgraph->input_wait_count++;
+    }
+
+    return 0;
+}
+
+/*
+ * one subgraph for each stage, so that the stages of one run can run in turn on their own cores,
+ * and a pipeline can start the next run in a stage once the stage is done.
+ * the input and const nodes do not run, they are left in the first stage
+ */
+static int allocate_stages(struct ir_graph* ir_graph, int stage_num, const size_t* cpu_mask)
+{
+    int node_num = ir_graph->node_num;
+    double* cost_sum = ( double* )sys_malloc(sizeof(double) * (node_num + 1));
+    uint16_t* run_node = ( uint16_t* )sys_malloc(sizeof(uint16_t) * node_num);
+    int start[MAX_PIPELINE_STAGE + 1];
+    int run_num = 0;
+
+    if (cost_sum == NULL || run_node == NULL)
+    {
+        sys_free(cost_sum);
+        sys_free(run_node);
+        set_tengine_errno(ENOMEM);
+        return -1;
+    }
+
+    cost_sum[0] = 0;
+
+    for (int i = 0; i < node_num; i++)
+    {
+        struct ir_node* ir_node = ir_graph->node_list[i];
+
+        ir_node->subgraph_idx = 0;
+
+        if (ir_node->op.op_type == OP_CONST || ir_node->op.op_type == OP_INPUT)
+            continue;
+
+        cost_sum[run_num + 1] = cost_sum[run_num] + get_node_cost(ir_graph, ir_node);
+        run_node[run_num++] = ir_node->idx;
+    }
+
+    if (stage_num > run_num)
+        stage_num = run_num > 0 ? run_num : 1;
+
+    if (balance_stages(cost_sum, run_num, stage_num, start) < 0)
+    {
+        sys_free(cost_sum);
+        sys_free(run_node);
+        return -1;
+    }
+
+    start[stage_num] = run_num;
+
+    for (int k = 0; k < stage_num; k++)
+    {
+        for (int i = start[k]; i < start[k + 1]; i++)
+            get_ir_graph_node(ir_graph, run_node[i])->subgraph_idx = k;
+
+        TLOG_DEBUG("pipeline stage %d: %d nodes, cost %.0f\n", k, start[k + 1] - start[k],
+                   cost_sum[start[k + 1]] - cost_sum[start[k]]);
+    }
+
+    sys_free(cost_sum);
+    sys_free(run_node);
+
+    for (int k = 0; k < stage_num; k++)
+    {
+        struct subgraph* subgraph = ( struct subgraph* )sys_malloc(sizeof(struct subgraph));
+
+        if (subgraph == NULL)
+        {
+            set_tengine_errno(ENOMEM);
+            return -1;
+        }
+
+        init_subgraph(ir_graph, subgraph, k);
+
+        subgraph->node_list = ( uint16_t* )sys_malloc(sizeof(uint16_t) * node_num);
+
+        if (subgraph->node_list == NULL || push_vector_data(ir_graph->subgraph_list, &subgraph) < 0)
+        {
+            sys_free(subgraph->node_list);
+            sys_free(subgraph);
+            set_tengine_errno(ENOMEM);
+            return -1;
+        }
+
+        for (int i = 0; i < node_num; i++)
+        {
+            if (ir_graph->node_list[i]->subgraph_idx == k)
+                subgraph->node_list[subgraph->node_num++] = ir_graph->node_list[i]->idx;
+        }
+
+        if (ir_graph->nn_dev)
+            subgraph->nn_dev = ir_graph->nn_dev;
+        else
+            subgraph->nn_dev = ir_graph->exec_attr->exec_context->def_dev;
+
+        if (cpu_mask)
+            subgraph->cpu_mask = cpu_mask[k];
+
+        if (set_stage_tensors(ir_graph, subgraph) < 0)
+            return -1;
+    }
+
+    return 0;
+}
+
 static int allocate(struct dev_allocator* allocator, struct ir_graph* ir_graph)
 {
+    int stage_num = 1;
+
+    get_attr_val(ir_graph->attr_mem, ir_graph->attr_num, PIPELINE_STAGE_NUM_ATTR, NULL, &stage_num, sizeof(int));
+
+    if (stage_num > 1)
+    {
+        size_t cpu_mask[MAX_PIPELINE_STAGE];
+        int has_mask = get_attr_val(ir_graph->attr_mem, ir_graph->attr_num, PIPELINE_CPU_MASK_ATTR, NULL, cpu_mask,
+                                    sizeof(cpu_mask)) == 0;
+
+        if (stage_num > MAX_PIPELINE_STAGE)
+        {
+            TLOG_ERR("pipeline: %d stages, at most %d are supported\n", stage_num, MAX_PIPELINE_STAGE);
+            set_tengine_errno(EINVAL);
+            return -1;
+        }
+
+        return allocate_stages(ir_graph, stage_num, has_mask ? cpu_mask : NULL);
+    }
+
     struct subgraph* subgraph = ( struct subgraph* )sys_malloc(sizeof(struct subgraph));
 
     init_subgraph(ir_graph, subgraph, 0);
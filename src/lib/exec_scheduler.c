@@ -24,8 +24,14 @@
 
 #include <stdio.h>
 
+#ifndef CONFIG_BAREMETAL_BUILD
+#include <pthread.h>
+#endif
+
 #include "sys_port.h"
+#include "tengine_c_api.h"
 #include "tengine_ir.h"
+#include "tengine_exec.h"
 #include "tengine_errno.h"
 #include "tengine_log.h"
 #include "exec_scheduler.h"
@@ -54,15 +60,31 @@ static int sched_prerun(struct exec_scheduler* scheduler, struct ir_graph* ir_gr
     return 0;
 }
 
-static int sched_run(struct exec_scheduler* scheduler, struct ir_graph* ir_graph, int block)
+/* a subgraph waits for each of its var inputs, count the ones the subgraph just run has written */
+static void set_inputs_ready(struct vector* wait_list, struct subgraph* done)
 {
-    if (block == 0)
+    int wait_num = get_vector_num(wait_list);
+
+    for (int i = 0; i < wait_num; i++)
     {
-        TLOG_DEBUG("sync scheduler does not support non block run\n");
-        set_tengine_errno(ENOTSUP);
-        return -1;
+        struct subgraph* subgraph = *( struct subgraph** )get_vector_data(wait_list, i);
+
+        if (subgraph == done)
+            continue;
+
+        for (int j = 0; j < subgraph->input_num; j++)
+        {
+            for (int k = 0; k < done->output_num; k++)
+            {
+                if (subgraph->input_tensor_list[j] == done->output_tensor_list[k])
+                    subgraph->input_ready_count++;
+            }
+        }
     }
+}
 
+static int run_subgraphs(struct ir_graph* ir_graph)
+{
     struct vector* wait_list = create_vector(sizeof(struct subgraph*), NULL);
 
     if (wait_list == NULL)
@@ -73,12 +95,13 @@ static int sched_run(struct exec_scheduler* scheduler, struct ir_graph* ir_graph
 
     int subgraph_num = get_vector_num(ir_graph->subgraph_list);
 
-    /* insert all subgraphs into wait list */
+    /* insert all subgraphs into wait list, with the ready count a failed run may have left reset */
 
     for (int i = 0; i < subgraph_num; i++)
     {
         struct subgraph* subgraph = get_ir_graph_subgraph(ir_graph, i);
 
+        subgraph->input_ready_count = 0;
         push_vector_data(wait_list, &subgraph);
     }
 
@@ -130,6 +153,8 @@ static int sched_run(struct exec_scheduler* scheduler, struct ir_graph* ir_graph
             }
 
             subgraph->status = GRAPH_STAT_READY;
+
+            set_inputs_ready(wait_list, subgraph);
         }
 
         /* remove executed subgraph from list,
@@ -144,28 +169,297 @@ static int sched_run(struct exec_scheduler* scheduler, struct ir_graph* ir_graph
 #endif
     }
 
-    /* reset the ready count */
+    sys_free(ready_list);
+    release_vector(wait_list);
 
-    for (int i = 0; i < subgraph_num; i++)
+    return 0;
+}
+
+static void fire_graph_event(struct ir_graph* ir_graph, int event)
+{
+    struct exec_attr* exec_attr = get_ir_graph_exec_attr(ir_graph);
+
+    if (exec_attr->event_hook[event])
+        exec_attr->event_hook[event](ir_graph, event, exec_attr->event_arg[event]);
+}
+
+/* run once and report it through the graph status and event hooks */
+static int run_graph_once(struct ir_graph* ir_graph)
+{
+    fire_graph_event(ir_graph, GRAPH_EXEC_START);
+
+    int ret = run_subgraphs(ir_graph);
+
+    ir_graph->status = ret < 0 ? GRAPH_STAT_ERROR : GRAPH_STAT_READY;
+
+    fire_graph_event(ir_graph, ret < 0 ? GRAPH_EXEC_ABORT : GRAPH_EXEC_DONE);
+
+    return ret;
+}
+
+#ifndef CONFIG_BAREMETAL_BUILD
+
+/* non block runs are queued to a worker thread owned by the graph */
+struct async_worker
+{
+    pthread_t thread;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+
+    int pending; /* queued run requests */
+    int busy; /* a request is being executed */
+    int quit;
+    int error; /* a queued run failed */
+};
+
+static void* async_worker_main(void* arg)
+{
+    struct ir_graph* ir_graph = ( struct ir_graph* )arg;
+    struct async_worker* worker = ( struct async_worker* )get_ir_graph_exec_attr(ir_graph)->sched_priv;
+
+    pthread_mutex_lock(&worker->mutex);
+
+    while (1)
     {
-        struct subgraph* subgraph = get_ir_graph_subgraph(ir_graph, i);
-        subgraph->input_ready_count = 0;
+        while (worker->pending == 0 && !worker->quit)
+            pthread_cond_wait(&worker->cond, &worker->mutex);
+
+        /* drain the queue before quit */
+        if (worker->pending == 0)
+            break;
+
+        worker->pending--;
+        worker->busy = 1;
+
+        /* the hooks are called unlocked, they may wait or queue the graph again */
+        pthread_mutex_unlock(&worker->mutex);
+
+        fire_graph_event(ir_graph, GRAPH_EXEC_START);
+
+        int ret = run_subgraphs(ir_graph);
+
+        if (ret < 0)
+            TLOG_ERR("async run graph failed\n");
+
+        pthread_mutex_lock(&worker->mutex);
+
+        if (ret < 0)
+            worker->error = 1;
+
+        if (worker->pending == 0)
+            ir_graph->status = worker->error ? GRAPH_STAT_ERROR : GRAPH_STAT_READY;
+
+        worker->busy = 0;
+        pthread_cond_broadcast(&worker->cond);
+        pthread_mutex_unlock(&worker->mutex);
+
+        fire_graph_event(ir_graph, ret < 0 ? GRAPH_EXEC_ABORT : GRAPH_EXEC_DONE);
+
+        pthread_mutex_lock(&worker->mutex);
     }
 
-    sys_free(ready_list);
-    release_vector(wait_list);
+    pthread_mutex_unlock(&worker->mutex);
+
+    return NULL;
+}
+
+static struct async_worker* get_async_worker(struct ir_graph* ir_graph)
+{
+    struct exec_attr* exec_attr = get_ir_graph_exec_attr(ir_graph);
+    struct async_worker* worker = ( struct async_worker* )exec_attr->sched_priv;
+
+    if (worker)
+        return worker;
+
+    worker = ( struct async_worker* )sys_malloc(sizeof(struct async_worker));
+
+    if (worker == NULL)
+    {
+        set_tengine_errno(ENOMEM);
+        return NULL;
+    }
+
+    pthread_mutex_init(&worker->mutex, NULL);
+    pthread_cond_init(&worker->cond, NULL);
+    worker->pending = 0;
+    worker->busy = 0;
+    worker->quit = 0;
+    worker->error = 0;
+
+    exec_attr->sched_priv = worker;
+
+    if (pthread_create(&worker->thread, NULL, async_worker_main, ir_graph) != 0)
+    {
+        exec_attr->sched_priv = NULL;
+        pthread_cond_destroy(&worker->cond);
+        pthread_mutex_destroy(&worker->mutex);
+        sys_free(worker);
+
+        TLOG_ERR("create async worker failed\n");
+        set_tengine_errno(EAGAIN);
+        return NULL;
+    }
+
+    return worker;
+}
+
+/* return 1 if all queued runs are done, or 0 if try_wait is set and some are not */
+static int wait_async_worker(struct async_worker* worker, int try_wait)
+{
+    int done;
+
+    pthread_mutex_lock(&worker->mutex);
+
+    if (!try_wait)
+    {
+        while (worker->pending || worker->busy)
+            pthread_cond_wait(&worker->cond, &worker->mutex);
+    }
+
+    done = !(worker->pending || worker->busy);
+
+    pthread_mutex_unlock(&worker->mutex);
+
+    return done;
+}
+
+static int sched_run(struct exec_scheduler* scheduler, struct ir_graph* ir_graph, int block)
+{
+    struct async_worker* worker = ( struct async_worker* )get_ir_graph_exec_attr(ir_graph)->sched_priv;
+
+    if (block)
+    {
+        /* keep the order with the runs queued before */
+        if (worker)
+            wait_async_worker(worker, 0);
+
+        return run_graph_once(ir_graph);
+    }
+
+    worker = get_async_worker(ir_graph);
+
+    if (worker == NULL)
+        return -1;
+
+    pthread_mutex_lock(&worker->mutex);
+
+    if (worker->pending == 0 && !worker->busy)
+        worker->error = 0;
+
+    worker->pending++;
+    ir_graph->status = GRAPH_STAT_RUNNING;
+
+    pthread_cond_broadcast(&worker->cond);
+    pthread_mutex_unlock(&worker->mutex);
 
     return 0;
 }
 
-static int sched_wait(struct exec_scheduler* scheduler, struct ir_graph* ir_graph)
+static int sched_wait(struct exec_scheduler* scheduler, struct ir_graph* ir_graph, int try_wait)
+{
+    struct async_worker* worker = ( struct async_worker* )get_ir_graph_exec_attr(ir_graph)->sched_priv;
+
+    if (worker && !wait_async_worker(worker, try_wait))
+        return 0;
+
+    if (ir_graph->status == GRAPH_STAT_ERROR)
+    {
+        set_tengine_errno(EFAULT);
+        return -1;
+    }
+
+    return 1;
+}
+
+static void sched_release_graph(struct exec_scheduler* scheduler, struct ir_graph* ir_graph)
+{
+    struct exec_attr* exec_attr = get_ir_graph_exec_attr(ir_graph);
+    struct async_worker* worker = ( struct async_worker* )exec_attr->sched_priv;
+
+    if (worker == NULL)
+        return;
+
+    pthread_mutex_lock(&worker->mutex);
+    worker->quit = 1;
+    pthread_cond_broadcast(&worker->cond);
+    pthread_mutex_unlock(&worker->mutex);
+
+    pthread_join(worker->thread, NULL);
+
+    pthread_cond_destroy(&worker->cond);
+    pthread_mutex_destroy(&worker->mutex);
+    sys_free(worker);
+
+    exec_attr->sched_priv = NULL;
+}
+
+#else
+
+static int sched_run(struct exec_scheduler* scheduler, struct ir_graph* ir_graph, int block)
+{
+    if (block == 0)
+    {
+        TLOG_DEBUG("sync scheduler does not support non block run\n");
+        set_tengine_errno(ENOTSUP);
+        return -1;
+    }
+
+    return run_graph_once(ir_graph);
+}
+
+static int sched_wait(struct exec_scheduler* scheduler, struct ir_graph* ir_graph, int try_wait)
 {
-    set_tengine_errno(ENOTSUP);
-    return -1;
+    if (ir_graph->status == GRAPH_STAT_ERROR)
+    {
+        set_tengine_errno(EFAULT);
+        return -1;
+    }
+
+    return 1;
+}
+
+static void sched_release_graph(struct exec_scheduler* scheduler, struct ir_graph* ir_graph) {}
+
+#endif
+
+static int sched_reshape(struct exec_scheduler* scheduler, struct ir_graph* ir_graph)
+{
+    /* the queued runs use the old shapes */
+    sched_wait(scheduler, ir_graph, 0);
+
+    if (infer_shape_graph(ir_graph) < 0)
+        return -1;
+
+    int subgraph_num = get_vector_num(ir_graph->subgraph_list);
+
+    for (int i = 0; i < subgraph_num; i++)
+    {
+        struct subgraph* subgraph = get_ir_graph_subgraph(ir_graph, i);
+        struct nn_device* nn_dev = subgraph->nn_dev;
+
+        if (nn_dev->reshape == NULL)
+        {
+            TLOG_ERR("subgraph %d: device %s can not reshape, prerun the graph again\n", subgraph->idx, nn_dev->name);
+            set_tengine_errno(ENOTSUP);
+            return -1;
+        }
+
+        if (nn_dev->reshape(nn_dev, subgraph) < 0)
+        {
+            subgraph->status = GRAPH_STAT_ERROR;
+            TLOG_ERR("subgraph %d reshape failed\n", subgraph->idx);
+            return -1;
+        }
+    }
+
+    return 0;
 }
 
 static int sched_postrun(struct exec_scheduler* scheduler, struct ir_graph* ir_graph)
 {
+    /* finish the queued runs before the exec graphs go away */
+    sched_release_graph(scheduler, ir_graph);
+
     int subgraph_num = get_vector_num(ir_graph->subgraph_list);
     int has_error = 0;
 
@@ -195,7 +489,9 @@ static struct exec_scheduler sync_scheduler = {
     .prerun = sched_prerun,
     .run = sched_run,
     .wait = sched_wait,
+    .reshape = sched_reshape,
     .postrun = sched_postrun,
+    .release_graph = sched_release_graph,
     .release = NULL,
 };
 
@@ -31,6 +31,7 @@
 #include "vector.h"
 #include "tengine_log.h"
 #include "module.h"
+#include "lock.h"
 
 #ifdef CONFIG_MEM_STAT
 
@@ -60,6 +61,9 @@ static int mem_stat_skipped = 1;
 static struct mem_stat mem_stat;
 static struct vector* block_list;
 
+/* graphs run on several threads, the sys_malloc() of them all is counted here */
+static lock_t stat_lock;
+
 DECLARE_AUTO_INIT_FUNC(init_mem_stat);
 DECLARE_AUTO_EXIT_FUNC(release_mem_stat);
 
@@ -98,6 +102,7 @@ static void init_mem_stat(void)
     mem_stat.min_block_size = 1 << 20;
 
     block_list = create_vector(sizeof(struct block_stat), NULL);
+    init_lock(&stat_lock);
 
     enable_mem_stat = real_enable_mem_stat;
     disable_mem_stat = real_disable_mem_stat;
@@ -143,6 +148,8 @@ void* stat_malloc(int size)
         return NULL;
     }
 
+    lock(&stat_lock);
+
     mem_stat.alloc_count++;
     mem_stat.cur_mem_size += size;
 
@@ -165,15 +172,21 @@ void* stat_malloc(int size)
 
     mem_stat_skipped = 0;
 
+    unlock(&stat_lock);
+
     return ptr;
 }
 
 void stat_free(void* ptr)
 {
+    lock(&stat_lock);
+
     int idx = find_block_list(ptr);
 
     if (idx < 0)
     {
+        unlock(&stat_lock);
+
         /* a memory not allocated by us ? */
         free(ptr);
         return;
@@ -190,6 +203,8 @@ void stat_free(void* ptr)
 
     mem_stat_skipped = 0;
 
+    unlock(&stat_lock);
+
     free(ptr);
 }
 
@@ -198,10 +213,15 @@ void* stat_realloc(void* ptr, size_t size)
     if (ptr == NULL)
         return stat_malloc(size);
 
+    lock(&stat_lock);
+
     int idx = find_block_list(ptr);
 
     if (idx < 0)
+    {
+        unlock(&stat_lock);
         return realloc(ptr, size);
+    }
 
     void* new_ptr = realloc(ptr, size);
 
@@ -211,6 +231,7 @@ void* stat_realloc(void* ptr, size_t size)
     {
         TLOG_ERR("cannot realloc size: %d --> %d\n", block_stat->size, size);
         TLOG_ERR("cur mem size: %d peak mem size: %d\n", mem_stat.cur_mem_size, mem_stat.peak_mem_size);
+        unlock(&stat_lock);
         return NULL;
     }
 
@@ -229,6 +250,8 @@ void* stat_realloc(void* ptr, size_t size)
     block_stat->ptr = new_ptr;
     block_stat->size = size;
 
+    unlock(&stat_lock);
+
     return new_ptr;
 }
 
@@ -0,0 +1,660 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * License); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * AS IS BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*
+ * Copyright (c) 2020, OPEN AI LAB
+ * Author: haitao@openailab.com
+ */
+
+#include <string.h>
+
+#ifndef CONFIG_BAREMETAL_BUILD
+#include <pthread.h>
+#endif
+
+#include "sys_port.h"
+#include "tengine_c_api.h"
+#include "tengine_ir.h"
+#include "tengine_errno.h"
+#include "tengine_log.h"
+#include "dev_allocator.h"
+#include "nn_device.h"
+#include "vector.h"
+#include "cpu.h"
+
+#ifndef CONFIG_BAREMETAL_BUILD
+
+/*
+ * the graph is split into stages, each run by its own thread on its own cores. a frame takes a
+ * slot, a session of the graph, and goes through the stages in turn, so that the stages work on
+ * different frames at the same time. a slot is freed once its frame leaves the last stage, so
+ * the tensors between two stages are held once for each frame in flight.
+ */
+struct pipeline_frame
+{
+    const void** input_data;
+    void** output_data;
+    int* output_size;
+    batch_done_t done;
+    void* arg;
+    int status;
+};
+
+struct pipeline_slot
+{
+    session_t session;
+    struct ir_graph* graph;
+    struct ir_tensor** input_tensors;
+    struct ir_tensor** output_tensors;
+    struct pipeline_frame frame; /* the frame in the slot */
+};
+
+struct pipeline;
+
+struct pipeline_stage
+{
+    struct pipeline* pipeline;
+    int idx;
+    size_t cpu_mask;
+    pthread_t thread;
+
+    /* the slots waiting for the stage, free slots for the first stage */
+    int* slot_queue;
+    int queue_head;
+    int queue_num;
+    int exited;
+};
+
+struct pipeline
+{
+    int stage_num;
+    int slot_num;
+    int input_num;
+    int output_num;
+    int* input_size; /* the bytes of each input */
+
+    struct pipeline_slot* slot_list;
+    struct pipeline_stage* stage_list;
+
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    struct vector* queue; /* the frames submitted, waiting for a free slot */
+    int frame_num; /* submitted and not done yet */
+    int error; /* a frame failed since the last wait */
+    int quit;
+};
+
+static void release_pipeline_frame(struct pipeline_frame* frame)
+{
+    sys_free(frame->input_data);
+}
+
+static void push_stage_slot(struct pipeline_stage* stage, int slot)
+{
+    int slot_num = stage->pipeline->slot_num;
+
+    stage->slot_queue[(stage->queue_head + stage->queue_num) % slot_num] = slot;
+    stage->queue_num++;
+}
+
+static int pop_stage_slot(struct pipeline_stage* stage)
+{
+    int slot = stage->slot_queue[stage->queue_head];
+
+    stage->queue_head = (stage->queue_head + 1) % stage->pipeline->slot_num;
+    stage->queue_num--;
+
+    return slot;
+}
+
+static int collect_graph_tensors(struct ir_graph* ir_graph, int16_t* nodes, int node_num, struct ir_tensor** tensors)
+{
+    int n = 0;
+
+    for (int i = 0; i < node_num; i++)
+    {
+        struct ir_node* ir_node = get_ir_graph_node(ir_graph, nodes[i]);
+
+        for (int j = 0; j < ir_node->output_num; j++)
+        {
+            if (tensors)
+                tensors[n] = get_ir_graph_tensor(ir_graph, ir_node->output_tensors[j]);
+
+            n++;
+        }
+    }
+
+    return n;
+}
+
+static int run_stage(struct ir_graph* ir_graph, int idx)
+{
+    struct subgraph* subgraph = get_ir_graph_subgraph(ir_graph, idx);
+    struct nn_device* nn_dev = subgraph->nn_dev;
+
+    subgraph->status = GRAPH_STAT_RUNNING;
+
+    if (nn_dev->run(nn_dev, subgraph) < 0)
+    {
+        TLOG_ERR("pipeline: run stage %d failed\n", idx);
+        subgraph->status = GRAPH_STAT_ERROR;
+        return -1;
+    }
+
+    subgraph->status = GRAPH_STAT_READY;
+
+    return 0;
+}
+
+/* the inputs are read in place, from the first stage until the frame is done */
+static void bind_frame_inputs(struct pipeline* pipeline, struct pipeline_slot* slot)
+{
+    for (int i = 0; i < pipeline->input_num; i++)
+    {
+        struct ir_tensor* ir_tensor = slot->input_tensors[i];
+
+        ir_tensor->data = ( void* )slot->frame.input_data[i];
+        ir_tensor->free_host_mem = 0;
+        ir_tensor->internal_allocated = 0;
+    }
+}
+
+static void finish_frame(struct pipeline* pipeline, struct pipeline_slot* slot)
+{
+    struct pipeline_frame* frame = &slot->frame;
+
+    for (int i = 0; i < pipeline->output_num && frame->status == 0; i++)
+    {
+        struct ir_tensor* ir_tensor = slot->output_tensors[i];
+        int size = ir_tensor->elem_num * ir_tensor->elem_size;
+
+        if (frame->output_data[i] == NULL)
+            continue;
+
+        if (frame->output_size[i] < size)
+        {
+            TLOG_ERR("pipeline: output %d has %d bytes, tensor %s needs %d\n", i, frame->output_size[i],
+                     ir_tensor->name, size);
+            frame->status = -1;
+            break;
+        }
+
+        memcpy(frame->output_data[i], ir_tensor->data, size);
+    }
+
+    for (int i = 0; i < pipeline->input_num; i++)
+        slot->input_tensors[i]->data = NULL;
+
+    if (frame->done)
+        frame->done(frame->status, frame->arg);
+
+    release_pipeline_frame(frame);
+}
+
+static int is_stage_ready(struct pipeline_stage* stage)
+{
+    if (stage->queue_num == 0)
+        return 0;
+
+    return stage->idx > 0 || get_vector_num(stage->pipeline->queue) > 0;
+}
+
+/* no frame will come to the stage any more */
+static int is_stage_drained(struct pipeline_stage* stage)
+{
+    struct pipeline* pipeline = stage->pipeline;
+
+    if (!pipeline->quit)
+        return 0;
+
+    if (stage->idx == 0)
+        return get_vector_num(pipeline->queue) == 0;
+
+    return pipeline->stage_list[stage->idx - 1].exited && stage->queue_num == 0;
+}
+
+static void* pipeline_stage_main(void* arg)
+{
+    struct pipeline_stage* stage = ( struct pipeline_stage* )arg;
+    struct pipeline* pipeline = stage->pipeline;
+    struct pipeline_stage* next = &pipeline->stage_list[(stage->idx + 1) % pipeline->stage_num];
+    int last = stage->idx == pipeline->stage_num - 1;
+
+    if (stage->cpu_mask && set_cpu_affine(stage->cpu_mask) < 0)
+        TLOG_ERR("pipeline: bind stage %d to cpu mask 0x%lx failed\n", stage->idx, ( unsigned long )stage->cpu_mask);
+
+    pthread_mutex_lock(&pipeline->mutex);
+
+    while (1)
+    {
+        while (!is_stage_ready(stage) && !is_stage_drained(stage))
+            pthread_cond_wait(&pipeline->cond, &pipeline->mutex);
+
+        if (!is_stage_ready(stage))
+            break;
+
+        struct pipeline_slot* slot = &pipeline->slot_list[pop_stage_slot(stage)];
+
+        if (stage->idx == 0)
+        {
+            slot->frame = *( struct pipeline_frame* )get_vector_data(pipeline->queue, 0);
+            remove_vector_by_idx(pipeline->queue, 0);
+        }
+
+        /* the stages before and after run other frames meanwhile */
+        pthread_mutex_unlock(&pipeline->mutex);
+
+        if (stage->idx == 0)
+            bind_frame_inputs(pipeline, slot);
+
+        /* a failed frame still goes through, it is done in order at the last stage */
+        if (slot->frame.status == 0 && run_stage(slot->graph, stage->idx) < 0)
+            slot->frame.status = -1;
+
+        int status = slot->frame.status;
+
+        if (last)
+            finish_frame(pipeline, slot);
+
+        pthread_mutex_lock(&pipeline->mutex);
+
+        push_stage_slot(next, slot - pipeline->slot_list);
+
+        if (last)
+        {
+            pipeline->frame_num--;
+
+            if (status < 0)
+                pipeline->error = 1;
+        }
+
+        pthread_cond_broadcast(&pipeline->cond);
+    }
+
+    stage->exited = 1;
+    pthread_cond_broadcast(&pipeline->cond);
+    pthread_mutex_unlock(&pipeline->mutex);
+
+    return NULL;
+}
+
+static void free_pipeline(struct pipeline* pipeline)
+{
+    if (pipeline->slot_list)
+    {
+        for (int i = 0; i < pipeline->slot_num; i++)
+        {
+            struct pipeline_slot* slot = &pipeline->slot_list[i];
+
+            if (slot->session)
+                release_exec_session(slot->session);
+
+            sys_free(slot->input_tensors);
+            sys_free(slot->output_tensors);
+        }
+    }
+
+    if (pipeline->stage_list)
+    {
+        for (int i = 0; i < pipeline->stage_num; i++)
+            sys_free(pipeline->stage_list[i].slot_queue);
+    }
+
+    if (pipeline->queue)
+        release_vector(pipeline->queue);
+
+    sys_free(pipeline->input_size);
+    sys_free(pipeline->slot_list);
+    sys_free(pipeline->stage_list);
+    sys_free(pipeline);
+}
+
+/* put back a graph attr overridden for the sessions, or drop it if the graph had none */
+static void restore_graph_attr(graph_t graph, const char* attr_name, const void* buf, int size, int saved)
+{
+    struct ir_graph* ir_graph = ( struct ir_graph* )graph;
+
+    if (saved)
+    {
+        set_graph_attr(graph, attr_name, buf, size);
+        return;
+    }
+
+    if (remove_single_attr(ir_graph->attr_mem, ir_graph->attr_num, attr_name) == NULL)
+        return;
+
+    ir_graph->attr_num--;
+
+    if (ir_graph->attr_num == 0)
+    {
+        remove_all_attr(ir_graph->attr_mem, 0);
+        ir_graph->attr_mem = NULL;
+    }
+}
+
+/* the stage attrs are taken by the sessions, the graph itself is left as it was */
+static int create_pipeline_slots(struct pipeline* pipeline, graph_t graph, int stage_num, const size_t cpu_mask[])
+{
+    size_t stage_mask[MAX_PIPELINE_STAGE] = {0};
+    size_t old_stage_mask[MAX_PIPELINE_STAGE];
+    int old_stage_num;
+
+    for (int i = 0; i < stage_num; i++)
+        stage_mask[i] = cpu_mask ? cpu_mask[i] : 0;
+
+    int has_stage_num = get_graph_attr(graph, PIPELINE_STAGE_NUM_ATTR, &old_stage_num, sizeof(int)) == 0;
+    int has_stage_mask = get_graph_attr(graph, PIPELINE_CPU_MASK_ATTR, old_stage_mask, sizeof(old_stage_mask)) == 0;
+
+    set_graph_attr(graph, PIPELINE_STAGE_NUM_ATTR, &stage_num, sizeof(int));
+    set_graph_attr(graph, PIPELINE_CPU_MASK_ATTR, stage_mask, sizeof(stage_mask));
+
+    int ret = 0;
+
+    for (int i = 0; i < pipeline->slot_num; i++)
+    {
+        struct pipeline_slot* slot = &pipeline->slot_list[i];
+
+        slot->session = create_exec_session(graph);
+
+        if (slot->session == NULL)
+        {
+            ret = -1;
+            break;
+        }
+
+        slot->graph = ( struct ir_graph* )get_session_graph(slot->session);
+    }
+
+    restore_graph_attr(graph, PIPELINE_STAGE_NUM_ATTR, &old_stage_num, sizeof(int), has_stage_num);
+    restore_graph_attr(graph, PIPELINE_CPU_MASK_ATTR, old_stage_mask, sizeof(old_stage_mask), has_stage_mask);
+
+    return ret;
+}
+
+pipeline_t DLLEXPORT create_pipeline(graph_t graph, int stage_num, const size_t cpu_mask[])
+{
+    if (stage_num < 1 || stage_num > MAX_PIPELINE_STAGE)
+    {
+        TLOG_ERR("create pipeline: %d stages, it should be 1 to %d\n", stage_num, MAX_PIPELINE_STAGE);
+        set_tengine_errno(EINVAL);
+        return NULL;
+    }
+
+    struct pipeline* pipeline = ( struct pipeline* )sys_malloc(sizeof(struct pipeline));
+
+    if (pipeline == NULL)
+    {
+        set_tengine_errno(ENOMEM);
+        return NULL;
+    }
+
+    memset(pipeline, 0, sizeof(struct pipeline));
+
+    /* one frame in flight for each stage, the tensors between two stages are double buffered at least */
+    pipeline->slot_num = stage_num;
+    pipeline->slot_list = ( struct pipeline_slot* )sys_malloc(sizeof(struct pipeline_slot) * pipeline->slot_num);
+    pipeline->queue = create_vector(sizeof(struct pipeline_frame), NULL);
+
+    if (pipeline->slot_list == NULL || pipeline->queue == NULL)
+    {
+        free_pipeline(pipeline);
+        set_tengine_errno(ENOMEM);
+        return NULL;
+    }
+
+    memset(pipeline->slot_list, 0, sizeof(struct pipeline_slot) * pipeline->slot_num);
+
+    if (create_pipeline_slots(pipeline, graph, stage_num, cpu_mask) < 0)
+    {
+        TLOG_ERR("create pipeline: prerun the stages failed\n");
+        free_pipeline(pipeline);
+        return NULL;
+    }
+
+    /* a small graph may have fewer nodes to run than stages */
+    struct ir_graph* ir_graph = pipeline->slot_list[0].graph;
+
+    pipeline->stage_num = get_vector_num(ir_graph->subgraph_list);
+    pipeline->input_num = collect_graph_tensors(ir_graph, ir_graph->input_nodes, ir_graph->input_num, NULL);
+    pipeline->output_num = collect_graph_tensors(ir_graph, ir_graph->output_nodes, ir_graph->output_num, NULL);
+    pipeline->input_size = ( int* )sys_malloc(sizeof(int) * pipeline->input_num);
+    pipeline->stage_list = ( struct pipeline_stage* )sys_malloc(sizeof(struct pipeline_stage) * pipeline->stage_num);
+
+    if (pipeline->input_size == NULL || pipeline->stage_list == NULL)
+    {
+        free_pipeline(pipeline);
+        set_tengine_errno(ENOMEM);
+        return NULL;
+    }
+
+    memset(pipeline->stage_list, 0, sizeof(struct pipeline_stage) * pipeline->stage_num);
+
+    for (int i = 0; i < pipeline->slot_num; i++)
+    {
+        struct pipeline_slot* slot = &pipeline->slot_list[i];
+
+        slot->input_tensors = ( struct ir_tensor** )sys_malloc(sizeof(struct ir_tensor*) * pipeline->input_num);
+        slot->output_tensors = ( struct ir_tensor** )sys_malloc(sizeof(struct ir_tensor*) * pipeline->output_num);
+
+        if (slot->input_tensors == NULL || slot->output_tensors == NULL)
+        {
+            free_pipeline(pipeline);
+            set_tengine_errno(ENOMEM);
+            return NULL;
+        }
+
+        collect_graph_tensors(slot->graph, slot->graph->input_nodes, slot->graph->input_num, slot->input_tensors);
+        collect_graph_tensors(slot->graph, slot->graph->output_nodes, slot->graph->output_num, slot->output_tensors);
+    }
+
+    for (int i = 0; i < pipeline->input_num; i++)
+    {
+        struct ir_tensor* ir_tensor = pipeline->slot_list[0].input_tensors[i];
+
+        pipeline->input_size[i] = ir_tensor->elem_num * ir_tensor->elem_size;
+    }
+
+    for (int i = 0; i < pipeline->stage_num; i++)
+    {
+        struct pipeline_stage* stage = &pipeline->stage_list[i];
+
+        stage->pipeline = pipeline;
+        stage->idx = i;
+        stage->cpu_mask = cpu_mask ? cpu_mask[i] : 0;
+        stage->slot_queue = ( int* )sys_malloc(sizeof(int) * pipeline->slot_num);
+
+        if (stage->slot_queue == NULL)
+        {
+            free_pipeline(pipeline);
+            set_tengine_errno(ENOMEM);
+            return NULL;
+        }
+    }
+
+    /* all the slots are free */
+    for (int i = 0; i < pipeline->slot_num; i++)
+        push_stage_slot(&pipeline->stage_list[0], i);
+
+    pthread_mutex_init(&pipeline->mutex, NULL);
+    pthread_cond_init(&pipeline->cond, NULL);
+
+    int started = 0;
+
+    for (; started < pipeline->stage_num; started++)
+    {
+        struct pipeline_stage* stage = &pipeline->stage_list[started];
+
+        if (pthread_create(&stage->thread, NULL, pipeline_stage_main, stage) != 0)
+            break;
+    }
+
+    if (started < pipeline->stage_num)
+    {
+        pthread_mutex_lock(&pipeline->mutex);
+        pipeline->quit = 1;
+        pthread_cond_broadcast(&pipeline->cond);
+        pthread_mutex_unlock(&pipeline->mutex);
+
+        for (int i = 0; i < started; i++)
+            pthread_join(pipeline->stage_list[i].thread, NULL);
+
+        pthread_cond_destroy(&pipeline->cond);
+        pthread_mutex_destroy(&pipeline->mutex);
+        free_pipeline(pipeline);
+
+        TLOG_ERR("create pipeline: create the stage threads failed\n");
+        set_tengine_errno(EAGAIN);
+        return NULL;
+    }
+
+    return pipeline;
+}
+
+int DLLEXPORT submit_pipeline_frame(pipeline_t pipeline_handle, const void* input_data[], const int input_size[],
+                                    void* output_data[], const int output_size[], batch_done_t done, void* arg)
+{
+    struct pipeline* pipeline = ( struct pipeline* )pipeline_handle;
+    struct pipeline_frame frame;
+
+    for (int i = 0; i < pipeline->input_num; i++)
+    {
+        if (input_size[i] != pipeline->input_size[i])
+        {
+            TLOG_ERR("pipeline: input %d has %d bytes, tensor %s needs %d\n", i, input_size[i],
+                     pipeline->slot_list[0].input_tensors[i]->name, pipeline->input_size[i]);
+            set_tengine_errno(EINVAL);
+            return -1;
+        }
+    }
+
+    /* the pointers are kept until the frame is done, the buffers are the caller's */
+    int ptr_num = pipeline->input_num + pipeline->output_num;
+    void** ptrs = ( void** )sys_malloc(sizeof(void*) * ptr_num + sizeof(int) * pipeline->output_num);
+
+    if (ptrs == NULL)
+    {
+        set_tengine_errno(ENOMEM);
+        return -1;
+    }
+
+    frame.input_data = ( const void** )ptrs;
+    frame.output_data = ptrs + pipeline->input_num;
+    frame.output_size = ( int* )(ptrs + ptr_num);
+    frame.done = done;
+    frame.arg = arg;
+    frame.status = 0;
+
+    memcpy(frame.input_data, input_data, sizeof(void*) * pipeline->input_num);
+    memcpy(frame.output_data, output_data, sizeof(void*) * pipeline->output_num);
+    memcpy(frame.output_size, output_size, sizeof(int) * pipeline->output_num);
+
+    pthread_mutex_lock(&pipeline->mutex);
+
+    int ret = push_vector_data(pipeline->queue, &frame);
+
+    if (ret == 0)
+    {
+        pipeline->frame_num++;
+        pthread_cond_broadcast(&pipeline->cond);
+    }
+
+    pthread_mutex_unlock(&pipeline->mutex);
+
+    if (ret < 0)
+    {
+        release_pipeline_frame(&frame);
+        set_tengine_errno(ENOMEM);
+        return -1;
+    }
+
+    return 0;
+}
+
+int DLLEXPORT wait_pipeline(pipeline_t pipeline_handle)
+{
+    struct pipeline* pipeline = ( struct pipeline* )pipeline_handle;
+
+    pthread_mutex_lock(&pipeline->mutex);
+
+    while (pipeline->frame_num > 0)
+        pthread_cond_wait(&pipeline->cond, &pipeline->mutex);
+
+    int error = pipeline->error;
+
+    pipeline->error = 0;
+
+    pthread_mutex_unlock(&pipeline->mutex);
+
+    if (error)
+    {
+        set_tengine_errno(EFAULT);
+        return -1;
+    }
+
+    return 0;
+}
+
+int DLLEXPORT release_pipeline(pipeline_t pipeline_handle)
+{
+    struct pipeline* pipeline = ( struct pipeline* )pipeline_handle;
+
+    pthread_mutex_lock(&pipeline->mutex);
+    pipeline->quit = 1;
+    pthread_cond_broadcast(&pipeline->cond);
+    pthread_mutex_unlock(&pipeline->mutex);
+
+    for (int i = 0; i < pipeline->stage_num; i++)
+        pthread_join(pipeline->stage_list[i].thread, NULL);
+
+    pthread_cond_destroy(&pipeline->cond);
+    pthread_mutex_destroy(&pipeline->mutex);
+
+    free_pipeline(pipeline);
+
+    return 0;
+}
+
+#else
+
+pipeline_t DLLEXPORT create_pipeline(graph_t graph, int stage_num, const size_t cpu_mask[])
+{
+    set_tengine_errno(ENOTSUP);
+    return NULL;
+}
+
+int DLLEXPORT submit_pipeline_frame(pipeline_t pipeline_handle, const void* input_data[], const int input_size[],
+                                    void* output_data[], const int output_size[], batch_done_t done, void* arg)
+{
+    set_tengine_errno(ENOTSUP);
+    return -1;
+}
+
+int DLLEXPORT wait_pipeline(pipeline_t pipeline_handle)
+{
+    set_tengine_errno(ENOTSUP);
+    return -1;
+}
+
+int DLLEXPORT release_pipeline(pipeline_t pipeline_handle)
+{
+    set_tengine_errno(ENOTSUP);
+    return -1;
+}
+
+#endif
@@ -63,6 +63,9 @@ void (*enable_mem_stat)(void) = NULL;
 void (*disable_intern_allocator)(void) = NULL;
 void (*disable_mem_stat)(void) = NULL;
 
+/* fusion rewrites the nodes and the const data a graph shares with its clones */
+static lock_t fuse_lock;
+
 int DLLEXPORT init_tengine(void)
 {
     // if (enable_intern_allocator)
@@ -73,6 +76,8 @@ int DLLEXPORT init_tengine(void)
     if (enable_mem_stat)
         enable_mem_stat();
 
+    init_lock(&fuse_lock);
+
     int ret = 0;
 
     ret = init_op_name_map();
@@ -228,11 +233,72 @@ error:
     return NULL;
 }
 
+graph_t DLLEXPORT clone_graph(graph_t graph)
+{
+    struct ir_graph* origin = ( struct ir_graph* )graph;
+    struct exec_attr* exec_attr = get_ir_graph_exec_attr(origin);
+    context_t context = exec_attr->exec_context;
+
+    if (exec_attr->priv_context)
+    {
+        context = create_context(NULL, 1);
+
+        if (context == NULL)
+            return NULL;
+    }
+
+    struct ir_graph* ir_graph = NULL;
+
+    lock(&fuse_lock);
+
+    /* the const data is shared, fold it now, before the clones could fold it once more */
+    if (fuse_ir_graph(origin) < 0)
+        TLOG_ERR("clone graph: fuse the graph failed\n");
+    else
+        ir_graph = clone_ir_graph(origin, ( struct exec_context* )context);
+
+    unlock(&fuse_lock);
+
+    if (ir_graph == NULL)
+    {
+        if (exec_attr->priv_context)
+            destroy_context(context);
+
+        return NULL;
+    }
+
+    ir_graph->exec_attr->priv_context = exec_attr->priv_context;
+
+    return ir_graph;
+}
+
 int DLLEXPORT save_graph(graph_t graph, const char* model_format, const char* fname, ...)
 {
-    // TODO: save graph as tengine model
-    set_tengine_errno(ENOTSUP);
-    return -1;
+    struct ir_graph* ir_graph = ( struct ir_graph* )graph;
+    struct serializer* saver = find_serializer(model_format);
+
+    if (saver == NULL)
+    {
+        TLOG_ERR("no serializer found for %s\n", model_format);
+        set_tengine_errno(ENOENT);
+        return -1;
+    }
+
+    if (saver->save_model == NULL)
+    {
+        TLOG_ERR("%s serializer does not support save\n", saver->get_name(saver));
+        set_tengine_errno(ENOTSUP);
+        return -1;
+    }
+
+    va_list ap;
+    va_start(ap, fname);
+
+    int ret = saver->save_model(saver, ir_graph, fname, ap);
+
+    va_end(ap);
+
+    return ret;
 }
 
 int DLLEXPORT set_graph_layout(graph_t graph, int layout_type)
@@ -329,6 +395,11 @@ graph_t DLLEXPORT merge_graph(int graph_num, graph_t graph0, graph_t graph1, ...
 int DLLEXPORT destroy_graph(graph_t graph)
 {
     struct ir_graph* ir_graph = ( struct ir_graph* )graph;
+    struct exec_scheduler* scheduler = get_ir_graph_context(ir_graph)->scheduler;
+
+    /* stop the async worker before the graph goes away */
+    if (scheduler->release_graph)
+        scheduler->release_graph(scheduler, ir_graph);
 
     if (ir_graph->exec_attr->priv_context)
         destroy_context(ir_graph->exec_attr->exec_context);
@@ -844,8 +915,17 @@ int DLLEXPORT get_tensor_data_type(tensor_t tensor)
 int DLLEXPORT set_tensor_data_type(tensor_t tensor, int data_type)
 {
     struct ir_tensor* ir_tensor = ( struct ir_tensor* )tensor;
+    int elem_size = data_type_size(data_type);
 
+    if (elem_size == 0)
+    {
+        set_tengine_errno(EINVAL);
+        return -1;
+    }
+
+    /* the buffer set after must match the new element size */
     ir_tensor->data_type = data_type;
+    ir_tensor->elem_size = elem_size;
 
     return 0;
 }
@@ -966,6 +1046,18 @@ int set_graph_thread_mask(graph_t graph, size_t cpu_mask)
     return 0;
 }
 
+/* a graph may be fused by a clone_graph() of another thread */
+static int fuse_graph(struct ir_graph* ir_graph)
+{
+    lock(&fuse_lock);
+
+    int ret = fuse_ir_graph(ir_graph);
+
+    unlock(&fuse_lock);
+
+    return ret;
+}
+
 int DLLEXPORT prerun_graph(graph_t graph)
 {
     struct ir_graph* ir_graph = ( struct ir_graph* )graph;
@@ -977,6 +1069,13 @@ int DLLEXPORT prerun_graph(graph_t graph)
         return -1;
     }
 
+    if (fuse_graph(ir_graph) < 0)
+    {
+        ir_graph->status = GRAPH_STAT_ERROR;
+        fprintf(stderr, "fuse_ir_graph failed\n");
+        return -1;
+    }
+
     struct exec_context* context = get_ir_graph_context(ir_graph);
 
     struct dev_allocator* allocator = context->dev_allocator;
@@ -1019,6 +1118,13 @@ int DLLEXPORT prerun_graph_multithread(graph_t graph, int cluster, int threads)
         return -1;
     }
 
+    if (fuse_graph(ir_graph) < 0)
+    {
+        ir_graph->status = GRAPH_STAT_ERROR;
+        fprintf(stderr, "fuse_ir_graph failed\n");
+        return -1;
+    }
+
     struct exec_context* context = get_ir_graph_context(ir_graph);
     struct dev_allocator* allocator = context->dev_allocator;
     if (allocator->allocate(allocator, ir_graph) < 0)
@@ -1042,23 +1148,52 @@ int DLLEXPORT prerun_graph_multithread(graph_t graph, int cluster, int threads)
     return 0;
 }
 
+/* set_tensor_shape() on a graph input after prerun */
+static int is_graph_input_reshaped(struct ir_graph* ir_graph)
+{
+    for (int i = 0; i < ir_graph->input_num; i++)
+    {
+        struct ir_node* ir_node = get_ir_graph_node(ir_graph, ir_graph->input_nodes[i]);
+
+        for (int j = 0; j < ir_node->output_num; j++)
+        {
+            if (get_ir_graph_tensor(ir_graph, ir_node->output_tensors[j])->reshaped)
+                return 1;
+        }
+    }
+
+    return 0;
+}
+
 int DLLEXPORT run_graph(graph_t graph, int block)
 {
     struct ir_graph* ir_graph = ( struct ir_graph* )graph;
     struct exec_context* context = get_ir_graph_context(ir_graph);
     struct exec_scheduler* scheduler = context->scheduler;
 
-    ir_graph->status = GRAPH_STAT_RUNNING;
+    if (ir_graph->status != GRAPH_STAT_READY && ir_graph->status != GRAPH_STAT_RUNNING &&
+        ir_graph->status != GRAPH_STAT_ERROR)
+    {
+        TLOG_ERR("run graph: graph is not prerun yet\n");
+        set_tengine_errno(EINVAL);
+        return -1;
+    }
 
-    if (scheduler->run(scheduler, ir_graph, block) < 0)
+    /* only the shapes and the activation memory are planned again, the weights stay packed */
+    if (is_graph_input_reshaped(ir_graph) && scheduler->reshape(scheduler, ir_graph) < 0)
     {
+        TLOG_ERR("run graph: reshape the graph failed\n");
         ir_graph->status = GRAPH_STAT_ERROR;
         return -1;
     }
-    else
+
+    /* the scheduler sets the status back to ready or error once the run is done */
+    ir_graph->status = GRAPH_STAT_RUNNING;
+
+    if (scheduler->run(scheduler, ir_graph, block) < 0)
     {
-        if (block)
-            ir_graph->status = GRAPH_STAT_READY;
+        ir_graph->status = GRAPH_STAT_ERROR;
+        return -1;
     }
 
     return 0;
@@ -1070,22 +1205,149 @@ int DLLEXPORT wait_graph(graph_t graph, int try_wait)
     struct exec_context* context = get_ir_graph_context(ir_graph);
     struct exec_scheduler* scheduler = context->scheduler;
 
-    if (ir_graph->status != GRAPH_STAT_RUNNING || ir_graph->status != GRAPH_STAT_READY)
+    if (ir_graph->status != GRAPH_STAT_RUNNING && ir_graph->status != GRAPH_STAT_READY &&
+        ir_graph->status != GRAPH_STAT_ERROR)
     {
         set_tengine_errno(EINVAL);
         return -1;
     }
 
-    if (ir_graph->status == GRAPH_STAT_READY)
-        return 0;
+    return scheduler->wait(scheduler, ir_graph, try_wait);
+}
+
+/* a session is a clone of the graph, prerun on its own */
+session_t DLLEXPORT create_exec_session(graph_t graph)
+{
+    struct ir_graph* ir_graph = clone_graph(graph);
+
+    if (ir_graph == NULL)
+        return NULL;
+
+    if (prerun_graph(ir_graph) < 0)
+    {
+        TLOG_ERR("create exec session: prerun the session failed\n");
+        destroy_graph(ir_graph);
+        return NULL;
+    }
+
+    return ir_graph;
+}
+
+static struct ir_tensor* get_session_tensor(struct ir_graph* ir_graph, int16_t* nodes, int node_num, int idx)
+{
+    for (int i = 0; i < node_num; i++)
+    {
+        struct ir_node* ir_node = get_ir_graph_node(ir_graph, nodes[i]);
 
-    if (!try_wait)
+        if (idx < ir_node->output_num)
+            return get_ir_graph_tensor(ir_graph, ir_node->output_tensors[idx]);
+
+        idx -= ir_node->output_num;
+    }
+
+    return NULL;
+}
+
+int DLLEXPORT run_session(session_t session, const void* input_data[], const int input_size[], void* output_data[],
+                          const int output_size[])
+{
+    struct ir_graph* ir_graph = ( struct ir_graph* )session;
+    struct ir_tensor* ir_tensor;
+    int ret = -1;
+
+    for (int i = 0; (ir_tensor = get_session_tensor(ir_graph, ir_graph->input_nodes, ir_graph->input_num, i)); i++)
     {
-        set_tengine_errno(EAGAIN);
+        int size = ir_tensor->elem_num * ir_tensor->elem_size;
+
+        if (input_size[i] != size)
+        {
+            TLOG_ERR("run session: input %d has %d bytes, tensor %s needs %d\n", i, input_size[i], ir_tensor->name,
+                     size);
+            set_tengine_errno(EINVAL);
+            goto unbind;
+        }
+
+        /* the input is read in place, and only for this call */
+        ir_tensor->data = ( void* )input_data[i];
+        ir_tensor->free_host_mem = 0;
+        ir_tensor->internal_allocated = 0;
+    }
+
+    ret = run_graph(ir_graph, 1);
+
+unbind:
+    for (int i = 0; (ir_tensor = get_session_tensor(ir_graph, ir_graph->input_nodes, ir_graph->input_num, i)); i++)
+        ir_tensor->data = NULL;
+
+    if (ret < 0)
         return -1;
+
+    for (int i = 0; (ir_tensor = get_session_tensor(ir_graph, ir_graph->output_nodes, ir_graph->output_num, i)); i++)
+    {
+        int size = ir_tensor->elem_num * ir_tensor->elem_size;
+
+        if (output_data[i] == NULL)
+            continue;
+
+        if (output_size[i] < size)
+        {
+            TLOG_ERR("run session: output %d has %d bytes, tensor %s needs %d\n", i, output_size[i], ir_tensor->name,
+                     size);
+            set_tengine_errno(EINVAL);
+            return -1;
+        }
+
+        memcpy(output_data[i], ir_tensor->data, size);
     }
 
-    return scheduler->wait(scheduler, ir_graph);
+    return 0;
+}
+
+graph_t DLLEXPORT get_session_graph(session_t session)
+{
+    return session;
+}
+
+int DLLEXPORT release_exec_session(session_t session)
+{
+    postrun_graph(session);
+
+    return destroy_graph(session);
+}
+
+int DLLEXPORT get_graph_exec_status(graph_t graph)
+{
+    struct ir_graph* ir_graph = ( struct ir_graph* )graph;
+
+    return ir_graph->status;
+}
+
+int DLLEXPORT set_graph_event_hook(graph_t graph, int event, event_handler_t cb_func, void* cb_arg)
+{
+    struct ir_graph* ir_graph = ( struct ir_graph* )graph;
+    struct exec_attr* exec_attr = get_ir_graph_exec_attr(ir_graph);
+
+    if (event < GRAPH_EXEC_START || event > GRAPH_EXEC_DONE)
+    {
+        set_tengine_errno(EINVAL);
+        return -1;
+    }
+
+    exec_attr->event_hook[event] = cb_func;
+    exec_attr->event_arg[event] = cb_arg;
+
+    return 0;
+}
+
+int DLLEXPORT set_graph_node_observer(graph_t graph, node_observer_t observer, void* arg)
+{
+    struct ir_graph* ir_graph = ( struct ir_graph* )graph;
+    struct exec_attr* exec_attr = get_ir_graph_exec_attr(ir_graph);
+
+    exec_attr->node_observer = observer;
+    exec_attr->observer_arg = arg;
+
+    return 0;
 }
 
 int DLLEXPORT postrun_graph(graph_t graph)
@@ -1105,6 +1367,77 @@ int DLLEXPORT postrun_graph(graph_t graph)
     return 0;
 }
 
+int DLLEXPORT do_graph_perf_stat(graph_t graph, int action)
+{
+    struct ir_graph* ir_graph = ( struct ir_graph* )graph;
+    struct exec_attr* exec_attr = get_ir_graph_exec_attr(ir_graph);
+
+    switch (action)
+    {
+        case GRAPH_PERF_STAT_DISABLE:
+            exec_attr->perf_stat = GRAPH_PERF_STAT_DISABLE;
+            break;
+        case GRAPH_PERF_STAT_ENABLE:
+        case GRAPH_PERF_STAT_START:
+            exec_attr->perf_stat = GRAPH_PERF_STAT_START;
+            break;
+        case GRAPH_PERF_STAT_STOP:
+            if (exec_attr->perf_stat != GRAPH_PERF_STAT_DISABLE)
+                exec_attr->perf_stat = GRAPH_PERF_STAT_STOP;
+            break;
+        case GRAPH_PERF_STAT_RESET:
+            break;
+        default:
+            set_tengine_errno(EINVAL);
+            return -1;
+    }
+
+    int subgraph_num = get_vector_num(ir_graph->subgraph_list);
+
+    for (int i = 0; i < subgraph_num; i++)
+    {
+        struct subgraph* subgraph = get_ir_graph_subgraph(ir_graph, i);
+        struct nn_device* nn_dev = subgraph->nn_dev;
+
+        if (nn_dev->perf_stat && nn_dev->perf_stat(nn_dev, subgraph, action) < 0)
+            return -1;
+    }
+
+    return 0;
+}
+
+int DLLEXPORT get_graph_perf_stat(graph_t graph, struct perf_info** buf, int buf_size)
+{
+    struct ir_graph* ir_graph = ( struct ir_graph* )graph;
+
+    if (buf == NULL || buf_size <= 0)
+    {
+        set_tengine_errno(EINVAL);
+        return -1;
+    }
+
+    int subgraph_num = get_vector_num(ir_graph->subgraph_list);
+    int record_num = 0;
+
+    for (int i = 0; i < subgraph_num && record_num < buf_size; i++)
+    {
+        struct subgraph* subgraph = get_ir_graph_subgraph(ir_graph, i);
+        struct nn_device* nn_dev = subgraph->nn_dev;
+
+        if (nn_dev->get_perf_stat == NULL)
+            continue;
+
+        int ret = nn_dev->get_perf_stat(nn_dev, subgraph, buf + record_num, buf_size - record_num);
+
+        if (ret < 0)
+            return -1;
+
+        record_num += ret;
+    }
+
+    return record_num;
+}
+
 void DLLEXPORT dump_graph(graph_t graph)
 {
     dump_ir_graph(graph);
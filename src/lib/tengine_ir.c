@@ -88,18 +88,20 @@ void init_ir_graph(struct ir_graph* g, struct exec_context* context)
     g->serializer = NULL;
     g->status = GRAPH_STAT_CREATED;
 
+    g->origin = NULL;
+    g->ref_count = 1;
+
     init_exec_attr(g->exec_attr, context);
 }
 
-void destroy_ir_graph(struct ir_graph* g)
+/* the tensors and nodes stay until the last clone using the const tensors is gone */
+static void put_ir_graph(struct ir_graph* g)
 {
-    struct serializer* serializer = g->serializer;
-
-    /* subgraph is related with run */
-    int subgraph_num = get_vector_num(g->subgraph_list);
+    if (__atomic_sub_fetch(&g->ref_count, 1, __ATOMIC_ACQ_REL) > 0)
+        return;
 
-    for (int i = 0; i < subgraph_num; i++)
-        release_subgraph(g, *( struct subgraph** )get_vector_data(g->subgraph_list, i));
+    struct serializer* serializer = g->serializer;
+    struct ir_graph* origin = g->origin;
 
     release_vector(g->subgraph_list);
 
@@ -126,6 +128,192 @@ void destroy_ir_graph(struct ir_graph* g)
         destroy_exec_attr(g, g->exec_attr);
 
     sys_free(g);
+
+    if (origin)
+        put_ir_graph(origin);
+}
+
+void destroy_ir_graph(struct ir_graph* g)
+{
+    /* subgraph is related with run */
+    int subgraph_num = get_vector_num(g->subgraph_list);
+
+    for (int i = 0; i < subgraph_num; i++)
+        release_subgraph(g, *( struct subgraph** )get_vector_data(g->subgraph_list, i));
+
+    while (get_vector_num(g->subgraph_list) > 0)
+        remove_vector_by_idx(g->subgraph_list, 0);
+
+    put_ir_graph(g);
+}
+
+static int copy_ir_attr(struct ir_attr** dst_mem, uint8_t* dst_num, struct ir_attr* src_mem, int src_num)
+{
+    struct ir_attr* attr = src_mem;
+
+    for (int i = 0; i < src_num; i++)
+    {
+        struct ir_attr* new_mem = add_new_attr(*dst_mem, *dst_num, attr->attr_name, attr->type_name, attr->data_size);
+
+        if (new_mem == NULL)
+            return -1;
+
+        *dst_mem = new_mem;
+        (*dst_num)++;
+
+        set_attr_val(*dst_mem, *dst_num, attr->attr_name, attr->type_name, attr + 1, attr->data_size);
+
+        attr = ( struct ir_attr* )(( char* )attr + attr->mem_size);
+    }
+
+    return 0;
+}
+
+static struct ir_tensor* clone_ir_tensor(struct ir_graph* ir_graph, struct ir_tensor* src)
+{
+    struct ir_tensor* tensor = create_ir_tensor(ir_graph, src->name, src->data_type);
+
+    if (tensor == NULL)
+        return NULL;
+
+    tensor->producer = src->producer;
+    tensor->consumer_num = src->consumer_num;
+    memcpy(tensor->consumer, src->consumer, sizeof(src->consumer));
+
+    tensor->tensor_type = src->tensor_type;
+    tensor->elem_size = src->elem_size;
+    tensor->layout = src->layout;
+    tensor->dim_num = src->dim_num;
+    tensor->elem_num = src->elem_num;
+    memcpy(tensor->dims, src->dims, sizeof(src->dims));
+
+    /* the const data is used in place, the origin frees it */
+    if (src->tensor_type == TENSOR_TYPE_CONST)
+        tensor->data = src->data;
+
+    if (src->quant_param_num > 1)
+    {
+        float* scale = ( float* )sys_malloc(sizeof(float) * src->quant_param_num);
+        int* zero_point = ( int* )sys_malloc(sizeof(int) * src->quant_param_num);
+
+        if (scale == NULL || zero_point == NULL)
+        {
+            sys_free(scale);
+            sys_free(zero_point);
+            set_tengine_errno(ENOMEM);
+            return NULL;
+        }
+
+        memcpy(scale, src->scale_list, sizeof(float) * src->quant_param_num);
+        memcpy(zero_point, src->zp_list, sizeof(int) * src->quant_param_num);
+
+        tensor->scale_list = scale;
+        tensor->zp_list = zero_point;
+    }
+    else
+    {
+        tensor->scale = src->scale;
+        tensor->zero_point = src->zero_point;
+    }
+
+    tensor->quant_param_num = src->quant_param_num;
+
+    return tensor;
+}
+
+static struct ir_node* clone_ir_node(struct ir_graph* ir_graph, struct ir_node* src)
+{
+    struct ir_node* node = create_ir_node(ir_graph, src->name, src->op.op_type, src->op.op_version);
+
+    if (node == NULL)
+        return NULL;
+
+    node->dynamic_shape = src->dynamic_shape;
+    node->node_type = src->node_type;
+    node->op.same_shape = src->op.same_shape;
+    node->op.infer_shape = src->op.infer_shape;
+
+    /* the arrays the param may point to are shared with the origin, only the origin releases them */
+    if (src->op.param_size > 0)
+    {
+        if (node->op.param_mem == NULL || node->op.param_size != src->op.param_size)
+        {
+            TLOG_ERR("clone node %d: op param of %s does not match\n", src->idx, get_op_name(src->op.op_type));
+            set_tengine_errno(EINVAL);
+            return NULL;
+        }
+
+        memcpy(node->op.param_mem, src->op.param_mem, src->op.param_size);
+    }
+
+    if (src->input_num > 0)
+    {
+        node->input_tensors = ( int16_t* )sys_malloc(sizeof(int16_t) * src->input_num);
+
+        if (node->input_tensors == NULL)
+            return NULL;
+
+        memcpy(node->input_tensors, src->input_tensors, sizeof(int16_t) * src->input_num);
+        node->input_num = src->input_num;
+    }
+
+    if (src->output_num > 0)
+    {
+        node->output_tensors = ( int16_t* )sys_malloc(sizeof(int16_t) * src->output_num);
+
+        if (node->output_tensors == NULL)
+            return NULL;
+
+        memcpy(node->output_tensors, src->output_tensors, sizeof(int16_t) * src->output_num);
+        node->output_num = src->output_num;
+    }
+
+    if (copy_ir_attr(&node->attr_mem, &node->attr_num, src->attr_mem, src->attr_num) < 0)
+        return NULL;
+
+    return node;
+}
+
+struct ir_graph* clone_ir_graph(struct ir_graph* origin, struct exec_context* context)
+{
+    /* a clone of a clone uses the same const tensors */
+    while (origin->origin)
+        origin = origin->origin;
+
+    struct ir_graph* g = create_ir_graph(context);
+
+    if (g == NULL)
+        return NULL;
+
+    __atomic_add_fetch(&origin->ref_count, 1, __ATOMIC_ACQ_REL);
+    g->origin = origin;
+
+    g->graph_layout = origin->graph_layout;
+    g->model_layout = origin->model_layout;
+    g->model_format = origin->model_format;
+
+    for (int i = 0; i < origin->tensor_num; i++)
+    {
+        if (clone_ir_tensor(g, get_ir_graph_tensor(origin, i)) == NULL)
+            goto error;
+    }
+
+    for (int i = 0; i < origin->node_num; i++)
+    {
+        if (clone_ir_node(g, get_ir_graph_node(origin, i)) == NULL)
+            goto error;
+    }
+
+    if (set_ir_graph_input_node(g, origin->input_nodes, origin->input_num) < 0 ||
+        set_ir_graph_output_node(g, origin->output_nodes, origin->output_num) < 0 ||
+        copy_ir_attr(&g->attr_mem, &g->attr_num, origin->attr_mem, origin->attr_num) < 0)
+        goto error;
+
+    return g;
+
+error:
+    destroy_ir_graph(g);
+    return NULL;
 }
 
 int set_ir_graph_input_node(struct ir_graph* ir_graph, int16_t input_nodes[], int input_number)
@@ -196,8 +384,14 @@ int infer_shape_graph(struct ir_graph* ir_graph)
         struct ir_node* node = get_ir_graph_node(ir_graph, i);
         struct ir_op* op = &node->op;
 
+        /* the shapes set on the graph inputs are taken by now */
         if (node->input_num == 0)
+        {
+            for (int j = 0; j < node->output_num; j++)
+                get_ir_graph_tensor(ir_graph, node->output_tensors[j])->reshaped = 0;
+
             continue;
+        }
 
         if (node->dynamic_shape)
         {
@@ -241,7 +435,7 @@ int infer_shape_graph(struct ir_graph* ir_graph)
 
         for (int j = 0; j < node->output_num; j++)
         {
-            struct ir_tensor* tensor = get_ir_graph_tensor(ir_graph, j);
+            struct ir_tensor* tensor = get_ir_graph_tensor(ir_graph, node->output_tensors[j]);
 
             tensor->reshaped = 0;
         }
@@ -302,6 +496,7 @@ void init_subgraph(struct ir_graph* ir_graph, struct subgraph* subgraph, int sub
     subgraph->graph = ir_graph;
     subgraph->nn_dev = NULL;
     subgraph->exec_graph = NULL;
+    subgraph->cpu_mask = 0;
     subgraph->status = GRAPH_STAT_CREATED;
 }
 
@@ -404,7 +599,10 @@ void destroy_ir_node(struct ir_graph* ir_graph, struct ir_node* node)
 
     struct op_method* m = find_op_method(node->op.op_type, node->op.op_version);
 
-    if (m && m->release_op)
+    /* a clone only owns the param block, not what it points to */
+    if (ir_graph->origin)
+        sys_free(node->op.param_mem);
+    else if (m && m->release_op)
         m->release_op(&node->op);
 
     sys_free(node);
@@ -665,11 +863,14 @@ int set_ir_tensor_shape(struct ir_tensor* ir_tensor, const int dims[], int dim_n
         return -1;
     }
 
-    int old_num = ir_tensor->elem_num;
+    int changed = dim_number != ir_tensor->dim_num;
     int new_num = 1;
 
     for (int i = 0; i < dim_number; i++)
     {
+        if (ir_tensor->dims[i] != dims[i])
+            changed = 1;
+
         ir_tensor->dims[i] = dims[i];
         new_num *= dims[i];
     }
@@ -677,7 +878,8 @@ int set_ir_tensor_shape(struct ir_tensor* ir_tensor, const int dims[], int dim_n
     ir_tensor->dim_num = dim_number;
     ir_tensor->elem_num = new_num;
 
-    if (new_num != old_num)
+    /* the consumers reshape, even for the same element number in other dims */
+    if (changed)
         ir_tensor->reshaped = ir_tensor->consumer_num;
 
     return 0;
@@ -717,8 +919,15 @@ int get_tensor_idx_from_name(struct ir_graph* ir_graph, const char* tensor_name)
 
 int set_ir_tensor_quant_param(struct ir_tensor* ir_tensor, const float* scale, const int* zero_point, int number)
 {
+    /* scale and scale_list share the memory, the lists are only owned with more than one param */
     if (number == 1)
     {
+        if (ir_tensor->quant_param_num > 1)
+        {
+            sys_free(ir_tensor->scale_list);
+            sys_free(ir_tensor->zp_list);
+        }
+
         ir_tensor->scale = scale[0];
         ir_tensor->zero_point = zero_point[0];
         ir_tensor->quant_param_num = 1;
@@ -740,8 +949,11 @@ int set_ir_tensor_quant_param(struct ir_tensor* ir_tensor, const float* scale, c
     memcpy(t_scale, scale, sizeof(float) * number);
     memcpy(t_zero, zero_point, sizeof(int) * number);
 
-    sys_free(ir_tensor->scale_list);
-    sys_free(ir_tensor->zp_list);
+    if (ir_tensor->quant_param_num > 1)
+    {
+        sys_free(ir_tensor->scale_list);
+        sys_free(ir_tensor->zp_list);
+    }
 
     ir_tensor->scale_list = t_scale;
     ir_tensor->zp_list = t_zero;
@@ -814,6 +1026,20 @@ static inline struct ir_attr* get_next_attr(struct ir_attr* p_attr)
     return ( struct ir_attr* )(( char* )p_attr + p_attr->mem_size);
 }
 
+/* the names are stored after the values, point them into the memory the attrs were moved to */
+static void relocate_attr_name(struct ir_attr* p_attr, int attr_num)
+{
+    for (int i = 0; i < attr_num; i++)
+    {
+        p_attr->attr_name = ( char* )(p_attr + 1) + p_attr->data_size;
+
+        if (p_attr->type_name)
+            p_attr->type_name = p_attr->attr_name + strlen(p_attr->attr_name) + 1;
+
+        p_attr = get_next_attr(p_attr);
+    }
+}
+
 struct ir_attr* add_new_attr(struct ir_attr* attr_mem, int attr_num, const char* attr_name, const char* type_name,
                              int val_size)
 {
@@ -839,6 +1065,14 @@ struct ir_attr* add_new_attr(struct ir_attr* attr_mem, int attr_num, const char*
 
     struct ir_attr* new_attr = sys_realloc(attr_mem, mem_size + new_attr_size);
 
+    if (new_attr == NULL)
+    {
+        set_tengine_errno(ENOMEM);
+        return NULL;
+    }
+
+    relocate_attr_name(new_attr, attr_num);
+
     p_attr = ( struct ir_attr* )(( char* )new_attr + mem_size);
 
     char* mem_block = ( char* )(p_attr + 1);
@@ -919,6 +1153,27 @@ int get_attr_val(struct ir_attr* attr_mem, int attr_num, const char* attr_name,
     return access_attr_val(attr_mem, attr_num, attr_name, type_name, ( void* )buf, size, 0);
 }
 
+void* get_attr_val_ptr(struct ir_attr* attr_mem, int attr_num, const char* attr_name, int* size)
+{
+    struct ir_attr* p_attr = attr_mem;
+
+    for (int i = 0; i < attr_num; i++)
+    {
+        if (!strcmp(attr_name, p_attr->attr_name))
+        {
+            if (size)
+                *size = p_attr->data_size;
+
+            return p_attr + 1;
+        }
+
+        p_attr = get_next_attr(p_attr);
+    }
+
+    set_tengine_errno(ENOENT);
+    return NULL;
+}
+
 struct ir_attr* remove_single_attr(struct ir_attr* attr_mem, int attr_num, const char* attr_name)
 {
     struct ir_attr* p_attr = attr_mem;
@@ -943,6 +1198,7 @@ struct ir_attr* remove_single_attr(struct ir_attr* attr_mem, int attr_num, const
 
     struct ir_attr* p_next_attr = get_next_attr(p_attr);
 
+    int left_num = attr_num - i - 1;
     int left_mem_size = 0;
 
     for (i++; i < attr_num; i++)
@@ -953,7 +1209,8 @@ struct ir_attr* remove_single_attr(struct ir_attr* attr_mem, int attr_num, const
 
     if (left_mem_size > 0)
     {
-        memcpy(p_attr, get_next_attr(p_attr), left_mem_size);
+        memmove(p_attr, get_next_attr(p_attr), left_mem_size);
+        relocate_attr_name(p_attr, left_num);
     }
 
     return attr_mem;
@@ -0,0 +1,650 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * License); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * AS IS BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*
+ * Copyright (c) 2020, OPEN AI LAB
+ * Author: haoluo@openailab.com
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "sys_port.h"
+#include "tengine_c_api.h"
+#include "tengine_errno.h"
+#include "tengine_ir.h"
+#include "tengine_op.h"
+#include "tengine_log.h"
+#include "vector.h"
+#include "convolution_param.h"
+#include "deconv_param.h"
+#include "fc_param.h"
+#include "batchnorm_param.h"
+#include "scale_param.h"
+#include "relu_param.h"
+#include "clip_param.h"
+
+/*
+ * graph level fusion, runs between infer_shape_graph() and the allocator:
+ *   conv/fc/deconv + batchnorm/scale  -> constants folded into weight and bias
+ *   conv/fc + relu/relu6/clip(0,6)    -> absorbed into param->activation
+ * the fused nodes, their private constants and the intermediate tensors are
+ * then removed and the node/tensor lists are compacted.
+ */
+
+static int is_graph_output_node(struct ir_graph* ir_graph, int node_idx)
+{
+    for (int i = 0; i < ir_graph->output_num; i++)
+    {
+        if (ir_graph->output_nodes[i] == node_idx)
+            return 1;
+    }
+
+    return 0;
+}
+
+static int is_fp32_const(struct ir_tensor* tensor)
+{
+    return tensor->tensor_type == TENSOR_TYPE_CONST && tensor->data_type == TENGINE_DT_FP32 && tensor->data != NULL;
+}
+
+/* the node whose output can be merged into, NULL if the output is visible to others */
+static struct ir_node* get_single_child(struct ir_graph* ir_graph, struct ir_node* ir_node)
+{
+    if (ir_node->output_num != 1 || is_graph_output_node(ir_graph, ir_node->idx))
+        return NULL;
+
+    struct ir_tensor* tensor = get_ir_graph_tensor(ir_graph, ir_node->output_tensors[0]);
+
+    if (tensor->consumer_num != 1 || tensor->data_type != TENGINE_DT_FP32)
+        return NULL;
+
+    struct ir_node* child = get_ir_graph_node(ir_graph, tensor->consumer[0]);
+
+    if (child->input_num < 1 || child->output_num != 1 || child->input_tensors[0] != tensor->idx)
+        return NULL;
+
+    return child;
+}
+
+static int get_out_channel(struct ir_node* ir_node)
+{
+    if (ir_node->op.op_type == OP_CONV)
+        return (( struct conv_param* )ir_node->op.param_mem)->output_channel;
+
+    if (ir_node->op.op_type == OP_FC)
+        return (( struct fc_param* )ir_node->op.param_mem)->num_output;
+
+    return (( struct deconv_param* )ir_node->op.param_mem)->num_output;
+}
+
+static int get_activation(struct ir_node* ir_node)
+{
+    if (ir_node->op.op_type == OP_CONV)
+        return (( struct conv_param* )ir_node->op.param_mem)->activation;
+
+    if (ir_node->op.op_type == OP_FC)
+        return (( struct fc_param* )ir_node->op.param_mem)->activation;
+
+    return (( struct deconv_param* )ir_node->op.param_mem)->activation;
+}
+
+/* make the const data writable without touching the model memory */
+static float* get_owned_data(struct ir_tensor* tensor)
+{
+    if (tensor->free_host_mem)
+        return tensor->data;
+
+    int size = tensor->elem_num * tensor->elem_size;
+    void* mem = sys_malloc(size);
+
+    if (mem == NULL)
+        return NULL;
+
+    memcpy(mem, tensor->data, size);
+
+    tensor->data = mem;
+    tensor->free_host_mem = 1;
+
+    return mem;
+}
+
+static int can_fold_const(struct ir_graph* ir_graph, struct ir_node* ir_node)
+{
+    int out_c = get_out_channel(ir_node);
+    struct ir_tensor* weight = get_ir_graph_tensor(ir_graph, ir_node->input_tensors[1]);
+
+    if (ir_graph->graph_layout != TENGINE_LAYOUT_NCHW || get_activation(ir_node) >= 0)
+        return 0;
+
+    if (out_c <= 0 || !is_fp32_const(weight) || weight->consumer_num != 1 || weight->elem_num % out_c)
+        return 0;
+
+    if (ir_node->op.op_type == OP_DECONV)
+    {
+        struct deconv_param* param = ( struct deconv_param* )ir_node->op.param_mem;
+
+        if (param->group <= 0 || out_c % param->group ||
+            weight->elem_num % (out_c * param->kernel_h * param->kernel_w))
+            return 0;
+    }
+
+    if (ir_node->input_num > 2)
+    {
+        struct ir_tensor* bias = get_ir_graph_tensor(ir_graph, ir_node->input_tensors[2]);
+
+        if (!is_fp32_const(bias) || bias->consumer_num != 1 || bias->elem_num != out_c)
+            return 0;
+    }
+
+    return 1;
+}
+
+/* weight[oc] = alpha[oc] * weight[oc], bias[oc] = alpha[oc] * bias[oc] + beta[oc] */
+static int fold_const(struct ir_graph* ir_graph, struct ir_node* ir_node, const float* alpha, const float* beta)
+{
+    int out_c = get_out_channel(ir_node);
+    struct ir_tensor* weight_tensor = get_ir_graph_tensor(ir_graph, ir_node->input_tensors[1]);
+    struct ir_tensor* bias_tensor = NULL;
+
+    float* weight = get_owned_data(weight_tensor);
+
+    if (weight == NULL)
+        return -1;
+
+    if (ir_node->input_num > 2)
+    {
+        bias_tensor = get_ir_graph_tensor(ir_graph, ir_node->input_tensors[2]);
+    }
+    else
+    {
+        char* name = ( char* )sys_malloc(strlen(ir_node->name ? ir_node->name : "node") + 16);
+
+        if (name == NULL)
+            return -1;
+
+        sprintf(name, "%s_fused_bias", ir_node->name ? ir_node->name : "node");
+        bias_tensor = create_ir_tensor(ir_graph, name, TENGINE_DT_FP32);
+        sys_free(name);
+
+        if (bias_tensor == NULL)
+            return -1;
+
+        int dims[1] = {out_c};
+
+        set_ir_tensor_shape(bias_tensor, dims, 1);
+        bias_tensor->tensor_type = TENSOR_TYPE_CONST;
+        bias_tensor->data = sys_malloc(out_c * sizeof(float));
+
+        if (bias_tensor->data == NULL)
+            return -1;
+
+        bias_tensor->free_host_mem = 1;
+        memset(bias_tensor->data, 0, out_c * sizeof(float));
+
+        if (set_ir_node_input_tensor(ir_node, 2, bias_tensor) < 0)
+            return -1;
+    }
+
+    float* bias = get_owned_data(bias_tensor);
+
+    if (bias == NULL)
+        return -1;
+
+    if (ir_node->op.op_type == OP_CONV)
+    {
+        int size = weight_tensor->elem_num / out_c;
+
+        for (int oc = 0; oc < out_c; oc++)
+        {
+            float* w = weight + oc * size;
+
+            for (int i = 0; i < size; i++)
+                w[i] *= alpha[oc];
+        }
+    }
+    else if (ir_node->op.op_type == OP_FC)
+    {
+        int hidden = weight_tensor->elem_num / out_c;
+
+        /* the same rule as the fc kernels use to detect a transposed weight */
+        if (weight_tensor->dims[0] == out_c)
+        {
+            for (int oc = 0; oc < out_c; oc++)
+                for (int i = 0; i < hidden; i++)
+                    weight[oc * hidden + i] *= alpha[oc];
+        }
+        else
+        {
+            for (int i = 0; i < hidden; i++)
+                for (int oc = 0; oc < out_c; oc++)
+                    weight[i * out_c + oc] *= alpha[oc];
+        }
+    }
+    else
+    {
+        /* deconv weight: [group][in_c / group][out_c / group][kernel_h][kernel_w] */
+        struct deconv_param* param = ( struct deconv_param* )ir_node->op.param_mem;
+        int kernel_size = param->kernel_h * param->kernel_w;
+        int out_c_g = out_c / param->group;
+        int in_c_g = weight_tensor->elem_num / (out_c * kernel_size);
+
+        for (int g = 0; g < param->group; g++)
+        {
+            for (int ic = 0; ic < in_c_g; ic++)
+            {
+                float* w = weight + (g * in_c_g + ic) * out_c_g * kernel_size;
+
+                for (int oc = 0; oc < out_c_g; oc++)
+                    for (int k = 0; k < kernel_size; k++)
+                        w[oc * kernel_size + k] *= alpha[g * out_c_g + oc];
+            }
+        }
+    }
+
+    for (int oc = 0; oc < out_c; oc++)
+        bias[oc] = bias[oc] * alpha[oc] + beta[oc];
+
+    return 0;
+}
+
+static int fold_batchnorm(struct ir_graph* ir_graph, struct ir_node* ir_node, struct ir_node* bn_node)
+{
+    int out_c = get_out_channel(ir_node);
+    struct batchnorm_param* param = ( struct batchnorm_param* )bn_node->op.param_mem;
+
+    if (bn_node->input_num != 5 || !can_fold_const(ir_graph, ir_node))
+        return 0;
+
+    for (int i = 1; i < 5; i++)
+    {
+        struct ir_tensor* tensor = get_ir_graph_tensor(ir_graph, bn_node->input_tensors[i]);
+
+        /* caffe flavor batchnorm has no gamma and beta */
+        if (param->caffe_flavor && i < 3)
+            continue;
+
+        if (!is_fp32_const(tensor) || tensor->elem_num != out_c)
+            return 0;
+    }
+
+    float* alpha = ( float* )sys_malloc(out_c * sizeof(float) * 2);
+
+    if (alpha == NULL)
+        return -1;
+
+    float* beta = alpha + out_c;
+
+    const float* mean = get_ir_graph_tensor(ir_graph, bn_node->input_tensors[3])->data;
+    const float* var = get_ir_graph_tensor(ir_graph, bn_node->input_tensors[4])->data;
+    float rescale_factor = param->rescale_factor ? 1 / param->rescale_factor : 0;
+
+    /* the same math as batchnorm_ref */
+    for (int c = 0; c < out_c; c++)
+    {
+        float var_inv = 1.f / sqrtf(var[c] * rescale_factor + param->eps);
+        float scale_mean = -mean[c] * rescale_factor * var_inv;
+
+        alpha[c] = var_inv;
+        beta[c] = scale_mean;
+    }
+
+    if (!param->caffe_flavor)
+    {
+        const float* gamma = get_ir_graph_tensor(ir_graph, bn_node->input_tensors[1])->data;
+        const float* bn_beta = get_ir_graph_tensor(ir_graph, bn_node->input_tensors[2])->data;
+
+        for (int c = 0; c < out_c; c++)
+        {
+            beta[c] = bn_beta[c] + gamma[c] * beta[c];
+            alpha[c] = gamma[c] * alpha[c];
+        }
+    }
+
+    int ret = fold_const(ir_graph, ir_node, alpha, beta);
+
+    sys_free(alpha);
+
+    return ret < 0 ? -1 : 1;
+}
+
+static int fold_scale(struct ir_graph* ir_graph, struct ir_node* ir_node, struct ir_node* scale_node)
+{
+    int out_c = get_out_channel(ir_node);
+
+    if (scale_node->input_num < 2 || scale_node->input_num > 3 || !can_fold_const(ir_graph, ir_node))
+        return 0;
+
+    for (int i = 1; i < scale_node->input_num; i++)
+    {
+        struct ir_tensor* tensor = get_ir_graph_tensor(ir_graph, scale_node->input_tensors[i]);
+
+        if (!is_fp32_const(tensor) || tensor->elem_num != out_c)
+            return 0;
+    }
+
+    float* beta = ( float* )sys_malloc(out_c * sizeof(float));
+
+    if (beta == NULL)
+        return -1;
+
+    const float* gamma = get_ir_graph_tensor(ir_graph, scale_node->input_tensors[1])->data;
+
+    if (scale_node->input_num > 2)
+        memcpy(beta, get_ir_graph_tensor(ir_graph, scale_node->input_tensors[2])->data, out_c * sizeof(float));
+    else
+        memset(beta, 0, out_c * sizeof(float));
+
+    int ret = fold_const(ir_graph, ir_node, gamma, beta);
+
+    sys_free(beta);
+
+    return ret < 0 ? -1 : 1;
+}
+
+static int absorb_activation(struct ir_graph* ir_graph, struct ir_node* ir_node, struct ir_node* act_node)
+{
+    int activation = -1;
+
+    /* deconv kernels use a different activation encoding, leave them alone */
+    if (ir_node->op.op_type == OP_DECONV || get_activation(ir_node) >= 0 || act_node->input_num != 1)
+        return 0;
+
+    if (act_node->op.op_type == OP_RELU)
+    {
+        struct relu_param* param = ( struct relu_param* )act_node->op.param_mem;
+
+        if (param->negative_slope == 0.f)
+            activation = 0;
+    }
+    else if (act_node->op.op_type == OP_RELU6)
+    {
+        activation = 6;
+    }
+    else
+    {
+        struct clip_param* param = ( struct clip_param* )act_node->op.param_mem;
+
+        if (param->min == 0.f && param->max == 6.f)
+            activation = 6;
+    }
+
+    if (activation < 0)
+        return 0;
+
+    if (ir_node->op.op_type == OP_CONV)
+        (( struct conv_param* )ir_node->op.param_mem)->activation = activation;
+    else
+        (( struct fc_param* )ir_node->op.param_mem)->activation = activation;
+
+    return 1;
+}
+
+/* let ir_node produce the output of child, the old output tensor becomes dead */
+static void merge_child(struct ir_graph* ir_graph, struct ir_node* ir_node, struct ir_node* child, uint8_t* node_dead)
+{
+    struct ir_tensor* mid_tensor = get_ir_graph_tensor(ir_graph, ir_node->output_tensors[0]);
+    struct ir_tensor* out_tensor = get_ir_graph_tensor(ir_graph, child->output_tensors[0]);
+
+    ir_node->output_tensors[0] = out_tensor->idx;
+    out_tensor->producer = ir_node->idx;
+
+    mid_tensor->producer = -1;
+    mid_tensor->consumer_num = 0;
+
+    for (int i = 0; i < ir_graph->output_num; i++)
+    {
+        if (ir_graph->output_nodes[i] == child->idx)
+            ir_graph->output_nodes[i] = ir_node->idx;
+    }
+
+    if (child->node_type == TENGINE_NODE_TYPE_OUTPUT)
+        ir_node->node_type = TENGINE_NODE_TYPE_OUTPUT;
+
+    node_dead[child->idx] = 1;
+}
+
+static int fuse_node(struct ir_graph* ir_graph, struct ir_node* ir_node, uint8_t* node_dead)
+{
+    int fused = 0;
+    struct ir_node* child;
+
+    while ((child = get_single_child(ir_graph, ir_node)) != NULL)
+    {
+        int ret = 0;
+
+        switch (child->op.op_type)
+        {
+            case OP_BATCHNORM:
+                ret = fold_batchnorm(ir_graph, ir_node, child);
+                break;
+            case OP_SCALE:
+                ret = fold_scale(ir_graph, ir_node, child);
+                break;
+            case OP_RELU:
+            case OP_RELU6:
+            case OP_CLIP:
+                ret = absorb_activation(ir_graph, ir_node, child);
+                break;
+            default:
+                break;
+        }
+
+        if (ret < 0)
+            return -1;
+
+        if (ret == 0)
+            break;
+
+        merge_child(ir_graph, ir_node, child, node_dead);
+        fused++;
+    }
+
+    return fused;
+}
+
+/* drop the dead nodes and tensors, then renumber what is left */
+static int compact_ir_graph(struct ir_graph* ir_graph, uint8_t* node_dead)
+{
+    int node_num = ir_graph->node_num;
+    int tensor_num = ir_graph->tensor_num;
+
+    int16_t* node_map = ( int16_t* )sys_malloc(sizeof(int16_t) * (node_num + tensor_num));
+    uint8_t* tensor_dead = ( uint8_t* )sys_malloc(tensor_num);
+
+    if (node_map == NULL || tensor_dead == NULL)
+    {
+        sys_free(node_map);
+        sys_free(tensor_dead);
+        set_tengine_errno(ENOMEM);
+        return -1;
+    }
+
+    int16_t* tensor_map = node_map + node_num;
+
+    /* the const nodes only feeding the fused nodes are dead too */
+    for (int i = 0; i < tensor_num; i++)
+    {
+        struct ir_tensor* tensor = get_ir_graph_tensor(ir_graph, i);
+        int n = 0;
+
+        for (int j = 0; j < tensor->consumer_num; j++)
+        {
+            if (!node_dead[tensor->consumer[j]])
+                tensor->consumer[n++] = tensor->consumer[j];
+        }
+
+        tensor->consumer_num = n;
+    }
+
+    for (int i = 0; i < node_num; i++)
+    {
+        struct ir_node* ir_node = get_ir_graph_node(ir_graph, i);
+
+        if (node_dead[i] || ir_node->op.op_type != OP_CONST || is_graph_output_node(ir_graph, i))
+            continue;
+
+        int used = 0;
+
+        for (int j = 0; j < ir_node->output_num; j++)
+            used += get_ir_graph_tensor(ir_graph, ir_node->output_tensors[j])->consumer_num;
+
+        if (used == 0)
+            node_dead[i] = 1;
+    }
+
+    for (int i = 0; i < tensor_num; i++)
+    {
+        struct ir_tensor* tensor = get_ir_graph_tensor(ir_graph, i);
+
+        if (tensor->producer >= 0)
+            tensor_dead[i] = node_dead[tensor->producer];
+        else
+            tensor_dead[i] = tensor->consumer_num == 0;
+    }
+
+    int n = 0;
+
+    for (int i = 0; i < node_num; i++)
+        node_map[i] = node_dead[i] ? -1 : n++;
+
+    n = 0;
+
+    for (int i = 0; i < tensor_num; i++)
+        tensor_map[i] = tensor_dead[i] ? -1 : n++;
+
+    /* note: must destroy tensor first, then node */
+    n = 0;
+
+    for (int i = 0; i < tensor_num; i++)
+    {
+        struct ir_tensor* tensor = get_ir_graph_tensor(ir_graph, i);
+
+        if (tensor_dead[i])
+        {
+            destroy_ir_tensor(ir_graph, tensor);
+            continue;
+        }
+
+        tensor->idx = tensor_map[i];
+
+        if (tensor->producer >= 0)
+            tensor->producer = node_map[tensor->producer];
+
+        for (int j = 0; j < tensor->consumer_num; j++)
+            tensor->consumer[j] = node_map[tensor->consumer[j]];
+
+        ir_graph->tensor_list[n++] = tensor;
+    }
+
+    ir_graph->tensor_num = n;
+    n = 0;
+
+    for (int i = 0; i < node_num; i++)
+    {
+        struct ir_node* ir_node = get_ir_graph_node(ir_graph, i);
+
+        if (node_dead[i])
+        {
+            destroy_ir_node(ir_graph, ir_node);
+            continue;
+        }
+
+        ir_node->idx = node_map[i];
+
+        for (int j = 0; j < ir_node->input_num; j++)
+        {
+            if (ir_node->input_tensors[j] >= 0)
+                ir_node->input_tensors[j] = tensor_map[ir_node->input_tensors[j]];
+        }
+
+        for (int j = 0; j < ir_node->output_num; j++)
+            ir_node->output_tensors[j] = tensor_map[ir_node->output_tensors[j]];
+
+        ir_graph->node_list[n++] = ir_node;
+    }
+
+    ir_graph->node_num = n;
+
+    for (int i = 0; i < ir_graph->input_num; i++)
+        ir_graph->input_nodes[i] = node_map[ir_graph->input_nodes[i]];
+
+    for (int i = 0; i < ir_graph->output_num; i++)
+        ir_graph->output_nodes[i] = node_map[ir_graph->output_nodes[i]];
+
+    sys_free(node_map);
+    sys_free(tensor_dead);
+
+    return 0;
+}
+
+int fuse_ir_graph(struct ir_graph* ir_graph)
+{
+    /* the graph has been scheduled already, node idx is in use */
+    if (get_vector_num(ir_graph->subgraph_list) > 0)
+        return 0;
+
+    int node_num = ir_graph->node_num;
+    uint8_t* node_dead = ( uint8_t* )sys_malloc(node_num);
+
+    if (node_dead == NULL)
+    {
+        set_tengine_errno(ENOMEM);
+        return -1;
+    }
+
+    memset(node_dead, 0, node_num);
+
+    int fused = 0;
+
+    for (int i = 0; i < node_num; i++)
+    {
+        struct ir_node* ir_node = get_ir_graph_node(ir_graph, i);
+        int op_type = ir_node->op.op_type;
+
+        if (node_dead[i] || (op_type != OP_CONV && op_type != OP_FC && op_type != OP_DECONV))
+            continue;
+
+        struct ir_tensor* input_tensor = get_ir_graph_tensor(ir_graph, ir_node->input_tensors[0]);
+
+        if (ir_node->input_num < 2 || input_tensor->data_type != TENGINE_DT_FP32)
+            continue;
+
+        int ret = fuse_node(ir_graph, ir_node, node_dead);
+
+        if (ret < 0)
+        {
+            TLOG_ERR("fuse node %d failed\n", i);
+            sys_free(node_dead);
+            return -1;
+        }
+
+        fused += ret;
+    }
+
+    int ret = 0;
+
+    if (fused > 0)
+        ret = compact_ir_graph(ir_graph, node_dead);
+
+    sys_free(node_dead);
+
+    return ret;
+}
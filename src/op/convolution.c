@@ -34,7 +34,7 @@
 #include "convolution_param.h"
 
 DEFINE_PARM_PARSE_ENTRY(conv_param, kernel_h, kernel_w, stride_h, stride_w, pad_h0, pad_h1, pad_w0, pad_w1, dilation_h,
-                        dilation_w, input_channel, output_channel, group);
+                        dilation_w, input_channel, output_channel, group, activation);
 
 static int infer_shape(struct ir_node* node)
 {
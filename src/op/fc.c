@@ -32,7 +32,7 @@
 #include "parameter.h"
 #include "fc_param.h"
 
-DEFINE_PARM_PARSE_ENTRY(fc_param, num_output);
+DEFINE_PARM_PARSE_ENTRY(fc_param, num_output, activation);
 
 static int infer_shape(struct ir_node* node)
 {
@@ -115,6 +115,7 @@ static int init_op(struct ir_op* op)
 
     /*set the param default value */
     fc_param->num_output = 1;
+    fc_param->activation = -1;
 
     op->param_mem = fc_param;
     op->param_size = sizeof(struct fc_param);
@@ -429,8 +429,11 @@ static struct serializer tiny_serializer = {
     .load_model = load_model,
     .load_mem = NULL,
     .unload_graph = NULL,
+    .save_model = NULL,
     .register_op_loader = NULL, /* do not export dynamic op extension */
     .unregister_op_loader = NULL,
+    .register_op_saver = NULL,
+    .unregister_op_saver = NULL,
     .init = init_tiny_serializer,
     .release = release_tiny_serializer,
 };
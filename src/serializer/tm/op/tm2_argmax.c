@@ -24,6 +24,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "sys_port.h"
 #include "module.h"
@@ -54,6 +55,23 @@ static int tm2_load_argmax(struct ir_graph* ir_graph, struct ir_node* ir_node, c
     return 0;
 }
 
+static int tm2_save_argmax(struct tm2_writer* writer, struct ir_graph* ir_graph, struct ir_node* ir_node,
+                           TM2_Operator* tm_op)
+{
+    struct argmax_param* argmax_param = ( struct argmax_param* )ir_node->op.param_mem;
+    TM2_ArgMaxParam tm_param;
+
+    memset(&tm_param, 0, sizeof(TM2_ArgMaxParam));
+
+    tm_param.axis = argmax_param->axis;
+    tm_param.keepdims = argmax_param->keepdims;
+
+    tm_op->operator_type = TM2_OPTYPE_ARGMAX;
+    tm_op->offset_t_param = tm2_write_object(writer, &tm_param, sizeof(TM2_ArgMaxParam));
+
+    return 0;
+}
+
 /* the auto register functions */
 
 static int reg_tm2_ops(void* arg)
@@ -67,6 +85,7 @@ static int reg_tm2_ops(void* arg)
     }
 
     tm2_s->register_op_loader(tm2_s, TM2_OPTYPE_ARGMAX, 1, tm2_load_argmax, argmax_op_map, NULL);
+    tm2_s->register_op_saver(tm2_s, OP_ARGMAX, tm2_save_argmax);
 
     return 0;
 }
@@ -76,6 +95,7 @@ static int unreg_tm2_ops(void* arg)
     struct serializer* tm2_s = find_serializer("tengine");
 
     tm2_s->unregister_op_loader(tm2_s, TM2_OPTYPE_ARGMAX, 1, tm2_load_argmax);
+    tm2_s->unregister_op_saver(tm2_s, OP_ARGMAX, tm2_save_argmax);
 
     return 0;
 }
@@ -24,6 +24,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "sys_port.h"
 #include "module.h"
@@ -58,6 +59,27 @@ static int tm2_load_batchtospacend(struct ir_graph* ir_graph, struct ir_node* ir
     return 0;
 }
 
+static int tm2_save_batchtospacend(struct tm2_writer* writer, struct ir_graph* ir_graph, struct ir_node* ir_node,
+                                   TM2_Operator* tm_op)
+{
+    struct batchtospacend_param* batchtospacend_param = ( struct batchtospacend_param* )ir_node->op.param_mem;
+    TM2_BatchToSpaceNDParam tm_param;
+
+    memset(&tm_param, 0, sizeof(TM2_BatchToSpaceNDParam));
+
+    tm_param.dilation_x = batchtospacend_param->dilation_x;
+    tm_param.dilation_y = batchtospacend_param->dilation_y;
+    tm_param.crop_top = batchtospacend_param->crop_top;
+    tm_param.crop_bottom = batchtospacend_param->crop_bottom;
+    tm_param.crop_left = batchtospacend_param->crop_left;
+    tm_param.crop_right = batchtospacend_param->crop_right;
+
+    tm_op->operator_type = TM2_OPTYPE_BATCHTOSPACEND;
+    tm_op->offset_t_param = tm2_write_object(writer, &tm_param, sizeof(TM2_BatchToSpaceNDParam));
+
+    return 0;
+}
+
 static int reg_tm2_ops(void* arg)
 {
     struct serializer* tm2_s = find_serializer("tengine");
@@ -70,6 +92,7 @@ static int reg_tm2_ops(void* arg)
 
     tm2_s->register_op_loader(tm2_s, TM2_OPTYPE_BATCHTOSPACEND, 1, tm2_load_batchtospacend, batchtospacend_op_map,
                               NULL);
+    tm2_s->register_op_saver(tm2_s, OP_BATCHTOSPACEND, tm2_save_batchtospacend);
 
     return 0;
 }
@@ -79,6 +102,7 @@ static int unreg_tm2_ops(void* arg)
     struct serializer* tm2_s = find_serializer("tengine");
 
     tm2_s->unregister_op_loader(tm2_s, TM2_OPTYPE_BATCHTOSPACEND, 1, tm2_load_batchtospacend);
+    tm2_s->unregister_op_saver(tm2_s, OP_BATCHTOSPACEND, tm2_save_batchtospacend);
 
     return 0;
 }
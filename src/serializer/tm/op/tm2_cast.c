@@ -24,6 +24,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "sys_port.h"
 #include "module.h"
@@ -56,6 +57,23 @@ static int tm2_load_cast(struct ir_graph* ir_graph, struct ir_node* ir_node, con
     return 0;
 }
 
+static int tm2_save_cast(struct tm2_writer* writer, struct ir_graph* ir_graph, struct ir_node* ir_node,
+                         TM2_Operator* tm_op)
+{
+    struct cast_param* param = ( struct cast_param* )ir_node->op.param_mem;
+    TM2_CastParam tm_param;
+
+    memset(&tm_param, 0, sizeof(TM2_CastParam));
+
+    tm_param.type_from = param->type_from;
+    tm_param.type_to = param->type_to;
+
+    tm_op->operator_type = TM2_OPTYPE_CAST;
+    tm_op->offset_t_param = tm2_write_object(writer, &tm_param, sizeof(TM2_CastParam));
+
+    return 0;
+}
+
 static int reg_tm2_ops(void* arg)
 {
     struct serializer* tm2_s = find_serializer("tengine");
@@ -67,6 +85,7 @@ static int reg_tm2_ops(void* arg)
     }
 
     tm2_s->register_op_loader(tm2_s, TM2_OPTYPE_CAST, 1, tm2_load_cast, op_map, NULL);
+    tm2_s->register_op_saver(tm2_s, OP_CAST, tm2_save_cast);
 
     return 0;
 }
@@ -76,6 +95,7 @@ static int unreg_tm2_ops(void* arg)
     struct serializer* tm2_s = find_serializer("tengine");
 
     tm2_s->unregister_op_loader(tm2_s, TM2_OPTYPE_CAST, 1, tm2_load_cast);
+    tm2_s->unregister_op_saver(tm2_s, OP_CAST, tm2_save_cast);
 
     return 0;
 }
@@ -24,6 +24,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "sys_port.h"
 #include "module.h"
@@ -53,6 +54,22 @@ static int tm2_load_concat(struct ir_graph* ir_graph, struct ir_node* ir_node, c
     return 0;
 }
 
+static int tm2_save_concat(struct tm2_writer* writer, struct ir_graph* ir_graph, struct ir_node* ir_node,
+                           TM2_Operator* tm_op)
+{
+    struct concat_param* concat_param = ( struct concat_param* )ir_node->op.param_mem;
+    TM2_ConcatParam tm_param;
+
+    memset(&tm_param, 0, sizeof(TM2_ConcatParam));
+
+    tm_param.axis = concat_param->axis;
+
+    tm_op->operator_type = TM2_OPTYPE_CONCAT;
+    tm_op->offset_t_param = tm2_write_object(writer, &tm_param, sizeof(TM2_ConcatParam));
+
+    return 0;
+}
+
 /* the auto register functions */
 
 static int reg_tm2_ops(void* arg)
@@ -66,6 +83,7 @@ static int reg_tm2_ops(void* arg)
     }
 
     tm2_s->register_op_loader(tm2_s, TM2_OPTYPE_CONCAT, 1, tm2_load_concat, concat_op_map, NULL);
+    tm2_s->register_op_saver(tm2_s, OP_CONCAT, tm2_save_concat);
 
     return 0;
 }
@@ -75,6 +93,7 @@ static int unreg_tm2_ops(void* arg)
     struct serializer* tm2_s = find_serializer("tengine");
 
     tm2_s->unregister_op_loader(tm2_s, TM2_OPTYPE_CONCAT, 1, tm2_load_concat);
+    tm2_s->unregister_op_saver(tm2_s, OP_CONCAT, tm2_save_concat);
 
     return 0;
 }
@@ -24,6 +24,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "sys_port.h"
 #include "module.h"
@@ -84,6 +85,35 @@ static int tm2_load_conv(struct ir_graph* ir_graph, struct ir_node* ir_node, con
     return 0;
 }
 
+static int tm2_save_conv(struct tm2_writer* writer, struct ir_graph* ir_graph, struct ir_node* ir_node,
+                         TM2_Operator* tm_op)
+{
+    struct conv_param* conv_param = ( struct conv_param* )ir_node->op.param_mem;
+    TM2_ConvParam tm_param;
+
+    memset(&tm_param, 0, sizeof(TM2_ConvParam));
+
+    tm_param.kernel_h = conv_param->kernel_h;
+    tm_param.kernel_w = conv_param->kernel_w;
+    tm_param.stride_h = conv_param->stride_h;
+    tm_param.stride_w = conv_param->stride_w;
+    tm_param.dilation_h = conv_param->dilation_h;
+    tm_param.dilation_w = conv_param->dilation_w;
+    tm_param.input_channel = conv_param->input_channel;
+    tm_param.output_channel = conv_param->output_channel;
+    tm_param.group = conv_param->group;
+    tm_param.activation = conv_param->activation;
+    tm_param.pad_h0 = conv_param->pad_h0;
+    tm_param.pad_w0 = conv_param->pad_w0;
+    tm_param.pad_h1 = conv_param->pad_h1;
+    tm_param.pad_w1 = conv_param->pad_w1;
+
+    tm_op->operator_type = TM2_OPTYPE_CONVOLUTION;
+    tm_op->offset_t_param = tm2_write_object(writer, &tm_param, sizeof(TM2_ConvParam));
+
+    return 0;
+}
+
 /* the auto register functions */
 
 static int reg_tm2_ops(void* arg)
@@ -97,6 +127,7 @@ static int reg_tm2_ops(void* arg)
     }
 
     tm2_s->register_op_loader(tm2_s, TM2_OPTYPE_CONVOLUTION, 1, tm2_load_conv, conv_op_map, NULL);
+    tm2_s->register_op_saver(tm2_s, OP_CONV, tm2_save_conv);
 
     return 0;
 }
@@ -106,6 +137,7 @@ static int unreg_tm2_ops(void* arg)
     struct serializer* tm2_s = find_serializer("tengine");
 
     tm2_s->unregister_op_loader(tm2_s, TM2_OPTYPE_CONVOLUTION, 1, tm2_load_conv);
+    tm2_s->unregister_op_saver(tm2_s, OP_CONV, tm2_save_conv);
 
     return 0;
 }
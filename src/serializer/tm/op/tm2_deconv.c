@@ -24,6 +24,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "sys_port.h"
 #include "module.h"
@@ -48,6 +49,7 @@ static int tm2_load_deconv(struct ir_graph* ir_graph, struct ir_node* ir_node, c
     const char* mem_base = tm2_priv->base;
     const TM2_DeconvParam* tm_param = ( TM2_DeconvParam* )(mem_base + tm_op->offset_t_param);
 
+    deconv_param->num_output = tm_param->num_output;
     deconv_param->kernel_h = tm_param->kernel_h;
     deconv_param->kernel_w = tm_param->kernel_w;
     deconv_param->stride_h = tm_param->stride_h;
@@ -64,7 +66,36 @@ static int tm2_load_deconv(struct ir_graph* ir_graph, struct ir_node* ir_node, c
     deconv_param->dilation_w = tm_param->dilation_w;
     /* TODO: get input_channel from tm_param */
 
-    deconv_param->group = deconv_param->group;
+    deconv_param->group = tm_param->group;
+    deconv_param->activation = tm_param->activation;
+
+    return 0;
+}
+
+static int tm2_save_deconv(struct tm2_writer* writer, struct ir_graph* ir_graph, struct ir_node* ir_node,
+                           TM2_Operator* tm_op)
+{
+    struct deconv_param* deconv_param = ( struct deconv_param* )ir_node->op.param_mem;
+    TM2_DeconvParam tm_param;
+
+    memset(&tm_param, 0, sizeof(TM2_DeconvParam));
+
+    tm_param.num_output = deconv_param->num_output;
+    tm_param.kernel_h = deconv_param->kernel_h;
+    tm_param.kernel_w = deconv_param->kernel_w;
+    tm_param.stride_h = deconv_param->stride_h;
+    tm_param.stride_w = deconv_param->stride_w;
+    tm_param.pad_w0 = deconv_param->pad_w0;
+    tm_param.pad_h0 = deconv_param->pad_h0;
+    tm_param.pad_w1 = deconv_param->pad_w1;
+    tm_param.pad_h1 = deconv_param->pad_h1;
+    tm_param.dilation_h = deconv_param->dilation_h;
+    tm_param.dilation_w = deconv_param->dilation_w;
+    tm_param.group = deconv_param->group;
+    tm_param.activation = deconv_param->activation;
+
+    tm_op->operator_type = TM2_OPTYPE_DECONVOLUTION;
+    tm_op->offset_t_param = tm2_write_object(writer, &tm_param, sizeof(TM2_DeconvParam));
 
     return 0;
 }
@@ -82,6 +113,7 @@ static int reg_tm2_ops(void* arg)
     }
 
     tm2_s->register_op_loader(tm2_s, TM2_OPTYPE_DECONVOLUTION, 1, tm2_load_deconv, deconv_op_map, NULL);
+    tm2_s->register_op_saver(tm2_s, OP_DECONV, tm2_save_deconv);
 
     return 0;
 }
@@ -91,6 +123,7 @@ static int unreg_tm2_ops(void* arg)
     struct serializer* tm2_s = find_serializer("tengine");
 
     tm2_s->unregister_op_loader(tm2_s, TM2_OPTYPE_DECONVOLUTION, 1, tm2_load_deconv);
+    tm2_s->unregister_op_saver(tm2_s, OP_DECONV, tm2_save_deconv);
 
     return 0;
 }
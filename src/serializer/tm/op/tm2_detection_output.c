@@ -24,6 +24,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "sys_port.h"
 #include "module.h"
@@ -57,6 +58,26 @@ static int tm2_load_detection(struct ir_graph* ir_graph, struct ir_node* ir_node
     return 0;
 }
 
+static int tm2_save_detection(struct tm2_writer* writer, struct ir_graph* ir_graph, struct ir_node* ir_node,
+                              TM2_Operator* tm_op)
+{
+    struct detection_output_param* detection_output_param = ( struct detection_output_param* )ir_node->op.param_mem;
+    TM2_DetectionOutputParam tm_param;
+
+    memset(&tm_param, 0, sizeof(TM2_DetectionOutputParam));
+
+    tm_param.num_classes = detection_output_param->num_classes;
+    tm_param.keep_top_k = detection_output_param->keep_top_k;
+    tm_param.nms_top_k = detection_output_param->nms_top_k;
+    tm_param.confidence_threshold = detection_output_param->confidence_threshold;
+    tm_param.nms_threshold = detection_output_param->nms_threshold;
+
+    tm_op->operator_type = TM2_OPTYPE_DETECTIONOUTPUT;
+    tm_op->offset_t_param = tm2_write_object(writer, &tm_param, sizeof(TM2_DetectionOutputParam));
+
+    return 0;
+}
+
 static int reg_tm2_ops(void* arg)
 {
     struct serializer* tm2_s = find_serializer("tengine");
@@ -68,6 +89,7 @@ static int reg_tm2_ops(void* arg)
     }
 
     tm2_s->register_op_loader(tm2_s, TM2_OPTYPE_DETECTIONOUTPUT, 1, tm2_load_detection, detection_op_map, NULL);
+    tm2_s->register_op_saver(tm2_s, OP_DETECTION_OUTPUT, tm2_save_detection);
 
     return 0;
 }
@@ -77,6 +99,7 @@ static int unreg_tm2_ops(void* arg)
     struct serializer* tm2_s = find_serializer("tengine");
 
     tm2_s->unregister_op_loader(tm2_s, TM2_OPTYPE_DETECTIONOUTPUT, 1, tm2_load_detection);
+    tm2_s->unregister_op_saver(tm2_s, OP_DETECTION_OUTPUT, tm2_save_detection);
 
     return 0;
 }
@@ -24,6 +24,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "sys_port.h"
 #include "module.h"
@@ -56,6 +57,24 @@ static int tm2_load_embedding(struct ir_graph* ir_graph, struct ir_node* ir_node
     return 0;
 }
 
+static int tm2_save_embedding(struct tm2_writer* writer, struct ir_graph* ir_graph, struct ir_node* ir_node,
+                              TM2_Operator* tm_op)
+{
+    struct embedding_param* gather_param = ( struct embedding_param* )ir_node->op.param_mem;
+    TM2_EmbedParam tm_param;
+
+    memset(&tm_param, 0, sizeof(TM2_EmbedParam));
+
+    tm_param.input_dim = gather_param->input_dim;
+    tm_param.num_output = gather_param->num_output;
+    tm_param.weight_data_size = gather_param->weight_data_size;
+
+    tm_op->operator_type = TM2_OPTYPE_EMBED;
+    tm_op->offset_t_param = tm2_write_object(writer, &tm_param, sizeof(TM2_EmbedParam));
+
+    return 0;
+}
+
 static int reg_tm2_ops(void* arg)
 {
     struct serializer* tm2_s = find_serializer("tengine");
@@ -67,6 +86,7 @@ static int reg_tm2_ops(void* arg)
     }
 
     tm2_s->register_op_loader(tm2_s, TM2_OPTYPE_EMBED, 1, tm2_load_embedding, gather_op_map, NULL);
+    tm2_s->register_op_saver(tm2_s, OP_EMBEDDING, tm2_save_embedding);
 
     return 0;
 }
@@ -76,6 +96,7 @@ static int unreg_tm2_ops(void* arg)
     struct serializer* tm2_s = find_serializer("tengine");
 
     tm2_s->unregister_op_loader(tm2_s, TM2_OPTYPE_EMBED, 1, tm2_load_embedding);
+    tm2_s->unregister_op_saver(tm2_s, OP_EMBEDDING, tm2_save_embedding);
 
     return 0;
 }
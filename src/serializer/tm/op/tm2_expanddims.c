@@ -24,6 +24,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "sys_port.h"
 #include "module.h"
@@ -53,6 +54,22 @@ static int tm2_load_expanddims(struct ir_graph* ir_graph, struct ir_node* ir_nod
     return 0;
 }
 
+static int tm2_save_expanddims(struct tm2_writer* writer, struct ir_graph* ir_graph, struct ir_node* ir_node,
+                               TM2_Operator* tm_op)
+{
+    struct expanddims_param* expanddims_param = ( struct expanddims_param* )ir_node->op.param_mem;
+    TM2_ExpanddimsParam tm_param;
+
+    memset(&tm_param, 0, sizeof(TM2_ExpanddimsParam));
+
+    tm_param.axis = expanddims_param->axis;
+
+    tm_op->operator_type = TM2_OPTYPE_EXPANDDIMS;
+    tm_op->offset_t_param = tm2_write_object(writer, &tm_param, sizeof(TM2_ExpanddimsParam));
+
+    return 0;
+}
+
 static int reg_tm2_ops(void* arg)
 {
     struct serializer* tm2_s = find_serializer("tengine");
@@ -64,6 +81,7 @@ static int reg_tm2_ops(void* arg)
     }
 
     tm2_s->register_op_loader(tm2_s, TM2_OPTYPE_EXPANDDIMS, 1, tm2_load_expanddims, expanddims_op_map, NULL);
+    tm2_s->register_op_saver(tm2_s, OP_EXPANDDIMS, tm2_save_expanddims);
 
     return 0;
 }
@@ -73,6 +91,7 @@ static int unreg_tm2_ops(void* arg)
     struct serializer* tm2_s = find_serializer("tengine");
 
     tm2_s->unregister_op_loader(tm2_s, TM2_OPTYPE_EXPANDDIMS, 1, tm2_load_expanddims);
+    tm2_s->unregister_op_saver(tm2_s, OP_EXPANDDIMS, tm2_save_expanddims);
 
     return 0;
 }
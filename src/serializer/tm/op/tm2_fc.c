@@ -24,6 +24,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "sys_port.h"
 #include "module.h"
@@ -52,6 +53,30 @@ static int tm2_load_fc(struct ir_graph* ir_graph, struct ir_node* ir_node, const
 
     fc_param->num_output = tm_param->num_output;
 
+    /* the shipped models are op_ver 2 and older, their param has num_output only */
+    if (tm_op->op_ver >= 3)
+        fc_param->activation = tm_param->activation;
+    else
+        fc_param->activation = -1;
+
+    return 0;
+}
+
+static int tm2_save_fc(struct tm2_writer* writer, struct ir_graph* ir_graph, struct ir_node* ir_node,
+                       TM2_Operator* tm_op)
+{
+    struct fc_param* fc_param = ( struct fc_param* )ir_node->op.param_mem;
+    TM2_FCParam tm_param;
+
+    memset(&tm_param, 0, sizeof(TM2_FCParam));
+
+    tm_param.num_output = fc_param->num_output;
+    tm_param.activation = fc_param->activation;
+
+    tm_op->operator_type = TM2_OPTYPE_FULLYCONNECTED;
+    tm_op->op_ver = 3; /* activation is only read from version 3 */
+    tm_op->offset_t_param = tm2_write_object(writer, &tm_param, sizeof(TM2_FCParam));
+
     return 0;
 }
 
@@ -68,6 +93,7 @@ static int reg_tm2_ops(void* arg)
     }
 
     tm2_s->register_op_loader(tm2_s, TM2_OPTYPE_FULLYCONNECTED, 1, tm2_load_fc, fc_op_map, NULL);
+    tm2_s->register_op_saver(tm2_s, OP_FC, tm2_save_fc);
 
     return 0;
 }
@@ -77,6 +103,7 @@ static int unreg_tm2_ops(void* arg)
     struct serializer* tm2_s = find_serializer("tengine");
 
     tm2_s->unregister_op_loader(tm2_s, TM2_OPTYPE_FULLYCONNECTED, 1, tm2_load_fc);
+    tm2_s->unregister_op_saver(tm2_s, OP_FC, tm2_save_fc);
 
     return 0;
 }
@@ -24,6 +24,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "sys_port.h"
 #include "module.h"
@@ -54,6 +55,23 @@ static int tm2_load_flatten(struct ir_graph* ir_graph, struct ir_node* ir_node,
     return 0;
 }
 
+static int tm2_save_flatten(struct tm2_writer* writer, struct ir_graph* ir_graph, struct ir_node* ir_node,
+                            TM2_Operator* tm_op)
+{
+    struct flatten_param* flatten_param = ( struct flatten_param* )ir_node->op.param_mem;
+    TM2_FlattenParam tm_param;
+
+    memset(&tm_param, 0, sizeof(TM2_FlattenParam));
+
+    tm_param.end_axis = flatten_param->end_axis;
+    tm_param.axis = flatten_param->axis;
+
+    tm_op->operator_type = TM2_OPTYPE_FLATTEN;
+    tm_op->offset_t_param = tm2_write_object(writer, &tm_param, sizeof(TM2_FlattenParam));
+
+    return 0;
+}
+
 /* the auto register functions */
 
 static int reg_tm2_ops(void* arg)
@@ -67,6 +85,7 @@ static int reg_tm2_ops(void* arg)
     }
 
     tm2_s->register_op_loader(tm2_s, TM2_OPTYPE_FLATTEN, 1, tm2_load_flatten, flatten_op_map, NULL);
+    tm2_s->register_op_saver(tm2_s, OP_FLATTEN, tm2_save_flatten);
 
     return 0;
 }
@@ -76,6 +95,7 @@ static int unreg_tm2_ops(void* arg)
     struct serializer* tm2_s = find_serializer("tengine");
 
     tm2_s->unregister_op_loader(tm2_s, TM2_OPTYPE_FLATTEN, 1, tm2_load_flatten);
+    tm2_s->unregister_op_saver(tm2_s, OP_FLATTEN, tm2_save_flatten);
 
     return 0;
 }
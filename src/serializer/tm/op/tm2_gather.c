@@ -24,6 +24,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "sys_port.h"
 #include "module.h"
@@ -58,6 +59,24 @@ static int tm2_load_gather(struct ir_graph* ir_graph, struct ir_node* ir_node, c
     return 0;
 }
 
+static int tm2_save_gather(struct tm2_writer* writer, struct ir_graph* ir_graph, struct ir_node* ir_node,
+                           TM2_Operator* tm_op)
+{
+    struct gather_param* gather_param = ( struct gather_param* )ir_node->op.param_mem;
+    TM2_GatherParam tm_param;
+
+    memset(&tm_param, 0, sizeof(TM2_GatherParam));
+
+    tm_param.axis = gather_param->axis;
+    tm_param.indices_num = gather_param->indices_num;
+    tm_param.is_onnx = gather_param->is_onnx;
+
+    tm_op->operator_type = TM2_OPTYPE_GATHER;
+    tm_op->offset_t_param = tm2_write_object(writer, &tm_param, sizeof(TM2_GatherParam));
+
+    return 0;
+}
+
 /* the auto register functions */
 
 static int reg_tm2_ops(void* arg)
@@ -71,6 +90,7 @@ static int reg_tm2_ops(void* arg)
     }
 
     tm2_s->register_op_loader(tm2_s, TM2_OPTYPE_GATHER, 1, tm2_load_gather, gather_op_map, NULL);
+    tm2_s->register_op_saver(tm2_s, OP_GATHER, tm2_save_gather);
 
     return 0;
 }
@@ -80,6 +100,7 @@ static int unreg_tm2_ops(void* arg)
     struct serializer* tm2_s = find_serializer("tengine");
 
     tm2_s->unregister_op_loader(tm2_s, TM2_OPTYPE_GATHER, 1, tm2_load_gather);
+    tm2_s->unregister_op_saver(tm2_s, OP_GATHER, tm2_save_gather);
 
     return 0;
 }
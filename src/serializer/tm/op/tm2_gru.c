@@ -24,6 +24,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "sys_port.h"
 #include "module.h"
@@ -62,6 +63,31 @@ static int tm2_load_gru(struct ir_graph* ir_graph, struct ir_node* ir_node, cons
     return 0;
 }
 
+static int tm2_save_gru(struct tm2_writer* writer, struct ir_graph* ir_graph, struct ir_node* ir_node,
+                        TM2_Operator* tm_op)
+{
+    struct gru_param* gru_param = ( struct gru_param* )ir_node->op.param_mem;
+    TM2_GRUParam tm_param;
+
+    memset(&tm_param, 0, sizeof(TM2_GRUParam));
+
+    tm_param.clip = gru_param->clip;
+    tm_param.output_len = gru_param->output_len;
+    tm_param.sequence_len = gru_param->sequence_len;
+    tm_param.input_size = gru_param->input_size;
+    tm_param.hidden_size = gru_param->hidden_size;
+    tm_param.has_clip = gru_param->has_clip;
+    tm_param.has_gate_bias = gru_param->has_gate_bias;
+    tm_param.has_candidate_bias = gru_param->has_candidate_bias;
+    tm_param.has_init_state = gru_param->has_init_state;
+    tm_param.mxnet_flag = gru_param->mxnet_flag;
+
+    tm_op->operator_type = TM2_OPTYPE_GRU;
+    tm_op->offset_t_param = tm2_write_object(writer, &tm_param, sizeof(TM2_GRUParam));
+
+    return 0;
+}
+
 /* the auto register functions */
 
 static int reg_tm2_ops(void* arg)
@@ -75,6 +101,7 @@ static int reg_tm2_ops(void* arg)
     }
 
     tm2_s->register_op_loader(tm2_s, TM2_OPTYPE_GRU, 1, tm2_load_gru, gru_op_map, NULL);
+    tm2_s->register_op_saver(tm2_s, OP_GRU, tm2_save_gru);
 
     return 0;
 }
@@ -84,6 +111,7 @@ static int unreg_tm2_ops(void* arg)
     struct serializer* tm2_s = find_serializer("tengine");
 
     tm2_s->unregister_op_loader(tm2_s, TM2_OPTYPE_GRU, 1, tm2_load_gru);
+    tm2_s->unregister_op_saver(tm2_s, OP_GRU, tm2_save_gru);
 
     return 0;
 }
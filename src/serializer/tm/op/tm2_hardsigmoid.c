@@ -24,6 +24,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "sys_port.h"
 #include "module.h"
@@ -54,6 +55,23 @@ static int tm2_load_hard_sigmoid(struct ir_graph* ir_graph, struct ir_node* ir_n
     return 0;
 }
 
+static int tm2_save_hard_sigmoid(struct tm2_writer* writer, struct ir_graph* ir_graph, struct ir_node* ir_node,
+                                 TM2_Operator* tm_op)
+{
+    struct hard_sigmoid_param* gather_param = ( struct hard_sigmoid_param* )ir_node->op.param_mem;
+    TM2_HardsigmoidParam tm_param;
+
+    memset(&tm_param, 0, sizeof(TM2_HardsigmoidParam));
+
+    tm_param.alpha = gather_param->alpha;
+    tm_param.beta = gather_param->beta;
+
+    tm_op->operator_type = TM2_OPTYPE_HARDSIGMOID;
+    tm_op->offset_t_param = tm2_write_object(writer, &tm_param, sizeof(TM2_HardsigmoidParam));
+
+    return 0;
+}
+
 static int reg_tm2_ops(void* arg)
 {
     struct serializer* tm2_s = find_serializer("tengine");
@@ -65,6 +83,7 @@ static int reg_tm2_ops(void* arg)
     }
 
     tm2_s->register_op_loader(tm2_s, TM2_OPTYPE_HARDSIGMOID, 1, tm2_load_hard_sigmoid, gather_op_map, NULL);
+    tm2_s->register_op_saver(tm2_s, OP_HARDSIGMOID, tm2_save_hard_sigmoid);
 
     return 0;
 }
@@ -74,6 +93,7 @@ static int unreg_tm2_ops(void* arg)
     struct serializer* tm2_s = find_serializer("tengine");
 
     tm2_s->unregister_op_loader(tm2_s, TM2_OPTYPE_HARDSIGMOID, 1, tm2_load_hard_sigmoid);
+    tm2_s->unregister_op_saver(tm2_s, OP_HARDSIGMOID, tm2_save_hard_sigmoid);
 
     return 0;
 }
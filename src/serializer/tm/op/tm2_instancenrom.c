@@ -24,6 +24,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "sys_port.h"
 #include "module.h"
@@ -53,6 +54,22 @@ static int tm2_load_instancenorm(struct ir_graph* ir_graph, struct ir_node* ir_n
     return 0;
 }
 
+static int tm2_save_instancenorm(struct tm2_writer* writer, struct ir_graph* ir_graph, struct ir_node* ir_node,
+                                 TM2_Operator* tm_op)
+{
+    struct instancenorm_Param* gather_param = ( struct instancenorm_Param* )ir_node->op.param_mem;
+    TM2_InstanceNormParam tm_param;
+
+    memset(&tm_param, 0, sizeof(TM2_InstanceNormParam));
+
+    tm_param.eps = gather_param->eps;
+
+    tm_op->operator_type = TM2_OPTYPE_INSTANCENORM;
+    tm_op->offset_t_param = tm2_write_object(writer, &tm_param, sizeof(TM2_InstanceNormParam));
+
+    return 0;
+}
+
 static int reg_tm2_ops(void* arg)
 {
     struct serializer* tm2_s = find_serializer("tengine");
@@ -64,6 +81,7 @@ static int reg_tm2_ops(void* arg)
     }
 
     tm2_s->register_op_loader(tm2_s, TM2_OPTYPE_INSTANCENORM, 1, tm2_load_instancenorm, instancenorm_op_map, NULL);
+    tm2_s->register_op_saver(tm2_s, OP_INSTANCENORM, tm2_save_instancenorm);
 
     return 0;
 }
@@ -73,6 +91,7 @@ static int unreg_tm2_ops(void* arg)
     struct serializer* tm2_s = find_serializer("tengine");
 
     tm2_s->unregister_op_loader(tm2_s, TM2_OPTYPE_INSTANCENORM, 1, tm2_load_instancenorm);
+    tm2_s->unregister_op_saver(tm2_s, OP_INSTANCENORM, tm2_save_instancenorm);
 
     return 0;
 }
@@ -24,6 +24,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "sys_port.h"
 #include "module.h"
@@ -70,6 +71,39 @@ static int tm2_load_lstm(struct ir_graph* ir_graph, struct ir_node* ir_node, con
     return 0;
 }
 
+static int tm2_save_lstm(struct tm2_writer* writer, struct ir_graph* ir_graph, struct ir_node* ir_node,
+                         TM2_Operator* tm_op)
+{
+    struct lstm_param* lstm_param = ( struct lstm_param* )ir_node->op.param_mem;
+    TM2_LstmParam tm_param;
+
+    memset(&tm_param, 0, sizeof(TM2_LstmParam));
+
+    tm_param.forget_bias = lstm_param->forget_bias;
+    tm_param.clip = lstm_param->clip;
+    tm_param.output_len = lstm_param->output_len;
+    tm_param.sequence_len = lstm_param->sequence_len;
+    tm_param.input_size = lstm_param->input_size;
+    tm_param.hidden_size = lstm_param->hidden_size;
+    tm_param.cell_size = lstm_param->cell_size;
+    tm_param.has_peephole = lstm_param->has_peephole;
+    tm_param.has_projection = lstm_param->has_projection;
+    tm_param.has_clip = lstm_param->has_clip;
+    tm_param.has_bias = lstm_param->has_bias;
+    tm_param.has_init_state = lstm_param->has_init_state;
+    tm_param.forget_act = lstm_param->forget_act;
+    tm_param.input_act = lstm_param->input_act;
+    tm_param.output_act = lstm_param->output_act;
+    tm_param.cellin_act = lstm_param->cellin_act;
+    tm_param.cellout_act = lstm_param->cellout_act;
+    tm_param.mxnet_flag = lstm_param->mxnet_flag;
+
+    tm_op->operator_type = TM2_OPTYPE_LSTM;
+    tm_op->offset_t_param = tm2_write_object(writer, &tm_param, sizeof(TM2_LstmParam));
+
+    return 0;
+}
+
 /* the auto register functions */
 
 static int reg_tm2_ops(void* arg)
@@ -83,6 +117,7 @@ static int reg_tm2_ops(void* arg)
     }
 
     tm2_s->register_op_loader(tm2_s, TM2_OPTYPE_LSTM, 1, tm2_load_lstm, lstm_op_map, NULL);
+    tm2_s->register_op_saver(tm2_s, OP_LSTM, tm2_save_lstm);
 
     return 0;
 }
@@ -92,6 +127,7 @@ static int unreg_tm2_ops(void* arg)
     struct serializer* tm2_s = find_serializer("tengine");
 
     tm2_s->unregister_op_loader(tm2_s, TM2_OPTYPE_LSTM, 1, tm2_load_lstm);
+    tm2_s->unregister_op_saver(tm2_s, OP_LSTM, tm2_save_lstm);
 
     return 0;
 }
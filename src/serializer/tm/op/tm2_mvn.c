@@ -24,6 +24,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "sys_port.h"
 #include "module.h"
@@ -55,6 +56,24 @@ static int tm2_load_mvn(struct ir_graph* ir_graph, struct ir_node* ir_node, cons
     return 0;
 }
 
+static int tm2_save_mvn(struct tm2_writer* writer, struct ir_graph* ir_graph, struct ir_node* ir_node,
+                        TM2_Operator* tm_op)
+{
+    struct mvn_param* gather_param = ( struct mvn_param* )ir_node->op.param_mem;
+    TM2_MVNParam tm_param;
+
+    memset(&tm_param, 0, sizeof(TM2_MVNParam));
+
+    tm_param.across_channels = gather_param->across_channels;
+    tm_param.eps = gather_param->eps;
+    tm_param.normalize_variance = gather_param->normalize_variance;
+
+    tm_op->operator_type = TM2_OPTYPE_MVN;
+    tm_op->offset_t_param = tm2_write_object(writer, &tm_param, sizeof(TM2_MVNParam));
+
+    return 0;
+}
+
 static int reg_tm2_ops(void* arg)
 {
     struct serializer* tm2_s = find_serializer("tengine");
@@ -66,6 +85,7 @@ static int reg_tm2_ops(void* arg)
     }
 
     tm2_s->register_op_loader(tm2_s, TM2_OPTYPE_MVN, 1, tm2_load_mvn, mvn_op_map, NULL);
+    tm2_s->register_op_saver(tm2_s, OP_MVN, tm2_save_mvn);
 
     return 0;
 }
@@ -75,6 +95,7 @@ static int unreg_tm2_ops(void* arg)
     struct serializer* tm2_s = find_serializer("tengine");
 
     tm2_s->unregister_op_loader(tm2_s, TM2_OPTYPE_MVN, 1, tm2_load_mvn);
+    tm2_s->unregister_op_saver(tm2_s, OP_MVN, tm2_save_mvn);
 
     return 0;
 }
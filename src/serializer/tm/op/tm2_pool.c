@@ -24,6 +24,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "sys_port.h"
 #include "module.h"
@@ -70,6 +71,36 @@ static int tm2_load_pooling(struct ir_graph* ir_graph, struct ir_node* ir_node,
     return 0;
 }
 
+static int tm2_save_pooling(struct tm2_writer* writer, struct ir_graph* ir_graph, struct ir_node* ir_node,
+                            TM2_Operator* tm_op)
+{
+    struct pool_param* pool_param = ( struct pool_param* )ir_node->op.param_mem;
+    TM2_PoolParam tm_param;
+
+    memset(&tm_param, 0, sizeof(TM2_PoolParam));
+
+    tm_param.kernel_h = pool_param->kernel_h;
+    tm_param.kernel_w = pool_param->kernel_w;
+    tm_param.stride_h = pool_param->stride_h;
+    tm_param.stride_w = pool_param->stride_w;
+    tm_param.global = pool_param->global;
+    tm_param.caffe_flavor = pool_param->caffe_flavor;
+    tm_param.pad_h0 = pool_param->pad_h0;
+    tm_param.pad_h1 = pool_param->pad_h1;
+    tm_param.pad_w0 = pool_param->pad_w0;
+    tm_param.pad_w1 = pool_param->pad_w1;
+    tm_param.pad_h0 = pool_param->pad_h0_org;
+    tm_param.pad_h1 = pool_param->pad_h1_org;
+    tm_param.pad_w0 = pool_param->pad_w0_org;
+    tm_param.pad_w1 = pool_param->pad_w1_org;
+    tm_param.alg = pool_param->pool_method;
+
+    tm_op->operator_type = TM2_OPTYPE_POOLING;
+    tm_op->offset_t_param = tm2_write_object(writer, &tm_param, sizeof(TM2_PoolParam));
+
+    return 0;
+}
+
 static int reg_tm2_ops(void* arg)
 {
     struct serializer* tm2_s = find_serializer("tengine");
@@ -81,6 +112,7 @@ static int reg_tm2_ops(void* arg)
     }
 
     tm2_s->register_op_loader(tm2_s, TM2_OPTYPE_POOLING, 1, tm2_load_pooling, pooling_op_map, NULL);
+    tm2_s->register_op_saver(tm2_s, OP_POOL, tm2_save_pooling);
 
     return 0;
 }
@@ -90,6 +122,7 @@ static int unreg_tm2_ops(void* arg)
     struct serializer* tm2_s = find_serializer("tengine");
 
     tm2_s->unregister_op_loader(tm2_s, TM2_OPTYPE_POOLING, 1, tm2_load_pooling);
+    tm2_s->unregister_op_saver(tm2_s, OP_POOL, tm2_save_pooling);
 
     return 0;
 }
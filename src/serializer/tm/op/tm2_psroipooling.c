@@ -24,6 +24,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "sys_port.h"
 #include "module.h"
@@ -56,6 +57,25 @@ static int tm2_load_psroipooling(struct ir_graph* ir_graph, struct ir_node* ir_n
     return 0;
 }
 
+static int tm2_save_psroipooling(struct tm2_writer* writer, struct ir_graph* ir_graph, struct ir_node* ir_node,
+                                 TM2_Operator* tm_op)
+{
+    struct psroipooling_param* psroipooling_param = ( struct psroipooling_param* )ir_node->op.param_mem;
+    TM2_PsroipoolingParam tm_param;
+
+    memset(&tm_param, 0, sizeof(TM2_PsroipoolingParam));
+
+    tm_param.pooled_w = psroipooling_param->pooled_w;
+    tm_param.pooled_h = psroipooling_param->pooled_h;
+    tm_param.spatial_scale = psroipooling_param->spatial_scale;
+    tm_param.output_dim = psroipooling_param->output_dim;
+
+    tm_op->operator_type = TM2_OPTYPE_PSROIPOOLING;
+    tm_op->offset_t_param = tm2_write_object(writer, &tm_param, sizeof(TM2_PsroipoolingParam));
+
+    return 0;
+}
+
 static int reg_tm2_ops(void* arg)
 {
     struct serializer* tm2_s = find_serializer("tengine");
@@ -67,6 +87,7 @@ static int reg_tm2_ops(void* arg)
     }
 
     tm2_s->register_op_loader(tm2_s, TM2_OPTYPE_PSROIPOOLING, 1, tm2_load_psroipooling, psroipooling_op_map, NULL);
+    tm2_s->register_op_saver(tm2_s, OP_PSROIPOOLING, tm2_save_psroipooling);
 
     return 0;
 }
@@ -76,6 +97,7 @@ static int unreg_tm2_ops(void* arg)
     struct serializer* tm2_s = find_serializer("tengine");
 
     tm2_s->unregister_op_loader(tm2_s, TM2_OPTYPE_PSROIPOOLING, 1, tm2_load_psroipooling);
+    tm2_s->unregister_op_saver(tm2_s, OP_PSROIPOOLING, tm2_save_psroipooling);
 
     return 0;
 }
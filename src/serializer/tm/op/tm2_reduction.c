@@ -24,6 +24,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "sys_port.h"
 #include "module.h"
 #include "tengine_ir.h"
@@ -57,6 +58,27 @@ static int tm2_load_reduction(struct ir_graph* ir_graph, struct ir_node* ir_node
     return 0;
 }
 
+static int tm2_save_reduction(struct tm2_writer* writer, struct ir_graph* ir_graph, struct ir_node* ir_node,
+                              TM2_Operator* tm_op)
+{
+    struct reduction_param* reduction_param = ( struct reduction_param* )ir_node->op.param_mem;
+    TM2_ReductionParam tm_param;
+
+    memset(&tm_param, 0, sizeof(TM2_ReductionParam));
+
+    tm_param.dim_0 = reduction_param->dim_0;
+    tm_param.dim_1 = reduction_param->dim_1;
+    tm_param.dim_2 = reduction_param->dim_2;
+    tm_param.dim_3 = reduction_param->dim_3;
+    tm_param.type = reduction_param->type;
+    tm_param.keepdim = reduction_param->keepdim;
+
+    tm_op->operator_type = TM2_OPTYPE_REDUCTION;
+    tm_op->offset_t_param = tm2_write_object(writer, &tm_param, sizeof(TM2_ReductionParam));
+
+    return 0;
+}
+
 static int reg_tm2_ops(void* arg)
 {
     struct serializer* tm2_s = find_serializer("tengine");
@@ -68,6 +90,7 @@ static int reg_tm2_ops(void* arg)
     }
 
     tm2_s->register_op_loader(tm2_s, TM2_OPTYPE_REDUCTION, 1, tm2_load_reduction, reduction_op_map, NULL);
+    tm2_s->register_op_saver(tm2_s, OP_REDUCTION, tm2_save_reduction);
 
     return 0;
 }
@@ -77,6 +100,7 @@ static int unreg_tm2_ops(void* arg)
     struct serializer* tm2_s = find_serializer("tengine");
 
     tm2_s->unregister_op_loader(tm2_s, TM2_OPTYPE_REDUCTION, 1, tm2_load_reduction);
+    tm2_s->unregister_op_saver(tm2_s, OP_REDUCTION, tm2_save_reduction);
 
     return 0;
 }
@@ -24,6 +24,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "sys_port.h"
 #include "module.h"
@@ -65,6 +66,28 @@ static int tm2_load_region(struct ir_graph* ir_graph, struct ir_node* ir_node, c
     return 0;
 }
 
+static int tm2_save_region(struct tm2_writer* writer, struct ir_graph* ir_graph, struct ir_node* ir_node,
+                           TM2_Operator* tm_op)
+{
+    struct region_param* region_param = ( struct region_param* )ir_node->op.param_mem;
+    TM2_RegionParam tm_param;
+
+    memset(&tm_param, 0, sizeof(TM2_RegionParam));
+
+    tm_param.num_classes = region_param->num_classes;
+    tm_param.side = region_param->side;
+    tm_param.num_box = region_param->num_box;
+    tm_param.coords = region_param->coords;
+    tm_param.confidence_threshold = region_param->confidence_threshold;
+    tm_param.nms_threshold = region_param->nms_threshold;
+    tm_param.offset_vf_biases = tm2_write_vector_floats(writer, region_param->biases, region_param->biases_num);
+
+    tm_op->operator_type = TM2_OPTYPE_REGION;
+    tm_op->offset_t_param = tm2_write_object(writer, &tm_param, sizeof(TM2_RegionParam));
+
+    return 0;
+}
+
 /* the auto register functions */
 
 static int reg_tm2_ops(void* arg)
@@ -78,6 +101,7 @@ static int reg_tm2_ops(void* arg)
     }
 
     tm2_s->register_op_loader(tm2_s, TM2_OPTYPE_REGION, 1, tm2_load_region, region_op_map, NULL);
+    tm2_s->register_op_saver(tm2_s, OP_REGION, tm2_save_region);
 
     return 0;
 }
@@ -87,6 +111,7 @@ static int unreg_tm2_ops(void* arg)
     struct serializer* tm2_s = find_serializer("tengine");
 
     tm2_s->unregister_op_loader(tm2_s, TM2_OPTYPE_REGION, 1, tm2_load_region);
+    tm2_s->unregister_op_saver(tm2_s, OP_REGION, tm2_save_region);
 
     return 0;
 }
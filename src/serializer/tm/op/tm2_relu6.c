@@ -24,6 +24,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "sys_port.h"
 #include "module.h"
@@ -45,6 +46,14 @@ static int tm2_load_relu6(struct ir_graph* ir_graph, struct ir_node* ir_node, co
     return 0;
 }
 
+static int tm2_save_relu6(struct tm2_writer* writer, struct ir_graph* ir_graph, struct ir_node* ir_node,
+                          TM2_Operator* tm_op)
+{
+    tm_op->operator_type = TM2_OPTYPE_RELU6;
+
+    return 0;
+}
+
 static int reg_tm2_ops(void* arg)
 {
     struct serializer* tm2_s = find_serializer("tengine");
@@ -56,6 +65,7 @@ static int reg_tm2_ops(void* arg)
     }
 
     tm2_s->register_op_loader(tm2_s, TM2_OPTYPE_RELU6, 1, tm2_load_relu6, relu6_op_map, NULL);
+    tm2_s->register_op_saver(tm2_s, OP_RELU6, tm2_save_relu6);
 
     return 0;
 }
@@ -65,6 +75,7 @@ static int unreg_tm2_ops(void* arg)
     struct serializer* tm2_s = find_serializer("tengine");
 
     tm2_s->unregister_op_loader(tm2_s, TM2_OPTYPE_RELU6, 1, tm2_load_relu6);
+    tm2_s->unregister_op_saver(tm2_s, OP_RELU6, tm2_save_relu6);
 
     return 0;
 }
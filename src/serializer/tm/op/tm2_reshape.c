@@ -24,6 +24,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "sys_port.h"
 #include "module.h"
@@ -74,6 +75,24 @@ static int tm2_load_reshape(struct ir_graph* ir_graph, struct ir_node* ir_node,
     return 0;
 }
 
+static int tm2_save_reshape(struct tm2_writer* writer, struct ir_graph* ir_graph, struct ir_node* ir_node,
+                            TM2_Operator* tm_op)
+{
+    struct reshape_param* param = ( struct reshape_param* )ir_node->op.param_mem;
+    TM2_ReshapeParam tm_param;
+
+    memset(&tm_param, 0, sizeof(TM2_ReshapeParam));
+
+    tm_param.is_mxnet = param->is_mxnet;
+    tm_param.reverse = param->reverse;
+    tm_param.offset_re_shape = tm2_write_vector_dims(writer, param->re_shape, param->dim_size);
+
+    tm_op->operator_type = TM2_OPTYPE_RESHAPE;
+    tm_op->offset_t_param = tm2_write_object(writer, &tm_param, sizeof(TM2_ReshapeParam));
+
+    return 0;
+}
+
 static int reg_tm2_ops(void* arg)
 {
     struct serializer* tm2_s = find_serializer("tengine");
@@ -85,6 +104,7 @@ static int reg_tm2_ops(void* arg)
     }
 
     tm2_s->register_op_loader(tm2_s, TM2_OPTYPE_RESHAPE, 1, tm2_load_reshape, reshape_op_map, NULL);
+    tm2_s->register_op_saver(tm2_s, OP_RESHAPE, tm2_save_reshape);
 
     return 0;
 }
@@ -94,6 +114,7 @@ static int unreg_tm2_ops(void* arg)
     struct serializer* tm2_s = find_serializer("tengine");
 
     tm2_s->unregister_op_loader(tm2_s, TM2_OPTYPE_RESHAPE, 1, tm2_load_reshape);
+    tm2_s->unregister_op_saver(tm2_s, OP_RESHAPE, tm2_save_reshape);
 
     return 0;
 }
@@ -24,6 +24,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "sys_port.h"
 #include "module.h"
@@ -60,6 +61,30 @@ static int tm2_load_rnn(struct ir_graph* ir_graph, struct ir_node* ir_node, cons
     return 0;
 }
 
+static int tm2_save_rnn(struct tm2_writer* writer, struct ir_graph* ir_graph, struct ir_node* ir_node,
+                        TM2_Operator* tm_op)
+{
+    struct rnn_param* rnn_param = ( struct rnn_param* )ir_node->op.param_mem;
+    TM2_RnnParam tm_param;
+
+    memset(&tm_param, 0, sizeof(TM2_RnnParam));
+
+    tm_param.clip = rnn_param->clip;
+    tm_param.output_len = rnn_param->output_len;
+    tm_param.sequence_len = rnn_param->sequence_len;
+    tm_param.input_size = rnn_param->input_size;
+    tm_param.hidden_size = rnn_param->hidden_size;
+    tm_param.has_clip = rnn_param->has_clip;
+    tm_param.has_bias = rnn_param->has_bias;
+    tm_param.has_init_state = rnn_param->has_init_state;
+    tm_param.activation = rnn_param->activation;
+
+    tm_op->operator_type = TM2_OPTYPE_RNN;
+    tm_op->offset_t_param = tm2_write_object(writer, &tm_param, sizeof(TM2_RnnParam));
+
+    return 0;
+}
+
 static int reg_tm2_ops(void* arg)
 {
     struct serializer* tm2_s = find_serializer("tengine");
@@ -71,6 +96,7 @@ static int reg_tm2_ops(void* arg)
     }
 
     tm2_s->register_op_loader(tm2_s, TM2_OPTYPE_RNN, 1, tm2_load_rnn, rnn_op_map, NULL);
+    tm2_s->register_op_saver(tm2_s, OP_RNN, tm2_save_rnn);
 
     return 0;
 }
@@ -80,6 +106,7 @@ static int unreg_tm2_ops(void* arg)
     struct serializer* tm2_s = find_serializer("tengine");
 
     tm2_s->unregister_op_loader(tm2_s, TM2_OPTYPE_RNN, 1, tm2_load_rnn);
+    tm2_s->unregister_op_saver(tm2_s, OP_RNN, tm2_save_rnn);
 
     return 0;
 }
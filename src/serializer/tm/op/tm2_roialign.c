@@ -24,6 +24,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "sys_port.h"
 #include "module.h"
@@ -55,6 +56,24 @@ static int tm2_load_roialign(struct ir_graph* ir_graph, struct ir_node* ir_node,
     return 0;
 }
 
+static int tm2_save_roialign(struct tm2_writer* writer, struct ir_graph* ir_graph, struct ir_node* ir_node,
+                             TM2_Operator* tm_op)
+{
+    struct roialign_param* roialign_param = ( struct roialign_param* )ir_node->op.param_mem;
+    TM2_RoialignParam tm_param;
+
+    memset(&tm_param, 0, sizeof(TM2_RoialignParam));
+
+    tm_param.pooled_width = roialign_param->pooled_width;
+    tm_param.pooled_height = roialign_param->pooled_height;
+    tm_param.spatial_scale = roialign_param->spatial_scale;
+
+    tm_op->operator_type = TM2_OPTYPE_ROIALIGN;
+    tm_op->offset_t_param = tm2_write_object(writer, &tm_param, sizeof(TM2_RoialignParam));
+
+    return 0;
+}
+
 static int reg_tm2_ops(void* arg)
 {
     struct serializer* tm2_s = find_serializer("tengine");
@@ -66,6 +85,7 @@ static int reg_tm2_ops(void* arg)
     }
 
     tm2_s->register_op_loader(tm2_s, TM2_OPTYPE_ROIALIGN, 1, tm2_load_roialign, roialign_op_map, NULL);
+    tm2_s->register_op_saver(tm2_s, OP_ROIALIGN, tm2_save_roialign);
 
     return 0;
 }
@@ -75,6 +95,7 @@ static int unreg_tm2_ops(void* arg)
     struct serializer* tm2_s = find_serializer("tengine");
 
     tm2_s->unregister_op_loader(tm2_s, TM2_OPTYPE_ROIALIGN, 1, tm2_load_roialign);
+    tm2_s->unregister_op_saver(tm2_s, OP_ROIALIGN, tm2_save_roialign);
 
     return 0;
 }
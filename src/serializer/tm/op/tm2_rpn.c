@@ -24,6 +24,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "sys_port.h"
 #include "module.h"
@@ -59,7 +60,7 @@ static int tm2_load_rpn(struct ir_graph* ir_graph, struct ir_node* ir_node, cons
     {
         const TM2_Vector_floats* v_anchor_scales = ( TM2_Vector_floats* )(mem_base + tm_param->offset_vf_anchor_scales);
         // param->dim_size = v_re_shape->v_num ;
-        rpn_param->anchor_scales = create_vector(v_anchor_scales->v_num * sizeof(float), NULL);
+        rpn_param->anchor_scales = create_vector(sizeof(float), NULL);
 
         for (unsigned int i = 0; i < v_anchor_scales->v_num; i++)
         {
@@ -71,7 +72,7 @@ static int tm2_load_rpn(struct ir_graph* ir_graph, struct ir_node* ir_node, cons
     {
         const TM2_Vector_floats* v_ratios = ( TM2_Vector_floats* )(mem_base + tm_param->offset_vf_ratios);
         // param->dim_size = v_re_shape->v_num ;
-        rpn_param->ratios = create_vector(v_ratios->v_num * sizeof(float), NULL);
+        rpn_param->ratios = create_vector(sizeof(float), NULL);
 
         for (unsigned int i = 0; i < v_ratios->v_num; i++)
         {
@@ -82,6 +83,30 @@ static int tm2_load_rpn(struct ir_graph* ir_graph, struct ir_node* ir_node, cons
     return 0;
 }
 
+static int tm2_save_rpn(struct tm2_writer* writer, struct ir_graph* ir_graph, struct ir_node* ir_node,
+                        TM2_Operator* tm_op)
+{
+    struct rpn_param* rpn_param = ( struct rpn_param* )ir_node->op.param_mem;
+    TM2_RPNParam tm_param;
+
+    memset(&tm_param, 0, sizeof(TM2_RPNParam));
+
+    tm_param.offset_vf_ratios = tm2_write_vector_items(writer, rpn_param->ratios);
+    tm_param.offset_vf_anchor_scales = tm2_write_vector_items(writer, rpn_param->anchor_scales);
+    tm_param.feat_stride = rpn_param->feat_stride;
+    tm_param.basesize = rpn_param->basesize;
+    tm_param.min_size = rpn_param->min_size;
+    tm_param.per_nms_topn = rpn_param->per_nms_topn;
+    tm_param.post_nms_topn = rpn_param->post_nms_topn;
+    tm_param.nms_thresh = rpn_param->nms_thresh;
+    tm_param.offset_va_anchors = TM2_NOT_SET;
+
+    tm_op->operator_type = TM2_OPTYPE_RPN;
+    tm_op->offset_t_param = tm2_write_object(writer, &tm_param, sizeof(TM2_RPNParam));
+
+    return 0;
+}
+
 static int reg_tm2_ops(void* arg)
 {
     struct serializer* tm2_s = find_serializer("tengine");
@@ -93,6 +118,7 @@ static int reg_tm2_ops(void* arg)
     }
 
     tm2_s->register_op_loader(tm2_s, TM2_OPTYPE_RPN, 1, tm2_load_rpn, rpn_op_map, NULL);
+    tm2_s->register_op_saver(tm2_s, OP_RPN, tm2_save_rpn);
 
     return 0;
 }
@@ -102,6 +128,7 @@ static int unreg_tm2_ops(void* arg)
     struct serializer* tm2_s = find_serializer("tengine");
 
     tm2_s->unregister_op_loader(tm2_s, TM2_OPTYPE_RPN, 1, tm2_load_rpn);
+    tm2_s->unregister_op_saver(tm2_s, OP_RPN, tm2_save_rpn);
 
     return 0;
 }
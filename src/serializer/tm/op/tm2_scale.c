@@ -24,6 +24,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "sys_port.h"
 #include "module.h"
@@ -55,6 +56,24 @@ static int tm2_load_scale(struct ir_graph* ir_graph, struct ir_node* ir_node, co
     return 0;
 }
 
+static int tm2_save_scale(struct tm2_writer* writer, struct ir_graph* ir_graph, struct ir_node* ir_node,
+                          TM2_Operator* tm_op)
+{
+    struct scale_param* scale_param = ( struct scale_param* )ir_node->op.param_mem;
+    TM2_ScaleParam tm_param;
+
+    memset(&tm_param, 0, sizeof(TM2_ScaleParam));
+
+    tm_param.axis = scale_param->axis;
+    tm_param.num_axes = scale_param->num_axes;
+    tm_param.bias_term = scale_param->bias_term;
+
+    tm_op->operator_type = TM2_OPTYPE_SCALE;
+    tm_op->offset_t_param = tm2_write_object(writer, &tm_param, sizeof(TM2_ScaleParam));
+
+    return 0;
+}
+
 static int reg_tm2_ops(void* arg)
 {
     struct serializer* tm2_s = find_serializer("tengine");
@@ -66,6 +85,7 @@ static int reg_tm2_ops(void* arg)
     }
 
     tm2_s->register_op_loader(tm2_s, TM2_OPTYPE_SCALE, 1, tm2_load_scale, scale_op_map, NULL);
+    tm2_s->register_op_saver(tm2_s, OP_SCALE, tm2_save_scale);
 
     return 0;
 }
@@ -75,6 +95,7 @@ static int unreg_tm2_ops(void* arg)
     struct serializer* tm2_s = find_serializer("tengine");
 
     tm2_s->unregister_op_loader(tm2_s, TM2_OPTYPE_SCALE, 1, tm2_load_scale);
+    tm2_s->unregister_op_saver(tm2_s, OP_SCALE, tm2_save_scale);
 
     return 0;
 }
@@ -24,6 +24,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "sys_port.h"
 #include "module.h"
@@ -55,6 +56,24 @@ static int tm2_load_sparsetodense(struct ir_graph* ir_graph, struct ir_node* ir_
     return 0;
 }
 
+static int tm2_save_sparsetodense(struct tm2_writer* writer, struct ir_graph* ir_graph, struct ir_node* ir_node,
+                                  TM2_Operator* tm_op)
+{
+    struct sparsetodense_param* sparsetodense_param = ( struct sparsetodense_param* )ir_node->op.param_mem;
+    TM2_SparseToDenseParam tm_param;
+
+    memset(&tm_param, 0, sizeof(TM2_SparseToDenseParam));
+
+    tm_param.default_value = sparsetodense_param->default_value;
+    tm_param.output_shape_size0 = sparsetodense_param->output_shape_size0;
+    tm_param.output_shape_size1 = sparsetodense_param->output_shape_size1;
+
+    tm_op->operator_type = TM2_OPTYPE_SPARSETODENSE;
+    tm_op->offset_t_param = tm2_write_object(writer, &tm_param, sizeof(TM2_SparseToDenseParam));
+
+    return 0;
+}
+
 static int reg_tm2_ops(void* arg)
 {
     struct serializer* tm2_s = find_serializer("tengine");
@@ -66,6 +85,7 @@ static int reg_tm2_ops(void* arg)
     }
 
     tm2_s->register_op_loader(tm2_s, TM2_OPTYPE_SPARSETODENSE, 1, tm2_load_sparsetodense, sparsetodense_op_map, NULL);
+    tm2_s->register_op_saver(tm2_s, OP_SPARSETODENSE, tm2_save_sparsetodense);
 
     return 0;
 }
@@ -75,6 +95,7 @@ static int unreg_tm2_ops(void* arg)
     struct serializer* tm2_s = find_serializer("tengine");
 
     tm2_s->unregister_op_loader(tm2_s, TM2_OPTYPE_SPARSETODENSE, 1, tm2_load_sparsetodense);
+    tm2_s->unregister_op_saver(tm2_s, OP_SPARSETODENSE, tm2_save_sparsetodense);
 
     return 0;
 }
@@ -24,6 +24,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "sys_port.h"
 #include "module.h"
@@ -79,6 +80,26 @@ static int tm2_load_split(struct ir_graph* ir_graph, struct ir_node* ir_node, co
     return 0;
 }
 
+static int tm2_save_split(struct tm2_writer* writer, struct ir_graph* ir_graph, struct ir_node* ir_node,
+                          TM2_Operator* tm_op)
+{
+    struct split_param* split_param = ( struct split_param* )ir_node->op.param_mem;
+    TM2_SplitParam tm_param;
+
+    memset(&tm_param, 0, sizeof(TM2_SplitParam));
+
+    tm_param.axis = split_param->axis;
+    tm_param.split_dim = split_param->split_dim;
+    tm_param.is_caffe = split_param->is_caffe;
+    tm_param.is_onnx = split_param->is_onnx;
+    tm_param.offset_split_sizes = tm2_write_vector_items(writer, split_param->split_sizes_);
+
+    tm_op->operator_type = TM2_OPTYPE_SPLIT;
+    tm_op->offset_t_param = tm2_write_object(writer, &tm_param, sizeof(TM2_SplitParam));
+
+    return 0;
+}
+
 /* the auto register functions */
 
 static int reg_tm2_ops(void* arg)
@@ -92,6 +113,7 @@ static int reg_tm2_ops(void* arg)
     }
 
     tm2_s->register_op_loader(tm2_s, TM2_OPTYPE_SPLIT, 1, tm2_load_split, split_op_map, NULL);
+    tm2_s->register_op_saver(tm2_s, OP_SPLIT, tm2_save_split);
 
     return 0;
 }
@@ -101,6 +123,7 @@ static int unreg_tm2_ops(void* arg)
     struct serializer* tm2_s = find_serializer("tengine");
 
     tm2_s->unregister_op_loader(tm2_s, TM2_OPTYPE_SPLIT, 1, tm2_load_split);
+    tm2_s->unregister_op_saver(tm2_s, OP_SPLIT, tm2_save_split);
 
     return 0;
 }
@@ -24,6 +24,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "sys_port.h"
 #include "module.h"
@@ -45,6 +46,14 @@ static int tm2_load_squareddifference(struct ir_graph* ir_graph, struct ir_node*
     return 0;
 }
 
+static int tm2_save_squareddifference(struct tm2_writer* writer, struct ir_graph* ir_graph, struct ir_node* ir_node,
+                                      TM2_Operator* tm_op)
+{
+    tm_op->operator_type = TM2_OPTYPE_SQUAREDDIFFERENCE;
+
+    return 0;
+}
+
 static int reg_tm2_ops(void* arg)
 {
     struct serializer* tm2_s = find_serializer("tengine");
@@ -57,6 +66,7 @@ static int reg_tm2_ops(void* arg)
 
     tm2_s->register_op_loader(tm2_s, TM2_OPTYPE_SQUAREDDIFFERENCE, 1, tm2_load_squareddifference,
                               squareddifference_op_map, NULL);
+    tm2_s->register_op_saver(tm2_s, OP_SQUAREDDIFFERENCE, tm2_save_squareddifference);
 
     return 0;
 }
@@ -66,6 +76,7 @@ static int unreg_tm2_ops(void* arg)
     struct serializer* tm2_s = find_serializer("tengine");
 
     tm2_s->unregister_op_loader(tm2_s, TM2_OPTYPE_SQUAREDDIFFERENCE, 1, tm2_load_squareddifference);
+    tm2_s->unregister_op_saver(tm2_s, OP_SQUAREDDIFFERENCE, tm2_save_squareddifference);
 
     return 0;
 }
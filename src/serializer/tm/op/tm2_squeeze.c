@@ -24,6 +24,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "sys_port.h"
 #include "module.h"
@@ -56,6 +57,25 @@ static int tm2_load_squeeze(struct ir_graph* ir_graph, struct ir_node* ir_node,
     return 0;
 }
 
+static int tm2_save_squeeze(struct tm2_writer* writer, struct ir_graph* ir_graph, struct ir_node* ir_node,
+                            TM2_Operator* tm_op)
+{
+    struct squeeze_param* squeeze_param = ( struct squeeze_param* )ir_node->op.param_mem;
+    TM2_SqueezeParam tm_param;
+
+    memset(&tm_param, 0, sizeof(TM2_SqueezeParam));
+
+    tm_param.dim_0 = squeeze_param->dim_0;
+    tm_param.dim_1 = squeeze_param->dim_1;
+    tm_param.dim_2 = squeeze_param->dim_2;
+    tm_param.dim_3 = squeeze_param->dim_3;
+
+    tm_op->operator_type = TM2_OPTYPE_SQUEEZE;
+    tm_op->offset_t_param = tm2_write_object(writer, &tm_param, sizeof(TM2_SqueezeParam));
+
+    return 0;
+}
+
 static int reg_tm2_ops(void* arg)
 {
     struct serializer* tm2_s = find_serializer("tengine");
@@ -67,6 +87,7 @@ static int reg_tm2_ops(void* arg)
     }
 
     tm2_s->register_op_loader(tm2_s, TM2_OPTYPE_SQUEEZE, 1, tm2_load_squeeze, squeeze_op_map, NULL);
+    tm2_s->register_op_saver(tm2_s, OP_SQUEEZE, tm2_save_squeeze);
 
     return 0;
 }
@@ -76,6 +97,7 @@ static int unreg_tm2_ops(void* arg)
     struct serializer* tm2_s = find_serializer("tengine");
 
     tm2_s->unregister_op_loader(tm2_s, TM2_OPTYPE_SQUEEZE, 1, tm2_load_squeeze);
+    tm2_s->unregister_op_saver(tm2_s, OP_SQUEEZE, tm2_save_squeeze);
 
     return 0;
 }
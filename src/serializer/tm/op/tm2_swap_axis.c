@@ -24,6 +24,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "sys_port.h"
 #include "module.h"
@@ -54,6 +55,23 @@ static int tm2_load_swap_axis(struct ir_graph* ir_graph, struct ir_node* ir_node
     return 0;
 }
 
+static int tm2_save_swap_axis(struct tm2_writer* writer, struct ir_graph* ir_graph, struct ir_node* ir_node,
+                              TM2_Operator* tm_op)
+{
+    struct swap_axis_param* swap_axis_param = ( struct swap_axis_param* )ir_node->op.param_mem;
+    TM2_SwapAxisParam tm_param;
+
+    memset(&tm_param, 0, sizeof(TM2_SwapAxisParam));
+
+    tm_param.dim_0 = swap_axis_param->dim_0;
+    tm_param.dim_1 = swap_axis_param->dim_1;
+
+    tm_op->operator_type = TM2_OPTYPE_SWAPAXIS;
+    tm_op->offset_t_param = tm2_write_object(writer, &tm_param, sizeof(TM2_SwapAxisParam));
+
+    return 0;
+}
+
 static int reg_tm2_ops(void* arg)
 {
     struct serializer* tm2_s = find_serializer("tengine");
@@ -65,6 +83,7 @@ static int reg_tm2_ops(void* arg)
     }
 
     tm2_s->register_op_loader(tm2_s, TM2_OPTYPE_SWAPAXIS, 1, tm2_load_swap_axis, swap_axis_op_map, NULL);
+    tm2_s->register_op_saver(tm2_s, OP_SWAP_AXIS, tm2_save_swap_axis);
 
     return 0;
 }
@@ -74,6 +93,7 @@ static int unreg_tm2_ops(void* arg)
     struct serializer* tm2_s = find_serializer("tengine");
 
     tm2_s->unregister_op_loader(tm2_s, TM2_OPTYPE_SWAPAXIS, 1, tm2_load_swap_axis);
+    tm2_s->unregister_op_saver(tm2_s, OP_SWAP_AXIS, tm2_save_swap_axis);
 
     return 0;
 }
@@ -24,6 +24,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "sys_port.h"
 #include "module.h"
@@ -57,6 +58,23 @@ static int tm2_load_topkv2(struct ir_graph* ir_graph, struct ir_node* ir_node, c
     return 0;
 }
 
+static int tm2_save_topkv2(struct tm2_writer* writer, struct ir_graph* ir_graph, struct ir_node* ir_node,
+                           TM2_Operator* tm_op)
+{
+    struct topkv2_param* topkv2_param = ( struct topkv2_param* )ir_node->op.param_mem;
+    TM2_TopKV2Param tm_param;
+
+    memset(&tm_param, 0, sizeof(TM2_TopKV2Param));
+
+    tm_param.k = topkv2_param->k;
+    tm_param.sorted = topkv2_param->sorted;
+
+    tm_op->operator_type = TM2_OPTYPE_TOPKV2;
+    tm_op->offset_t_param = tm2_write_object(writer, &tm_param, sizeof(TM2_TopKV2Param));
+
+    return 0;
+}
+
 static int reg_tm2_ops(void* arg)
 {
     struct serializer* tm2_s = find_serializer("tengine");
@@ -68,6 +86,7 @@ static int reg_tm2_ops(void* arg)
     }
 
     tm2_s->register_op_loader(tm2_s, TM2_OPTYPE_TOPKV2, 1, tm2_load_topkv2, topkv2_op_map, NULL);
+    tm2_s->register_op_saver(tm2_s, OP_TOPKV2, tm2_save_topkv2);
 
     return 0;
 }
@@ -77,6 +96,7 @@ static int unreg_tm2_ops(void* arg)
     struct serializer* tm2_s = find_serializer("tengine");
 
     tm2_s->unregister_op_loader(tm2_s, TM2_OPTYPE_TOPKV2, 1, tm2_load_topkv2);
+    tm2_s->unregister_op_saver(tm2_s, OP_TOPKV2, tm2_save_topkv2);
 
     return 0;
 }
@@ -24,6 +24,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "sys_port.h"
 #include "module.h"
@@ -63,6 +64,22 @@ static int tm2_load_transpose(struct ir_graph* ir_graph, struct ir_node* ir_node
     return 0;
 }
 
+static int tm2_save_transpose(struct tm2_writer* writer, struct ir_graph* ir_graph, struct ir_node* ir_node,
+                              TM2_Operator* tm_op)
+{
+    struct transpose_param* transpose_param = ( struct transpose_param* )ir_node->op.param_mem;
+    TM2_TransposeParam tm_param;
+
+    memset(&tm_param, 0, sizeof(TM2_TransposeParam));
+
+    tm_param.offset_tr_shape = tm2_write_vector_dims(writer, transpose_param->tr_shape, transpose_param->tr_shape_size);
+
+    tm_op->operator_type = TM2_OPTYPE_TRANSPOSE;
+    tm_op->offset_t_param = tm2_write_object(writer, &tm_param, sizeof(TM2_TransposeParam));
+
+    return 0;
+}
+
 /* the auto register functions */
 
 static int reg_tm2_ops(void* arg)
@@ -76,6 +93,7 @@ static int reg_tm2_ops(void* arg)
     }
 
     tm2_s->register_op_loader(tm2_s, TM2_OPTYPE_TRANSPOSE, 1, tm2_load_transpose, transpose_op_map, NULL);
+    tm2_s->register_op_saver(tm2_s, OP_TRANSPOSE, tm2_save_transpose);
 
     return 0;
 }
@@ -85,6 +103,7 @@ static int unreg_tm2_ops(void* arg)
     struct serializer* tm2_s = find_serializer("tengine");
 
     tm2_s->unregister_op_loader(tm2_s, TM2_OPTYPE_TRANSPOSE, 1, tm2_load_transpose);
+    tm2_s->unregister_op_saver(tm2_s, OP_TRANSPOSE, tm2_save_transpose);
 
     return 0;
 }
@@ -24,6 +24,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "sys_port.h"
 #include "module.h"
@@ -53,6 +54,22 @@ static int tm2_load_unary(struct ir_graph* ir_graph, struct ir_node* ir_node, co
     return 0;
 }
 
+static int tm2_save_unary(struct tm2_writer* writer, struct ir_graph* ir_graph, struct ir_node* ir_node,
+                          TM2_Operator* tm_op)
+{
+    struct unary_param* unary_param = ( struct unary_param* )ir_node->op.param_mem;
+    TM2_UnaryParam tm_param;
+
+    memset(&tm_param, 0, sizeof(TM2_UnaryParam));
+
+    tm_param.type = unary_param->type;
+
+    tm_op->operator_type = TM2_OPTYPE_UNARY;
+    tm_op->offset_t_param = tm2_write_object(writer, &tm_param, sizeof(TM2_UnaryParam));
+
+    return 0;
+}
+
 static int reg_tm2_ops(void* arg)
 {
     struct serializer* tm2_s = find_serializer("tengine");
@@ -64,6 +81,7 @@ static int reg_tm2_ops(void* arg)
     }
 
     tm2_s->register_op_loader(tm2_s, TM2_OPTYPE_UNARY, 1, tm2_load_unary, unary_op_map, NULL);
+    tm2_s->register_op_saver(tm2_s, OP_UNARY, tm2_save_unary);
 
     return 0;
 }
@@ -73,6 +91,7 @@ static int unreg_tm2_ops(void* arg)
     struct serializer* tm2_s = find_serializer("tengine");
 
     tm2_s->unregister_op_loader(tm2_s, TM2_OPTYPE_UNARY, 1, tm2_load_unary);
+    tm2_s->unregister_op_saver(tm2_s, OP_UNARY, tm2_save_unary);
 
     return 0;
 }
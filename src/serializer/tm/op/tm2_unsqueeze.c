@@ -24,6 +24,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "sys_port.h"
 #include "module.h"
 #include "tengine_ir.h"
@@ -59,6 +60,22 @@ static int tm2_load_unsqueeze(struct ir_graph* ir_graph, struct ir_node* ir_node
     return 0;
 }
 
+static int tm2_save_unsqueeze(struct tm2_writer* writer, struct ir_graph* ir_graph, struct ir_node* ir_node,
+                              TM2_Operator* tm_op)
+{
+    struct unsqueeze_param* unsqueeze_param = ( struct unsqueeze_param* )ir_node->op.param_mem;
+    TM2_UnsqueezeParam tm_param;
+
+    memset(&tm_param, 0, sizeof(TM2_UnsqueezeParam));
+
+    tm_param.offset_vi_axises = tm2_write_vector_dims(writer, unsqueeze_param->axises, unsqueeze_param->axises_size);
+
+    tm_op->operator_type = TM2_OPTYPE_UNSQUEEZE;
+    tm_op->offset_t_param = tm2_write_object(writer, &tm_param, sizeof(TM2_UnsqueezeParam));
+
+    return 0;
+}
+
 static int reg_tm2_ops(void* arg)
 {
     struct serializer* tm2_s = find_serializer("tengine");
@@ -70,6 +87,7 @@ static int reg_tm2_ops(void* arg)
     }
 
     tm2_s->register_op_loader(tm2_s, TM2_OPTYPE_UNSQUEEZE, 1, tm2_load_unsqueeze, unsqueeze_op_map, NULL);
+    tm2_s->register_op_saver(tm2_s, OP_UNSQUEEZE, tm2_save_unsqueeze);
 
     return 0;
 }
@@ -79,6 +97,7 @@ static int unreg_tm2_ops(void* arg)
     struct serializer* tm2_s = find_serializer("tengine");
 
     tm2_s->unregister_op_loader(tm2_s, TM2_OPTYPE_UNSQUEEZE, 1, tm2_load_unsqueeze);
+    tm2_s->unregister_op_saver(tm2_s, OP_UNSQUEEZE, tm2_save_unsqueeze);
 
     return 0;
 }
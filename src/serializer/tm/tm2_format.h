@@ -427,6 +427,7 @@ typedef struct
 typedef struct
 {
     int32_t num_output;
+    int32_t activation; /* op_ver 3 and later */
 } TM2_FCParam;
 
 typedef struct
@@ -24,12 +24,12 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <limits.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <unistd.h>
-#ifdef __ANDROID__
 #include <sys/mman.h>
-#endif
 #include <fcntl.h>
 
 #include "sys_port.h"
@@ -38,6 +38,8 @@
 #include "tengine_log.h"
 #include "tengine_ir.h"
 #include "tengine_op.h"
+#include "tengine_utils.h"
+#include "vector.h"
 #include "tengine_serializer.h"
 #include "tm2_serializer.h"
 
@@ -50,11 +52,18 @@ struct op_loader_entry
     tm2_map_t ver_map;
 };
 
+struct op_saver_entry
+{
+    int op_type; /* ir op type */
+    tm2_op_saver_t saver;
+};
+
 struct tm2_serializer
 {
     struct serializer base;
 
     struct vector* loader_list;
+    struct vector* saver_list;
 };
 
 static const char* tm2_name = "tengine";
@@ -145,6 +154,101 @@ static int unregister_tm2_op_loader(struct tm2_serializer* s, int op_type, int o
     return -1;
 }
 
+static struct op_saver_entry* find_op_saver(struct tm2_serializer* s, int op_type)
+{
+    int saver_num = get_vector_num(s->saver_list);
+
+    for (int i = 0; i < saver_num; i++)
+    {
+        struct op_saver_entry* e = ( struct op_saver_entry* )get_vector_data(s->saver_list, i);
+
+        if (e->op_type == op_type)
+            return e;
+    }
+
+    return NULL;
+}
+
+static int register_tm2_op_saver(struct tm2_serializer* s, int op_type, tm2_op_saver_t op_saver)
+{
+    if (find_op_saver(s, op_type) != NULL)
+    {
+        TLOG_DEBUG("serializer: op: %d has saver already\n", op_type);
+        set_tengine_errno(EEXIST);
+        return -1;
+    }
+
+    struct op_saver_entry e;
+
+    e.op_type = op_type;
+    e.saver = op_saver;
+
+    push_vector_data(s->saver_list, &e);
+
+    return 0;
+}
+
+static int unregister_tm2_op_saver(struct tm2_serializer* s, int op_type, tm2_op_saver_t op_saver)
+{
+    int n = get_vector_num(s->saver_list);
+
+    for (int i = 0; i < n; i++)
+    {
+        struct op_saver_entry* e = ( struct op_saver_entry* )get_vector_data(s->saver_list, i);
+
+        if (e->op_type == op_type && e->saver == op_saver)
+        {
+            remove_vector_data(s->saver_list, e);
+            return 0;
+        }
+    }
+
+    return -1;
+}
+
+/* the tile is small enough for both its source rows and destination rows to stay in l1 */
+#define TM2_PERMUTE_TILE 32
+
+#define PERMUTE_TILE(type)                                      \
+    {                                                           \
+        const type* s = ( const type* )src + b * rows * cols;   \
+        type* d = ( type* )dst + b * rows * cols;               \
+        for (int c = c0; c < c1; c++)                           \
+            for (int r = r0; r < r1; r++)                       \
+                d[c * rows + r] = s[r * cols + c];              \
+    }
+
+/* dst[b][col][row] = src[b][row][col], tile by tile */
+static void permute_tm2_data(void* dst, const void* src, int batch, int rows, int cols, int elem_size)
+{
+    int row_tiles = (rows + TM2_PERMUTE_TILE - 1) / TM2_PERMUTE_TILE;
+    int col_tiles = (cols + TM2_PERMUTE_TILE - 1) / TM2_PERMUTE_TILE;
+    int tile_num = batch * row_tiles * col_tiles;
+
+#pragma omp parallel for
+    for (int t = 0; t < tile_num; t++)
+    {
+        int b = t / (row_tiles * col_tiles);
+        int r0 = (t / col_tiles) % row_tiles * TM2_PERMUTE_TILE;
+        int c0 = t % col_tiles * TM2_PERMUTE_TILE;
+        int r1 = r0 + TM2_PERMUTE_TILE < rows ? r0 + TM2_PERMUTE_TILE : rows;
+        int c1 = c0 + TM2_PERMUTE_TILE < cols ? c0 + TM2_PERMUTE_TILE : cols;
+
+        switch (elem_size)
+        {
+            case 4:
+                PERMUTE_TILE(uint32_t);
+                break;
+            case 2:
+                PERMUTE_TILE(uint16_t);
+                break;
+            default:
+                PERMUTE_TILE(uint8_t);
+                break;
+        }
+    }
+}
+
 static int load_graph_tensors(struct tm2_serializer* tm2_s, struct ir_graph* graph, struct tm2_priv* priv)
 {
     char* mem_base = ( char* )priv->base;
@@ -167,7 +271,6 @@ static int load_graph_tensors(struct tm2_serializer* tm2_s, struct ir_graph* gra
     {
         const TM2_Tensor* tm_tensor = ( TM2_Tensor* )(mem_base + v_tensors->offsets[i]);
         int flag_permute = 0;    // flag the tensor has to be permute
-        int dims_org[8] = {0};
 
         /* TODO: check type definition */
         struct ir_tensor* ir_tensor = create_ir_tensor(graph, NULL, tm_tensor->data_type);
@@ -203,11 +306,6 @@ static int load_graph_tensors(struct tm2_serializer* tm2_s, struct ir_graph* gra
                 {
                     int dims[8] = {0};
 
-                    dims_org[0] = v_dims->dims[0];
-                    dims_org[1] = v_dims->dims[1];
-                    dims_org[2] = v_dims->dims[2];
-                    dims_org[3] = v_dims->dims[3];
-
                     dims[0] = v_dims->dims[0];    // c_out
                     dims[1] = v_dims->dims[3];    // c_in
                     dims[2] = v_dims->dims[1];    // h
@@ -258,180 +356,33 @@ static int load_graph_tensors(struct tm2_serializer* tm2_s, struct ir_graph* gra
                     return -1;
                 }
 
-                /* permute the data of tensor from nhwc to nchw */
+                /*
+                 * permute the data of tensor from nhwc to nchw. the model data is shared with the file
+                 * mapping or the caller's buffer, so the permuted data goes to a buffer of its own.
+                 */
                 if (flag_permute)
                 {
-                    int size = ir_tensor->elem_num;
-                    int type = ir_tensor->data_type;
+                    int size = ir_tensor->elem_num * ir_tensor->elem_size;
+                    void* tensor_data = sys_malloc(size);
 
-                    if (type == TENGINE_DT_FP32)
+                    if (tensor_data == NULL)
                     {
-                        float* tensor_data_org = ( float* )sys_malloc(size * sizeof(float));
-                        float* original_date = ir_tensor->data;
-
-                        for (int n = 0; n < size; n++)
-                        {
-                            tensor_data_org[n] = original_date[n];
-                        }
-
-                        int dims[4];
-                        dims[0] = ir_tensor->dims[0];
-                        dims[1] = ir_tensor->dims[1];
-                        dims[2] = ir_tensor->dims[2];
-                        dims[3] = ir_tensor->dims[3];
-
-                        /* nhwc to nchw */
-                        //                    fprintf(stderr, "%s:\n", ir_tensor->name);
-                        //                    fprintf(stderr, "original %d, %d, %d, %d\n", dims_org[0], dims_org[1], dims_org[2],
-                        //                    dims_org[3]); fprintf(stderr, "permute  %d, %d, %d, %d\n", dims[0], dims[1], dims[2],
-                        //                    dims[3]);
-
-                        float* input = tensor_data_org;
-                        float* output = ir_tensor->data;
-
-                        int cout = dims[0];
-                        int cin = dims[1];
-                        int h = dims[2];
-                        int w = dims[3];
-
-                        if (cin == 1)
-                        {
-                            for (int co = 0; co < cout; co++)
-                            {
-                                for (int hi = 0; hi < h; hi++)
-                                {
-                                    for (int wi = 0; wi < w; wi++)
-                                    {
-                                        int offset_org = 0;
-                                        offset_org += co;
-                                        offset_org += hi * w * cout;
-                                        offset_org += wi * cout;
-
-                                        int offset = 0;
-                                        offset += co * h * w;
-                                        offset += hi * w;
-                                        offset += wi;
-
-                                        output[offset] = input[offset_org];
-                                    }
-                                }
-                            }
-                        }
-                        else
-                        {
-                            for (int co = 0; co < cout; co++)
-                            {
-                                for (int ci = 0; ci < cin; ci++)
-                                {
-                                    for (int hi = 0; hi < h; hi++)
-                                    {
-                                        for (int wi = 0; wi < w; wi++)
-                                        {
-                                            int offset_org = 0;
-                                            offset_org += co * cin * h * w;
-                                            offset_org += ci;
-                                            offset_org += hi * w * cin;
-                                            offset_org += wi * cin;
-
-                                            int offset = 0;
-                                            offset += co * cin * h * w;
-                                            offset += ci * h * w;
-                                            offset += hi * w;
-                                            offset += wi;
-
-                                            output[offset] = input[offset_org];
-                                        }
-                                    }
-                                }
-                            }
-                        }
-
-                        sys_free(tensor_data_org);
+                        set_tengine_errno(ENOMEM);
+                        return -1;
                     }
 
-                    if (type == TENGINE_DT_UINT8 || type == TENGINE_DT_INT8)
-                    {
-                        unsigned char* tensor_data_org = ( unsigned char* )sys_malloc(size * sizeof(unsigned char));
-                        unsigned char* original_date = ir_tensor->data;
-
-                        for (int n = 0; n < size; n++)
-                        {
-                            tensor_data_org[n] = original_date[n];
-                        }
-
-                        int dims[4];
-                        dims[0] = ir_tensor->dims[0];
-                        dims[1] = ir_tensor->dims[1];
-                        dims[2] = ir_tensor->dims[2];
-                        dims[3] = ir_tensor->dims[3];
-
-                        /* nhwc to nchw */
-                        fprintf(stderr, "%s:\n", ir_tensor->name);
-                        fprintf(stderr, "original %d, %d, %d, %d\n", dims_org[0], dims_org[1], dims_org[2], dims_org[3]);
-                        fprintf(stderr, "permute  %d, %d, %d, %d\n", dims[0], dims[1], dims[2], dims[3]);
-
-                        unsigned char* input = tensor_data_org;
-                        unsigned char* output = ir_tensor->data;
-
-                        int cout = dims[0];
-                        int cin = dims[1];
-                        int h = dims[2];
-                        int w = dims[3];
-
-                        if (cin == 1)
-                        {
-                            for (int co = 0; co < cout; co++)
-                            {
-                                for (int hi = 0; hi < h; hi++)
-                                {
-                                    for (int wi = 0; wi < w; wi++)
-                                    {
-                                        int offset_org = 0;
-                                        offset_org += co;
-                                        offset_org += hi * w * cout;
-                                        offset_org += wi * cout;
-
-                                        int offset = 0;
-                                        offset += co * h * w;
-                                        offset += hi * w;
-                                        offset += wi;
-
-                                        output[offset] = input[offset_org];
-                                    }
-                                }
-                            }
-                        }
-                        else
-                        {
-                            for (int co = 0; co < cout; co++)
-                            {
-                                for (int ci = 0; ci < cin; ci++)
-                                {
-                                    for (int hi = 0; hi < h; hi++)
-                                    {
-                                        for (int wi = 0; wi < w; wi++)
-                                        {
-                                            int offset_org = 0;
-                                            offset_org += co * cin * h * w;
-                                            offset_org += ci;
-                                            offset_org += hi * w * cin;
-                                            offset_org += wi * cin;
-
-                                            int offset = 0;
-                                            offset += co * cin * h * w;
-                                            offset += ci * h * w;
-                                            offset += hi * w;
-                                            offset += wi;
-
-                                            output[offset] = input[offset_org];
-                                        }
-                                    }
-                                }
-                            }
-                        }
-
-                        sys_free(tensor_data_org);
-                    }
+                    int cout = ir_tensor->dims[0];
+                    int cin = ir_tensor->dims[1];
+                    int hw = ir_tensor->dims[2] * ir_tensor->dims[3];
+
+                    /* [cout][h][w][cin] to [cout][cin][h][w], depthwise weight is [h][w][cout] */
+                    if (cin == 1)
+                        permute_tm2_data(tensor_data, ir_tensor->data, 1, hw, cout, ir_tensor->elem_size);
+                    else
+                        permute_tm2_data(tensor_data, ir_tensor->data, cout, hw, cin, ir_tensor->elem_size);
+
+                    ir_tensor->data = tensor_data;
+                    ir_tensor->free_host_mem = 1;
                 }
             }
         }
@@ -800,6 +751,36 @@ error:
     return -1;
 }
 
+/* read the whole file into memory, when it cannot be mapped */
+static void* read_model_file(int fd, int file_len)
+{
+    char* mem_base = ( char* )sys_malloc(file_len);
+
+    if (mem_base == NULL)
+    {
+        set_tengine_errno(ENOMEM);
+        return NULL;
+    }
+
+    int offset = 0;
+
+    while (offset < file_len)
+    {
+        ssize_t ret = read(fd, mem_base + offset, file_len - offset);
+
+        if (ret <= 0)
+        {
+            set_tengine_errno(EIO);
+            sys_free(mem_base);
+            return NULL;
+        }
+
+        offset += ret;
+    }
+
+    return mem_base;
+}
+
 static int load_model(struct serializer* s, struct ir_graph* graph, const char* fname, va_list ap)
 {
     struct stat stat;
@@ -813,32 +794,54 @@ static int load_model(struct serializer* s, struct ir_graph* graph, const char*
         return -1;
     }
 
-    fstat(fd, &stat);
+    if (fstat(fd, &stat) < 0 || stat.st_size <= 0)
+    {
+        set_tengine_errno(EIO);
+        TLOG_ERR("cannot get the size of file %s\n", fname);
+        close(fd);
+        return -1;
+    }
 
     int file_len = stat.st_size;
+    int mem_type = TM2_MEM_MAPPED;
 
-    //    void* mem_base = mmap(NULL, file_len, PROT_READ, MAP_PRIVATE, fd, 0);
-    //
-    //    if(mem_base == MAP_FAILED)
-    //    {
-    //        set_tengine_errno(errno);
-    //        close(fd);
-    //        return -1;
-    //    }
+    /*
+     * const tensors point straight into the mapping, so the pages are shared with the page cache
+     * and other processes loading the same model. the mapping is private and writable: a tensor
+     * written in place only gets a private copy of the pages it touches.
+     */
+    void* mem_base = mmap(NULL, file_len, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
 
-    void* mem_base = ( void* )sys_malloc(file_len);
-    int ret = read(fd, mem_base, file_len);
+    if (mem_base == MAP_FAILED)
+    {
+        mem_type = TM2_MEM_ALLOCATED;
+        mem_base = read_model_file(fd, file_len);
+    }
+
+    /* the mapping stays valid after the file is closed */
+    close(fd);
+
+    if (mem_base == NULL)
+    {
+        TLOG_ERR("cannot read file %s\n", fname);
+        return -1;
+    }
 
     struct tm2_priv* priv = ( struct tm2_priv* )sys_malloc(sizeof(struct tm2_priv));
 
     if (priv == NULL)
     {
+        if (mem_type == TM2_MEM_MAPPED)
+            munmap(mem_base, file_len);
+        else
+            sys_free(mem_base);
+
         set_tengine_errno(ENOMEM);
-        close(fd);
         return -1;
     }
 
-    priv->fd = fd;
+    priv->fd = -1;
+    priv->mem_type = mem_type;
     priv->mem_len = file_len;
     priv->base = mem_base;
     priv->header = get_tm_file_header(mem_base);
@@ -862,7 +865,9 @@ static int load_mem(struct serializer* s, struct ir_graph* graph, const void* ad
         return -1;
     }
 
+    /* the buffer belongs to the caller, it has to outlive the graph */
     priv->fd = -1;
+    priv->mem_type = TM2_MEM_EXTERNAL;
     priv->mem_len = size;
     priv->base = addr;
     priv->header = get_tm_file_header(addr);
@@ -880,23 +885,389 @@ static int unload_graph(struct serializer* s, struct ir_graph* graph, void* s_pr
 {
     struct tm2_priv* priv = ( struct tm2_priv* )s_priv;
 
-    if (priv->base)
+    if (priv->mem_type == TM2_MEM_MAPPED)
+        munmap(( void* )priv->base, priv->mem_len);
+    else if (priv->mem_type == TM2_MEM_ALLOCATED)
         sys_free(( void* )priv->base);
 
+    if (priv->fd >= 0)
+        close(priv->fd);
+
     graph->serializer = NULL;
     graph->serializer_priv = NULL;
-#ifdef __ANDROID__
-    if (priv->fd >= 0)
+
+    sys_free(priv);
+
+    return 0;
+}
+
+/************************** save ************************************/
+
+/* const data is aligned for the simd loads of the kernels */
+#define TM2_DATA_ALIGN 16
+
+static tm_uoffset_t write_tm2_data(struct tm2_writer* writer, const void* data, int size, int align)
+{
+    if (writer->error)
+        return TM2_NOT_SET;
+
+    int offset = (writer->size + align - 1) & -align;
+
+    if (size < 0 || offset > INT_MAX - size)
     {
-        munmap(( void* )priv->base, priv->mem_len);
-        close(priv->fd);
+        TLOG_ERR("serializer: model is too large for tm2\n");
+        writer->error = 1;
+        return TM2_NOT_SET;
     }
-#endif
-    sys_free(priv);
+
+    if (offset + size > writer->capacity)
+    {
+        int capacity = writer->capacity > 0 ? writer->capacity : 4096;
+
+        while (capacity < offset + size)
+            capacity = capacity > INT_MAX / 2 ? INT_MAX : capacity * 2;
+
+        char* base = ( char* )sys_realloc(writer->base, capacity);
+
+        if (base == NULL)
+        {
+            writer->error = 1;
+            return TM2_NOT_SET;
+        }
+
+        writer->base = base;
+        writer->capacity = capacity;
+    }
+
+    memset(writer->base + writer->size, 0, offset - writer->size);
+
+    if (data != NULL)
+        memcpy(writer->base + offset, data, size);
+    else
+        memset(writer->base + offset, 0, size);
+
+    writer->size = offset + size;
+
+    return offset;
+}
+
+tm_uoffset_t tm2_write_object(struct tm2_writer* writer, const void* obj, int size)
+{
+    return write_tm2_data(writer, obj, size, 4);
+}
+
+tm_uoffset_t tm2_write_string(struct tm2_writer* writer, const char* str)
+{
+    if (str == NULL)
+        return TM2_NOT_SET;
+
+    TM2_String tm_str;
+
+    tm_str.size = strlen(str);
+    tm_str.offset_data = write_tm2_data(writer, str, tm_str.size + 1, 4);
+
+    return tm2_write_object(writer, &tm_str, sizeof(TM2_String));
+}
+
+/* the vectors are all a count followed by 4-byte items */
+static tm_uoffset_t write_tm2_vector(struct tm2_writer* writer, const void* items, int num)
+{
+    tm_size_t v_num = num;
+    tm_uoffset_t offset = tm2_write_object(writer, &v_num, sizeof(tm_size_t));
+
+    if (num > 0)
+        write_tm2_data(writer, items, num * 4, 4);
+
+    return offset;
+}
+
+tm_uoffset_t tm2_write_vector_dims(struct tm2_writer* writer, const int* dims, int num)
+{
+    if (dims == NULL)
+        return TM2_NOT_SET;
+
+    return write_tm2_vector(writer, dims, num);
+}
+
+tm_uoffset_t tm2_write_vector_floats(struct tm2_writer* writer, const float* data, int num)
+{
+    if (data == NULL)
+        return TM2_NOT_SET;
+
+    return write_tm2_vector(writer, data, num);
+}
+
+tm_uoffset_t tm2_write_vector_items(struct tm2_writer* writer, struct vector* v)
+{
+    if (v == NULL || v->elem_size != 4)
+        return TM2_NOT_SET;
+
+    int num = get_vector_num(v);
+    tm_size_t v_num = num;
+    tm_uoffset_t offset = tm2_write_object(writer, &v_num, sizeof(tm_size_t));
+
+    /* vector entries are padded, copy them one by one */
+    for (int i = 0; i < num; i++)
+        write_tm2_data(writer, get_vector_data(v, i), 4, 4);
+
+    return offset;
+}
+
+static tm_uoffset_t write_tm2_quant_params(struct tm2_writer* writer, struct ir_tensor* ir_tensor)
+{
+    int num = ir_tensor->quant_param_num;
+    tm_uoffset_t offsets[num];
+
+    for (int i = 0; i < num; i++)
+    {
+        TM2_QuantParam tm_qtparam;
+
+        tm_qtparam.zero_point = num == 1 ? ir_tensor->zero_point : ir_tensor->zp_list[i];
+        tm_qtparam.scale = num == 1 ? ir_tensor->scale : ir_tensor->scale_list[i];
+        tm_qtparam.width = ir_tensor->elem_size * 8;
+
+        offsets[i] = tm2_write_object(writer, &tm_qtparam, sizeof(TM2_QuantParam));
+    }
+
+    return write_tm2_vector(writer, offsets, num);
+}
+
+static int save_graph_tensors(struct tm2_writer* writer, struct ir_graph* ir_graph, TM2_Subgraph* tm_graph)
+{
+    int tensor_num = ir_graph->tensor_num;
+    int buffer_num = 0;
+    tm_uoffset_t* tensor_offsets = ( tm_uoffset_t* )sys_malloc(sizeof(tm_uoffset_t) * (tensor_num + 1));
+    tm_uoffset_t* buffer_offsets = ( tm_uoffset_t* )sys_malloc(sizeof(tm_uoffset_t) * (tensor_num + 1));
+
+    if (tensor_offsets == NULL || buffer_offsets == NULL)
+    {
+        sys_free(tensor_offsets);
+        sys_free(buffer_offsets);
+        set_tengine_errno(ENOMEM);
+        return -1;
+    }
+
+    for (int i = 0; i < tensor_num; i++)
+    {
+        struct ir_tensor* ir_tensor = get_ir_graph_tensor(ir_graph, i);
+        TM2_Tensor tm_tensor;
+
+        memset(&tm_tensor, 0, sizeof(TM2_Tensor));
+
+        tm_tensor.tensor_id = i;
+        tm_tensor.layout = ir_tensor->layout;
+        tm_tensor.type = ir_tensor->tensor_type;
+        tm_tensor.data_type = ir_tensor->data_type;
+        tm_tensor.offset_s_tname = tm2_write_string(writer, ir_tensor->name);
+
+        if (ir_tensor->dim_num > 0)
+            tm_tensor.offset_vd_dims = tm2_write_vector_dims(writer, ir_tensor->dims, ir_tensor->dim_num);
+
+        if (ir_tensor->quant_param_num > 0)
+            tm_tensor.offect_vo_quantparams = write_tm2_quant_params(writer, ir_tensor);
+
+        /* the const data as it is now, folded and permuted */
+        if (ir_tensor->tensor_type == TENSOR_TYPE_CONST)
+        {
+            TM2_Buffer tm_buf;
+
+            tm_buf.size = ir_tensor->elem_num * ir_tensor->elem_size;
+            tm_buf.offset_data = TM2_NOT_SET;
+
+            if (ir_tensor->data != NULL)
+                tm_buf.offset_data = write_tm2_data(writer, ir_tensor->data, tm_buf.size, TM2_DATA_ALIGN);
+
+            tm_tensor.buffer_id = buffer_num;
+            buffer_offsets[buffer_num++] = tm2_write_object(writer, &tm_buf, sizeof(TM2_Buffer));
+        }
+
+        tensor_offsets[i] = tm2_write_object(writer, &tm_tensor, sizeof(TM2_Tensor));
+    }
+
+    tm_graph->offset_vo_tensors = write_tm2_vector(writer, tensor_offsets, tensor_num);
+    tm_graph->offset_vo_buffers = write_tm2_vector(writer, buffer_offsets, buffer_num);
+
+    sys_free(tensor_offsets);
+    sys_free(buffer_offsets);
 
     return 0;
 }
 
+static tm_uoffset_t write_tm2_tensor_indices(struct tm2_writer* writer, const int16_t* idx, int num)
+{
+    uint32_t indices[num + 1];
+
+    for (int i = 0; i < num; i++)
+        indices[i] = idx[i];
+
+    return write_tm2_vector(writer, indices, num);
+}
+
+static int save_graph_nodes(struct tm2_serializer* tm2_s, struct tm2_writer* writer, struct ir_graph* ir_graph,
+                            TM2_Subgraph* tm_graph)
+{
+    int node_num = ir_graph->node_num;
+    tm_uoffset_t* node_offsets = ( tm_uoffset_t* )sys_malloc(sizeof(tm_uoffset_t) * (node_num + 1));
+
+    if (node_offsets == NULL)
+    {
+        set_tengine_errno(ENOMEM);
+        return -1;
+    }
+
+    for (int i = 0; i < node_num; i++)
+    {
+        struct ir_node* ir_node = get_ir_graph_node(ir_graph, i);
+        struct op_saver_entry* e = find_op_saver(tm2_s, ir_node->op.op_type);
+
+        if (e == NULL)
+        {
+            TLOG_ERR("serializer: cannot find op saver for op: %s\n", get_op_name(ir_node->op.op_type));
+            sys_free(node_offsets);
+            set_tengine_errno(ENOTSUP);
+            return -1;
+        }
+
+        TM2_Operator tm_op;
+
+        tm_op.op_ver = TM2_OP_VER;
+        tm_op.operator_type = TM2_OPTYPE_NUM;
+        tm_op.offset_t_param = TM2_NOT_SET;
+
+        if (e->saver(writer, ir_graph, ir_node, &tm_op) < 0)
+        {
+            TLOG_ERR("serializer: failed to save op: %s for node: %d\n", get_op_name(ir_node->op.op_type), i);
+            sys_free(node_offsets);
+            set_tengine_errno(EFAULT);
+            return -1;
+        }
+
+        TM2_Node tm_node;
+
+        memset(&tm_node, 0, sizeof(TM2_Node));
+
+        tm_node.node_id = i;
+        tm_node.dynamic_shape = ir_node->dynamic_shape;
+        tm_node.offset_s_nname = tm2_write_string(writer, ir_node->name);
+        tm_node.offset_t_operator = tm2_write_object(writer, &tm_op, sizeof(TM2_Operator));
+        tm_node.offset_vo_attrs = TM2_NOT_SET;
+
+        if (ir_node->input_num > 0)
+            tm_node.offset_vi_input_tensors =
+                write_tm2_tensor_indices(writer, ir_node->input_tensors, ir_node->input_num);
+
+        tm_node.offset_vi_output_tensors =
+            write_tm2_tensor_indices(writer, ir_node->output_tensors, ir_node->output_num);
+
+        node_offsets[i] = tm2_write_object(writer, &tm_node, sizeof(TM2_Node));
+    }
+
+    tm_graph->offset_vo_seq_nodes = write_tm2_vector(writer, node_offsets, node_num);
+
+    sys_free(node_offsets);
+
+    return 0;
+}
+
+static int save_graph_image(struct tm2_serializer* tm2_s, struct tm2_writer* writer, struct ir_graph* ir_graph)
+{
+    /* the header goes first, its root offset is filled at the end */
+    write_tm2_data(writer, NULL, sizeof(TM2_Header), 4);
+
+    TM2_Subgraph tm_graph;
+
+    memset(&tm_graph, 0, sizeof(TM2_Subgraph));
+
+    /* tensors and params are in the graph layout already, they must not be permuted again by the loader */
+    tm_graph.subgraph_id = 0;
+    tm_graph.graph_layout = ir_graph->graph_layout;
+    tm_graph.model_layout = ir_graph->graph_layout;
+
+    if (save_graph_tensors(writer, ir_graph, &tm_graph) < 0 || save_graph_nodes(tm2_s, writer, ir_graph, &tm_graph) < 0)
+        return -1;
+
+    tm_graph.offset_vi_input_indices = write_tm2_tensor_indices(writer, ir_graph->input_nodes, ir_graph->input_num);
+    tm_graph.offset_vi_output_indices = write_tm2_tensor_indices(writer, ir_graph->output_nodes, ir_graph->output_num);
+    tm_graph.offset_s_sname = TM2_NOT_SET;
+
+    tm_uoffset_t subgraph_offset = tm2_write_object(writer, &tm_graph, sizeof(TM2_Subgraph));
+
+    TM2_Model tm_model;
+
+    memset(&tm_model, 0, sizeof(TM2_Model));
+
+    /* keep the origin of a model loaded from tm2 */
+    if (ir_graph->serializer == ( struct serializer* )tm2_s && ir_graph->serializer_priv != NULL)
+    {
+        const struct tm2_priv* priv = ( struct tm2_priv* )ir_graph->serializer_priv;
+
+        tm_model.orig_format = priv->model->orig_format;
+        tm_model.sub_format = priv->model->sub_format;
+    }
+
+    tm_model.offset_vo_subgraphs = write_tm2_vector(writer, &subgraph_offset, 1);
+    tm_model.offset_s_mname = TM2_NOT_SET;
+
+    tm_uoffset_t root_offset = tm2_write_object(writer, &tm_model, sizeof(TM2_Model));
+
+    if (writer->error)
+    {
+        set_tengine_errno(ENOMEM);
+        return -1;
+    }
+
+    TM2_Header* header = ( TM2_Header* )writer->base;
+
+    header->ver_main = TM2_FILE_VER_MAIN;
+    header->ver_sub = TM2_FILE_VER_SUB;
+    header->ver_compile = TM2_FILE_VER_COMPILE;
+    header->offset_root = root_offset;
+
+    return 0;
+}
+
+static int save_model(struct serializer* s, struct ir_graph* graph, const char* fname, va_list ap)
+{
+    struct tm2_serializer* tm2_s = ( struct tm2_serializer* )s;
+    struct tm2_writer writer;
+
+    memset(&writer, 0, sizeof(struct tm2_writer));
+
+    if (save_graph_image(tm2_s, &writer, graph) < 0)
+    {
+        sys_free(writer.base);
+        return -1;
+    }
+
+    FILE* fp = fopen(fname, "wb");
+
+    if (fp == NULL)
+    {
+        TLOG_ERR("cannot open file %s\n", fname);
+        sys_free(writer.base);
+        set_tengine_errno(ENOENT);
+        return -1;
+    }
+
+    int ret = 0;
+
+    if (fwrite(writer.base, 1, writer.size, fp) != ( size_t )writer.size)
+        ret = -1;
+
+    if (fclose(fp) != 0)
+        ret = -1;
+
+    sys_free(writer.base);
+
+    if (ret < 0)
+    {
+        TLOG_ERR("cannot write file %s\n", fname);
+        set_tengine_errno(EIO);
+    }
+
+    return ret;
+}
+
 /* a simple wrapper for type convsion */
 static int register_op_loader(struct serializer* s, int op_type, int op_ver, void* op_load_func, void* op_map_func,
                               void* ver_map_func)
@@ -917,6 +1288,22 @@ static int unregister_op_loader(struct serializer* s, int op_type, int op_ver, v
     return unregister_tm2_op_loader(tm2_s, op_type, op_ver, op_load);
 }
 
+static int register_op_saver(struct serializer* s, int op_type, void* op_save_func)
+{
+    struct tm2_serializer* tm2_s = ( struct tm2_serializer* )s;
+    tm2_op_saver_t op_save = op_save_func;
+
+    return register_tm2_op_saver(tm2_s, op_type, op_save);
+}
+
+static int unregister_op_saver(struct serializer* s, int op_type, void* op_save_func)
+{
+    struct tm2_serializer* tm2_s = ( struct tm2_serializer* )s;
+    tm2_op_saver_t op_save = op_save_func;
+
+    return unregister_tm2_op_saver(tm2_s, op_type, op_save);
+}
+
 static const char* get_name(struct serializer* s)
 {
     return tm2_name;
@@ -932,18 +1319,36 @@ static int input_op_map(int op)
     return OP_INPUT;
 }
 
+static int const_op_save(struct tm2_writer* writer, struct ir_graph* ir_graph, struct ir_node* ir_node,
+                         TM2_Operator* tm_op)
+{
+    tm_op->operator_type = TM2_OPTYPE_CONST;
+    return 0;
+}
+
+static int input_op_save(struct tm2_writer* writer, struct ir_graph* ir_graph, struct ir_node* ir_node,
+                         TM2_Operator* tm_op)
+{
+    tm_op->operator_type = TM2_OPTYPE_INPUTOP;
+    return 0;
+}
+
 static int init_tm2_serializer(struct serializer* s)
 {
     struct tm2_serializer* tm2_s = ( struct tm2_serializer* )s;
 
     tm2_s->loader_list = create_vector(sizeof(struct op_loader_entry), NULL);
+    tm2_s->saver_list = create_vector(sizeof(struct op_saver_entry), NULL);
 
-    if (tm2_s->loader_list == NULL)
+    if (tm2_s->loader_list == NULL || tm2_s->saver_list == NULL)
         return -1;
 
     s->register_op_loader(s, TM2_OPTYPE_INPUTOP, 1, NULL_TM2_OP_LOADER, input_op_map, NULL);
     s->register_op_loader(s, TM2_OPTYPE_CONST, 1, NULL_TM2_OP_LOADER, const_op_map, NULL);
 
+    s->register_op_saver(s, OP_INPUT, input_op_save);
+    s->register_op_saver(s, OP_CONST, const_op_save);
+
     return 0;
 }
 
@@ -954,7 +1359,11 @@ static int release_tm2_serializer(struct serializer* s)
     s->unregister_op_loader(s, TM2_OPTYPE_INPUTOP, 1, NULL_TM2_OP_LOADER);
     s->unregister_op_loader(s, TM2_OPTYPE_CONST, 1, NULL_TM2_OP_LOADER);
 
+    s->unregister_op_saver(s, OP_INPUT, input_op_save);
+    s->unregister_op_saver(s, OP_CONST, const_op_save);
+
     release_vector(tm2_s->loader_list);
+    release_vector(tm2_s->saver_list);
 
     return 0;
 }
@@ -966,12 +1375,16 @@ static struct tm2_serializer tm2_serializer = {
             .load_model = load_model,
             .load_mem = load_mem,
             .unload_graph = unload_graph,
+            .save_model = save_model,
             .register_op_loader = register_op_loader,
             .unregister_op_loader = unregister_op_loader,
+            .register_op_saver = register_op_saver,
+            .unregister_op_saver = unregister_op_saver,
             .init = init_tm2_serializer,
             .release = release_tm2_serializer,
         },
     .loader_list = NULL,
+    .saver_list = NULL,
 };
 
 static int reg_tm2_serializer(void* arg)
@@ -27,11 +27,19 @@
 
 #include "tm2_format.h"
 
+struct vector;
+
 #define NULL_TM2_OP_LOADER (( tm2_op_loader_t )0x1)
 
+/* where the model data lives */
+#define TM2_MEM_EXTERNAL 0 /* owned by the caller of load_mem */
+#define TM2_MEM_ALLOCATED 1 /* read into memory */
+#define TM2_MEM_MAPPED 2 /* mapped from the file */
+
 struct tm2_priv
 {
     int fd; /* for file load */
+    int mem_type;
     int mem_len;
     const char* base; /* mem base for model */
     const TM2_Header* header; /* file header */
@@ -41,6 +49,26 @@ struct tm2_priv
 
 typedef int (*tm2_op_loader_t)(struct ir_graph*, struct ir_node*, const TM2_Node*, const TM2_Operator* tm_op);
 
+/* the model image built by save_model, objects are appended and referred to by their offset in the file */
+struct tm2_writer
+{
+    char* base;
+    int size;
+    int capacity;
+    int error; /* an append failed, the image is dropped */
+};
+
+/* fills operator_type and offset_t_param of tm_op */
+typedef int (*tm2_op_saver_t)(struct tm2_writer*, struct ir_graph*, struct ir_node*, TM2_Operator* tm_op);
+
+/* for the op savers: append an object, returns its offset or TM2_NOT_SET for an empty one or on failure */
+tm_uoffset_t tm2_write_object(struct tm2_writer* writer, const void* obj, int size);
+tm_uoffset_t tm2_write_string(struct tm2_writer* writer, const char* str);
+tm_uoffset_t tm2_write_vector_dims(struct tm2_writer* writer, const int* dims, int num);
+tm_uoffset_t tm2_write_vector_floats(struct tm2_writer* writer, const float* data, int num);
+/* a struct vector of 4-byte items, ints or floats */
+tm_uoffset_t tm2_write_vector_items(struct tm2_writer* writer, struct vector* v);
+
 typedef int (*tm2_map_t)(int);
 
 #endif
@@ -0,0 +1,134 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * License); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * AS IS BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*
+ * Copyright (c) 2020, OPEN AI LAB
+ */
+
+/*
+ * the fc nodes of the shipped models are op_ver 2, their param has no activation field.
+ * they must load without activation, and an activation saved by save_graph must load back.
+ */
+
+#include <stdio.h>
+
+#include "tengine_c_api.h"
+#include "tengine_ir.h"
+#include "tengine_op.h"
+#include "fc_param.h"
+
+static int check_fc_activation(struct ir_graph* graph, int activation)
+{
+    int fc_num = 0;
+
+    for (int i = 0; i < graph->node_num; i++)
+    {
+        struct ir_node* node = get_ir_graph_node(graph, i);
+
+        if (node->op.op_type != OP_FC)
+            continue;
+
+        struct fc_param* param = ( struct fc_param* )node->op.param_mem;
+
+        if (param->activation != activation)
+        {
+            fprintf(stderr, "node %s: activation %d, expected %d\n", node->name, param->activation, activation);
+            return -1;
+        }
+
+        fc_num++;
+    }
+
+    if (fc_num == 0)
+    {
+        fprintf(stderr, "no fc node in the model\n");
+        return -1;
+    }
+
+    return 0;
+}
+
+static void set_fc_activation(struct ir_graph* graph, int activation)
+{
+    for (int i = 0; i < graph->node_num; i++)
+    {
+        struct ir_node* node = get_ir_graph_node(graph, i);
+
+        if (node->op.op_type == OP_FC)
+            (( struct fc_param* )node->op.param_mem)->activation = activation;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 3)
+    {
+        fprintf(stderr, "usage: %s model_file save_file\n", argv[0]);
+        return 1;
+    }
+
+    if (init_tengine() < 0)
+        return 1;
+
+    int ret = 1;
+    graph_t graph = create_graph(NULL, "tengine", argv[1]);
+    graph_t saved = NULL;
+
+    if (graph == NULL)
+    {
+        fprintf(stderr, "load model %s failed\n", argv[1]);
+        goto out;
+    }
+
+    if (check_fc_activation(( struct ir_graph* )graph, -1) < 0)
+        goto out;
+
+    set_fc_activation(( struct ir_graph* )graph, 0);
+
+    if (save_graph(graph, "tengine", argv[2]) < 0)
+    {
+        fprintf(stderr, "save model %s failed\n", argv[2]);
+        goto out;
+    }
+
+    saved = create_graph(NULL, "tengine", argv[2]);
+
+    if (saved == NULL)
+    {
+        fprintf(stderr, "load model %s failed\n", argv[2]);
+        goto out;
+    }
+
+    if (check_fc_activation(( struct ir_graph* )saved, 0) < 0)
+        goto out;
+
+    ret = 0;
+
+out:
+    if (saved)
+        destroy_graph(saved);
+    if (graph)
+        destroy_graph(graph);
+
+    release_tengine();
+
+    printf("%s: %s\n", argv[1], ret ? "FAIL" : "PASS");
+
+    return ret;
+}